@@ -756,10 +756,9 @@ Mutation *Chromosome::ApplyMutationCallbacks(Mutation *p_mut, Genome *p_genome,
 				
 				// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
 				{
-					EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim_->SymbolTable());
-					EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-					EidosFunctionMap &function_map = sim_->FunctionMap();
-					EidosInterpreter interpreter(mutation_callback->compound_statement_node_, client_symbols, function_map, sim_, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+					SLiMCallbackInvocation invocation(mutation_callback, *sim_);
+					EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+					EidosInterpreter &interpreter = invocation.Interpreter();
 					
 					if (mutation_callback->contains_self_)
 						callback_symbols.InitializeConstantSymbolEntry(mutation_callback->SelfSymbolTableEntry());		// define "self"
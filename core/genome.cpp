@@ -28,8 +28,10 @@
 
 #include <algorithm>
 #include <string>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <iomanip>
 #include <map>
 #include <utility>
@@ -1375,8 +1377,8 @@ void Genome::PrintGenomes_SLiM(std::ostream &p_out, std::vector<Genome *> &p_gen
 	}
 }
 
-// print the sample represented by genomes, using "ms" format
-void Genome::PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genomes, const Chromosome &p_chromosome, bool p_filter_monomorphic)
+// print the sample represented by genomes, using "ms" format; returns the number of segregating sites printed
+size_t Genome::PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genomes, const Chromosome &p_chromosome, bool p_filter_monomorphic)
 {
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 	slim_popsize_t sample_size = (slim_popsize_t)p_genomes.size();
@@ -1469,11 +1471,14 @@ void Genome::PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genom
 		p_out.precision(oldprecision);
 	}
 	
-	// print the sample's genotypes
+	// print the sample's genotypes; each line is assembled in a reused buffer and written with a single write() call
+	std::string genotype;
+	
 	for (slim_popsize_t j = 0; j < sample_size; j++)														// go through all individuals
 	{
 		Genome &genome = *p_genomes[j];
-		std::string genotype(sorted_polymorphisms.size(), '0'); // fill with 0s
+		
+		genotype.assign(sorted_polymorphisms.size(), '0'); // fill with 0s
 		
 		for (int run_index = 0; run_index < genome.mutrun_count_; ++run_index)
 		{
@@ -1488,12 +1493,46 @@ void Genome::PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genom
 				
 				// BCH 4/24/2019: when p_filter_monomorphic is true, mutations in a given genome may not exist in the position map
 				if (found_position != genotype_string_positions.end())
-					genotype.replace(found_position->second, 1, "1");
+					genotype[found_position->second] = '1';
 			}
 		}
 		
-		p_out << genotype << std::endl;
+		genotype.push_back('\n');
+		p_out.write(genotype.data(), (std::streamsize)genotype.size());
+	}
+	
+	return sorted_polymorphisms.size();
+}
+
+// Helpers for PrintGenomes_VCF(), which assembles the genotype columns of each call line in a character buffer
+static inline void _VCFAppendInteger(std::string &p_buffer, int64_t p_value)
+{
+	char digits[24];
+	char *digits_end = digits + 24, *digit_ptr = digits_end;
+	uint64_t magnitude = (p_value < 0) ? (uint64_t)0 - (uint64_t)p_value : (uint64_t)p_value;
+	
+	do
+	{
+		*--digit_ptr = (char)('0' + (magnitude % 10));
+		magnitude /= 10;
 	}
+	while (magnitude);
+	
+	if (p_value < 0)
+		*--digit_ptr = '-';
+	
+	p_buffer.append(digit_ptr, digits_end - digit_ptr);
+}
+
+static inline bool _VCFWalkerContainsMutation(GenomeWalker &p_walker, const Mutation *p_mutation)
+{
+	// call lines are emitted in position order, so each walker only ever moves forward; stacked mutations are handled by the lookahead
+	slim_position_t position = p_mutation->position_;
+	
+	while (!p_walker.Finished() && (p_walker.Position() < position))
+		p_walker.NextMutation();
+	
+	return (!p_walker.Finished() && (p_walker.Position() == position) && p_walker.MutationIsStackedAtCurrentPosition(const_cast<Mutation *>(p_mutation)));
 }
 
 // print the sample represented by genomes, using "vcf" format
@@ -1613,6 +1652,18 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 	
 	std::sort(sorted_polymorphisms.begin(), sorted_polymorphisms.end());
 	
+	// Genotypes are called with one GenomeWalker per genome, advanced in step with the sorted polymorphisms, rather than with a
+	// contains_mutation() search per genome per call line; the genotype columns of each call line are then assembled in a reused
+	// buffer and written out with a single write() call, which is much faster than streaming each genotype with operator<<.
+	std::vector<GenomeWalker> walkers;
+	std::string calls;
+	
+	walkers.reserve(p_genomes.size());
+	for (Genome *genome : p_genomes)
+		walkers.emplace_back(genome);
+	
+	calls.reserve(sample_size * 4 + 1);
+	
 	// Print a line for each mutation.  Note that we do NOT treat multiple mutations at the same position at being different alleles,
 	// output on the same line.  This is because a single individual can carry more than one mutation at the same position, so it is
 	// not really a question of different alleles; if there are N mutations at a given position, there are 2^N possible "alleles",
@@ -1736,6 +1787,8 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 					p_out << "\tGT";
 					
 					// emit the individual calls
+					calls.clear();
+					
 					for (slim_popsize_t s = 0; s < sample_size; s++)
 					{
 						Genome &g1 = *p_genomes[s * 2];
@@ -1748,7 +1801,7 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 							EIDOS_TERMINATION << "ERROR (Population::PrintGenomes_VCF): (internal error) no non-null genome to output for individual." << EidosTerminate();
 						}
 						
-						p_out << '\t';
+						calls.push_back('\t');
 						
 						for (int genome_index = 0; genome_index <= 1; ++genome_index)
 						{
@@ -1763,7 +1816,7 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 								{
 									const Mutation *mutation = nuc_based[muts_index]->mutation_ptr_;
 									
-									if (genome.contains_mutation(mutation->BlockIndex()))
+									if (_VCFWalkerContainsMutation(walkers[s * 2 + genome_index], mutation))
 									{
 										if (contained_mut_index == -1)
 											contained_mut_index = muts_index;
@@ -1773,18 +1826,19 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 								}
 								
 								if (contained_mut_index == -1)
-									p_out << '0';
+									calls.push_back('0');
 								else
-									p_out << allele_index_for_nuc[nuc_based[contained_mut_index]->mutation_ptr_->nucleotide_];
+									_VCFAppendInteger(calls, allele_index_for_nuc[nuc_based[contained_mut_index]->mutation_ptr_->nucleotide_]);
 							}
 							
 							// If both genomes are non-null, emit a separator
 							if ((genome_index == 0) && !g1_null && !g2_null)
-								p_out << '|';
+								calls.push_back('|');
 						}
 					}
 					
-					p_out << std::endl;
+					calls.push_back('\n');
+					p_out.write(calls.data(), (std::streamsize)calls.size());
 				}
 			}
 			else
@@ -1878,6 +1932,8 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 				p_out << "\tGT";
 				
 				// emit the individual calls
+				calls.clear();
+				
 				for (slim_popsize_t s = 0; s < sample_size; s++)
 				{
 					Genome &g1 = *p_genomes[s * 2];
@@ -1890,7 +1946,7 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 						EIDOS_TERMINATION << "ERROR (Population::PrintGenomes_VCF): (internal error) no non-null genome to output for individual." << EidosTerminate();
 					}
 					
-					p_out << '\t';
+					calls.push_back('\t');
 					
 					for (int genome_index = 0; genome_index <= 1; ++genome_index)
 					{
@@ -1905,7 +1961,7 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 							{
 								const Mutation *mutation = nuc_based[muts_index]->mutation_ptr_;
 								
-								if (genome.contains_mutation(mutation->BlockIndex()))
+								if (_VCFWalkerContainsMutation(walkers[s * 2 + genome_index], mutation))
 								{
 									if (contained_mut_index == -1)
 										contained_mut_index = muts_index;
@@ -1915,18 +1971,19 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 							}
 							
 							if (contained_mut_index == -1)
-								p_out << '0';
+								calls.push_back('0');
 							else
-								p_out << (contained_mut_index + 1);
+								_VCFAppendInteger(calls, contained_mut_index + 1);
 						}
 						
 						// If both genomes are non-null, emit a separator
 						if ((genome_index == 0) && !g1_null && !g2_null)
-							p_out << '|';
+							calls.push_back('|');
 					}
 				}
 				
-				p_out << std::endl;
+				calls.push_back('\n');
+				p_out.write(calls.data(), (std::streamsize)calls.size());
 			}
 		}
 		
@@ -1968,6 +2025,8 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 					p_out << "\tGT";
 					
 					// emit the individual calls
+					calls.clear();
+					
 					for (slim_popsize_t s = 0; s < sample_size; s++)
 					{
 						Genome &g1 = *p_genomes[s * 2];
@@ -1982,27 +2041,28 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 						else if (g1_null)
 						{
 							// An unpaired X or Y; we emit this as haploid, I think that is the right call...
-							p_out << (g2.contains_mutation(mutation->BlockIndex()) ? "\t1" : "\t0");
+							calls.append(_VCFWalkerContainsMutation(walkers[s * 2 + 1], mutation) ? "\t1" : "\t0");
 						}
 						else if (g2_null)
 						{
 							// An unpaired X or Y; we emit this as haploid, I think that is the right call...
-							p_out << (g1.contains_mutation(mutation->BlockIndex()) ? "\t1" : "\t0");
+							calls.append(_VCFWalkerContainsMutation(walkers[s * 2], mutation) ? "\t1" : "\t0");
 						}
 						else
 						{
 							// Both genomes are non-null; emit an x|y pair that indicates the data is phased
-							bool g1_has_mut = g1.contains_mutation(mutation->BlockIndex());
-							bool g2_has_mut = g2.contains_mutation(mutation->BlockIndex());
+							bool g1_has_mut = _VCFWalkerContainsMutation(walkers[s * 2], mutation);
+							bool g2_has_mut = _VCFWalkerContainsMutation(walkers[s * 2 + 1], mutation);
 							
-							if (g1_has_mut && g2_has_mut)	p_out << "\t1|1";
-							else if (g1_has_mut)			p_out << "\t1|0";
-							else if (g2_has_mut)			p_out << "\t0|1";
-							else							p_out << "\t0|0";
+							if (g1_has_mut && g2_has_mut)	calls.append("\t1|1");
+							else if (g1_has_mut)			calls.append("\t1|0");
+							else if (g2_has_mut)			calls.append("\t0|1");
+							else							calls.append("\t0|0");
 						}
 					}
 					
-					p_out << std::endl;
+					calls.push_back('\n');
+					p_out.write(calls.data(), (std::streamsize)calls.size());
 				}
 			}
 		}
@@ -2011,6 +2071,99 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 	}
 }
 
+// write the sample represented by genomes as a packed binary genotype matrix; see outputGenotypeMatrix() for the layout
+void Genome::PrintGenomes_GenotypeMatrix(std::ostream &p_out, std::vector<Genome *> &p_genomes, bool p_filter_monomorphic)
+{
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	int64_t sample_size = (int64_t)p_genomes.size();
+	
+	// Tally the sample prevalence of every mutation directly from the mutation runs, in a table indexed by mutation block index;
+	// this is much cheaper than building a PolymorphismMap, and the same table then maps each mutation to its matrix row
+	std::vector<int32_t> row_for_mutation(gSLiM_Mutation_Block_LastUsedIndex + 1, 0);
+	std::vector<MutationIndex> sites;
+	
+	for (Genome *genome : p_genomes)
+	{
+		if (genome->IsNull())
+			EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_GenotypeMatrix): cannot output null genomes." << EidosTerminate();
+		
+		for (int run_index = 0; run_index < genome->mutrun_count_; ++run_index)
+		{
+			MutationRun *mutrun = genome->mutruns_[run_index].get();
+			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
+			const MutationIndex *mut_end_ptr = mutrun->end_pointer_const();
+			
+			for (; mut_ptr != mut_end_ptr; ++mut_ptr)
+				if (row_for_mutation[*mut_ptr]++ == 0)
+					sites.emplace_back(*mut_ptr);
+		}
+	}
+	
+	// Filter out mutations fixed within the sample, if requested, and sort the sites by position (then by id, for a stable order)
+	if (p_filter_monomorphic)
+		sites.erase(std::remove_if(sites.begin(), sites.end(), [&row_for_mutation, sample_size](MutationIndex mut_index) { return (row_for_mutation[mut_index] == sample_size); }), sites.end());
+	
+	std::sort(sites.begin(), sites.end(), [mut_block_ptr](MutationIndex l, MutationIndex r) {
+		const Mutation *l_mut = mut_block_ptr + l, *r_mut = mut_block_ptr + r;
+		return (l_mut->position_ < r_mut->position_) || ((l_mut->position_ == r_mut->position_) && (l_mut->mutation_id_ < r_mut->mutation_id_));
+	});
+	
+	std::fill(row_for_mutation.begin(), row_for_mutation.end(), -1);
+	
+	int64_t site_count = (int64_t)sites.size();
+	
+	for (int64_t site_index = 0; site_index < site_count; ++site_index)
+		row_for_mutation[sites[site_index]] = (int32_t)site_index;
+	
+	// Write the header: endianness and version tags, the matrix dimensions, and the position and mutation id of each site (row)
+	{
+		int32_t endianness_tag = 0x12345678;
+		int32_t version_tag = 1;
+		std::vector<int64_t> site_info(site_count);
+		
+		p_out.write(reinterpret_cast<char *>(&endianness_tag), sizeof endianness_tag);
+		p_out.write(reinterpret_cast<char *>(&version_tag), sizeof version_tag);
+		p_out.write(reinterpret_cast<char *>(&site_count), sizeof site_count);
+		p_out.write(reinterpret_cast<char *>(&sample_size), sizeof sample_size);
+		
+		for (int64_t site_index = 0; site_index < site_count; ++site_index)
+			site_info[site_index] = (mut_block_ptr + sites[site_index])->position_;
+		p_out.write(reinterpret_cast<char *>(site_info.data()), (std::streamsize)(site_count * sizeof(int64_t)));
+		
+		for (int64_t site_index = 0; site_index < site_count; ++site_index)
+			site_info[site_index] = (mut_block_ptr + sites[site_index])->mutation_id_;
+		p_out.write(reinterpret_cast<char *>(site_info.data()), (std::streamsize)(site_count * sizeof(int64_t)));
+	}
+	
+	// Build the site x genome matrix, one bit per genome with eight genomes to a byte (lowest bit first), and write it in one block
+	int64_t row_bytes = (sample_size + 7) / 8;
+	std::vector<uint8_t> matrix(site_count * row_bytes, 0);
+	
+	for (int64_t genome_index = 0; genome_index < sample_size; ++genome_index)
+	{
+		Genome *genome = p_genomes[genome_index];
+		uint8_t *column_ptr = matrix.data() + (genome_index >> 3);
+		uint8_t genome_bit = (uint8_t)(1 << (genome_index & 7));
+		
+		for (int run_index = 0; run_index < genome->mutrun_count_; ++run_index)
+		{
+			MutationRun *mutrun = genome->mutruns_[run_index].get();
+			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
+			const MutationIndex *mut_end_ptr = mutrun->end_pointer_const();
+			
+			for (; mut_ptr != mut_end_ptr; ++mut_ptr)
+			{
+				int32_t row = row_for_mutation[*mut_ptr];
+				
+				if (row >= 0)
+					column_ptr[row * row_bytes] |= genome_bit;
+			}
+		}
+	}
+	
+	p_out.write(reinterpret_cast<char *>(matrix.data()), (std::streamsize)matrix.size());
+}
+
 size_t Genome::MemoryUsageForMutrunBuffers(void)
 {
 	if (mutruns_ == run_buffer_)
@@ -2070,11 +2223,12 @@ const std::vector<EidosMethodSignature_CSP> *Genome_Class::Methods(void) const
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_mutationFrequenciesInGenomes, kEidosValueMaskFloat))->AddObject_ON("mutations", gSLiM_Mutation_Class, gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_mutationsOfType, kEidosValueMaskObject, gSLiM_Mutation_Class))->AddIntObject_S("mutType", gSLiM_MutationType_Class));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_nucleotides, kEidosValueMaskInt | kEidosValueMaskString))->AddInt_OSN(gEidosStr_start, gStaticEidosValueNULL)->AddInt_OSN(gEidosStr_end, gStaticEidosValueNULL)->AddString_OS("format", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton("string"))));
-		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_readFromMS, kEidosValueMaskObject, gSLiM_Mutation_Class))->AddString_S(gEidosStr_filePath)->AddIntObject_S("mutationType", gSLiM_MutationType_Class));
+		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_readFromMS, kEidosValueMaskObject, gSLiM_Mutation_Class))->AddString_S(gEidosStr_filePath)->AddIntObject_S("mutationType", gSLiM_MutationType_Class)->AddInt_ON("haplotypes", gStaticEidosValueNULL));
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_readFromVCF, kEidosValueMaskObject, gSLiM_Mutation_Class))->AddString_S(gEidosStr_filePath)->AddIntObject_OSN("mutationType", gSLiM_MutationType_Class, gStaticEidosValueNULL));
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_removeMutations, kEidosValueMaskVOID))->AddObject_ON("mutations", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddLogical_OS("substitute", gStaticEidosValue_LogicalF));
-		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputMS, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("filterMonomorphic", gStaticEidosValue_LogicalF));
-		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputVCF, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("outputMultiallelics", gStaticEidosValue_LogicalT)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("simplifyNucleotides", gStaticEidosValue_LogicalF)->AddLogical_OS("outputNonnucleotides", gStaticEidosValue_LogicalT));
+		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputMS, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("filterMonomorphic", gStaticEidosValue_LogicalF)->AddLogical_OS("compress", gStaticEidosValue_LogicalF)->AddLogical_OS("index", gStaticEidosValue_LogicalF));
+		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputVCF, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("outputMultiallelics", gStaticEidosValue_LogicalT)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("simplifyNucleotides", gStaticEidosValue_LogicalF)->AddLogical_OS("outputNonnucleotides", gStaticEidosValue_LogicalT)->AddLogical_OS("compress", gStaticEidosValue_LogicalF));
+		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputGenotypeMatrix, kEidosValueMaskVOID))->AddString_S(gEidosStr_filePath)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("filterMonomorphic", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_output, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_sumOfMutationsOfType, kEidosValueMaskFloat | kEidosValueMaskSingleton))->AddIntObject_S("mutType", gSLiM_MutationType_Class));
 		
@@ -2096,6 +2250,7 @@ EidosValue_SP Genome_Class::ExecuteClassMethod(EidosGlobalStringID p_method_id,
 		case gID_output:
 		case gID_outputMS:
 		case gID_outputVCF:						return ExecuteMethod_outputX(p_method_id, p_target, p_arguments, p_interpreter);
+		case gID_outputGenotypeMatrix:			return ExecuteMethod_outputGenotypeMatrix(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_readFromMS:					return ExecuteMethod_readFromMS(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_readFromVCF:					return ExecuteMethod_readFromVCF(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_removeMutations:				return ExecuteMethod_removeMutations(p_method_id, p_target, p_arguments, p_interpreter);
@@ -2845,9 +3000,269 @@ EidosValue_SP Genome_Class::ExecuteMethod_mutationFreqsCountsInGenomes(EidosGlob
 		return population.Eidos_CountsForTalliedMutations(mutations_value, target_size);
 }
 
+// Support for MS files with a sidecar index, written by outputMS(index=T) and used by readFromMS() to read a subset of the call
+// lines without reading the whole file.  The index lives at the MS file's path plus ".msi", and is a small binary file: the tags
+// 0x12345678 (for endianness) and 1 (the version) as int32_t, followed by int64_t values giving the number of call lines, segsites,
+// the length of the header (the uncompressed offset of the first call line), and the length of the MS file itself (used to detect
+// a stale index), then the BGZF block input size (0 for an uncompressed file), the number of block offsets, and the block offsets
+// (the file offset of each BGZF block, followed by that of the end-of-file block).  Each call line is exactly segsites+1 bytes.
+struct MSIndex {
+	int64_t haplotype_count_;
+	int64_t segsites_;
+	int64_t header_length_;
+	int64_t file_length_;
+	int64_t block_input_size_;
+	std::vector<int64_t> block_offsets_;
+};
+
+static void _MSWriteIndex(const std::string &p_file_path, int64_t p_haplotype_count, int64_t p_segsites, int64_t p_data_length, const std::vector<int64_t> *p_block_offsets)
+{
+	std::string index_path = p_file_path + ".msi";
+	std::ofstream index_file(index_path.c_str(), std::ios_base::out | std::ios_base::binary);
+	
+	if (!index_file.is_open())
+		EIDOS_TERMINATION << "ERROR (_MSWriteIndex): could not open "<< index_path << "." << EidosTerminate();
+	
+	int32_t endianness_tag = 0x12345678;
+	int32_t version_tag = 1;
+	int64_t header_info[6];
+	
+	header_info[0] = p_haplotype_count;
+	header_info[1] = p_segsites;
+	header_info[2] = p_data_length - p_haplotype_count * (p_segsites + 1);
+	header_info[3] = (p_block_offsets ? p_block_offsets->back() + 28 : p_data_length);		// 28 is the size of the BGZF end-of-file block
+	header_info[4] = (p_block_offsets ? (int64_t)EIDOS_BGZF_BLOCK_INPUT_SIZE : 0);
+	header_info[5] = (p_block_offsets ? (int64_t)p_block_offsets->size() : 0);
+	
+	index_file.write(reinterpret_cast<char *>(&endianness_tag), sizeof endianness_tag);
+	index_file.write(reinterpret_cast<char *>(&version_tag), sizeof version_tag);
+	index_file.write(reinterpret_cast<char *>(header_info), sizeof header_info);
+	
+	if (p_block_offsets)
+		index_file.write(reinterpret_cast<const char *>(p_block_offsets->data()), (std::streamsize)(p_block_offsets->size() * sizeof(int64_t)));
+	
+	index_file.close();
+	
+	if (index_file.fail())
+		EIDOS_TERMINATION << "ERROR (_MSWriteIndex): encountered errors while writing to file at path " << index_path << "." << EidosTerminate();
+}
+
+// Returns false if there is no usable index for the file; a missing, malformed, or stale index just means the whole file gets read
+static bool _MSReadIndex(const std::string &p_file_path, MSIndex &p_index)
+{
+	std::string index_contents;
+	
+	if (!Eidos_ReadFileContents(p_file_path + ".msi", index_contents))
+		return false;
+	
+	const size_t fixed_size = 2 * sizeof(int32_t) + 6 * sizeof(int64_t);
+	int32_t tags[2];
+	int64_t header_info[6];
+	
+	if (index_contents.length() < fixed_size)
+		return false;
+	
+	memcpy(tags, index_contents.data(), sizeof tags);
+	memcpy(header_info, index_contents.data() + sizeof tags, sizeof header_info);
+	
+	if ((tags[0] != 0x12345678) || (tags[1] != 1))
+		return false;
+	if ((header_info[0] < 0) || (header_info[1] <= 0) || (header_info[2] <= 0) || (header_info[4] < 0) || (header_info[5] < 0))
+		return false;
+	if (index_contents.length() != fixed_size + header_info[5] * sizeof(int64_t))
+		return false;
+	if ((header_info[4] > 0) && (header_info[5] < 1))
+		return false;
+	
+	// check that the MS file is the one that was indexed, as far as we can tell cheaply
+	std::ifstream data_file(p_file_path.c_str(), std::ios_base::in | std::ios_base::binary);
+	
+	if (!data_file.is_open())
+		return false;
+	
+	data_file.seekg(0, std::ios_base::end);
+	
+	if ((int64_t)data_file.tellg() != header_info[3])
+		return false;
+	
+	p_index.haplotype_count_ = header_info[0];
+	p_index.segsites_ = header_info[1];
+	p_index.header_length_ = header_info[2];
+	p_index.file_length_ = header_info[3];
+	p_index.block_input_size_ = header_info[4];
+	p_index.block_offsets_.resize(header_info[5]);
+	
+	if (header_info[5] > 0)
+		memcpy(p_index.block_offsets_.data(), index_contents.data() + fixed_size, header_info[5] * sizeof(int64_t));
+	
+	return true;
+}
+
+// The decompressed contents of a run of consecutive BGZF blocks, kept between calls to _MSReadIndexedRange() so that reading call
+// lines in file order decompresses each block only once; for an uncompressed file it is just a buffer
+struct MSBlockWindow {
+	int64_t first_block_ = 0;
+	int64_t end_block_ = 0;
+	std::string contents_;
+};
+
+// Reads p_length bytes starting at uncompressed offset p_start, setting *p_range to point to them; returns false on failure
+static bool _MSReadIndexedRange(std::ifstream &p_file, const MSIndex &p_index, int64_t p_start, int64_t p_length, MSBlockWindow &p_window, const char **p_range)
+{
+	if (p_index.block_input_size_ == 0)
+	{
+		if (p_start + p_length > p_index.file_length_)
+			return false;
+		
+		p_window.contents_.resize((size_t)p_length);
+		p_file.seekg(p_start, std::ios_base::beg);
+		p_file.read(&p_window.contents_[0], p_length);
+		*p_range = p_window.contents_.data();
+		return !p_file.fail();
+	}
+	
+	int64_t block_input_size = p_index.block_input_size_;
+	int64_t first_block = p_start / block_input_size;
+	int64_t last_block = (p_start + p_length - 1) / block_input_size;
+	
+	if (last_block + 1 >= (int64_t)p_index.block_offsets_.size())
+		return false;
+	
+	// drop blocks before the range from the window, or start over if the range is not within or just past the window
+	if ((first_block < p_window.first_block_) || (first_block >= p_window.end_block_))
+	{
+		p_window.contents_.clear();
+		p_window.first_block_ = p_window.end_block_ = first_block;
+	}
+	else if (first_block > p_window.first_block_)
+	{
+		p_window.contents_.erase(0, (size_t)((first_block - p_window.first_block_) * block_input_size));
+		p_window.first_block_ = first_block;
+	}
+	
+	std::string compressed_block;
+	
+	while (p_window.end_block_ <= last_block)
+	{
+		int64_t block_start = p_index.block_offsets_[p_window.end_block_];
+		int64_t block_end = p_index.block_offsets_[p_window.end_block_ + 1];
+		
+		if ((block_end <= block_start) || (block_end > p_index.file_length_))
+			return false;
+		
+		compressed_block.resize((size_t)(block_end - block_start));
+		p_file.seekg(block_start, std::ios_base::beg);
+		p_file.read(&compressed_block[0], block_end - block_start);
+		
+		if (p_file.fail() || !Eidos_GunzipContents(compressed_block.data(), compressed_block.length(), p_window.contents_))
+			return false;
+		
+		p_window.end_block_++;
+	}
+	
+	int64_t window_offset = p_start - p_window.first_block_ * block_input_size;
+	
+	if (window_offset + p_length > (int64_t)p_window.contents_.length())
+		return false;
+	
+	*p_range = p_window.contents_.data() + window_offset;
+	return true;
+}
+
+// Parses one line of the header of an MS file, before the call lines: "//" lines and empty lines are skipped, then we expect a
+// "segsites: x" line (parse_state 0) and a "positions: a b c..." line (parse_state 1), after which p_parse_state is 2
+static void _MSParseHeaderLine(int &p_parse_state, const char *p_line_start, const char *p_line_end, int &p_segsites, std::vector<slim_position_t> &p_positions, slim_position_t p_last_position)
+{
+	if ((p_line_end == p_line_start) || ((p_line_end - p_line_start >= 2) && (p_line_start[0] == '/') && (p_line_start[1] == '/')))
+		return;
+	
+	std::istringstream iss(std::string(p_line_start, p_line_end));
+	std::string sub;
+	
+	if (p_parse_state == 0)
+	{
+		// Expecting "segsites: x"
+		iss >> sub;
+		if (sub != "segsites:")
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): expecting 'segsites:', found '" << sub << "'." << EidosTerminate();
+		if (iss.eof())
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): missing segsites value." << EidosTerminate();
+		
+		iss >> sub;
+		int64_t segsites_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+		
+		if ((segsites_long <= 0) || (segsites_long > 1000000))
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): readMS() requires segsites in (0,1000000]." << EidosTerminate();
+		
+		p_segsites = (int)segsites_long;
+		
+		if (!iss.eof())
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): malformed segsites line; additional content after segsites value." << EidosTerminate();
+		
+		p_parse_state = 1;
+	}
+	else if (p_parse_state == 1)
+	{
+		// Expecting "positions: a b c..."
+		iss >> sub;
+		if (sub != "positions:")
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): expecting 'positions:', found '" << sub << "'." << EidosTerminate();
+		
+		for (int pos_index = 0; pos_index < p_segsites; ++pos_index)
+		{
+			if (iss.eof())
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): missing positions value." << EidosTerminate();
+			
+			iss >> sub;
+			double pos_double = EidosInterpreter::FloatForString(sub, nullptr);
+			
+			if ((pos_double < 0.0) || (pos_double > 1.0))
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): readMS() requires positions in [0,1]." << EidosTerminate();
+			
+			// BCH 26 Jan. 2020: There is a little subtlety here.  This equation, round(pos * L), provides
+			// the exact inverse of what outputMS() / outputMSSample() do, so it should exactly recover
+			// positions written out by SLiM in MS format (modulo numerical error).  However, it results
+			// in half as much "mutational density" at positions 0 and L as at other positions, if the
+			// positions are uniformly distributed in [0,1] rather than originating in SLiM.  In that case,
+			// min(floor(pos*(L+1)), L) would be better.  Maybe this choice ought to be an optional logical
+			// parameter to readFromMS(), but nobody has complained yet, so I'm ignoring it for now; if
+			// you expect to get exact discrete base positions you shouldn't be using MS format anyway...
+			p_positions.emplace_back((slim_position_t)round(pos_double * p_last_position));
+		}
+		
+		if (!iss.eof())
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): malformed positions line; additional content after last expected position." << EidosTerminate();
+		
+		p_parse_state = 2;
+	}
+}
+
+// Packs a call line of segsites 0/1 characters into bits, setting bit p_site_rank[i] (the rank of site i by position) for a '1' at i
+static void _MSPackCallLine(const char *p_line_start, int p_segsites, const std::vector<int64_t> &p_site_rank, uint8_t *p_row)
+{
+	unsigned int bad_chars = 0;
+	
+	for (int site_index = 0; site_index < p_segsites; ++site_index)
+	{
+		unsigned int call = (unsigned char)p_line_start[site_index] - '0';
+		
+		bad_chars |= (call & ~1U);
+		
+		if (call == 1)
+		{
+			int64_t bit_index = p_site_rank[site_index];
+			
+			p_row[bit_index >> 3] |= (uint8_t)(1 << (bit_index & 7));
+		}
+	}
+	
+	if (bad_chars)
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): call lines must be composed entirely of 0 and 1." << EidosTerminate();
+}
+
 //	*********************	+ (void)output([Ns$ filePath = NULL], [logical$ append=F])
-//	*********************	+ (void)outputMS([Ns$ filePath = NULL], [logical$ append=F], [logical$ filterMonomorphic = F])
-//	*********************	+ (void)outputVCF([Ns$ filePath = NULL], [logical$ outputMultiallelics = T], [logical$ append=F], [logical$ simplifyNucleotides = F], [logical$ outputNonnucleotides = T])
+//	*********************	+ (void)outputMS([Ns$ filePath = NULL], [logical$ append=F], [logical$ filterMonomorphic = F], [logical$ compress = F], [logical$ index = F])
+//	*********************	+ (void)outputVCF([Ns$ filePath = NULL], [logical$ outputMultiallelics = T], [logical$ append=F], [logical$ simplifyNucleotides = F], [logical$ outputNonnucleotides = T], [logical$ compress = F])
 //
 EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const
 {
@@ -2858,6 +3273,8 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 	EidosValue *filterMonomorphic_value = ((p_method_id == gID_outputMS) ? p_arguments[2].get() : nullptr);
 	EidosValue *simplifyNucleotides_value = ((p_method_id == gID_outputVCF) ? p_arguments[3].get() : nullptr);
 	EidosValue *outputNonnucleotides_value = ((p_method_id == gID_outputVCF) ? p_arguments[4].get() : nullptr);
+	EidosValue *compress_value = ((p_method_id == gID_outputVCF) ? p_arguments[5].get() : ((p_method_id == gID_outputMS) ? p_arguments[3].get() : nullptr));
+	EidosValue *index_value = ((p_method_id == gID_outputMS) ? p_arguments[4].get() : nullptr);
 	
 	SLiMSim &sim = SLiM_GetSimFromInterpreter(p_interpreter);
 	Chromosome &chromosome = sim.TheChromosome();
@@ -2884,6 +3301,22 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 	if (p_method_id == gID_outputMS)
 		filter_monomorphic = filterMonomorphic_value->LogicalAtIndex(0, nullptr);
 	
+	// figure out whether we're writing BGZF-compressed output (VCF and MS output only), and whether we're writing an index (MS output only)
+	bool compress = false;
+	bool write_index = false;
+	
+	if (compress_value)
+		compress = compress_value->LogicalAtIndex(0, nullptr);
+	if (index_value)
+		write_index = index_value->LogicalAtIndex(0, nullptr);
+	
+	if (compress && (filePath_value->Type() == EidosValueType::kValueNULL))
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputX): " << ((p_method_id == gID_outputVCF) ? "outputVCF()" : "outputMS()") << " requires a filePath when compress is T." << EidosTerminate();
+	if (write_index && (filePath_value->Type() == EidosValueType::kValueNULL))
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputX): outputMS() requires a filePath when index is T." << EidosTerminate();
+	if (write_index && append_value->LogicalAtIndex(0, nullptr))
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputX): outputMS() cannot write an index when append is T." << EidosTerminate();
+	
 	// Get all the genomes we're sampling from p_target
 	int sample_size = p_target->Count();
 	std::vector<Genome *> genomes;
@@ -2917,6 +3350,33 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 		else if (p_method_id == gID_outputVCF)
 			Genome::PrintGenomes_VCF(output_stream, genomes, output_multiallelics, simplify_nucs, output_nonnucs, sim.IsNucleotideBased(), sim.TheChromosome().AncestralSequence());
 	}
+	else if (compress)
+	{
+		// Compressed output to filePath is assembled in memory and then written out in BGZF format; as for writeFile(), ".gz" is added if needed
+		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex(0, nullptr));
+		bool append = append_value->LogicalAtIndex(0, nullptr);
+		std::ostringstream outstream;
+		
+		if (!Eidos_string_hasSuffix(outfile_path, ".gz"))
+			outfile_path.append(".gz");
+		
+		if (p_method_id == gID_outputMS)
+		{
+			size_t segsites = Genome::PrintGenomes_MS(outstream, genomes, chromosome, filter_monomorphic);
+			std::string outstring = outstream.str();
+			std::vector<int64_t> block_offsets;
+			
+			Eidos_WriteBGZFFile(outfile_path, outstring, append, write_index ? &block_offsets : nullptr);
+			
+			if (write_index)
+				_MSWriteIndex(outfile_path, sample_size, (int64_t)segsites, (int64_t)outstring.length(), &block_offsets);
+		}
+		else
+		{
+			Genome::PrintGenomes_VCF(outstream, genomes, output_multiallelics, simplify_nucs, output_nonnucs, sim.IsNucleotideBased(), sim.TheChromosome().AncestralSequence());
+			Eidos_WriteBGZFFile(outfile_path, outstream.str(), append);
+		}
+	}
 	else
 	{
 		// Otherwise, output to filePath
@@ -2936,8 +3396,13 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 					Genome::PrintGenomes_SLiM(outfile, genomes, -1);	// -1 represents unknown source subpopulation
 					break;
 				case gID_outputMS:
-					Genome::PrintGenomes_MS(outfile, genomes, chromosome, filter_monomorphic);
+				{
+					size_t segsites = Genome::PrintGenomes_MS(outfile, genomes, chromosome, filter_monomorphic);
+					
+					if (write_index)
+						_MSWriteIndex(outfile_path, sample_size, (int64_t)segsites, (int64_t)outfile.tellp(), nullptr);
 					break;
+				}
 				case gID_outputVCF:
 					Genome::PrintGenomes_VCF(outfile, genomes, output_multiallelics, simplify_nucs, output_nonnucs, sim.IsNucleotideBased(), sim.TheChromosome().AncestralSequence());
 					break;
@@ -2954,13 +3419,49 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 	return gStaticEidosValueVOID;
 }
 
-//	*********************	+ (o<Mutation>)readFromMS(s$ filePath = NULL, io<MutationType> mutationType)
+//	*********************	+ (void)outputGenotypeMatrix(s$ filePath, [logical$ append = F], [logical$ filterMonomorphic = F])
+//
+EidosValue_SP Genome_Class::ExecuteMethod_outputGenotypeMatrix(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const
+{
+#pragma unused (p_method_id, p_target, p_arguments, p_interpreter)
+	EidosValue *filePath_value = p_arguments[0].get();
+	EidosValue *append_value = p_arguments[1].get();
+	EidosValue *filterMonomorphic_value = p_arguments[2].get();
+	
+	bool append = append_value->LogicalAtIndex(0, nullptr);
+	bool filter_monomorphic = filterMonomorphic_value->LogicalAtIndex(0, nullptr);
+	
+	// Get all the genomes we're sampling from p_target
+	int sample_size = p_target->Count();
+	std::vector<Genome *> genomes;
+	
+	for (int index = 0; index < sample_size; ++index)
+		genomes.emplace_back((Genome *)p_target->ObjectElementAtIndex(index, nullptr));
+	
+	// The matrix is binary, so unlike the other output methods there is no output stream option; it always goes to filePath
+	std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex(0, nullptr));
+	std::ofstream outfile;
+	
+	outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out | std::ios_base::binary) : (std::ios_base::out | std::ios_base::binary));
+	
+	if (!outfile.is_open())
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputGenotypeMatrix): could not open "<< outfile_path << "." << EidosTerminate();
+	
+	Genome::PrintGenomes_GenotypeMatrix(outfile, genomes, filter_monomorphic);
+	
+	outfile.close();
+	
+	return gStaticEidosValueVOID;
+}
+
+//	*********************	+ (o<Mutation>)readFromMS(s$ filePath = NULL, io<MutationType> mutationType, [Ni haplotypes = NULL])
 //
 EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const
 {
 #pragma unused (p_method_id, p_target, p_arguments, p_interpreter)
 	EidosValue *filePath_value = p_arguments[0].get();
 	EidosValue *mutationType_value = p_arguments[1].get();
+	EidosValue *haplotypes_value = p_arguments[2].get();
 	
 	SLiMSim &sim = SLiM_GetSimFromInterpreter(p_interpreter);
 	Population &pop = sim.ThePopulation();
@@ -2976,113 +3477,183 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 	if (!mutation_type_ptr)
 		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): mutation type not found." << EidosTerminate();
 	
-	// Parse the whole input file and retain the information from it
-	std::ifstream infile(file_path);
-	std::string line, sub;
-	int parse_state = 0;
+	// Load the file, or just the parts of it we need; call lines are packed into bits as they are parsed, one row per genome, with
+	// the bits for each row in position order (see below), so the raw call characters never need to be retained
 	int segsites = -1;
 	std::vector<slim_position_t> positions;
-	std::vector<std::string> calls;
+	std::vector<int64_t> order_vec;
+	std::vector<int64_t> site_rank;
+	std::vector<uint8_t> call_bits;
+	size_t row_bytes = 0;
+	int64_t call_line_count = 0;
+	int target_size = p_target->Count();
+	std::vector<int64_t> haplotypes;
+	bool use_haplotypes = (haplotypes_value->Type() != EidosValueType::kValueNULL);
+	MSIndex ms_index;
 	
-	while (!infile.eof())
+	if (use_haplotypes)
 	{
-		getline(infile, line);
+		int haplotype_count = haplotypes_value->Count();
 		
-		if ((line.length() == 0) || (line.find("//") == 0))
-			continue;
+		if (haplotype_count != target_size)
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): target genome vector has size " << target_size << " but haplotypes has size " << haplotype_count << "." << EidosTerminate();
 		
-		switch (parse_state)
+		for (int haplotype_index = 0; haplotype_index < haplotype_count; ++haplotype_index)
 		{
-			case 0:
-			{
-				// Expecting "segsites: x"
-				std::istringstream iss(line);
-				
-				iss >> sub;
-				if (sub != "segsites:")
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): expecting 'segsites:', found '" << sub << "'." << EidosTerminate();
-				if (iss.eof())
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): missing segsites value." << EidosTerminate();
-				
-				iss >> sub;
-				int64_t segsites_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
-				
-				if ((segsites_long <= 0) || (segsites_long > 1000000))
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): readMS() requires segsites in (0,1000000]." << EidosTerminate();
-				
-				segsites = (int)segsites_long;
-				
-				if (!iss.eof())
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): malformed segsites line; additional content after segsites value." << EidosTerminate();
-				
-				parse_state = 1;
-				break;
-			}
-			case 1:
+			int64_t haplotype = haplotypes_value->IntAtIndex(haplotype_index, nullptr);
+			
+			if (haplotype < 0)
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): haplotypes must be greater than or equal to 0." << EidosTerminate();
+			
+			haplotypes.emplace_back(haplotype);
+		}
+	}
+	
+	if (use_haplotypes && (target_size > 0) && _MSReadIndex(file_path, ms_index))
+	{
+		// With an index from outputMS(index=T), we read the header and then seek to each requested call line, in file order
+		std::ifstream infile(file_path.c_str(), std::ios_base::in | std::ios_base::binary);
+		MSBlockWindow window;
+		const char *range;
+		int parse_state = 0;
+		
+		if (!infile.is_open() || !_MSReadIndexedRange(infile, ms_index, 0, ms_index.header_length_, window, &range))
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): could not read MS file at path " << file_path << "." << EidosTerminate();
+		
+		for (const char *line_start = range, *header_end = range + ms_index.header_length_; line_start < header_end; )
+		{
+			const char *line_end = (const char *)memchr(line_start, '\n', (size_t)(header_end - line_start));
+			const char *next_line_start = (line_end ? line_end + 1 : (line_end = header_end));
+			
+			_MSParseHeaderLine(parse_state, line_start, line_end, segsites, positions, last_position);
+			line_start = next_line_start;
+		}
+		
+		if ((parse_state != 2) || (segsites != ms_index.segsites_))
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): the MS index does not match the MS file at path " << file_path << "." << EidosTerminate();
+		
+		order_vec = EidosSortIndexes(positions);
+		site_rank.resize(segsites);
+		for (int site_index = 0; site_index < segsites; ++site_index)
+			site_rank[order_vec[site_index]] = site_index;
+		
+		row_bytes = ((size_t)segsites + 7) / 8;
+		call_bits.resize(row_bytes * target_size, 0);
+		call_line_count = ms_index.haplotype_count_;
+		
+		std::vector<int64_t> read_order = EidosSortIndexes(haplotypes);
+		
+		for (int64_t row_index : read_order)
+		{
+			int64_t haplotype = haplotypes[row_index];
+			
+			if (haplotype >= call_line_count)
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): haplotype index " << haplotype << " is out of range; the MS file has " << call_line_count << " call lines." << EidosTerminate();
+			
+			int64_t line_length = segsites + 1;
+			
+			if (!_MSReadIndexedRange(infile, ms_index, ms_index.header_length_ + haplotype * line_length, line_length, window, &range))
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): could not read MS file at path " << file_path << "." << EidosTerminate();
+			if (range[segsites] != '\n')
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): the MS index does not match the MS file at path " << file_path << "." << EidosTerminate();
+			
+			_MSPackCallLine(range, segsites, site_rank, call_bits.data() + row_index * row_bytes);
+		}
+	}
+	else
+	{
+		// Otherwise we read the whole file with a single read, decompressing it first if it is gzip-compressed
+		std::string file_contents;
+		
+		if (!Eidos_ReadFileContents(file_path, file_contents))
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): could not read MS file at path " << file_path << "." << EidosTerminate();
+		
+		if (Eidos_ContentsAreGzipped(file_contents))
+		{
+			std::string decompressed_contents;
+			
+			if (!Eidos_GunzipContents(file_contents.data(), file_contents.length(), decompressed_contents))
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): could not decompress the gzip-compressed MS file at path " << file_path << "." << EidosTerminate();
+			
+			std::swap(file_contents, decompressed_contents);
+		}
+		
+		// Call lines are located in place in the buffer; they are packed once we know how many there are and which ones we want
+		const char *file_buf = file_contents.data();
+		const char *file_end = file_buf + file_contents.length();
+		int parse_state = 0;
+		std::vector<const char *> call_lines;
+		
+		for (const char *line_start = file_buf; line_start < file_end; )
+		{
+			const char *line_end = (const char *)memchr(line_start, '\n', (size_t)(file_end - line_start));
+			const char *next_line_start = (line_end ? line_end + 1 : (line_end = file_end));
+			
+			if ((line_end > line_start) && (*(line_end - 1) == '\r'))	// tolerate CRLF line endings
+				line_end--;
+			
+			if (parse_state < 2)
 			{
-				// Expecting "positions: a b c..."
-				std::istringstream iss(line);
-				
-				iss >> sub;
-				if (sub != "positions:")
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): expecting 'positions:', found '" << sub << "'." << EidosTerminate();
-				
-				for (int pos_index = 0; pos_index < segsites; ++pos_index)
-				{
-					if (iss.eof())
-						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): missing positions value." << EidosTerminate();
-					
-					iss >> sub;
-					double pos_double = EidosInterpreter::FloatForString(sub, nullptr);
-					
-					if ((pos_double < 0.0) || (pos_double > 1.0))
-						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): readMS() requires positions in [0,1]." << EidosTerminate();
-					
-					// BCH 26 Jan. 2020: There is a little subtlety here.  This equation, round(pos * L), provides
-					// the exact inverse of what outputMS() / outputMSSample() do, so it should exactly recover
-					// positions written out by SLiM in MS format (modulo numerical error).  However, it results
-					// in half as much "mutational density" at positions 0 and L as at other positions, if the
-					// positions are uniformly distributed in [0,1] rather than originating in SLiM.  In that case,
-					// min(floor(pos*(L+1)), L) would be better.  Maybe this choice ought to be an optional logical
-					// parameter to readFromMS(), but nobody has complained yet, so I'm ignoring it for now; if
-					// you expect to get exact discrete base positions you shouldn't be using MS format anyway...
-					positions.emplace_back((slim_position_t)round(pos_double * last_position));
-				}
-				
-				if (!iss.eof())
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): malformed positions line; additional content after last expected position." << EidosTerminate();
-				
-				parse_state = 2;
-				break;
+				_MSParseHeaderLine(parse_state, line_start, line_end, segsites, positions, last_position);
 			}
-			case 2:
+			else if ((line_end > line_start) && !((line_end - line_start >= 2) && (line_start[0] == '/') && (line_start[1] == '/')))
 			{
 				// Expecting "001010011001101111010..." of length segsites
-				if (line.find_first_not_of("01") != std::string::npos)
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): call lines must be composed entirely of 0 and 1." << EidosTerminate();
-				if ((int)line.length() != segsites)
+				if (line_end - line_start != segsites)
+				{
+					if (std::find_if(line_start, line_end, [](char c) { return (c != '0') && (c != '1'); }) != line_end)
+						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): call lines must be composed entirely of 0 and 1." << EidosTerminate();
 					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): call lines must be equal in length to the segsites value." << EidosTerminate();
+				}
 				
-				calls.emplace_back(line);
-				break;
+				call_lines.emplace_back(line_start);
 			}
+			
+			line_start = next_line_start;
+		}
+		
+		if (parse_state == 1)
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): expecting 'positions:', found end of file." << EidosTerminate();
+		
+		call_line_count = (int64_t)call_lines.size();
+		
+		if (!use_haplotypes)
+		{
+			if (call_line_count != target_size)
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): target genome vector has size " << target_size << " but " << call_line_count << " call lines found." << EidosTerminate();
+			
+			for (int64_t line_index = 0; line_index < call_line_count; ++line_index)
+				haplotypes.emplace_back(line_index);
+		}
+		
+		if (segsites > 0)
+		{
+			order_vec = EidosSortIndexes(positions);
+			site_rank.resize(segsites);
+			for (int site_index = 0; site_index < segsites; ++site_index)
+				site_rank[order_vec[site_index]] = site_index;
+		}
+		
+		row_bytes = ((size_t)std::max(segsites, 0) + 7) / 8;
+		call_bits.resize(row_bytes * target_size, 0);
+		
+		for (int row_index = 0; row_index < target_size; ++row_index)
+		{
+			int64_t haplotype = haplotypes[row_index];
+			
+			if (haplotype >= call_line_count)
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): haplotype index " << haplotype << " is out of range; the MS file has " << call_line_count << " call lines." << EidosTerminate();
+			
+			_MSPackCallLine(call_lines[haplotype], segsites, site_rank, call_bits.data() + row_index * row_bytes);
 		}
 	}
 	
-	infile.close();
-	
-	// Get the target genomes into a vector
-	int target_size = p_target->Count();
-	
-	if ((int)calls.size() != target_size)
-		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): target genome vector has size " << target_size << " but " << calls.size() << " call lines found." << EidosTerminate();
-	
-	// Instantiate the mutations; NOTE THAT THE STACKING POLICY IS NOT CHECKED HERE, AS THIS IS NOT CONSIDERED THE ADDITION OF A MUTATION!
+	// Instantiate the mutations in position order; NOTE THAT THE STACKING POLICY IS NOT CHECKED HERE, AS THIS IS NOT CONSIDERED THE ADDITION OF A MUTATION!
 	std::vector<MutationIndex> mutation_indices;
 	
-	for (int mut_index = 0; mut_index < segsites; ++mut_index)
+	for (int site_index = 0; site_index < segsites; ++site_index)
 	{
-		slim_position_t position = positions[mut_index];
+		slim_position_t position = positions[order_vec[site_index]];
 		double selection_coeff = mutation_type_ptr->DrawSelectionCoefficient();
 		slim_objectid_t subpop_index = -1;
 		slim_generation_t origin_generation = sim.Generation();
@@ -3118,35 +3689,40 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 		mutation_indices.emplace_back(new_mut_index);
 	}
 	
-	// Sort the mutations by position so we can add them in order, and make an "order" vector for accessing calls in the sorted order
+	// Add the mutations to the target genomes, recording a new derived state with each addition; the set bits in each genome's row
+	// are visited in position order, so mutations can simply be appended to each mutation run if the genome started out empty
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
-	std::vector<int64_t> order_vec = EidosSortIndexes(positions);
 	
-	std::sort(mutation_indices.begin(), mutation_indices.end(), [mut_block_ptr](MutationIndex i1, MutationIndex i2) {return (mut_block_ptr + i1)->position_ < (mut_block_ptr + i2)->position_;});
-	
-	// Add the mutations to the target genomes, recording a new derived state with each addition
 	for (int genome_index = 0; genome_index < target_size; ++genome_index)
 	{
 		Genome *genome = (Genome *)p_target->ObjectElementAtIndex(genome_index, nullptr);
 		bool genome_started_empty = (genome->mutation_count() == 0);
 		slim_position_t mutrun_length = genome->mutrun_length_;
 		slim_mutrun_index_t current_run_index = -1;
-		std::string &genome_string = calls[genome_index];
+		const uint8_t *row = call_bits.data() + genome_index * row_bytes;
 		
-		for (int segsite_index = 0; segsite_index < segsites; ++segsite_index)
+		for (size_t byte_index = 0; byte_index < row_bytes; ++byte_index)
 		{
-			int64_t call_index = order_vec[segsite_index];
-			char call = genome_string[call_index];
+			uint8_t row_byte = row[byte_index];
+			
+			if (row_byte == 0)
+				continue;		// most rows are sparse, so skipping whole bytes saves a lot of work
 			
-			if (call == '1')
+			for (int bit_index = 0; bit_index < 8; ++bit_index)
 			{
-				MutationIndex mut_index = mutation_indices[segsite_index];
+				if (!(row_byte & (1 << bit_index)))
+					continue;
+				
+				MutationIndex mut_index = mutation_indices[byte_index * 8 + bit_index];
 				Mutation *mut = mut_block_ptr + mut_index;
 				slim_position_t mut_pos = mut->position_;
 				slim_mutrun_index_t mut_mutrun_index = (slim_mutrun_index_t)(mut_pos / mutrun_length);
 				
 				if (mut_mutrun_index != current_run_index)
+				{
 					genome->WillModifyRun(mut_mutrun_index);
+					current_run_index = mut_mutrun_index;
+				}
 				
 				MutationRun *mut_mutrun = genome->mutruns_[mut_mutrun_index].get();
 				
@@ -3172,6 +3748,41 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 	return EidosValue_Object_vector_SP(vec);
 }
 
+// Tokenizing helpers for readFromVCF(), which works directly on the characters of the file in memory; numeric fields are converted
+// with SLiM_NonnegativeIntegerForChars(), which falls back to the standard Eidos conversion (with its error messages) when needed
+static inline int8_t _VCFNucleotideForChars(const char *p_start, const char *p_end)
+{
+	if (p_end - p_start == 1)
+	{
+		switch (*p_start)
+		{
+			case 'A':	return 0;
+			case 'C':	return 1;
+			case 'G':	return 2;
+			case 'T':	return 3;
+			default:	break;
+		}
+	}
+	
+	return -1;
+}
+
+template <typename F>
+static inline void _VCFForEachCommaSeparatedValue(const char *p_start, const char *p_end, F p_value_handler)
+{
+	while (true)
+	{
+		const char *comma = (const char *)memchr(p_start, ',', (size_t)(p_end - p_start));
+		const char *value_end = (comma ? comma : p_end);
+		
+		p_value_handler(p_start, value_end);
+		
+		if (!comma)
+			break;
+		p_start = comma + 1;
+	}
+}
+
 //	*********************	+ (o<Mutation>)readFromVCF(s$ filePath = NULL, [Nio<MutationType> mutationType = NULL])
 //
 EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const
@@ -3191,19 +3802,50 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 	if (mutationType_value->Type() != EidosValueType::kValueNULL)
 		default_mutation_type_ptr = SLiM_ExtractMutationTypeFromEidosValue_io(mutationType_value, 0, sim, "readFromVCF()");
 	
-	// Parse the whole input file and retain the information from it
-	std::ifstream infile(file_path);
-	std::string line, sub;
+	// Read the whole input file into memory with one read, decompressing it first if it is gzip-compressed (including BGZF, as
+	// written by outputVCF(compress=T)); call lines are then located in place within that buffer, rather than being copied out
+	std::string file_contents;
+	
+	if (!Eidos_ReadFileContents(file_path, file_contents))
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): could not read VCF file at path " << file_path << "." << EidosTerminate();
+	
+	if (Eidos_ContentsAreGzipped(file_contents))
+	{
+		std::string decompressed_contents;
+		
+		if (!Eidos_GunzipContents(file_contents.data(), file_contents.length(), decompressed_contents))
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): could not decompress the gzip-compressed VCF file at path " << file_path << "." << EidosTerminate();
+		
+		std::swap(file_contents, decompressed_contents);
+	}
+	
+	struct VCFCallLine {
+		slim_position_t position_;
+		const char *start_;
+		const char *end_;
+	};
+	
+	const char *file_buf = file_contents.data();
+	const char *file_end = file_buf + file_contents.length();
 	int parse_state = 0;
 	int sample_id_count = 0;
 	int target_size = p_target->Count();
 	bool info_MID_defined = false, info_S_defined = false, info_DOM_defined = false, info_PO_defined = false;
 	bool info_GO_defined = false, info_MT_defined = false, /*info_AA_defined = false,*/ info_NONNUC_defined = false;
-	std::vector<std::pair<slim_position_t, std::string>> call_lines;
+	std::vector<VCFCallLine> call_lines;
 	
-	while (!infile.eof())
+	for (const char *line_start = file_buf; line_start < file_end; )
 	{
-		getline(infile, line);
+		const char *line_end = (const char *)memchr(line_start, '\n', (size_t)(file_end - line_start));
+		const char *next_line_start;
+		
+		if (line_end)
+			next_line_start = line_end + 1;
+		else
+			next_line_start = line_end = file_end;
+		
+		if ((line_end > line_start) && (*(line_end - 1) == '\r'))	// tolerate CRLF line endings
+			line_end--;
 		
 		switch (parse_state)
 		{
@@ -3211,6 +3853,8 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 			{
 				// In header, parsing ## lines, until we get to the #CHROM line; the point of this is that we only want to interpret
 				// INFO fields like MID, S, etc. as having their SLiM-specific meaning if their SLiM-specific definition is present
+				std::string line(line_start, line_end);
+				
 				if (line.compare(0, 2, "##") == 0)
 				{
 					if (line == "##INFO=<ID=MID,Number=.,Type=Integer,Description=\"Mutation ID in SLiM\">")	info_MID_defined = true;
@@ -3226,25 +3870,22 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 				{
 					static const char *header_fields[9] = {"CHROM", "POS", "ID", "REF", "ALT", "QUAL", "FILTER", "INFO", "FORMAT"};
 					std::istringstream iss(line);
+					std::string sub;
 					
 					iss.get();	// eat the initial #
 					
 					// verify that the expected standard columns are present
 					for (int header_index = 0; header_index < 9; ++header_index)
 					{
-						if (iss.eof())
+						if (!(iss >> sub))
 							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): missing VCF header '" << header_fields[header_index] << "'." << EidosTerminate();
-						iss >> sub;
 						if (sub != header_fields[header_index])
 							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): expected VCF header '" << header_fields[header_index] << "', saw '" << sub << "'." << EidosTerminate();
 					}
 					
 					// the remaining columns are sample IDs; we don't care what they are, we just count them
-					while (!iss.eof())
-					{
-						iss >> sub;
+					while (iss >> sub)
 						sample_id_count++;
-					}
 					
 					// now the remainder of the file should be call lines
 					parse_state = 1;
@@ -3257,35 +3898,41 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 			}
 			case 1:
 			{
-				// In call lines, fields are separated by tabs, and could theoretically contain spaces; here we just read a whole line,
-				// extract the position field for the mutation, and save the line indexed by its mutation's position for later handling
-				if (line.length() == 0)
+				// In call lines, fields are separated by tabs, and could theoretically contain spaces; here we just find the position
+				// field for the mutation, and remember where the line is, indexed by its mutation's position, for later handling
+				if (line_end == line_start)
 					break;
 				
-				std::istringstream iss(line);
+				const char *chrom_end = (const char *)memchr(line_start, '\t', (size_t)(line_end - line_start));
+				const char *pos_start = (chrom_end ? chrom_end + 1 : line_end);
+				const char *pos_end = (const char *)memchr(pos_start, '\t', (size_t)(line_end - pos_start));
 				
-				std::getline(iss, sub, '\t');	// CHROM
-				std::getline(iss, sub, '\t');	// POS
+				if (!pos_end)
+					pos_end = line_end;
 				
-				int64_t pos = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr) - 1;		// -1 because VCF uses 1-based positions
+				int64_t pos = SLiM_NonnegativeIntegerForChars(pos_start, pos_end) - 1;		// -1 because VCF uses 1-based positions
 				
 				if ((pos < 0) || (pos > last_position))
 					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file POS value " << pos << " out of range." << EidosTerminate();
 				
-				call_lines.emplace_back(pos, line);
+				call_lines.push_back(VCFCallLine{pos, line_start, line_end});
 				break;
 			}
 		}
+		
+		line_start = next_line_start;
 	}
 	
-	infile.close();
+	if (parse_state == 0)
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file has no #CHROM header line." << EidosTerminate();
 	
 	// sort the call lines by position, so that we can add them to empty genomes efficiently
-	std::sort(call_lines.begin(), call_lines.end(), [ ](const std::pair<slim_position_t, std::string> &l1, const std::pair<slim_position_t, std::string> &l2) {return l1.first < l2.first;});
+	std::stable_sort(call_lines.begin(), call_lines.end(), [ ](const VCFCallLine &l1, const VCFCallLine &l2) {return l1.position_ < l2.position_;});
 	
 	// cache target genomes and determine whether they are initially empty, in which case we can do fast mutation addition with emplace_back()
 	std::vector<Genome *> targets;
 	std::vector<slim_mutrun_index_t> target_last_mutrun_modified;
+	std::vector<int> target_last_mutrun_original_count;
 	bool all_target_genomes_started_empty = true;
 	
 	for (int genome_index = 0; genome_index < target_size; ++genome_index)
@@ -3300,74 +3947,139 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 			
 			targets.emplace_back(genome);
 			target_last_mutrun_modified.emplace_back(-1);
+			target_last_mutrun_original_count.emplace_back(0);
 		}
 	}
 	
 	target_size = (int)targets.size();	// adjust for possible exclusion of null genomes
 	
-	// parse all the call lines, instantiate their mutations, and add the mutations to the target genomes
+	// If the target genomes already have mutations, new mutations can't just be appended to their runs.  Since call lines are sorted,
+	// each genome's runs are visited one after another, so unless we are recording derived states (which are read back from the run
+	// after each addition, and so need it to be sorted throughout) we append the new mutations to each run, and then merge them into
+	// the run's existing mutations with one pass when we move on to the next run; this is a stable merge, matching the result of
+	// insert_sorted_mutation(), but linear in the size of the run rather than quadratic
+	bool merge_into_runs = (!all_target_genomes_started_empty && !recording_mutations);
+	
+	auto merge_appended_mutations = [](MutationRun *p_mutrun, int p_original_count) {
+		Mutation *merge_block_ptr = gSLiM_Mutation_Block;	// fetched here, since adding new mutations can reallocate the block
+		MutationIndex *run_begin = p_mutrun->begin_pointer();
+		
+		std::inplace_merge(run_begin, run_begin + p_original_count, p_mutrun->end_pointer(), [merge_block_ptr](MutationIndex i1, MutationIndex i2) {return CompareMutations(merge_block_ptr + i1, merge_block_ptr + i2);});
+	};
+	
+	// parse all the call lines, instantiate their mutations, and add the mutations to the target genomes; the per-line vectors
+	// are declared outside the loop so that their buffers get reused, since VCF files can have millions of call lines
 	std::vector<MutationIndex> mutation_indices;
 	bool has_initial_mutations = (gSLiM_next_mutation_id != 0);
-	
-	for (std::pair<slim_position_t, std::string> &call_line : call_lines)
+	std::vector<int8_t> alt_nucs;
+	std::vector<slim_mutationid_t> info_mutids;
+	std::vector<double> info_selcoeffs;
+	std::vector<double> info_domcoeffs;
+	std::vector<slim_objectid_t> info_poporigin;
+	std::vector<slim_generation_t> info_genorigin;
+	std::vector<slim_objectid_t> info_muttype;
+	std::vector<int> genotype_calls;
+	std::vector<MutationIndex> alt_allele_mut_indices;
+	
+	for (VCFCallLine &call_line : call_lines)
 	{
-		slim_position_t mut_position = call_line.first;
-		std::istringstream iss(call_line.second);
-		std::string ref_str, alt_str, info_str;
-		
-		std::getline(iss, sub, '\t');		// CHROM; don't care
-		std::getline(iss, sub, '\t');		// POS; already fetched
-		std::getline(iss, sub, '\t');		// ID; don't care
-		std::getline(iss, ref_str, '\t');	// REF
-		std::getline(iss, alt_str, '\t');	// ALT
-		std::getline(iss, sub, '\t');		// QUAL; don't care
-		std::getline(iss, sub, '\t');		// FILTER; don't care
-		std::getline(iss, info_str, '\t');	// INFO
-		std::getline(iss, sub, '\t');		// FORMAT; don't care (GT must be first, according to the standard; we don't check)
+		slim_position_t mut_position = call_line.position_;
+		const char *field_cursor = call_line.start_;
+		const char *line_end = call_line.end_;
+		bool line_exhausted = false;
+		
+		// get the next tab-delimited field of the call line; this follows the semantics of std::getline(), which the
+		// validation below was originally written against: a trailing tab yields one final empty field
+		auto next_field = [&field_cursor, &line_end, &line_exhausted](const char *&p_field_start, const char *&p_field_end) {
+			p_field_start = field_cursor;
+			
+			if (line_exhausted)
+			{
+				p_field_end = field_cursor;
+				return;
+			}
+			
+			const char *tab = (const char *)memchr(field_cursor, '\t', (size_t)(line_end - field_cursor));
+			
+			if (tab)
+			{
+				p_field_end = tab;
+				field_cursor = tab + 1;
+			}
+			else
+			{
+				p_field_end = field_cursor = line_end;
+				line_exhausted = true;
+			}
+		};
+		
+		const char *field_start, *field_end;
+		const char *ref_start, *ref_end, *alt_start, *alt_end, *info_start, *info_end;
+		
+		next_field(field_start, field_end);		// CHROM; don't care
+		next_field(field_start, field_end);		// POS; already fetched
+		next_field(field_start, field_end);		// ID; don't care
+		next_field(ref_start, ref_end);			// REF
+		next_field(alt_start, alt_end);			// ALT
+		next_field(field_start, field_end);		// QUAL; don't care
+		next_field(field_start, field_end);		// FILTER; don't care
+		next_field(info_start, info_end);		// INFO
+		next_field(field_start, field_end);		// FORMAT; don't care (GT must be first, according to the standard; we don't check)
 		
 		// parse/validate the REF nucleotide
-		int8_t ref_nuc;
+		int8_t ref_nuc = _VCFNucleotideForChars(ref_start, ref_end);
 		
-		if (ref_str == "A")			ref_nuc = 0;
-		else if (ref_str == "C")	ref_nuc = 1;
-		else if (ref_str == "G")	ref_nuc = 2;
-		else if (ref_str == "T")	ref_nuc = 3;
-		else						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file REF value must be A/C/G/T." << EidosTerminate();
+		if (ref_nuc == -1)
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file REF value must be A/C/G/T." << EidosTerminate();
 		
 		// parse/validate the ALT nucleotides
-		std::vector<std::string> alt_substrs = Eidos_string_split(alt_str, ",");
-		std::vector<int8_t> alt_nucs;
+		alt_nucs.clear();
 		
-		for (std::string &alt_substr : alt_substrs)
+		for (const char *alt_substr_start = alt_start; ; )
 		{
-			if (alt_substr == "A")			alt_nucs.emplace_back(0);
-			else if (alt_substr == "C")		alt_nucs.emplace_back(1);
-			else if (alt_substr == "G")		alt_nucs.emplace_back(2);
-			else if (alt_substr == "T")		alt_nucs.emplace_back(3);
-			else							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file ALT value must be A/C/G/T." << EidosTerminate();
+			const char *alt_substr_end = (const char *)memchr(alt_substr_start, ',', (size_t)(alt_end - alt_substr_start));
+			
+			if (!alt_substr_end)
+				alt_substr_end = alt_end;
+			
+			int8_t alt_nuc = _VCFNucleotideForChars(alt_substr_start, alt_substr_end);
+			
+			if (alt_nuc == -1)
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file ALT value must be A/C/G/T." << EidosTerminate();
+			
+			alt_nucs.emplace_back(alt_nuc);
+			
+			if (alt_substr_end == alt_end)
+				break;
+			alt_substr_start = alt_substr_end + 1;
 		}
 		
 		std::size_t alt_allele_count = alt_nucs.size();
 		
 		// parse/validate the INFO fields that we recognize
-		std::vector<std::string> info_substrs = Eidos_string_split(info_str, ";");
-		std::vector<slim_mutationid_t> info_mutids;
-		std::vector<double> info_selcoeffs;
-		std::vector<double> info_domcoeffs;
-		std::vector<slim_objectid_t> info_poporigin;
-		std::vector<slim_generation_t> info_genorigin;
-		std::vector<slim_objectid_t> info_muttype;
+		info_mutids.clear();
+		info_selcoeffs.clear();
+		info_domcoeffs.clear();
+		info_poporigin.clear();
+		info_genorigin.clear();
+		info_muttype.clear();
 		int8_t info_ancestral_nuc = -1;
 		bool info_is_nonnuc = false;
 		
-		for (std::string &info_substr : info_substrs)
+		for (const char *info_substr_start = info_start; ; )
 		{
-			if (info_MID_defined && (info_substr.compare(0, 4, "MID=") == 0))		// Mutation ID
+			const char *info_substr_end = (const char *)memchr(info_substr_start, ';', (size_t)(info_end - info_substr_start));
+			
+			if (!info_substr_end)
+				info_substr_end = info_end;
+			
+			size_t info_substr_length = (size_t)(info_substr_end - info_substr_start);
+			
+			if (info_MID_defined && (info_substr_length >= 4) && (strncmp(info_substr_start, "MID=", 4) == 0))		// Mutation ID
 			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(4), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_mutids.emplace_back((slim_mutationid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
+				_VCFForEachCommaSeparatedValue(info_substr_start + 4, info_substr_end, [&info_mutids](const char *p_value_start, const char *p_value_end) {
+					info_mutids.emplace_back((slim_mutationid_t)SLiM_NonnegativeIntegerForChars(p_value_start, p_value_end));
+				});
 				
 				if (info_mutids.size() && has_initial_mutations)
 				{
@@ -3385,52 +4097,44 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 					info_mutids.clear();
 				}
 			}
-			else if (info_S_defined && (info_substr.compare(0, 2, "S=") == 0))		// Selection Coefficient
+			else if (info_S_defined && (info_substr_length >= 2) && (strncmp(info_substr_start, "S=", 2) == 0))		// Selection Coefficient
 			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(2), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_selcoeffs.emplace_back(EidosInterpreter::FloatForString(value_substr, nullptr));
+				_VCFForEachCommaSeparatedValue(info_substr_start + 2, info_substr_end, [&info_selcoeffs](const char *p_value_start, const char *p_value_end) {
+					info_selcoeffs.emplace_back(EidosInterpreter::FloatForString(std::string(p_value_start, p_value_end), nullptr));
+				});
 			}
-			else if (info_DOM_defined && (info_substr.compare(0, 4, "DOM=") == 0))	// Dominance Coefficient
+			else if (info_DOM_defined && (info_substr_length >= 4) && (strncmp(info_substr_start, "DOM=", 4) == 0))	// Dominance Coefficient
 			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(4), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_domcoeffs.emplace_back(EidosInterpreter::FloatForString(value_substr, nullptr));
+				_VCFForEachCommaSeparatedValue(info_substr_start + 4, info_substr_end, [&info_domcoeffs](const char *p_value_start, const char *p_value_end) {
+					info_domcoeffs.emplace_back(EidosInterpreter::FloatForString(std::string(p_value_start, p_value_end), nullptr));
+				});
 			}
-			else if (info_PO_defined && (info_substr.compare(0, 3, "PO=") == 0))	// Population of Origin
+			else if (info_PO_defined && (info_substr_length >= 3) && (strncmp(info_substr_start, "PO=", 3) == 0))	// Population of Origin
 			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_poporigin.emplace_back((slim_objectid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
+				_VCFForEachCommaSeparatedValue(info_substr_start + 3, info_substr_end, [&info_poporigin](const char *p_value_start, const char *p_value_end) {
+					info_poporigin.emplace_back((slim_objectid_t)SLiM_NonnegativeIntegerForChars(p_value_start, p_value_end));
+				});
 			}
-			else if (info_GO_defined && (info_substr.compare(0, 3, "GO=") == 0))	// Generation of Origin
+			else if (info_GO_defined && (info_substr_length >= 3) && (strncmp(info_substr_start, "GO=", 3) == 0))	// Generation of Origin
 			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_genorigin.emplace_back((slim_generation_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
+				_VCFForEachCommaSeparatedValue(info_substr_start + 3, info_substr_end, [&info_genorigin](const char *p_value_start, const char *p_value_end) {
+					info_genorigin.emplace_back((slim_generation_t)SLiM_NonnegativeIntegerForChars(p_value_start, p_value_end));
+				});
 			}
-			else if (info_MT_defined && (info_substr.compare(0, 3, "MT=") == 0))	// Mutation Type
+			else if (info_MT_defined && (info_substr_length >= 3) && (strncmp(info_substr_start, "MT=", 3) == 0))	// Mutation Type
 			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_muttype.emplace_back((slim_objectid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
+				_VCFForEachCommaSeparatedValue(info_substr_start + 3, info_substr_end, [&info_muttype](const char *p_value_start, const char *p_value_end) {
+					info_muttype.emplace_back((slim_objectid_t)SLiM_NonnegativeIntegerForChars(p_value_start, p_value_end));
+				});
 			}
-			else if (/* info_AA_defined && */ (info_substr.compare(0, 3, "AA=") == 0))	// Ancestral Allele; definition not required since it is a standard field
+			else if (/* info_AA_defined && */ (info_substr_length >= 3) && (strncmp(info_substr_start, "AA=", 3) == 0))	// Ancestral Allele; definition not required since it is a standard field
 			{
-				std::string aa_str = info_substr.substr(3);
+				info_ancestral_nuc = _VCFNucleotideForChars(info_substr_start + 3, info_substr_end);
 				
-				if (aa_str == "A")			info_ancestral_nuc = 0;
-				else if (aa_str == "C")		info_ancestral_nuc = 1;
-				else if (aa_str == "G")		info_ancestral_nuc = 2;
-				else if (aa_str == "T")		info_ancestral_nuc = 3;
-				else						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file AA value must be A/C/G/T." << EidosTerminate();
+				if (info_ancestral_nuc == -1)
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file AA value must be A/C/G/T." << EidosTerminate();
 			}
-			else if (info_NONNUC_defined && (info_substr == "NONNUC"))				// Non-nucleotide-based
+			else if (info_NONNUC_defined && (info_substr_length == 6) && (strncmp(info_substr_start, "NONNUC", 6) == 0))	// Non-nucleotide-based
 			{
 				info_is_nonnuc = true;
 			}
@@ -3447,39 +4151,44 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for GO field." << EidosTerminate();
 			if ((info_muttype.size() != 0) && (info_muttype.size() != alt_allele_count))
 				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for MT field." << EidosTerminate();
+			
+			if (info_substr_end == info_end)
+				break;
+			info_substr_start = info_substr_end + 1;
 		}
 		
 		// read the genotype data for each sample id, which might be diploid or haploid, and might have data beyond GT
-		std::vector<int> genotype_calls;
+		genotype_calls.clear();
 		
 		for (int sample_index = 0; sample_index < sample_id_count; ++sample_index)
 		{
-			if (iss.eof())
+			if (line_exhausted)
 				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call line ended unexpectly before the last sample." << EidosTerminate();
 			
-			std::getline(iss, sub, '\t');
+			next_field(field_start, field_end);
 			
 			// extract just the GT field if others are present
-			std::size_t colon_pos = sub.find_first_of(':');
+			const char *colon_pos = (const char *)memchr(field_start, ':', (size_t)(field_end - field_start));
 			
-			if (colon_pos != std::string::npos)
-				sub = sub.substr(0, colon_pos);
+			if (colon_pos)
+				field_end = colon_pos;
 			
 			// separate haploid calls that are joined by | or /; this is the hotspot of the whole method, so we try to be efficient here
+			size_t field_length = (size_t)(field_end - field_start);
 			bool call_handled = false;
 			
-			if ((sub.length() == 3) && ((sub[1] == '|') || (sub[1] == '/')))
+			if ((field_length == 3) && ((field_start[1] == '|') || (field_start[1] == '/')))
 			{
 				// diploid, both single-digit
-				char sub_ch1 = sub[0];
-				char sub_ch2 = sub[2];
+				char sub_ch1 = field_start[0];
+				char sub_ch2 = field_start[2];
 				
 				if ((sub_ch1 >= '0') && (sub_ch1 <= '9') && (sub_ch2 >= '0') && (sub_ch2 <= '9'))
 				{
 					int genotype_call1 = (int)(sub_ch1 - '0');
 					int genotype_call2 = (int)(sub_ch2 - '0');
 					
-					if ((genotype_call1 < 0) || (genotype_call1 > (int)alt_allele_count) || (genotype_call2 < 0) || (genotype_call2 > (int)alt_allele_count))	// 0 is REF, 1..n are ALT alleles
+					if ((genotype_call1 > (int)alt_allele_count) || (genotype_call2 > (int)alt_allele_count))	// 0 is REF, 1..n are ALT alleles
 						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call out of range (does not correspond to a REF or ALT allele in the call line)." << EidosTerminate();
 					
 					genotype_calls.emplace_back(genotype_call1);
@@ -3487,16 +4196,16 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 					call_handled = true;
 				}
 			}
-			else if (sub.length() == 1)
+			else if (field_length == 1)
 			{
 				// haploid, single-digit
-				char sub_ch = sub[0];
+				char sub_ch = field_start[0];
 				
 				if ((sub_ch >= '0') && (sub_ch <= '9'))
 				{
 					int genotype_call = (int)(sub_ch - '0');
 					
-					if ((genotype_call < 0) || (genotype_call > (int)alt_allele_count))	// 0 is REF, 1..n are ALT alleles
+					if (genotype_call > (int)alt_allele_count)	// 0 is REF, 1..n are ALT alleles
 						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call out of range (does not correspond to a REF or ALT allele in the call line)." << EidosTerminate();
 					
 					genotype_calls.emplace_back(genotype_call);
@@ -3506,6 +4215,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 			
 			if (!call_handled)
 			{
+				std::string sub(field_start, field_end);
 				std::vector<std::string> genotype_substrs;
 				
 				if (sub.find("|") != std::string::npos)
@@ -3531,13 +4241,13 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 			}
 		}
 		
-		if (!iss.eof())
+		if (!line_exhausted)
 			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call line has unexpected entries following the last sample." << EidosTerminate();
 		if ((int)genotype_calls.size() != target_size)
 			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): target genome vector has size " << target_size << " but " << genotype_calls.size() << " calls were found in one call line." << EidosTerminate();
 		
 		// instantiate the mutations involved in this call line; the REF allele represents no mutation, ALT alleles are each separate mutations
-		std::vector<MutationIndex> alt_allele_mut_indices;
+		alt_allele_mut_indices.clear();
 		
 		for (std::size_t alt_allele_index = 0; alt_allele_index < alt_allele_count; ++alt_allele_index)
 		{
@@ -3691,14 +4401,23 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 				
 				if (mut_mutrun_index != genome_last_mutrun_modified)
 				{
+					if (merge_into_runs)
+					{
+						if (genome_last_mutrun_modified != -1)
+							merge_appended_mutations(genome->mutruns_[genome_last_mutrun_modified].get(), target_last_mutrun_original_count[genome_index]);
+						
+						target_last_mutrun_original_count[genome_index] = genome->mutruns_[mut_mutrun_index]->size();
+					}
+					
 					genome->WillModifyRun(mut_mutrun_index);
 					genome_last_mutrun_modified = mut_mutrun_index;
 				}
 				
 				MutationRun *mut_mutrun = genome->mutruns_[mut_mutrun_index].get();
 				
-				// If the genome started empty, we can add mutations to the end with emplace_back(); if it did not, then they need to be inserted
-				if (all_target_genomes_started_empty)
+				// If the genome started empty, we can add mutations to the end with emplace_back(); if it did not, then they need to be
+				// inserted, or appended and merged in later (see above)
+				if (all_target_genomes_started_empty || merge_into_runs)
 					mut_mutrun->emplace_back(mut_index);
 				else
 					mut_mutrun->insert_sorted_mutation(mut_index);
@@ -3709,6 +4428,18 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 		}
 	}
 	
+	// Merge the mutations appended to the last run modified in each genome
+	if (merge_into_runs)
+	{
+		for (int genome_index = 0; genome_index < target_size; ++genome_index)
+		{
+			slim_mutrun_index_t genome_last_mutrun_modified = target_last_mutrun_modified[genome_index];
+			
+			if (genome_last_mutrun_modified != -1)
+				merge_appended_mutations(targets[genome_index]->mutruns_[genome_last_mutrun_modified].get(), target_last_mutrun_original_count[genome_index]);
+		}
+	}
+	
 	// Return the instantiated mutations
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 	int mutation_count = (int)mutation_indices.size();
@@ -1423,10 +1423,9 @@ double InteractionType::ApplyInteractionCallbacks(Individual *p_receiver, Indivi
 				
 				// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
 				{
-					EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim.SymbolTable());
-					EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-					EidosFunctionMap &function_map = sim.FunctionMap();
-					EidosInterpreter interpreter(interaction_callback->compound_statement_node_, client_symbols, function_map, &sim, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+					SLiMCallbackInvocation invocation(interaction_callback, sim);
+					EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+					EidosInterpreter &interpreter = invocation.Interpreter();
 					
 					if (interaction_callback->contains_self_)
 						callback_symbols.InitializeConstantSymbolEntry(interaction_callback->SelfSymbolTableEntry());		// define "self"
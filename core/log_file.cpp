@@ -24,6 +24,10 @@
 #include <algorithm>
 #include <vector>
 #include <iomanip>
+#include <fstream>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
 
 #include "slim_globals.h"
 #include "slim_sim.h"
@@ -37,16 +41,57 @@
 #pragma mark LogFile
 #pragma mark -
 
+// The binary columnar format; see the documentation for createLogFile() for the layout.  The tags are written in native byte order,
+// so a reader can detect the endianness of the writer from them, as with outputFull(binary=T).
+static const int32_t kLogFileBinaryHeaderTag = 0x12345678;
+static const int32_t kLogFileBinaryChunkTag = 0x43484E4B;		// 'CHNK'
+static const int32_t kLogFileBinaryVersion = 1;
+static const int64_t kLogFileBinaryDefaultChunkRows = 1000;		// rows per chunk when no flushInterval is given
+
+enum class LogFileBinaryColumnType : uint8_t {
+	kColumnNA = 0,			// every value in the chunk was NA; no data follows
+	kColumnLogical,			// int8 values; NA is -1
+	kColumnInt,				// int64 values; NA is INT64_MIN
+	kColumnFloat,			// float64 values; NA is NaN
+	kColumnString			// a dictionary of unique strings followed by int32 indices into it; NA is -1
+};
+
+template <typename T>
+static inline void _LogFileAppendBinary(std::string &p_out, T p_value)
+{
+	p_out.append(reinterpret_cast<const char *>(&p_value), sizeof(T));
+}
+
 LogFile::LogFile(SLiMSim &p_sim) : sim_(p_sim)
 {
+	// Binary rows are buffered by us rather than by Eidos, so we need to hand them over when Eidos flushes at exit
+	Eidos_RegisterFlushCallback(LogFile::FlushCallback, this);
 }
 
 LogFile::~LogFile(void)
 {
+	Eidos_UnregisterFlushCallback(LogFile::FlushCallback, this);
+	
+	// Rows still buffered when we go away (after a stop() or an error in SLiMgui, for example) get written at the next flush
+	BufferBinaryChunk();
 }
 
-void LogFile::ConfigureFile(const std::string &p_filePath, std::vector<const std::string *> &p_initialContents, bool p_append, bool p_compress, const std::string &p_sep)
+void LogFile::FlushCallback(void *p_context)
 {
+	static_cast<LogFile *>(p_context)->BufferBinaryChunk();
+}
+
+void LogFile::ConfigureFile(const std::string &p_filePath, std::vector<const std::string *> &p_initialContents, bool p_append, bool p_compress, const std::string &p_sep, bool p_binary)
+{
+	if (p_binary && p_compress)
+		EIDOS_TERMINATION << "ERROR (LogFile::ConfigureFile): binary output cannot be compressed." << EidosTerminate();
+	if (p_binary && p_initialContents.size())
+		EIDOS_TERMINATION << "ERROR (LogFile::ConfigureFile): initialContents cannot be supplied for binary output." << EidosTerminate();
+	
+	// Rows buffered for a binary chunk belong to the file we were previously writing to
+	if (binary_)
+		WriteBinaryChunk();
+	
 	user_file_path_ = p_filePath;
 	
 	// correct the user-visible path to end in ".gz" if it doesn't already
@@ -77,10 +122,31 @@ void LogFile::ConfigureFile(const std::string &p_filePath, std::vector<const std
 	}
 	
 	compress_ = p_compress;
+	binary_ = p_binary;
 	sep_ = p_sep;
 	
-	// We always open the file for writing (or appending) synchronously and write out the initial contents, if any
-	Eidos_WriteToFile(resolved_file_path_, p_initialContents, p_append, p_compress, EidosFileFlush::kForceFlush);
+	if (binary_)
+	{
+		// A binary file gets its own header with the first chunk; appending thus produces a concatenation of complete logs
+		binary_file_header_written_ = false;
+		
+		if (!p_append)
+		{
+#if EIDOS_BUFFER_ZIP_APPENDS
+			gEidosBufferedAppendData.erase(resolved_file_path_);
+#endif
+			
+			std::ofstream truncate_stream(resolved_file_path_, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+			
+			if (!truncate_stream.is_open())
+				EIDOS_TERMINATION << "ERROR (LogFile::ConfigureFile): could not open " << user_file_path_ << "." << EidosTerminate();
+		}
+	}
+	else
+	{
+		// We always open the file for writing (or appending) synchronously and write out the initial contents, if any
+		Eidos_WriteToFile(resolved_file_path_, p_initialContents, p_append, p_compress, EidosFileFlush::kForceFlush);
+	}
 }
 
 void LogFile::SetLogInterval(bool p_autologging_enabled, int64_t p_logInterval)
@@ -342,8 +408,12 @@ void LogFile::AppendNewRow(void)
 #endif
 		}
 		
-		header_line = ss.str();
-		line_vec.emplace_back(&header_line);
+		// In binary mode the column names go into the binary file header instead; see WriteBinaryChunk()
+		if (!binary_)
+		{
+			header_line = ss.str();
+			line_vec.emplace_back(&header_line);
+		}
 		
 #ifdef SLIMGUI
 		emitted_lines_.emplace_back(std::move(gui_line));
@@ -353,101 +423,118 @@ void LogFile::AppendNewRow(void)
 		header_logged_ = true;
 	}
 	
-	// Generate the text of the row from the Dictionary entries
+	// Generate the values of the row and add them to our Dictionary state as we go, so later generators can see earlier values
+	std::vector<EidosValue_SP> row_values;
+	
+	row_values.reserve(column_names_.size());
+	
+	for (const LogFileGeneratorInfo &generator : generator_info_)
 	{
-		std::ostringstream ss;
-		int column_index = 0;
+		EidosValue_SP generated_value;
 		
-#ifdef SLIMGUI
-		std::vector<std::string> gui_line;
-#endif
-		
-		for (const LogFileGeneratorInfo &generator : generator_info_)
+		switch (generator.type_)
 		{
-			EidosValue_SP generated_value;
-			
-			switch (generator.type_)
+			case LogFileGeneratorType::kGenerator_Generation:
+				generated_value = _GeneratedValue_Generation(generator);
+				break;
+			case LogFileGeneratorType::kGenerator_GenerationStage:
+				generated_value = _GeneratedValue_GenerationStage(generator);
+				break;
+			case LogFileGeneratorType::kGenerator_PopulationSexRatio:
+				generated_value = _GeneratedValue_PopulationSexRatio(generator);
+				break;
+			case LogFileGeneratorType::kGenerator_PopulationSize:
+				generated_value = _GeneratedValue_PopulationSize(generator);
+				break;
+			case LogFileGeneratorType::kGenerator_SubpopulationSexRatio:
+				generated_value = _GeneratedValue_SubpopulationSexRatio(generator);
+				break;
+			case LogFileGeneratorType::kGenerator_SubpopulationSize:
+				generated_value = _GeneratedValue_SubpopulationSize(generator);
+				break;
+			case LogFileGeneratorType::kGenerator_CustomScript:
+				generated_value = _GeneratedValue_CustomScript(generator);
+				break;
+			case LogFileGeneratorType::kGenerator_CustomMeanAndSD:
 			{
-				case LogFileGeneratorType::kGenerator_Generation:
-					generated_value = _GeneratedValue_Generation(generator);
-					break;
-				case LogFileGeneratorType::kGenerator_GenerationStage:
-					generated_value = _GeneratedValue_GenerationStage(generator);
-					break;
-				case LogFileGeneratorType::kGenerator_PopulationSexRatio:
-					generated_value = _GeneratedValue_PopulationSexRatio(generator);
-					break;
-				case LogFileGeneratorType::kGenerator_PopulationSize:
-					generated_value = _GeneratedValue_PopulationSize(generator);
-					break;
-				case LogFileGeneratorType::kGenerator_SubpopulationSexRatio:
-					generated_value = _GeneratedValue_SubpopulationSexRatio(generator);
-					break;
-				case LogFileGeneratorType::kGenerator_SubpopulationSize:
-					generated_value = _GeneratedValue_SubpopulationSize(generator);
-					break;
-				case LogFileGeneratorType::kGenerator_CustomScript:
-					generated_value = _GeneratedValue_CustomScript(generator);
-					break;
-				case LogFileGeneratorType::kGenerator_CustomMeanAndSD:
-				{
-					// This requires special-casing because it generates two columns
-					EidosValue_SP generated_value_1, generated_value_2;
-					
-					_GeneratedValues_CustomMeanAndSD(generator, &generated_value_1, &generated_value_2);
-					
-					// emit generated_value_1
-					if (column_index != 0)
-						ss << sep_;
-					
-					_OutputValue(ss, generated_value_1.get());
-					
-#ifdef SLIMGUI
-					std::ostringstream gui_ss;
-					_OutputValue(gui_ss, generated_value_1.get());
-					gui_line.emplace_back(gui_ss.str());
-#endif
-					
-					if (generated_value_1->Type() != EidosValueType::kValueNULL)
-						SetKeyValue(column_names_[column_index], std::move(generated_value_1));
-					
-					column_index++;
-					
-					// let the code below emit generated_value_2
-					generated_value = generated_value_2;
-
-					break;
-				}
+				// This requires special-casing because it generates two columns
+				EidosValue_SP generated_value_1, generated_value_2;
+				
+				_GeneratedValues_CustomMeanAndSD(generator, &generated_value_1, &generated_value_2);
+				
+				// record generated_value_1
+				if (generated_value_1->Type() != EidosValueType::kValueNULL)
+					SetKeyValue(column_names_[row_values.size()], generated_value_1);
+				
+				row_values.emplace_back(std::move(generated_value_1));
+				
+				// let the code below record generated_value_2
+				generated_value = generated_value_2;
+				
+				break;
 			}
-			
-			// Emit the generated value and add it to our Dictionary state
-			if (column_index != 0)
-				ss << sep_;
-			
-			_OutputValue(ss, generated_value.get());
-			
+		}
+		
+		if (generated_value->Type() != EidosValueType::kValueNULL)
+			SetKeyValue(column_names_[row_values.size()], generated_value);
+		
+		row_values.emplace_back(std::move(generated_value));
+	}
+	
 #ifdef SLIMGUI
+	{
+		std::vector<std::string> gui_line;
+		
+		for (const EidosValue_SP &value : row_values)
+		{
 			std::ostringstream gui_ss;
-			_OutputValue(gui_ss, generated_value.get());
+			_OutputValue(gui_ss, value.get());
 			gui_line.emplace_back(gui_ss.str());
+		}
+		
+		emitted_lines_.emplace_back(std::move(gui_line));
+	}
 #endif
+	
+	ContentsChanged("LogFile::AppendNewRow()");
+	
+	if (binary_)
+	{
+		// Buffer the row column-wise; the chunk is written out once it reaches the flush interval
+		size_t column_count = row_values.size();
+		
+		if (binary_chunk_columns_.size() != column_count)
+			binary_chunk_columns_.resize(column_count);
+		
+		for (size_t column_index = 0; column_index < column_count; ++column_index)
+			binary_chunk_columns_[column_index].emplace_back(std::move(row_values[column_index]));
+		
+		binary_chunk_row_count_++;
+		
+		if (binary_chunk_row_count_ >= (explicit_flushing_ ? flush_interval_ : kLogFileBinaryDefaultChunkRows))
+			WriteBinaryChunk();
+		
+		return;
+	}
+	
+	// Generate the text of the row from the generated values
+	{
+		std::ostringstream ss;
+		bool first_column = true;
+		
+		for (const EidosValue_SP &value : row_values)
+		{
+			if (!first_column)
+				ss << sep_;
+			first_column = false;
 			
-			if (generated_value->Type() != EidosValueType::kValueNULL)
-				SetKeyValue(column_names_[column_index], std::move(generated_value));
-			
-			column_index++;
+			_OutputValue(ss, value.get());
 		}
 		
 		row_line = ss.str();
 		line_vec.emplace_back(&row_line);
-		
-#ifdef SLIMGUI
-		emitted_lines_.emplace_back(std::move(gui_line));
-#endif
 	}
 	
-	ContentsChanged("LogFile::AppendNewRow()");
-	
 	// Write out the row
 	EidosFileFlush flush = EidosFileFlush::kDefaultFlush;
 	
@@ -469,6 +556,151 @@ void LogFile::AppendNewRow(void)
 	Eidos_WriteToFile(resolved_file_path_, line_vec, true, compress_, flush);
 }
 
+void LogFile::_AppendBinaryColumn(std::string &p_out, std::vector<EidosValue_SP> &p_column_values)
+{
+	// Each column of a chunk gets the narrowest type that can represent all of its values; NULL values become NA
+	bool has_logical = false, has_int = false, has_float = false, has_string = false;
+	
+	for (const EidosValue_SP &value : p_column_values)
+	{
+		switch (value->Type())
+		{
+			case EidosValueType::kValueLogical:	has_logical = true; break;
+			case EidosValueType::kValueInt:		has_int = true; break;
+			case EidosValueType::kValueFloat:	has_float = true; break;
+			case EidosValueType::kValueString:	has_string = true; break;
+			default: break;
+		}
+	}
+	
+	LogFileBinaryColumnType column_type;
+	
+	if (has_string)			column_type = LogFileBinaryColumnType::kColumnString;
+	else if (has_float)		column_type = LogFileBinaryColumnType::kColumnFloat;
+	else if (has_int)		column_type = LogFileBinaryColumnType::kColumnInt;
+	else if (has_logical)	column_type = LogFileBinaryColumnType::kColumnLogical;
+	else					column_type = LogFileBinaryColumnType::kColumnNA;
+	
+	_LogFileAppendBinary<uint8_t>(p_out, (uint8_t)column_type);
+	
+	switch (column_type)
+	{
+		case LogFileBinaryColumnType::kColumnNA:
+			break;
+		case LogFileBinaryColumnType::kColumnLogical:
+			for (const EidosValue_SP &value : p_column_values)
+				_LogFileAppendBinary<int8_t>(p_out, (value->Type() == EidosValueType::kValueNULL) ? -1 : (int8_t)value->LogicalAtIndex(0, nullptr));
+			break;
+		case LogFileBinaryColumnType::kColumnInt:
+			for (const EidosValue_SP &value : p_column_values)
+				_LogFileAppendBinary<int64_t>(p_out, (value->Type() == EidosValueType::kValueNULL) ? std::numeric_limits<int64_t>::min() : value->IntAtIndex(0, nullptr));
+			break;
+		case LogFileBinaryColumnType::kColumnFloat:
+			for (const EidosValue_SP &value : p_column_values)
+				_LogFileAppendBinary<double>(p_out, (value->Type() == EidosValueType::kValueNULL) ? std::numeric_limits<double>::quiet_NaN() : value->FloatAtIndex(0, nullptr));
+			break;
+		case LogFileBinaryColumnType::kColumnString:
+		{
+			std::unordered_map<std::string, int32_t> string_indices;
+			std::vector<const std::string *> unique_strings;
+			std::vector<int32_t> indices;
+			
+			indices.reserve(p_column_values.size());
+			
+			for (const EidosValue_SP &value : p_column_values)
+			{
+				if (value->Type() == EidosValueType::kValueNULL)
+				{
+					indices.emplace_back(-1);
+					continue;
+				}
+				
+				auto inserted = string_indices.emplace(value->StringAtIndex(0, nullptr), (int32_t)unique_strings.size());
+				
+				if (inserted.second)
+					unique_strings.emplace_back(&inserted.first->first);
+				
+				indices.emplace_back(inserted.first->second);
+			}
+			
+			_LogFileAppendBinary<int32_t>(p_out, (int32_t)unique_strings.size());
+			
+			for (const std::string *unique_string : unique_strings)
+			{
+				_LogFileAppendBinary<int32_t>(p_out, (int32_t)unique_string->length());
+				p_out.append(*unique_string);
+			}
+			
+			p_out.append(reinterpret_cast<const char *>(indices.data()), indices.size() * sizeof(int32_t));
+			break;
+		}
+	}
+	
+	p_column_values.clear();
+}
+
+void LogFile::EncodeBinaryChunk(std::string &p_chunk)
+{
+	// The file header: tag, version, column count, and the length-prefixed column names
+	if (!binary_file_header_written_)
+	{
+		_LogFileAppendBinary<int32_t>(p_chunk, kLogFileBinaryHeaderTag);
+		_LogFileAppendBinary<int32_t>(p_chunk, kLogFileBinaryVersion);
+		_LogFileAppendBinary<int32_t>(p_chunk, (int32_t)column_names_.size());
+		
+		for (const std::string &column_name : column_names_)
+		{
+			_LogFileAppendBinary<int32_t>(p_chunk, (int32_t)column_name.length());
+			p_chunk.append(column_name);
+		}
+	}
+	
+	// The chunk: tag, row count, and then each column's type code and data
+	_LogFileAppendBinary<int32_t>(p_chunk, kLogFileBinaryChunkTag);
+	_LogFileAppendBinary<int64_t>(p_chunk, binary_chunk_row_count_);
+	
+	for (std::vector<EidosValue_SP> &column_values : binary_chunk_columns_)
+		_AppendBinaryColumn(p_chunk, column_values);
+	
+	binary_chunk_row_count_ = 0;
+	binary_file_header_written_ = true;
+}
+
+void LogFile::WriteBinaryChunk(void)
+{
+	if (binary_chunk_row_count_ == 0)
+		return;
+	
+	// Rows handed to Eidos by BufferBinaryChunk() for this path precede ours in the file
+	Eidos_FlushFile(resolved_file_path_);
+	
+	std::string chunk;
+	
+	EncodeBinaryChunk(chunk);
+	
+	std::ofstream file_stream(resolved_file_path_, std::ios_base::out | std::ios_base::binary | std::ios_base::app);
+	
+	if (!file_stream.is_open())
+		EIDOS_TERMINATION << "ERROR (LogFile::WriteBinaryChunk): could not open " << user_file_path_ << "." << EidosTerminate();
+	
+	file_stream.write(chunk.data(), chunk.size());
+	
+	if (!file_stream)
+		EIDOS_TERMINATION << "ERROR (LogFile::WriteBinaryChunk): an error occurred while writing to " << user_file_path_ << "." << EidosTerminate();
+}
+
+void LogFile::BufferBinaryChunk(void)
+{
+	// Like WriteBinaryChunk(), but hands the chunk to Eidos's append buffers instead of writing it, and so never raises
+	if (!binary_ || (binary_chunk_row_count_ == 0))
+		return;
+	
+	std::string chunk;
+	
+	EncodeBinaryChunk(chunk);
+	Eidos_BufferAppendData(resolved_file_path_, chunk);
+}
+
 void LogFile::GenerationEndCallout(void)
 {
 	if (autologging_enabled_)
@@ -480,6 +712,13 @@ void LogFile::GenerationEndCallout(void)
 	}
 }
 
+void LogFile::SimulationFinishedCallout(void)
+{
+	// Write out any partial binary chunk, so the file is complete when the simulation ends
+	if (binary_)
+		WriteBinaryChunk();
+}
+
 EidosValue_SP LogFile::AllKeys(void) const
 {
 	// We want to return the column names in order, so we have to override EidosDictionaryUnretained here
@@ -811,7 +1050,11 @@ EidosValue_SP LogFile::ExecuteMethod_addSubpopulationSize(EidosGlobalStringID p_
 EidosValue_SP LogFile::ExecuteMethod_flush(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
 #pragma unused (p_method_id, p_arguments, p_interpreter)
-	Eidos_FlushFile(resolved_file_path_);
+	if (binary_)
+		WriteBinaryChunk();
+	else
+		Eidos_FlushFile(resolved_file_path_);
+	
 	unflushed_row_count_ = 0;
 	
 	return gStaticEidosValueVOID;
@@ -884,7 +1127,7 @@ EidosValue_SP LogFile::ExecuteMethod_setFilePath(EidosGlobalStringID p_method_id
 	if (sep_value->Type() != EidosValueType::kValueNULL)
 		sep = sep_value->StringRefAtIndex(0, nullptr);
 	
-	ConfigureFile(filePath, initialContents, append, do_compress, sep);
+	ConfigureFile(filePath, initialContents, append, do_compress, sep, binary_);
 	
 	return gStaticEidosValueVOID;
 }
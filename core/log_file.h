@@ -72,6 +72,7 @@ private:
 	bool header_logged_ = false;								// true if the header has been written out (in which case our generators are locked)
 	
 	bool compress_;
+	bool binary_ = false;										// true if we write the binary columnar format instead of delimited text
 	std::string sep_;											// the separator string between values, such as "," or "\t"
 	int float_precision_ = 6;									// the precision of output of float values
 	
@@ -91,6 +92,11 @@ private:
 	// Columns; note that one generator can generate more than one column!
 	std::vector<std::string> column_names_;
 	
+	// Binary mode buffers the values of the current chunk column by column; see WriteBinaryChunk()
+	std::vector<std::vector<EidosValue_SP>> binary_chunk_columns_;
+	int64_t binary_chunk_row_count_ = 0;
+	bool binary_file_header_written_ = false;
+	
 #ifdef SLIMGUI
 	// For SLiMgui, LogFile keeps a record of all of the output it generates, which SLiMgui pulls out of it
 	std::vector<std::vector<std::string>> emitted_lines_;
@@ -108,6 +114,11 @@ private:
 	void _GeneratedValues_CustomMeanAndSD(const LogFileGeneratorInfo &p_generator_info, EidosValue_SP *p_generated_value_1, EidosValue_SP *p_generated_value_2);
 	
 	void _OutputValue(std::ostringstream &ss, EidosValue *value);
+	void _AppendBinaryColumn(std::string &p_out, std::vector<EidosValue_SP> &p_column_values);
+	void EncodeBinaryChunk(std::string &p_chunk);
+	void WriteBinaryChunk(void);
+	void BufferBinaryChunk(void);
+	static void FlushCallback(void *p_context);
 	
 public:
 	LogFile(const LogFile &p_original) = delete;	// no copy-construct
@@ -116,12 +127,13 @@ public:
 	explicit LogFile(SLiMSim &p_sim);
 	virtual ~LogFile(void) override;
 	
-	void ConfigureFile(const std::string &p_filePath, std::vector<const std::string *> &p_initialContents, bool p_append, bool p_compress, const std::string &p_sep);
+	void ConfigureFile(const std::string &p_filePath, std::vector<const std::string *> &p_initialContents, bool p_append, bool p_compress, const std::string &p_sep, bool p_binary);
 	void SetLogInterval(bool p_autologging_enabled, int64_t p_logInterval);
 	void SetFlushInterval(bool p_explicit_flushing, int64_t p_flushInterval);
 	
 	void AppendNewRow(void);
 	void GenerationEndCallout(void);
+	void SimulationFinishedCallout(void);
 	
 	virtual EidosValue_SP AllKeys(void) const override;	// provide keys in column order
 	
@@ -39,6 +39,7 @@
 #include "eidos_test.h"
 #include "slim_test.h"
 #include "eidos_symbol_table.h"
+#include "eidos_parallel.h"
 
 
 static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
@@ -88,6 +89,7 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 	
 	SLIM_OUTSTREAM << "usage: slim -v[ersion] | -u[sage] | -h[elp] | -testEidos | -testSLiM |" << std::endl;
 	SLIM_OUTSTREAM << "   [-l[ong] [<l>]] [-s[eed] <seed>] [-t[ime]] [-m[em]] [-M[emhist]] [-x]" << std::endl;
+	SLIM_OUTSTREAM << "   [-noBytecode] [-noFusion] [-noFolding] [-maxThreads <n>] [-parallelThreshold <n>]" << std::endl;
 	SLIM_OUTSTREAM << "   [-d[efine] <def>] [<script file>]" << std::endl;
 	
 	if (p_print_full_usage)
@@ -105,6 +107,11 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 		SLIM_OUTSTREAM << "   -m[em]           : print SLiM's peak memory usage" << std::endl;
 		SLIM_OUTSTREAM << "   -M[emhist]       : print a histogram of SLiM's memory usage" << std::endl;
 		SLIM_OUTSTREAM << "   -x               : disable SLiM's runtime safety/consistency checks" << std::endl;
+		SLIM_OUTSTREAM << "   -noBytecode      : evaluate all Eidos code with the tree-walking interpreter" << std::endl;
+		SLIM_OUTSTREAM << "   -noFusion        : evaluate Eidos vector expressions one operator at a time" << std::endl;
+		SLIM_OUTSTREAM << "   -noFolding       : re-evaluate constant Eidos expressions every time" << std::endl;
+		SLIM_OUTSTREAM << "   -maxThreads <n>  : use up to <n> threads for large vector builtins (0 = all cores)" << std::endl;
+		SLIM_OUTSTREAM << "   -parallelThreshold <n> : minimum vector size for builtins to use threads" << std::endl;
 		SLIM_OUTSTREAM << "   -d[efine] <def>  : define an Eidos constant, such as \"mu=1e-7\"" << std::endl;
 		SLIM_OUTSTREAM << "   <script file>    : the input script file (stdin may be used instead)" << std::endl;
 	}
@@ -146,6 +153,7 @@ int main(int argc, char *argv[])
 	unsigned long int *override_seed_ptr = nullptr;			// by default, a seed is generated or supplied in the input file
 	const char *input_file = nullptr;
 	bool keep_time = false, keep_mem = false, keep_mem_hist = false, skip_checks = false, tree_seq_checks = false, tree_seq_force = false;
+	size_t tree_seq_checks_sample_size = 0;
 	std::vector<std::string> defined_constants;
 	
 	// command-line SLiM generally terminates rather than throwing
@@ -262,6 +270,52 @@ int main(int argc, char *argv[])
 			continue;
 		}
 		
+		// -noBytecode: disable scalar bytecode compilation, for debugging or timing the interpreter; must precede -testEidos/-testSLiM to affect them
+		if (strcmp(arg, "-noBytecode") == 0)
+		{
+			gEidosScalarBytecode = false;
+			
+			continue;
+		}
+		
+		// -noFusion: disable fusion of vector expressions, for debugging or timing the interpreter; must precede -testEidos/-testSLiM to affect them
+		if (strcmp(arg, "-noFusion") == 0)
+		{
+			gEidosVectorFusion = false;
+			
+			continue;
+		}
+		
+		// -noFolding: disable folding of constant expressions, for debugging or timing the interpreter; must precede -testEidos/-testSLiM to affect them
+		if (strcmp(arg, "-noFolding") == 0)
+		{
+			gEidosConstantFolding = false;
+			
+			continue;
+		}
+		
+		// -maxThreads <n>: let large Eidos vector builtins use up to n threads (0 for one per core); results do not depend on it
+		if (strcmp(arg, "-maxThreads") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie(false, true);
+			
+			Eidos_SetMaxThreads(strtol(argv[arg_index], NULL, 10));
+			
+			continue;
+		}
+		
+		// -parallelThreshold <n>: the number of elements below which Eidos builtins stay single-threaded
+		if (strcmp(arg, "-parallelThreshold") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie(false, true);
+			
+			Eidos_SetParallelThreshold(strtol(argv[arg_index], NULL, 10));
+			
+			continue;
+		}
+		
 		// -version or -v: print version information
 		if (strcmp(arg, "--version") == 0 || strcmp(arg, "-version") == 0 || strcmp(arg, "-v") == 0)
 		{
@@ -313,10 +367,29 @@ int main(int argc, char *argv[])
 			continue;
 		}
 		
-        // -TSXC is an undocumented command-line flag that turns on tree-sequence recording and runtime crosschecks
+        // -TSXC is an undocumented command-line flag that turns on tree-sequence recording and runtime crosschecks;
+        // an optional integer argument following it makes each crosscheck check only a random sample of that many genomes
         if (strcmp(arg, "-TSXC") == 0)
         {
             tree_seq_checks = true;
+            
+            if (arg_index + 1 < argc)
+            {
+                // there is another argument following; if it is an integer, we eat it
+                const char *s = argv[arg_index + 1];
+                bool is_digits = (*s != 0);
+                
+                while (*s) {
+                    if (isdigit(*s++) == 0)
+                    {
+                        is_digits = false;
+                        break;
+                    }
+                }
+                
+                if (is_digits)
+                    tree_seq_checks_sample_size = (size_t)strtoull(argv[++arg_index], NULL, 10);
+            }
             continue;
         }
         
@@ -442,7 +515,7 @@ int main(int argc, char *argv[])
 			sim->cli_params_.emplace_back(argv[arg_index]);
 		
 		if (tree_seq_checks)
-			sim->TSXC_Enable();
+			sim->TSXC_Enable(tree_seq_checks_sample_size);
         if (tree_seq_force && !tree_seq_checks)
             sim->TSF_Enable();
 		
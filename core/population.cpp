@@ -647,10 +647,9 @@ slim_popsize_t Population::ApplyMateChoiceCallbacks(slim_popsize_t p_parent1_ind
 			
 			// The callback is active, so we need to execute it; we start a block here to manage the lifetime of the symbol table
 			{
-				EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim_.SymbolTable());
-				EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-				EidosFunctionMap &function_map = sim_.FunctionMap();
-				EidosInterpreter interpreter(mate_choice_callback->compound_statement_node_, client_symbols, function_map, &sim_, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+				SLiMCallbackInvocation invocation(mate_choice_callback, sim_);
+				EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+				EidosInterpreter &interpreter = invocation.Interpreter();
 				
 				if (mate_choice_callback->contains_self_)
 					callback_symbols.InitializeConstantSymbolEntry(mate_choice_callback->SelfSymbolTableEntry());		// define "self"
@@ -987,10 +986,9 @@ bool Population::ApplyModifyChildCallbacks(Individual *p_child, Genome *p_child_
 #endif
 			
 			// The callback is active, so we need to execute it
-			EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim_.SymbolTable());
-			EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-			EidosFunctionMap &function_map = sim_.FunctionMap();
-			EidosInterpreter interpreter(modify_child_callback->compound_statement_node_, client_symbols, function_map, &sim_, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+			SLiMCallbackInvocation invocation(modify_child_callback, sim_);
+			EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+			EidosInterpreter &interpreter = invocation.Interpreter();
 			
 			if (modify_child_callback->contains_self_)
 				callback_symbols.InitializeConstantSymbolEntry(modify_child_callback->SelfSymbolTableEntry());		// define "self"
@@ -2252,10 +2250,10 @@ bool Population::ApplyRecombinationCallbacks(slim_popsize_t p_parent_index, Geno
 #endif
 			
 			// The callback is active, so we need to execute it
-			EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim_.SymbolTable());
-			EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-			EidosFunctionMap &function_map = sim_.FunctionMap();
-			EidosInterpreter interpreter(recombination_callback->compound_statement_node_, client_symbols, function_map, &sim_, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+			SLiMCallbackInvocation invocation(recombination_callback, sim_);
+			EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+			EidosSymbolTable &client_symbols = invocation.ClientSymbols();
+			EidosInterpreter &interpreter = invocation.Interpreter();
 			
 			if (recombination_callback->contains_self_)
 				callback_symbols.InitializeConstantSymbolEntry(recombination_callback->SelfSymbolTableEntry());		// define "self"
@@ -6735,11 +6733,13 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 		p_out.write(reinterpret_cast<char *>(&endianness_tag), sizeof endianness_tag);
 		
 		// Write a format version tag
-		int32_t version_tag = 6;													// version 2 started with SLiM 2.1
+		int32_t version_tag = 7;													// version 2 started with SLiM 2.1
 																					// version 3 started with SLiM 2.3
 																					// version 4 started with SLiM 3.0, only when individual age is output
 																					// version 5 started with SLiM 3.3, adding a "flags" field and nucleotide support
 																					// version 6 started with SLiM 3.5, adding optional pedigree ID output with a new flag
+																					// version 7 adds a table of unique mutation runs, referenced by index from genomes,
+																					// and moves individual information into columns in its own section
 		p_out.write(reinterpret_cast<char *>(&version_tag), sizeof version_tag);
 		
 		// Write the size of a double
@@ -6922,130 +6922,167 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 	// Write a tag indicating the section has ended
 	p_out.write(reinterpret_cast<char *>(&section_end_tag), sizeof section_end_tag);
 	
-	// Genomes section
+	// Mutation runs section, added in version 7.  Each distinct MutationRun used by the genomes is written once, and genomes then
+	// refer to runs by their index in this table; runs shared by many genomes (the common case) thus cost nothing extra to write or read.
 	bool use_16_bit = (mutation_map_size <= UINT16_MAX - 1);	// 0xFFFF is reserved as the start of our various tags
+	robin_hood::unordered_flat_map<const MutationRun *, int32_t> mutrun_table_indices;
+	std::vector<const MutationRun *> mutrun_table;
 	
 	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)			// go through all subpopulations
 	{
 		Subpopulation *subpop = subpop_pair.second;
-		slim_objectid_t subpop_id = subpop_pair.first;
 		slim_popsize_t subpop_size = subpop->CurrentSubpopSize();
 		
-		for (slim_popsize_t i = 0; i < 2 * subpop_size; i++)							// go through all children
+		for (slim_popsize_t i = 0; i < 2 * subpop_size; i++)				// go through all children
 		{
 			Genome &genome = *(subpop->CurrentGenomes()[i]);
+			int mutrun_count = genome.mutrun_count_;
 			
-			// Write out the genome header; start with the genome type to guarantee that the first 32 bits are != section_end_tag
-			int32_t genome_type = (int32_t)(genome.Type());
-			
-			p_out.write(reinterpret_cast<char *>(&genome_type), sizeof genome_type);
-			p_out.write(reinterpret_cast<char *>(&subpop_id), sizeof subpop_id);
-			p_out.write(reinterpret_cast<char *>(&i), sizeof i);
-			
-			// Output individual spatial position information before the mutation list.  Added in version 3.
-			if (spatial_output_count && ((i % 2) == 0))
+			for (int run_index = 0; run_index < mutrun_count; ++run_index)
 			{
-				int individual_index = i / 2;
-				Individual &individual = *(subpop->CurrentIndividuals()[individual_index]);
+				const MutationRun *mutrun = genome.mutruns_[run_index].get();
 				
-				if (spatial_output_count >= 1)
-					p_out.write(reinterpret_cast<char *>(&individual.spatial_x_), sizeof individual.spatial_x_);
-				if (spatial_output_count >= 2)
-					p_out.write(reinterpret_cast<char *>(&individual.spatial_y_), sizeof individual.spatial_y_);
-				if (spatial_output_count >= 3)
-					p_out.write(reinterpret_cast<char *>(&individual.spatial_z_), sizeof individual.spatial_z_);
+				if (mutrun_table_indices.emplace(mutrun, (int32_t)mutrun_table.size()).second)
+					mutrun_table.emplace_back(mutrun);
 			}
+		}
+	}
+	
+	{
+		// Write the mutation run configuration of the chromosome, so the reader can tell whether it can use the runs as they are
+		const Chromosome &chromosome = sim_.TheChromosome();
+		int32_t mutrun_count = chromosome.mutrun_count_;
+		slim_position_t mutrun_length = chromosome.mutrun_length_;
+		int32_t mutrun_table_size = (int32_t)mutrun_table.size();
+		
+		p_out.write(reinterpret_cast<char *>(&mutrun_count), sizeof mutrun_count);
+		p_out.write(reinterpret_cast<char *>(&mutrun_length), sizeof mutrun_length);
+		p_out.write(reinterpret_cast<char *>(&mutrun_table_size), sizeof mutrun_table_size);
+	}
+	
+	for (const MutationRun *mutrun : mutrun_table)
+	{
+		// write a 32-bit mutation count, followed by the polymorphism ids of the mutations in the run, in 16 or 32 bits
+		int32_t mut_count = mutrun->size();
+		const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
+		
+		p_out.write(reinterpret_cast<char *>(&mut_count), sizeof mut_count);
+		
+		for (int mut_index = 0; mut_index < mut_count; ++mut_index)
+		{
+			slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
 			
-			// Output individual pedigree ID information.  Added in version 5.
-			if (pedigree_output_count && ((i % 2) == 0))
+			if (polymorphism_id == -1)
+				EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) polymorphism not found." << EidosTerminate();
+			
+			if (use_16_bit)
 			{
-				int individual_index = i / 2;
-				Individual &individual = *(subpop->CurrentIndividuals()[individual_index]);
-				slim_pedigreeid_t pedigree_id = individual.PedigreeID();
+				if (polymorphism_id > UINT16_MAX - 1)
+					EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) mutation id out of 16-bit bounds." << EidosTerminate();
+				
+				uint16_t id_16 = (uint16_t)polymorphism_id;
 				
-				p_out.write(reinterpret_cast<char *>(&pedigree_id), sizeof pedigree_id);
+				p_out.write(reinterpret_cast<char *>(&id_16), sizeof id_16);
+			}
+			else
+			{
+				p_out.write(reinterpret_cast<char *>(&polymorphism_id), sizeof polymorphism_id);
 			}
+		}
+	}
+	
+	// Write a tag indicating the section has ended
+	p_out.write(reinterpret_cast<char *>(&section_end_tag), sizeof section_end_tag);
+	
+	// Individuals section, added in version 7.  For each subpopulation in turn, each requested individual field is written as a
+	// column, with one value per individual, so that it can be read back with a single copy (and compresses well, if requested)
+	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)
+	{
+		Subpopulation *subpop = subpop_pair.second;
+		slim_popsize_t subpop_size = subpop->CurrentSubpopSize();
+		std::vector<Individual *> &individuals = subpop->CurrentIndividuals();
+		
+		if (spatial_output_count)
+		{
+			std::vector<double> column(subpop_size);
 			
-#ifdef SLIM_NONWF_ONLY
-			// Output individual age information before the mutation list.  Added in version 4.
-			if (age_output_count && ((i % 2) == 0))
+			for (int spatial_index = 0; spatial_index < spatial_output_count; ++spatial_index)
 			{
-				int individual_index = i / 2;
-				Individual &individual = *(subpop->CurrentIndividuals()[individual_index]);
+				for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+				{
+					Individual *individual = individuals[individual_index];
+					
+					column[individual_index] = ((spatial_index == 0) ? individual->spatial_x_ : ((spatial_index == 1) ? individual->spatial_y_ : individual->spatial_z_));
+				}
 				
-				p_out.write(reinterpret_cast<char *>(&individual.age_), sizeof individual.age_);
+				p_out.write(reinterpret_cast<const char *>(column.data()), subpop_size * sizeof(double));
 			}
+		}
+		
+		if (pedigree_output_count)
+		{
+			std::vector<slim_pedigreeid_t> column(subpop_size);
+			
+			for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+				column[individual_index] = individuals[individual_index]->PedigreeID();
+			
+			p_out.write(reinterpret_cast<const char *>(column.data()), subpop_size * sizeof(slim_pedigreeid_t));
+		}
+		
+#ifdef SLIM_NONWF_ONLY
+		if (age_output_count)
+		{
+			std::vector<slim_age_t> column(subpop_size);
+			
+			for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+				column[individual_index] = individuals[individual_index]->age_;
+			
+			p_out.write(reinterpret_cast<const char *>(column.data()), subpop_size * sizeof(slim_age_t));
+		}
 #endif  // SLIM_NONWF_ONLY
+	}
+	
+	// Write a tag indicating the section has ended
+	p_out.write(reinterpret_cast<char *>(&section_end_tag), sizeof section_end_tag);
+	
+	// Genomes section
+	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)			// go through all subpopulations
+	{
+		Subpopulation *subpop = subpop_pair.second;
+		slim_objectid_t subpop_id = subpop_pair.first;
+		slim_popsize_t subpop_size = subpop->CurrentSubpopSize();
+		
+		for (slim_popsize_t i = 0; i < 2 * subpop_size; i++)							// go through all children
+		{
+			Genome &genome = *(subpop->CurrentGenomes()[i]);
+			
+			// Write out the genome header; start with the genome type to guarantee that the first 32 bits are != section_end_tag
+			int32_t genome_type = (int32_t)(genome.Type());
+			
+			p_out.write(reinterpret_cast<char *>(&genome_type), sizeof genome_type);
+			p_out.write(reinterpret_cast<char *>(&subpop_id), sizeof subpop_id);
+			p_out.write(reinterpret_cast<char *>(&i), sizeof i);
 			
-			// Write out the mutation list
+			// Write out the mutation run list; individual information was written in the individuals section above, as of version 7
 			if (genome.IsNull())
 			{
-				// null genomes get a 32-bit flag value written instead of a mutation count
+				// null genomes get a 32-bit flag value written instead of a mutation run count
 				int32_t null_genome_tag = 0xFFFF1000;
 				
 				p_out.write(reinterpret_cast<char *>(&null_genome_tag), sizeof null_genome_tag);
 			}
 			else
 			{
-				// write a 32-bit mutation count
-				{
-					int32_t total_mutations = genome.mutation_count();
-					
-					p_out.write(reinterpret_cast<char *>(&total_mutations), sizeof total_mutations);
-				}
+				// write a 32-bit mutation run count, followed by the 32-bit index in the mutation run table of each run
+				int32_t mutrun_count = genome.mutrun_count_;
 				
-				if (use_16_bit)
-				{
-					// Write out 16-bit mutation tags
-					int mutrun_count = genome.mutrun_count_;
-					
-					for (int run_index = 0; run_index < mutrun_count; ++run_index)
-					{
-						MutationRun *mutrun = genome.mutruns_[run_index].get();
-						int mut_count = mutrun->size();
-						const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-						
-						for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-						{
-							slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-							
-							if (polymorphism_id == -1)
-								EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) polymorphism not found." << EidosTerminate();
-							
-							if (polymorphism_id <= UINT16_MAX - 1)
-							{
-								uint16_t id_16 = (uint16_t)polymorphism_id;
-								
-								p_out.write(reinterpret_cast<char *>(&id_16), sizeof id_16);
-							}
-							else
-							{
-								EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) mutation id out of 16-bit bounds." << EidosTerminate();
-							}
-						}
-					}
-				}
-				else
+				p_out.write(reinterpret_cast<char *>(&mutrun_count), sizeof mutrun_count);
+				
+				for (int run_index = 0; run_index < mutrun_count; ++run_index)
 				{
-					// Write out 32-bit mutation tags
-					int mutrun_count = genome.mutrun_count_;
+					int32_t mutrun_table_index = mutrun_table_indices.find(genome.mutruns_[run_index].get())->second;
 					
-					for (int run_index = 0; run_index < mutrun_count; ++run_index)
-					{
-						MutationRun *mutrun = genome.mutruns_[run_index].get();
-						int mut_count = mutrun->size();
-						const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-						
-						for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-						{
-							slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-							
-							if (polymorphism_id == -1)
-								EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) polymorphism not found." << EidosTerminate();
-							
-							p_out.write(reinterpret_cast<char *>(&polymorphism_id), sizeof polymorphism_id);
-						}
-					}
+					p_out.write(reinterpret_cast<char *>(&mutrun_table_index), sizeof mutrun_table_index);
 				}
 				
 				// now will come either a genome type (32 bits: 0, 1, or 2), or a section end tag
@@ -16,6 +16,7 @@
 #include "slim_sim.h"
 #include "interaction_type.h"
 #include "subpopulation.h"
+#include "eidos_rng.h"
 
 #include "errno.h"
 #include "string.h"
@@ -939,6 +940,12 @@ SLiMEidosBlock::SLiMEidosBlock(slim_objectid_t p_id, const std::string &p_script
 
 SLiMEidosBlock::~SLiMEidosBlock(void)
 {
+	delete callback_frame_;
+	callback_frame_ = nullptr;
+	
+	delete compiled_callback_;
+	compiled_callback_ = nullptr;
+	
 	delete script_;
 }
 
@@ -1065,6 +1072,586 @@ void SLiMEidosBlock::ScanTreeForIdentifiersUsed(void)
 	}
 }
 
+bool SLiMEidosBlock::_NodeIsVectorizable(const EidosASTNode *p_node)
+{
+	const EidosToken *token = p_node->token_;
+	
+	switch (token->token_type_)
+	{
+		case EidosTokenType::kTokenNumber:
+			return !!p_node->cached_literal_value_;
+			
+		case EidosTokenType::kTokenIdentifier:
+		{
+			// constant identifiers such as T and PI are cached as literals; callback parameters are bound by the caller
+			if (p_node->cached_literal_value_)
+				return true;
+			
+			EidosGlobalStringID symbol_id = p_node->cached_stringID_;
+			
+			if ((symbol_id == gID_mut) || (symbol_id == gID_relFitness) || (symbol_id == gID_homozygous) || (symbol_id == gID_individual) ||
+				(symbol_id == gID_genome1) || (symbol_id == gID_genome2) || (symbol_id == gID_subpop) || (symbol_id == gID_self))
+				return true;
+			
+			// any other identifier has the same value for every invocation, and must be checked to be a singleton before vectorizing
+			if (std::find(vectorized_uniform_ids_.begin(), vectorized_uniform_ids_.end(), symbol_id) == vectorized_uniform_ids_.end())
+				vectorized_uniform_ids_.emplace_back(symbol_id);
+			
+			return true;
+		}
+			
+		case EidosTokenType::kTokenDot:
+		{
+			// a property of a callback parameter, or of sim, that is a logical/integer/float singleton for each element
+			if (p_node->children_.size() != 2)
+				return false;
+			
+			const EidosASTNode *target_node = p_node->children_[0];
+			const EidosASTNode *property_node = p_node->children_[1];
+			
+			if ((target_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || (property_node->token_->token_type_ != EidosTokenType::kTokenIdentifier))
+				return false;
+			
+			EidosGlobalStringID target_id = target_node->cached_stringID_;
+			const EidosClass *target_class;
+			
+			if (target_id == gID_individual)
+				target_class = gSLiM_Individual_Class;
+			else if ((target_id == gID_genome1) || (target_id == gID_genome2))
+				target_class = gSLiM_Genome_Class;
+			else if ((target_id == gID_mut) && (type_ == SLiMEidosBlockType::SLiMEidosFitnessCallback))
+				target_class = gSLiM_Mutation_Class;
+			else if (target_id == gID_subpop)
+				target_class = gSLiM_Subpopulation_Class;
+			else if (target_id == gID_self)
+				target_class = gSLiM_SLiMEidosBlock_Class;
+			else if (target_id == gID_sim)
+				target_class = gSLiM_SLiMSim_Class;
+			else
+				return false;
+			
+			const EidosPropertySignature *signature = target_class->SignatureForProperty(property_node->cached_stringID_);
+			
+			if (!signature || !(signature->value_mask_ & kEidosValueMaskSingleton))
+				return false;
+			
+			EidosValueMask value_mask = (signature->value_mask_ & kEidosValueMaskFlagStrip);
+			
+			return ((value_mask == kEidosValueMaskLogical) || (value_mask == kEidosValueMaskInt) || (value_mask == kEidosValueMaskFloat));
+		}
+			
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenExp:
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		case EidosTokenType::kTokenNot:
+		{
+			// operators work element by element, recycling singletons
+			for (const EidosASTNode *child : p_node->children_)
+				if (!_NodeIsVectorizable(child))
+					return false;
+			
+			return true;
+		}
+			
+		case EidosTokenType::kTokenLParen:
+		{
+			// a call to a one-argument math function that works element by element
+			if (p_node->children_.size() != 2)
+				return false;
+			
+			const EidosASTNode *name_node = p_node->children_[0];
+			const EidosASTNode *argument_node = p_node->children_[1];
+			
+			if ((name_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || (argument_node->token_->token_type_ == EidosTokenType::kTokenAssign))
+				return false;
+			
+			const std::string &function_name = name_node->token_->token_string_;
+			
+			if ((function_name != "abs") && (function_name != "exp") && (function_name != "log") && (function_name != "log10") && (function_name != "log2") &&
+				(function_name != "sqrt") && (function_name != "floor") && (function_name != "ceil") && (function_name != "round") && (function_name != "trunc") &&
+				(function_name != "asFloat"))
+				return false;
+			
+			return _NodeIsVectorizable(argument_node);
+		}
+			
+		default:
+			return false;
+	}
+}
+
+void SLiMEidosBlock::ScanTreeForVectorization(void)
+{
+	// A fitness() callback is vectorizable if its body is { return <expr>; }, where <expr> is built only from numeric literals,
+	// identifiers, singleton-valued numeric properties of its parameters, element-wise operators, and element-wise math functions.
+	// Such a callback has no side effects, and evaluating it once with vectors bound to its per-invocation parameters (mut,
+	// relFitness, homozygous, individual, genome1, genome2) gives, element by element, exactly the results that evaluating it once
+	// per invocation would give; Subpopulation::UpdateFitness() uses that to run it once per subpopulation instead of once per call.
+	vectorizable_ = false;
+	vectorized_uniform_ids_.clear();
+	
+	if ((type_ != SLiMEidosBlockType::SLiMEidosFitnessCallback) && (type_ != SLiMEidosBlockType::SLiMEidosFitnessGlobalCallback))
+		return;
+	if (contains_wildcard_ || has_cached_optimization_ || compiled_callback_ || compound_statement_node_->cached_return_value_)
+		return;
+	
+	const EidosASTNode *base_node = compound_statement_node_;
+	
+	if ((base_node->token_->token_type_ == EidosTokenType::kTokenLBrace) && (base_node->children_.size() == 1))
+	{
+		const EidosASTNode *return_node = base_node->children_[0];
+		
+		if ((return_node->token_->token_type_ == EidosTokenType::kTokenReturn) && (return_node->children_.size() == 1))
+			vectorizable_ = _NodeIsVectorizable(return_node->children_[0]);
+	}
+	
+	if (!vectorizable_)
+		vectorized_uniform_ids_.clear();
+}
+
+
+bool SLiMEidosBlock::_CompileNode(const EidosASTNode *p_node, SLiMCompiledCallback *p_compiled, int p_depth, CompiledType *p_type)
+{
+	// Compile p_node so that its value ends up at stack position p_depth; *p_type receives its type.  Integer values can only come from
+	// literals; we do no integer arithmetic, since its overflow behavior differs, and we reject any mixing of types that Eidos would raise on.
+	std::vector<SLiMCompiledInstruction> &instructions = p_compiled->instructions_;
+	const EidosToken *token = p_node->token_;
+	EidosTokenType token_type = token->token_type_;
+	
+	if (p_depth >= SLIM_COMPILED_CALLBACK_MAX_STACK)
+		return false;
+	
+	if ((token_type == EidosTokenType::kTokenNumber) || ((token_type == EidosTokenType::kTokenIdentifier) && p_node->cached_literal_value_))
+	{
+		// numeric literals, and constants like T, PI, and INF
+		EidosValue *literal = p_node->cached_literal_value_.get();
+		
+		if (!literal || (literal->Count() != 1) || (literal->DimensionCount() != 1))
+			return false;
+		
+		switch (literal->Type())
+		{
+			case EidosValueType::kValueLogical:	*p_type = CompiledType::kLogical; break;
+			case EidosValueType::kValueInt:		*p_type = CompiledType::kInteger; break;
+			case EidosValueType::kValueFloat:	*p_type = CompiledType::kFloat; break;
+			default:							return false;
+		}
+		
+		instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kConstant, 0, literal->FloatAtIndex(0, nullptr)});
+		return true;
+	}
+	
+	switch (token_type)
+	{
+		case EidosTokenType::kTokenIdentifier:
+		{
+			EidosGlobalStringID symbol_id = p_node->cached_stringID_;
+			
+			if (symbol_id == gID_relFitness)
+			{
+				instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kRelFitness, 0, 0.0});
+				*p_type = CompiledType::kFloat;
+				return true;
+			}
+			if ((symbol_id == gID_homozygous) && (type_ == SLiMEidosBlockType::SLiMEidosFitnessCallback))
+			{
+				instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kHomozygous, 0, 0.0});
+				*p_type = CompiledType::kLogical;
+				return true;
+			}
+			return false;
+		}
+			
+		case EidosTokenType::kTokenDot:
+		{
+			if (p_node->children_.size() != 2)
+				return false;
+			
+			const EidosASTNode *target_node = p_node->children_[0];
+			const EidosASTNode *property_node = p_node->children_[1];
+			
+			if ((target_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || (property_node->token_->token_type_ != EidosTokenType::kTokenIdentifier))
+				return false;
+			
+			EidosGlobalStringID target_id = target_node->cached_stringID_;
+			EidosGlobalStringID property_id = property_node->cached_stringID_;
+			SLiMCompiledOp op;
+			
+			if ((target_id == gID_mut) && (type_ == SLiMEidosBlockType::SLiMEidosFitnessCallback) && (property_id == gID_selectionCoeff))
+				op = SLiMCompiledOp::kSelectionCoeff;
+			else if ((target_id == gID_individual) && (property_id == gID_tagF))
+				op = SLiMCompiledOp::kTagF;
+			else if ((target_id == gID_individual) && (property_id == gEidosID_x))
+				op = SLiMCompiledOp::kSpatialX;
+			else if ((target_id == gID_individual) && (property_id == gEidosID_y))
+				op = SLiMCompiledOp::kSpatialY;
+			else if ((target_id == gID_individual) && (property_id == gEidosID_z))
+				op = SLiMCompiledOp::kSpatialZ;
+			else if ((target_id == gID_individual) && (property_id == gID_fitnessScaling))
+				op = SLiMCompiledOp::kFitnessScaling;
+			else
+				return false;
+			
+			instructions.emplace_back(SLiMCompiledInstruction{op, 0, 0.0});
+			*p_type = CompiledType::kFloat;
+			return true;
+		}
+			
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenExp:
+		{
+			CompiledType type1, type2;
+			
+			if (p_node->children_.size() == 1)
+			{
+				// unary plus and minus; negating an integer literal cannot overflow
+				if ((token_type != EidosTokenType::kTokenPlus) && (token_type != EidosTokenType::kTokenMinus))
+					return false;
+				if (!_CompileNode(p_node->children_[0], p_compiled, p_depth, &type1) || (type1 == CompiledType::kLogical))
+					return false;
+				
+				if (token_type == EidosTokenType::kTokenMinus)
+					instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kNegate, 0, 0.0});
+				
+				*p_type = type1;
+				return true;
+			}
+			
+			if (p_node->children_.size() != 2)
+				return false;
+			if (!_CompileNode(p_node->children_[0], p_compiled, p_depth, &type1) || (type1 == CompiledType::kLogical))
+				return false;
+			if (!_CompileNode(p_node->children_[1], p_compiled, p_depth + 1, &type2) || (type2 == CompiledType::kLogical))
+				return false;
+			
+			SLiMCompiledOp op;
+			
+			switch (token_type)
+			{
+				case EidosTokenType::kTokenPlus:	op = SLiMCompiledOp::kPlus; break;
+				case EidosTokenType::kTokenMinus:	op = SLiMCompiledOp::kMinus; break;
+				case EidosTokenType::kTokenMult:	op = SLiMCompiledOp::kMult; break;
+				case EidosTokenType::kTokenDiv:		op = SLiMCompiledOp::kDiv; break;
+				default:							op = SLiMCompiledOp::kExp; break;
+			}
+			
+			// / and ^ always produce float; +, -, and * produce integer for two integers, which we don't do
+			if ((op == SLiMCompiledOp::kPlus) || (op == SLiMCompiledOp::kMinus) || (op == SLiMCompiledOp::kMult))
+				if ((type1 == CompiledType::kInteger) && (type2 == CompiledType::kInteger))
+					return false;
+			
+			instructions.emplace_back(SLiMCompiledInstruction{op, 0, 0.0});
+			*p_type = CompiledType::kFloat;
+			return true;
+		}
+			
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+		{
+			CompiledType type1, type2;
+			
+			if (p_node->children_.size() != 2)
+				return false;
+			if (!_CompileNode(p_node->children_[0], p_compiled, p_depth, &type1))
+				return false;
+			if (!_CompileNode(p_node->children_[1], p_compiled, p_depth + 1, &type2))
+				return false;
+			
+			// compare logical with logical, or float with float/integer; integer comparisons could lose precision as doubles
+			if ((type1 == CompiledType::kLogical) != (type2 == CompiledType::kLogical))
+				return false;
+			if ((type1 == CompiledType::kInteger) && (type2 == CompiledType::kInteger))
+				return false;
+			
+			SLiMCompiledOp op;
+			
+			switch (token_type)
+			{
+				case EidosTokenType::kTokenEq:		op = SLiMCompiledOp::kEq; break;
+				case EidosTokenType::kTokenNotEq:	op = SLiMCompiledOp::kNotEq; break;
+				case EidosTokenType::kTokenLt:		op = SLiMCompiledOp::kLt; break;
+				case EidosTokenType::kTokenLtEq:	op = SLiMCompiledOp::kLtEq; break;
+				case EidosTokenType::kTokenGt:		op = SLiMCompiledOp::kGt; break;
+				default:							op = SLiMCompiledOp::kGtEq; break;
+			}
+			
+			instructions.emplace_back(SLiMCompiledInstruction{op, 0, 0.0});
+			*p_type = CompiledType::kLogical;
+			return true;
+		}
+			
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		{
+			// & and | take any number of operands, all of which we require to be logical
+			SLiMCompiledOp op = ((token_type == EidosTokenType::kTokenAnd) ? SLiMCompiledOp::kAnd : SLiMCompiledOp::kOr);
+			CompiledType child_type;
+			
+			if (p_node->children_.size() < 2)
+				return false;
+			
+			for (size_t child_index = 0; child_index < p_node->children_.size(); ++child_index)
+			{
+				if (!_CompileNode(p_node->children_[child_index], p_compiled, (child_index == 0) ? p_depth : p_depth + 1, &child_type) || (child_type != CompiledType::kLogical))
+					return false;
+				
+				if (child_index > 0)
+					instructions.emplace_back(SLiMCompiledInstruction{op, 0, 0.0});
+			}
+			
+			*p_type = CompiledType::kLogical;
+			return true;
+		}
+			
+		case EidosTokenType::kTokenNot:
+		{
+			CompiledType child_type;
+			
+			if ((p_node->children_.size() != 1) || !_CompileNode(p_node->children_[0], p_compiled, p_depth, &child_type) || (child_type != CompiledType::kLogical))
+				return false;
+			
+			instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kNot, 0, 0.0});
+			*p_type = CompiledType::kLogical;
+			return true;
+		}
+			
+		case EidosTokenType::kTokenConditional:
+		{
+			// condition ? a else b, with a logical condition and float branches; only the chosen branch is evaluated, as in Eidos
+			CompiledType condition_type, true_type, false_type;
+			
+			if (p_node->children_.size() != 3)
+				return false;
+			if (!_CompileNode(p_node->children_[0], p_compiled, p_depth, &condition_type) || (condition_type != CompiledType::kLogical))
+				return false;
+			
+			size_t jump_if_false_index = instructions.size();
+			
+			instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kJumpIfFalse, 0, 0.0});
+			
+			if (!_CompileNode(p_node->children_[1], p_compiled, p_depth, &true_type) || (true_type != CompiledType::kFloat))
+				return false;
+			
+			size_t jump_index = instructions.size();
+			
+			instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kJump, 0, 0.0});
+			instructions[jump_if_false_index].target_ = (uint32_t)instructions.size();
+			
+			if (!_CompileNode(p_node->children_[2], p_compiled, p_depth, &false_type) || (false_type != CompiledType::kFloat))
+				return false;
+			
+			instructions[jump_index].target_ = (uint32_t)instructions.size();
+			*p_type = CompiledType::kFloat;
+			return true;
+		}
+			
+		case EidosTokenType::kTokenLParen:
+		{
+			// a function call, with positional arguments only
+			if (p_node->children_.size() < 2)
+				return false;
+			
+			const EidosASTNode *name_node = p_node->children_[0];
+			
+			if (name_node->token_->token_type_ != EidosTokenType::kTokenIdentifier)
+				return false;
+			
+			for (size_t child_index = 1; child_index < p_node->children_.size(); ++child_index)
+				if (p_node->children_[child_index]->token_->token_type_ == EidosTokenType::kTokenAssign)
+					return false;
+			
+			const std::string &function_name = name_node->token_->token_string_;
+			size_t argument_count = p_node->children_.size() - 1;
+			CompiledType argument_type;
+			
+			if (function_name == "dnorm")
+			{
+				// dnorm(float x, [numeric mean = 0], [numeric sd = 1])
+				if (argument_count > 3)
+					return false;
+				if (!_CompileNode(p_node->children_[1], p_compiled, p_depth, &argument_type) || (argument_type != CompiledType::kFloat))
+					return false;
+				
+				for (size_t argument_index = 1; argument_index < 3; ++argument_index)
+				{
+					if (argument_index < argument_count)
+					{
+						if (!_CompileNode(p_node->children_[argument_index + 1], p_compiled, p_depth + (int)argument_index, &argument_type) || (argument_type == CompiledType::kLogical))
+							return false;
+					}
+					else
+					{
+						if (p_depth + (int)argument_index >= SLIM_COMPILED_CALLBACK_MAX_STACK)
+							return false;
+						
+						instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kConstant, 0, (argument_index == 1) ? 0.0 : 1.0});
+					}
+				}
+				
+				instructions.emplace_back(SLiMCompiledInstruction{SLiMCompiledOp::kDnorm, 0, 0.0});
+				*p_type = CompiledType::kFloat;
+				return true;
+			}
+			
+			// the one-argument math functions; we require a float argument, since some of them keep or reject integer arguments
+			SLiMCompiledOp op;
+			
+			if (function_name == "abs")			op = SLiMCompiledOp::kAbs;
+			else if (function_name == "exp")	op = SLiMCompiledOp::kExpFunction;
+			else if (function_name == "log")	op = SLiMCompiledOp::kLog;
+			else if (function_name == "log10")	op = SLiMCompiledOp::kLog10;
+			else if (function_name == "log2")	op = SLiMCompiledOp::kLog2;
+			else if (function_name == "sqrt")	op = SLiMCompiledOp::kSqrt;
+			else if (function_name == "floor")	op = SLiMCompiledOp::kFloor;
+			else if (function_name == "ceil")	op = SLiMCompiledOp::kCeil;
+			else if (function_name == "round")	op = SLiMCompiledOp::kRound;
+			else if (function_name == "trunc")	op = SLiMCompiledOp::kTrunc;
+			else return false;
+			
+			if ((argument_count != 1) || !_CompileNode(p_node->children_[1], p_compiled, p_depth, &argument_type) || (argument_type != CompiledType::kFloat))
+				return false;
+			
+			instructions.emplace_back(SLiMCompiledInstruction{op, 0, 0.0});
+			*p_type = CompiledType::kFloat;
+			return true;
+		}
+			
+		default:
+			return false;
+	}
+}
+
+void SLiMEidosBlock::CompileFitnessCallback(void)
+{
+	delete compiled_callback_;
+	compiled_callback_ = nullptr;
+	
+	if ((type_ != SLiMEidosBlockType::SLiMEidosFitnessCallback) && (type_ != SLiMEidosBlockType::SLiMEidosFitnessGlobalCallback))
+		return;
+	if (has_cached_optimization_ || compound_statement_node_->cached_return_value_)
+		return;
+	
+	const EidosASTNode *base_node = compound_statement_node_;
+	
+	if ((base_node->token_->token_type_ != EidosTokenType::kTokenLBrace) || (base_node->children_.size() != 1))
+		return;
+	
+	const EidosASTNode *return_node = base_node->children_[0];
+	
+	if ((return_node->token_->token_type_ != EidosTokenType::kTokenReturn) || (return_node->children_.size() != 1))
+		return;
+	
+	// the callback must return a float; anything else raises in the interpreter, so we leave it to the interpreter
+	SLiMCompiledCallback *compiled = new SLiMCompiledCallback();
+	CompiledType result_type;
+	
+	if (_CompileNode(return_node->children_[0], compiled, 0, &result_type) && (result_type == CompiledType::kFloat))
+		compiled_callback_ = compiled;
+	else
+		delete compiled;
+}
+
+bool SLiMCompiledCallback::Evaluate(double p_rel_fitness, int p_homozygous, Mutation *p_mut, Individual *p_individual, double *p_result) const
+{
+	double stack[SLIM_COMPILED_CALLBACK_MAX_STACK];
+	int sp = 0;		// the number of values on the stack
+	const SLiMCompiledInstruction *instructions = instructions_.data();
+	size_t instruction_count = instructions_.size();
+	size_t pc = 0;
+	
+	while (pc < instruction_count)
+	{
+		const SLiMCompiledInstruction &instruction = instructions[pc++];
+		
+		switch (instruction.op_)
+		{
+			case SLiMCompiledOp::kConstant:			stack[sp++] = instruction.constant_; break;
+			case SLiMCompiledOp::kRelFitness:		stack[sp++] = p_rel_fitness; break;
+			case SLiMCompiledOp::kHomozygous:
+				if (p_homozygous == -1)
+					return false;
+				stack[sp++] = (p_homozygous ? 1.0 : 0.0);
+				break;
+			case SLiMCompiledOp::kSelectionCoeff:	stack[sp++] = p_mut->selection_coeff_; break;
+			case SLiMCompiledOp::kTagF:
+			{
+				double tagF_value = p_individual->tagF_value_;
+				
+				if (tagF_value == SLIM_TAGF_UNSET_VALUE)
+					return false;
+				stack[sp++] = tagF_value;
+				break;
+			}
+			case SLiMCompiledOp::kSpatialX:			stack[sp++] = p_individual->spatial_x_; break;
+			case SLiMCompiledOp::kSpatialY:			stack[sp++] = p_individual->spatial_y_; break;
+			case SLiMCompiledOp::kSpatialZ:			stack[sp++] = p_individual->spatial_z_; break;
+			case SLiMCompiledOp::kFitnessScaling:	stack[sp++] = p_individual->fitness_scaling_; break;
+			case SLiMCompiledOp::kNegate:			stack[sp - 1] = -stack[sp - 1]; break;
+			case SLiMCompiledOp::kPlus:				sp--; stack[sp - 1] = stack[sp - 1] + stack[sp]; break;
+			case SLiMCompiledOp::kMinus:			sp--; stack[sp - 1] = stack[sp - 1] - stack[sp]; break;
+			case SLiMCompiledOp::kMult:				sp--; stack[sp - 1] = stack[sp - 1] * stack[sp]; break;
+			case SLiMCompiledOp::kDiv:				sp--; stack[sp - 1] = stack[sp - 1] / stack[sp]; break;
+			case SLiMCompiledOp::kExp:				sp--; stack[sp - 1] = pow(stack[sp - 1], stack[sp]); break;
+			case SLiMCompiledOp::kEq:				sp--; stack[sp - 1] = ((stack[sp - 1] == stack[sp]) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kNotEq:			sp--; stack[sp - 1] = ((stack[sp - 1] != stack[sp]) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kLt:				sp--; stack[sp - 1] = ((stack[sp - 1] < stack[sp]) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kLtEq:				sp--; stack[sp - 1] = ((stack[sp - 1] <= stack[sp]) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kGt:				sp--; stack[sp - 1] = ((stack[sp - 1] > stack[sp]) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kGtEq:				sp--; stack[sp - 1] = ((stack[sp - 1] >= stack[sp]) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kAnd:				sp--; stack[sp - 1] = (((stack[sp - 1] != 0.0) && (stack[sp] != 0.0)) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kOr:				sp--; stack[sp - 1] = (((stack[sp - 1] != 0.0) || (stack[sp] != 0.0)) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kNot:				stack[sp - 1] = ((stack[sp - 1] == 0.0) ? 1.0 : 0.0); break;
+			case SLiMCompiledOp::kAbs:				stack[sp - 1] = fabs(stack[sp - 1]); break;
+			case SLiMCompiledOp::kExpFunction:		stack[sp - 1] = exp(stack[sp - 1]); break;
+			case SLiMCompiledOp::kLog:				stack[sp - 1] = log(stack[sp - 1]); break;
+			case SLiMCompiledOp::kLog10:			stack[sp - 1] = log10(stack[sp - 1]); break;
+			case SLiMCompiledOp::kLog2:				stack[sp - 1] = log2(stack[sp - 1]); break;
+			case SLiMCompiledOp::kSqrt:				stack[sp - 1] = sqrt(stack[sp - 1]); break;
+			case SLiMCompiledOp::kFloor:			stack[sp - 1] = floor(stack[sp - 1]); break;
+			case SLiMCompiledOp::kCeil:				stack[sp - 1] = ceil(stack[sp - 1]); break;
+			case SLiMCompiledOp::kRound:			stack[sp - 1] = round(stack[sp - 1]); break;
+			case SLiMCompiledOp::kTrunc:			stack[sp - 1] = trunc(stack[sp - 1]); break;
+			case SLiMCompiledOp::kDnorm:
+			{
+				double sd = stack[--sp];
+				double mean = stack[--sp];
+				
+				if (sd <= 0.0)
+					return false;
+				stack[sp - 1] = gsl_ran_gaussian_pdf(stack[sp - 1] - mean, sd);
+				break;
+			}
+			case SLiMCompiledOp::kJumpIfFalse:
+				if (stack[--sp] == 0.0)
+					pc = instruction.target_;
+				break;
+			case SLiMCompiledOp::kJump:
+				pc = instruction.target_;
+				break;
+		}
+	}
+	
+	*p_result = stack[0];
+	return true;
+}
 
 //
 //	Eidos support
@@ -1233,6 +1820,51 @@ const std::vector<EidosPropertySignature_CSP> *SLiMEidosBlock_Class::Properties(
 }
 
 
+//
+//	SLiMCallbackFrame
+//
+#pragma mark -
+#pragma mark SLiMCallbackFrame
+#pragma mark -
+
+SLiMCallbackFrame::SLiMCallbackFrame(SLiMEidosBlock *p_block, SLiMSim &p_sim) :
+	callback_symbols_(EidosSymbolTableType::kContextConstantsTable, &p_sim.SymbolTable()),
+	client_symbols_(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols_),
+	interpreter_(p_block->compound_statement_node_, client_symbols_, p_sim.FunctionMap(), &p_sim, SLIM_OUTSTREAM, SLIM_ERRSTREAM)
+{
+}
+
+void SLiMCallbackInvocation::_AcquireNewFrame(SLiMEidosBlock *p_block, SLiMSim &p_sim)
+{
+	frame_ = new SLiMCallbackFrame(p_block, p_sim);
+	
+	if (!p_block->callback_frame_)
+	{
+		// the block has no frame yet, so this frame becomes its frame for reuse
+		p_block->callback_frame_ = frame_;
+		frame_owned_ = false;
+	}
+	else
+	{
+		// the block's frame is in use by an enclosing invocation, so this frame is temporary
+		frame_owned_ = true;
+	}
+}
+
+SLiMCallbackInvocation::~SLiMCallbackInvocation(void)
+{
+	// empty the tables, releasing the callback's parameters and local variables; the parameters may be stack-allocated
+	// values in the caller, so this must happen before the caller's scope ends, which our declaration order guarantees
+	frame_->client_symbols_.RemoveAllSymbols();
+	frame_->callback_symbols_.RemoveAllSymbols();
+	
+	if (frame_owned_)
+		delete frame_;
+	else
+		frame_->in_use_ = false;
+}
+
+
 //
 //	SLiMTypeTable
 //
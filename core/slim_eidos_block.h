@@ -34,6 +34,14 @@
 #include "eidos_functions.h"
 #include "eidos_type_table.h"
 #include "eidos_type_interpreter.h"
+#include "eidos_interpreter.h"
+#include "eidos_symbol_table.h"
+
+
+class SLiMSim;
+class SLiMCallbackFrame;
+class Mutation;
+class Individual;
 
 
 enum class SLiMEidosBlockType {
@@ -101,6 +109,76 @@ public:
 };
 
 
+#pragma mark -
+#pragma mark SLiMCompiledCallback
+#pragma mark -
+
+// SLiMCompiledCallback is a fitness() callback body of the form { return <expr>; } compiled to a postfix program over a stack of doubles,
+// so it can be run natively instead of by the interpreter.  The expression may use numeric literals, relFitness, homozygous, the properties
+// mut.selectionCoeff, individual.tagF, individual.x/y/z, and individual.fitnessScaling, arithmetic/comparison/logical operators, the ternary
+// conditional, and the math functions abs(), exp(), log(), log10(), log2(), sqrt(), floor(), ceil(), round(), trunc(), and dnorm(); logical
+// values are held as 0.0/1.0.  Compilation rejects anything whose result type or value could differ from the interpreter's, and Evaluate()
+// returns false (a "bail") for inputs the interpreter would raise on, such as an unset tagF or a NULL homozygous, so that the caller can run
+// the interpreter instead and get exactly the same error.  See SLiMEidosBlock::CompileFitnessCallback().
+#define SLIM_COMPILED_CALLBACK_MAX_STACK	32
+
+enum class SLiMCompiledOp : uint8_t {
+	kConstant = 0,			// push constant_
+	kRelFitness,			// push relFitness
+	kHomozygous,			// push homozygous; bails if it is NULL
+	kSelectionCoeff,		// push mut.selectionCoeff
+	kTagF,					// push individual.tagF; bails if it is unset
+	kSpatialX,				// push individual.x
+	kSpatialY,				// push individual.y
+	kSpatialZ,				// push individual.z
+	kFitnessScaling,		// push individual.fitnessScaling
+	kNegate,				// unary minus
+	kPlus,					// binary operators pop two values and push one
+	kMinus,
+	kMult,
+	kDiv,
+	kExp,
+	kEq,
+	kNotEq,
+	kLt,
+	kLtEq,
+	kGt,
+	kGtEq,
+	kAnd,
+	kOr,
+	kNot,
+	kAbs,					// one-argument math functions replace the top value
+	kExpFunction,
+	kLog,
+	kLog10,
+	kLog2,
+	kSqrt,
+	kFloor,
+	kCeil,
+	kRound,
+	kTrunc,
+	kDnorm,					// pop sd, mean, and x, push dnorm(x, mean, sd); bails if sd <= 0
+	kJumpIfFalse,			// pop a value, and jump to target_ if it is 0.0
+	kJump					// jump to target_
+};
+
+struct SLiMCompiledInstruction
+{
+	SLiMCompiledOp op_;
+	uint32_t target_;						// the instruction index jumped to by kJumpIfFalse and kJump
+	double constant_;						// the value pushed by kConstant
+};
+
+class SLiMCompiledCallback
+{
+public:
+	std::vector<SLiMCompiledInstruction> instructions_;
+	
+	// Run the program; returns false if execution bails, in which case the callback must be run by the interpreter
+	bool Evaluate(double p_rel_fitness, int p_homozygous, Mutation *p_mut, Individual *p_individual, double *p_result) const;
+};
+
+
 #pragma mark -
 #pragma mark SLiMEidosBlock
 #pragma mark -
@@ -189,6 +267,16 @@ public:
 	double cached_opt_C_ = 0.0;
 	double cached_opt_D_ = 0.0;
 	
+	// A native compiled form of a fitness() callback that no special case above handles; see SLiMCompiledCallback
+	SLiMCompiledCallback *compiled_callback_ = nullptr;			// OWNED
+	
+	// Vectorization of fitness() callbacks; see ScanTreeForVectorization() and Subpopulation::UpdateFitness()
+	bool vectorizable_ = false;									// T if the callback can be evaluated over vectors of its parameters at once
+	std::vector<EidosGlobalStringID> vectorized_uniform_ids_;	// other identifiers the callback uses; they must be singletons for it to be vectorized
+	
+	// A prebuilt interpreter and symbol table pair for executing this block as a callback, created on first use; see SLiMCallbackInvocation
+	SLiMCallbackFrame *callback_frame_ = nullptr;				// OWNED
+	
 	
 	SLiMEidosBlock(const SLiMEidosBlock&) = delete;					// no copying
 	SLiMEidosBlock& operator=(const SLiMEidosBlock&) = delete;		// no copying
@@ -205,6 +293,15 @@ public:
 	void _ScanNodeForIdentifiersUsed(const EidosASTNode *p_scan_node);
 	void ScanTreeForIdentifiersUsed(void);
 	
+	// Compile a fitness() callback to native code if possible, called by SLiMSim::OptimizeScriptBlock()
+	enum class CompiledType { kFloat, kInteger, kLogical };
+	bool _CompileNode(const EidosASTNode *p_node, SLiMCompiledCallback *p_compiled, int p_depth, CompiledType *p_type);
+	void CompileFitnessCallback(void);
+	
+	// Determine whether a fitness() callback is vectorizable, called by SLiMSim::OptimizeScriptBlock()
+	bool _NodeIsVectorizable(const EidosASTNode *p_node);
+	void ScanTreeForVectorization(void);
+	
 	//
 	// Eidos support
 	//
@@ -218,6 +315,76 @@ public:
 	virtual void SetProperty(EidosGlobalStringID p_property_id, const EidosValue &p_value) override;
 };
 
+// SLiMCallbackFrame is the execution state for one invocation of a callback block: a constants table for the callback's
+// parameters (self, mut, individual, etc.), chained to the simulation's constants, a local variables table below it, and an
+// interpreter for the block's compound statement.  Constructing and tearing these down for every fitness(), mateChoice(),
+// modifyChild(), or interaction() invocation is a substantial fraction of the cost of a short callback, so each block keeps
+// one frame (callback_frame_) that is reused; the tables are emptied in place after each invocation, without returning
+// their lookup tables to the pool, so the next invocation just rebinds the parameter slots it uses.
+class SLiMCallbackFrame
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+	
+public:
+	
+	EidosSymbolTable callback_symbols_;		// kContextConstantsTable: the callback's parameters
+	EidosSymbolTable client_symbols_;		// kLocalVariablesTable: variables defined by the callback
+	EidosInterpreter interpreter_;
+	bool in_use_ = false;					// true while an invocation is using the frame; a reentrant invocation gets a temporary frame
+	
+	SLiMCallbackFrame(const SLiMCallbackFrame&) = delete;					// no copying
+	SLiMCallbackFrame& operator=(const SLiMCallbackFrame&) = delete;		// no copying
+	SLiMCallbackFrame(void) = delete;										// no null construction
+	
+	SLiMCallbackFrame(SLiMEidosBlock *p_block, SLiMSim &p_sim);
+};
+
+// SLiMCallbackInvocation is a stack object that borrows a block's SLiMCallbackFrame for the duration of one callback
+// invocation.  The caller binds the callback's parameters into CallbackSymbols() with InitializeConstantSymbolEntry(),
+// exactly as it would for freshly constructed tables, and runs Interpreter(); at the end of the scope, both tables are
+// emptied and the frame is returned to the block.  If the block's frame is already in use (because the callback has been
+// reentered, which SLiM mostly prohibits, but which we handle defensively), a temporary frame is made and freed instead.
+class SLiMCallbackInvocation
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+	
+private:
+	
+	SLiMCallbackFrame *frame_;
+	bool frame_owned_;						// true if frame_ is a temporary frame that we own, rather than the block's frame
+	
+	void _AcquireNewFrame(SLiMEidosBlock *p_block, SLiMSim &p_sim);
+	
+public:
+	
+	SLiMCallbackInvocation(const SLiMCallbackInvocation&) = delete;					// no copying
+	SLiMCallbackInvocation& operator=(const SLiMCallbackInvocation&) = delete;		// no copying
+	SLiMCallbackInvocation(void) = delete;											// no null construction
+	
+	inline SLiMCallbackInvocation(SLiMEidosBlock *p_block, SLiMSim &p_sim)
+	{
+		SLiMCallbackFrame *frame = p_block->callback_frame_;
+		
+		if (frame && !frame->in_use_)
+		{
+			frame_ = frame;
+			frame_owned_ = false;
+		}
+		else
+		{
+			_AcquireNewFrame(p_block, p_sim);
+		}
+		
+		frame_->in_use_ = true;
+	}
+	
+	~SLiMCallbackInvocation(void);
+	
+	inline __attribute__((always_inline)) EidosSymbolTable &CallbackSymbols(void) { return frame_->callback_symbols_; }
+	inline __attribute__((always_inline)) EidosSymbolTable &ClientSymbols(void) { return frame_->client_symbols_; }
+	inline __attribute__((always_inline)) EidosInterpreter &Interpreter(void) { return frame_->interpreter_; }
+};
+
 class SLiMEidosBlock_Class : public EidosClass
 {
 private:
@@ -39,6 +39,8 @@
 
 #include <string>
 #include <vector>
+#include <cerrno>
+#include <cstdlib>
 
 #include "json.hpp"
 
@@ -485,6 +487,77 @@ slim_objectid_t SLiM_ExtractObjectIDFromEidosValue_is(EidosValue *p_value, int p
 	return (p_value->Type() == EidosValueType::kValueInt) ? SLiMCastToObjectidTypeOrRaise(p_value->IntAtIndex(p_index, nullptr)) : SLiMEidosScript::ExtractIDFromStringWithPrefix(p_value->StringAtIndex(p_index, nullptr), p_prefix_char, nullptr);
 }
 
+int64_t SLiM_NonnegativeIntegerForChars(const char *p_start, const char *p_end)
+{
+	size_t length = (size_t)(p_end - p_start);
+	
+	// up to 18 digits cannot overflow int64_t, so we can convert those directly
+	if ((length >= 1) && (length <= 18))
+	{
+		int64_t value = 0;
+		const char *p = p_start;
+		
+		for ( ; p < p_end; ++p)
+		{
+			char ch = *p;
+			
+			if ((ch < '0') || (ch > '9'))
+				break;
+			
+			value = value * 10 + (ch - '0');
+		}
+		
+		if (p == p_end)
+			return value;
+	}
+	
+	return EidosInterpreter::NonnegativeIntegerForString(std::string(p_start, p_end), nullptr);
+}
+
+double SLiM_FloatForChars(const char *p_start, const char *p_end)
+{
+	if (p_end > p_start)
+	{
+		char *last_used_char = nullptr;
+		
+		errno = 0;
+		
+		double converted_value = strtod(p_start, &last_used_char);
+		
+		if (!errno && (last_used_char == p_end))
+			return converted_value;
+	}
+	
+	return EidosInterpreter::FloatForString(std::string(p_start, p_end), nullptr);
+}
+
+slim_objectid_t SLiM_ExtractIDFromCharsWithPrefix(const char *p_start, const char *p_end, char p_prefix_char)
+{
+	size_t length = (size_t)(p_end - p_start);
+	
+	// an id of up to 9 digits cannot overflow, but it still needs to be range-checked against SLIM_MAX_ID_VALUE
+	if ((length >= 2) && (length <= 10) && (*p_start == p_prefix_char))
+	{
+		int64_t value = 0;
+		const char *p = p_start + 1;
+		
+		for ( ; p < p_end; ++p)
+		{
+			char ch = *p;
+			
+			if ((ch < '0') || (ch > '9'))
+				break;
+			
+			value = value * 10 + (ch - '0');
+		}
+		
+		if ((p == p_end) && (value <= SLIM_MAX_ID_VALUE))
+			return static_cast<slim_objectid_t>(value);
+	}
+	
+	return SLiMEidosScript::ExtractIDFromStringWithPrefix(std::string(p_start, p_end), p_prefix_char, nullptr);
+}
+
 MutationType *SLiM_ExtractMutationTypeFromEidosValue_io(EidosValue *p_value, int p_index, SLiMSim &p_sim, const char *p_method_name)
 {
 	if (p_value->Type() == EidosValueType::kValueInt)
@@ -1233,6 +1306,7 @@ const std::string &gStr_addSubpop = EidosRegisteredString("addSubpop", gID_addSu
 const std::string &gStr_addSubpopSplit = EidosRegisteredString("addSubpopSplit", gID_addSubpopSplit);
 const std::string &gStr_deregisterScriptBlock = EidosRegisteredString("deregisterScriptBlock", gID_deregisterScriptBlock);
 const std::string &gStr_individualsWithPedigreeIDs = EidosRegisteredString("individualsWithPedigreeIDs", gID_individualsWithPedigreeIDs);
+const std::string &gStr_kinship = EidosRegisteredString("kinship", gID_kinship);
 const std::string &gStr_mutationCounts = EidosRegisteredString("mutationCounts", gID_mutationCounts);
 const std::string &gStr_mutationCountsInGenomes = EidosRegisteredString("mutationCountsInGenomes", gID_mutationCountsInGenomes);
 const std::string &gStr_mutationFrequencies = EidosRegisteredString("mutationFrequencies", gID_mutationFrequencies);
@@ -1263,6 +1337,8 @@ const std::string &gStr_treeSeqCoalesced = EidosRegisteredString("treeSeqCoalesc
 const std::string &gStr_treeSeqSimplify = EidosRegisteredString("treeSeqSimplify", gID_treeSeqSimplify);
 const std::string &gStr_treeSeqRememberIndividuals = EidosRegisteredString("treeSeqRememberIndividuals", gID_treeSeqRememberIndividuals);
 const std::string &gStr_treeSeqOutput = EidosRegisteredString("treeSeqOutput", gID_treeSeqOutput);
+const std::string &gStr_treeSeqCheckpoint = EidosRegisteredString("treeSeqCheckpoint", gID_treeSeqCheckpoint);
+const std::string &gStr_treeSeqStatistic = EidosRegisteredString("treeSeqStatistic", gID_treeSeqStatistic);
 const std::string &gStr_setMigrationRates = EidosRegisteredString("setMigrationRates", gID_setMigrationRates);
 const std::string &gStr_pointInBounds = EidosRegisteredString("pointInBounds", gID_pointInBounds);
 const std::string &gStr_pointReflected = EidosRegisteredString("pointReflected", gID_pointReflected);
@@ -1293,6 +1369,7 @@ const std::string &gStr_outputVCFSample = EidosRegisteredString("outputVCFSample
 const std::string &gStr_outputSample = EidosRegisteredString("outputSample", gID_outputSample);
 const std::string &gStr_outputMS = EidosRegisteredString("outputMS", gID_outputMS);
 const std::string &gStr_outputVCF = EidosRegisteredString("outputVCF", gID_outputVCF);
+const std::string &gStr_outputGenotypeMatrix = EidosRegisteredString("outputGenotypeMatrix", gID_outputGenotypeMatrix);
 const std::string &gStr_output = EidosRegisteredString("output", gID_output);
 const std::string &gStr_evaluate = EidosRegisteredString("evaluate", gID_evaluate);
 const std::string &gStr_distance = EidosRegisteredString("distance", gID_distance);
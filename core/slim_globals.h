@@ -268,6 +268,13 @@ GenomicElementType *SLiM_ExtractGenomicElementTypeFromEidosValue_io(EidosValue *
 Subpopulation *SLiM_ExtractSubpopulationFromEidosValue_io(EidosValue *p_value, int p_index, SLiMSim &p_sim, const char *p_method_name);
 SLiMEidosBlock *SLiM_ExtractSLiMEidosBlockFromEidosValue_io(EidosValue *p_value, int p_index, SLiMSim &p_sim, const char *p_method_name);
 
+// Conversions from a range of characters in memory, used by the text file readers to avoid making a std::string for every field.
+// These handle the common well-formed cases directly, and fall back to the standard Eidos/SLiM conversions (and their errors) otherwise.
+// The character at p_end must not continue the field (it should be whitespace, a delimiter, or a NUL), since strtod() may look at it.
+int64_t SLiM_NonnegativeIntegerForChars(const char *p_start, const char *p_end);
+double SLiM_FloatForChars(const char *p_start, const char *p_end);
+slim_objectid_t SLiM_ExtractIDFromCharsWithPrefix(const char *p_start, const char *p_end, char p_prefix_char);
+
 
 // *******************************************************************************************************************
 //
@@ -721,6 +728,7 @@ extern const std::string &gStr_addSubpop;
 extern const std::string &gStr_addSubpopSplit;
 extern const std::string &gStr_deregisterScriptBlock;
 extern const std::string &gStr_individualsWithPedigreeIDs;
+extern const std::string &gStr_kinship;
 extern const std::string &gStr_mutationCounts;
 extern const std::string &gStr_mutationCountsInGenomes;
 extern const std::string &gStr_mutationFrequencies;
@@ -751,6 +759,8 @@ extern const std::string &gStr_treeSeqCoalesced;
 extern const std::string &gStr_treeSeqSimplify;
 extern const std::string &gStr_treeSeqRememberIndividuals;
 extern const std::string &gStr_treeSeqOutput;
+extern const std::string &gStr_treeSeqCheckpoint;
+extern const std::string &gStr_treeSeqStatistic;
 extern const std::string &gStr_setMigrationRates;
 extern const std::string &gStr_pointInBounds;
 extern const std::string &gStr_pointReflected;
@@ -781,6 +791,7 @@ extern const std::string &gStr_outputVCFSample;
 extern const std::string &gStr_outputSample;
 extern const std::string &gStr_outputMS;
 extern const std::string &gStr_outputVCF;
+extern const std::string &gStr_outputGenotypeMatrix;
 extern const std::string &gStr_output;
 extern const std::string &gStr_evaluate;
 extern const std::string &gStr_distance;
@@ -1064,6 +1075,7 @@ enum _SLiMGlobalStringID : int {
 	gID_addSubpopSplit,
 	gID_deregisterScriptBlock,
 	gID_individualsWithPedigreeIDs,
+	gID_kinship,
 	gID_mutationCounts,
 	gID_mutationCountsInGenomes,
 	gID_mutationFrequencies,
@@ -1094,6 +1106,8 @@ enum _SLiMGlobalStringID : int {
 	gID_treeSeqSimplify,
 	gID_treeSeqRememberIndividuals,
 	gID_treeSeqOutput,
+	gID_treeSeqCheckpoint,
+	gID_treeSeqStatistic,
 	gID_setMigrationRates,
 	gID_pointInBounds,
 	gID_pointReflected,
@@ -1124,6 +1138,7 @@ enum _SLiMGlobalStringID : int {
 	gID_outputSample,
 	gID_outputMS,
 	gID_outputVCF,
+	gID_outputGenotypeMatrix,
 	gID_output,
 	gID_evaluate,
 	gID_distance,
@@ -38,6 +38,7 @@
 #include <typeinfo>
 #include <memory>
 #include <string>
+#include <cstring>
 #include <utility>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -46,6 +47,7 @@
 #include <unordered_map>
 #include <float.h>
 #include <ctime>
+#include <random>
 
 #include "eidos_globals.h"
 #if EIDOS_ROBIN_HOOD_HASHING
@@ -273,20 +275,71 @@ void SLiMSim::InitializeFromFile(std::istream &p_infile)
 	gEidosErrorContext.executingRuntimeScript = false;
 }
 
-// get one line of input, sanitizing by removing comments and whitespace; used only by SLiMSim::InitializePopulationFromTextFile
-void GetInputLine(std::istream &p_input_file, std::string &p_line);
-void GetInputLine(std::istream &p_input_file, std::string &p_line)
+// get one line of input from a file buffer in memory, sanitizing by removing comments and whitespace; used only by SLiMSim::_InitializePopulationFromTextFile
+// the sanitized line is returned in [p_line_start, p_line_end), and p_cursor is advanced to the next line; returns false at the end of the buffer
+static bool GetInputLine(const char *&p_cursor, const char *p_buffer_end, const char *&p_line_start, const char *&p_line_end)
 {
-	getline(p_input_file, p_line);
+	if (p_cursor >= p_buffer_end)
+		return false;
+	
+	const char *line_start = p_cursor;
+	const char *line_end = (const char *)memchr(line_start, '\n', (size_t)(p_buffer_end - line_start));
+	
+	if (line_end)
+		p_cursor = line_end + 1;
+	else
+		p_cursor = line_end = p_buffer_end;
 	
 	// remove all after "//", the comment start sequence
 	// BCH 16 Dec 2014: note this was "/" in SLiM 1.8 and earlier, changed to allow full filesystem paths to be specified.
-	if (p_line.find("//") != std::string::npos)
-		p_line.erase(p_line.find("//"));
+	for (const char *slash = line_start; (slash = (const char *)memchr(slash, '/', (size_t)(line_end - slash))) != nullptr; ++slash)
+	{
+		if ((slash + 1 < line_end) && (slash[1] == '/'))
+		{
+			line_end = slash;
+			break;
+		}
+	}
+	
+	// remove leading and trailing whitespace (spaces and tabs, plus the carriage return of CRLF line endings)
+	while ((line_start < line_end) && ((*line_start == ' ') || (*line_start == '\t')))
+		line_start++;
+	while ((line_end > line_start) && ((line_end[-1] == ' ') || (line_end[-1] == '\t') || (line_end[-1] == '\r')))
+		line_end--;
+	
+	p_line_start = line_start;
+	p_line_end = line_end;
+	return true;
+}
+
+// get the next whitespace-delimited token from a line obtained with GetInputLine(), advancing p_cursor past it; returns false,
+// with an empty token at the end of the line, if no tokens remain; this replaces the use of std::istringstream for each line
+static inline bool GetInputToken(const char *&p_cursor, const char *p_line_end, const char *&p_token_start, const char *&p_token_end)
+{
+	const char *cursor = p_cursor;
+	
+	while ((cursor < p_line_end) && isspace((unsigned char)*cursor))
+		cursor++;
+	
+	p_token_start = cursor;
+	
+	while ((cursor < p_line_end) && !isspace((unsigned char)*cursor))
+		cursor++;
 	
-	// remove leading and trailing whitespace (spaces and tabs)
-	p_line.erase(0, p_line.find_first_not_of(" \t"));
-	p_line.erase(p_line.find_last_not_of(" \t") + 1);
+	p_token_end = p_cursor = cursor;
+	return (p_token_start < p_token_end);
+}
+
+static inline bool InputLineContains(const char *p_line_start, const char *p_line_end, const char *p_string)
+{
+	return (std::search(p_line_start, p_line_end, p_string, p_string + strlen(p_string)) != p_line_end);
+}
+
+static inline bool InputTokenIs(const char *p_token_start, const char *p_token_end, const char *p_string)
+{
+	size_t length = strlen(p_string);
+	
+	return ((size_t)(p_token_end - p_token_start) == length) && (memcmp(p_token_start, p_string, length) == 0);
 }
 
 SLiMFileFormat SLiMSim::FormatOfPopulationFile(const std::string &p_file_string)
@@ -372,6 +425,10 @@ SLiMFileFormat SLiMSim::FormatOfPopulationFile(const std::string &p_file_string)
 				
 				if ((file_chars[0] == '#') && (file_chars[1] == 'O') && (file_chars[2] == 'U') && (file_chars[3] == 'T'))
 					return SLiMFileFormat::kFormatSLiMText;
+				else if ((file_chars[0] == 'C') && (file_chars[1] == 'K') && (file_chars[2] == 'P') && (file_chars[3] == 'T'))
+					return SLiMFileFormat::kFormatSLiMCheckpoint;
+				else if (((unsigned char)file_chars[0] == 0x1F) && ((unsigned char)file_chars[1] == 0x8B))
+					return SLiMFileFormat::kFormatSLiMCompressed;	// gzip-compressed; the format of the decompressed contents is checked when reading
 				else if (file_endianness_tag == 0x12345678)
 					return SLiMFileFormat::kFormatSLiMBinary;
 				else if (file_endianness_tag == 0x46444889)			// 'âHDF', the prefix for HDF5 files apparently; reinterpreted via endianness
@@ -445,8 +502,36 @@ slim_generation_t SLiMSim::InitializePopulationFromFile(const std::string &p_fil
     const char *file_cstr = p_file_string.c_str();
     slim_generation_t new_generation = 0;
     
-	if ((file_format == SLiMFileFormat::kFormatSLiMText) || (file_format == SLiMFileFormat::kFormatSLiMBinary))
+	if ((file_format == SLiMFileFormat::kFormatSLiMText) || (file_format == SLiMFileFormat::kFormatSLiMBinary) || (file_format == SLiMFileFormat::kFormatSLiMCompressed))
 	{
+		// Read the whole file in one block; the readers parse it in place.  A gzip-compressed file, as written by outputFull(compress=T),
+		// is decompressed first, and its format is then determined from its leading bytes as FormatOfPopulationFile() does for other files
+		std::string file_contents;
+		
+		if (!Eidos_ReadFileContents(p_file_string, file_contents))
+			EIDOS_TERMINATION << "ERROR (SLiMSim::InitializePopulationFromFile): could not open initialization file." << EidosTerminate();
+		
+		if (file_format == SLiMFileFormat::kFormatSLiMCompressed)
+		{
+			std::string decompressed_contents;
+			int32_t endianness_tag = 0;
+			
+			if (!Eidos_GunzipContents(file_contents.data(), file_contents.length(), decompressed_contents))
+				EIDOS_TERMINATION << "ERROR (SLiMSim::InitializePopulationFromFile): could not decompress the gzip-compressed initialization file." << EidosTerminate();
+			
+			if (decompressed_contents.length() >= sizeof(endianness_tag))
+				memcpy(&endianness_tag, decompressed_contents.data(), sizeof(endianness_tag));
+			
+			if (decompressed_contents.compare(0, 4, "#OUT") == 0)
+				file_format = SLiMFileFormat::kFormatSLiMText;
+			else if (endianness_tag == 0x12345678)
+				file_format = SLiMFileFormat::kFormatSLiMBinary;
+			else
+				EIDOS_TERMINATION << "ERROR (SLiMSim::InitializePopulationFromFile): a gzip-compressed initialization file must be in SLiM's text or binary format." << EidosTerminate();
+			
+			std::swap(file_contents, decompressed_contents);
+		}
+		
 		// TREE SEQUENCE RECORDING
 		if (RecordingTreeSequence())
 		{
@@ -455,9 +540,9 @@ slim_generation_t SLiMSim::InitializePopulationFromFile(const std::string &p_fil
 		}
 		
 		if (file_format == SLiMFileFormat::kFormatSLiMText)
-			new_generation = _InitializePopulationFromTextFile(file_cstr, p_interpreter);
+			new_generation = _InitializePopulationFromTextFile(file_contents, p_interpreter);
 		else if (file_format == SLiMFileFormat::kFormatSLiMBinary)
-			new_generation = _InitializePopulationFromBinaryFile(file_cstr, p_interpreter);
+			new_generation = _InitializePopulationFromBinaryFile(file_contents, p_interpreter);
 		
 		// TREE SEQUENCE RECORDING
 		if (RecordingTreeSequence())
@@ -476,36 +561,41 @@ slim_generation_t SLiMSim::InitializePopulationFromFile(const std::string &p_fil
 		new_generation = _InitializePopulationFromTskitTextFile(file_cstr, p_interpreter);
 	else if (file_format == SLiMFileFormat::kFormatTskitBinary_kastore)
 		new_generation = _InitializePopulationFromTskitBinaryFile(file_cstr, p_interpreter);
+	else if (file_format == SLiMFileFormat::kFormatSLiMCheckpoint)
+		new_generation = _InitializePopulationFromCheckpointFile(file_cstr, p_interpreter);
 	else if (file_format == SLiMFileFormat::kFormatTskitBinary_HDF5)
 		EIDOS_TERMINATION << "ERROR (SLiMSim::InitializePopulationFromFile): msprime HDF5 binary files are not supported; that file format has been superseded by kastore." << EidosTerminate();
 	else
 		EIDOS_TERMINATION << "ERROR (SLiMSim::InitializePopulationFromFile): unrecognized format code." << EidosTerminate();
 	
+	// the pedigree store refers to individuals that no longer exist
+	if (pedigree_depth_ > 0)
+		ClearPedigreeStore();
+	
 	return new_generation;
 }
 
-slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file, EidosInterpreter *p_interpreter)
+slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const std::string &p_file_contents, EidosInterpreter *p_interpreter)
 {
 	slim_generation_t file_generation;
-	std::map<slim_polymorphismid_t,MutationIndex> mutations;
-	std::string line, sub; 
-	std::ifstream infile(p_file);
 	int age_output_count = 0;
 	bool has_individual_pedigree_IDs = false;
 	
-	if (!infile.is_open())
-		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): could not open initialization file." << EidosTerminate();
+	// All parsing below works on lines and tokens within the file buffer, without copying them
+	const char *cursor = p_file_contents.data();
+	const char *buffer_end = cursor + p_file_contents.length();
+	const char *line_start = cursor, *line_end = cursor;
+	const char *token_cursor, *token_start, *token_end;
 	
 	// Parse the first line, to get the generation
 	{
-		GetInputLine(infile, line);
-	
-		std::istringstream iss(line);
+		GetInputLine(cursor, buffer_end, line_start, line_end);
+		token_cursor = line_start;
 		
-		iss >> sub;		// #OUT:
+		GetInputToken(token_cursor, line_end, token_start, token_end);		// #OUT:
 		
-		iss >> sub;		// generation
-		int64_t generation_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);		// generation
+		int64_t generation_long = SLiM_NonnegativeIntegerForChars(token_start, token_end);
 		file_generation = SLiMCastToGenerationTypeOrRaise(generation_long);
 	}
 	
@@ -516,19 +606,17 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 	// Read and ignore initial stuff until we hit the Populations section
 	int64_t file_version = 0;	// initially unknown; we will leave this as 0 for versions < 3, for now
 	
-	while (!infile.eof())
+	while (GetInputLine(cursor, buffer_end, line_start, line_end))
 	{
-		GetInputLine(infile, line);
-		
 		// Starting in SLiM 3, we will handle a Version line if we see one in passing
-		if (line.find("Version:") != std::string::npos)
+		if (InputLineContains(line_start, line_end, "Version:"))
 		{
-			std::istringstream iss(line);
+			token_cursor = line_start;
 			
-			iss >> sub;		// Version:
-			iss >> sub;		// version number
+			GetInputToken(token_cursor, line_end, token_start, token_end);		// Version:
+			GetInputToken(token_cursor, line_end, token_start, token_end);		// version number
 			
-			file_version = (int64_t)EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+			file_version = (int64_t)SLiM_NonnegativeIntegerForChars(token_start, token_end);
 			
 			// version 5/6 are the same as 3/4 but have individual pedigree IDs; added in SLiM 3.5
 			if (file_version >= 5)
@@ -550,7 +638,7 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 			continue;
 		}
 		
-		if (line.find("Populations") != std::string::npos)
+		if (InputLineContains(line_start, line_end, "Populations"))
 			break;
 	}
 	
@@ -560,33 +648,31 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): age information is not present but the simulation is using a nonWF model; age information must be included." << EidosTerminate();
 	
 	// Now we are in the Populations section; read and instantiate each population until we hit the Mutations section
-	while (!infile.eof())
+	while (GetInputLine(cursor, buffer_end, line_start, line_end))
 	{ 
-		GetInputLine(infile, line);
-		
-		if (line.length() == 0)
+		if (line_start == line_end)
 			continue;
-		if (line.find("Mutations") != std::string::npos)
+		if (InputLineContains(line_start, line_end, "Mutations"))
 			break;
 		
-		std::istringstream iss(line);
+		token_cursor = line_start;
 		
-		iss >> sub;
-		slim_objectid_t subpop_index = SLiMEidosScript::ExtractIDFromStringWithPrefix(sub, 'p', nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);
+		slim_objectid_t subpop_index = SLiM_ExtractIDFromCharsWithPrefix(token_start, token_end, 'p');
 		
-		iss >> sub;
-		int64_t subpop_size_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);
+		int64_t subpop_size_long = SLiM_NonnegativeIntegerForChars(token_start, token_end);
 		slim_popsize_t subpop_size = SLiMCastToPopsizeTypeOrRaise(subpop_size_long);
 		
 		// SLiM 2.0 output format has <H | S <ratio>> here; if that is missing or "H" is given, the population is hermaphroditic and the ratio given is irrelevant
 		double sex_ratio = 0.0;
 		
-		if (iss >> sub)
+		if (GetInputToken(token_cursor, line_end, token_start, token_end))
 		{
-			if (sub == "S")
+			if (InputTokenIs(token_start, token_end, "S"))
 			{
-				iss >> sub;
-				sex_ratio = EidosInterpreter::FloatForString(sub, nullptr);
+				GetInputToken(token_cursor, line_end, token_start, token_end);
+				sex_ratio = SLiM_FloatForChars(token_start, token_end);
 			}
 		}
 		
@@ -602,70 +688,72 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 		simulation_constants_->InitializeConstantSymbolEntry(symbol_entry);
 	}
 	
-	// Now we are in the Mutations section; read and instantiate all mutations and add them to our map and to the registry
-	while (!infile.eof()) 
+	// Now we are in the Mutations section; read and instantiate all mutations and add them to our list and to the registry
+	std::vector<std::pair<slim_polymorphismid_t, MutationIndex>> polymorphism_pairs;
+	
+	while (GetInputLine(cursor, buffer_end, line_start, line_end))
 	{
-		GetInputLine(infile, line);
-		
-		if (line.length() == 0)
+		if (line_start == line_end)
 			continue;
-		if (line.find("Genomes") != std::string::npos)
-			break;
-		if (line.find("Individuals") != std::string::npos)	// SLiM 2.0 added this section
-			break;
+		if ((*line_start < '0') || (*line_start > '9'))		// mutation lines begin with a polymorphism id, so only other lines need to be checked
+		{
+			if (InputLineContains(line_start, line_end, "Genomes"))
+				break;
+			if (InputLineContains(line_start, line_end, "Individuals"))	// SLiM 2.0 added this section
+				break;
+		}
 		
-		std::istringstream iss(line);
+		token_cursor = line_start;
 		
-		iss >> sub;
-		int64_t polymorphismid_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);
+		int64_t polymorphismid_long = SLiM_NonnegativeIntegerForChars(token_start, token_end);
 		slim_polymorphismid_t polymorphism_id = SLiMCastToPolymorphismidTypeOrRaise(polymorphismid_long);
 		
 		// Added in version 2 output, starting in SLiM 2.1
-		iss >> sub;
+		GetInputToken(token_cursor, line_end, token_start, token_end);
 		slim_mutationid_t mutation_id;
 		
-		if (sub[0] == 'm')	// autodetect whether we are parsing version 1 or version 2 output
+		if ((token_start < token_end) && (*token_start == 'm'))	// autodetect whether we are parsing version 1 or version 2 output
 		{
 			mutation_id = polymorphism_id;		// when parsing version 1 output, we use the polymorphism id as the mutation id
 		}
 		else
 		{
-			mutation_id = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+			mutation_id = SLiM_NonnegativeIntegerForChars(token_start, token_end);
 			
-			iss >> sub;		// queue up sub for mutation_type_id
+			GetInputToken(token_cursor, line_end, token_start, token_end);		// queue up the token for mutation_type_id
 		}
 		
-		slim_objectid_t mutation_type_id = SLiMEidosScript::ExtractIDFromStringWithPrefix(sub, 'm', nullptr);
+		slim_objectid_t mutation_type_id = SLiM_ExtractIDFromCharsWithPrefix(token_start, token_end, 'm');
 		
-		iss >> sub;
-		int64_t position_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);
+		int64_t position_long = SLiM_NonnegativeIntegerForChars(token_start, token_end);
 		slim_position_t position = SLiMCastToPositionTypeOrRaise(position_long);
 		
-		iss >> sub;
-		double selection_coeff = EidosInterpreter::FloatForString(sub, nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);
+		double selection_coeff = SLiM_FloatForChars(token_start, token_end);
 		
-		iss >> sub;		// dominance coefficient, which is given in the mutation type; we check below that the value read matches the mutation type
-		double dominance_coeff = EidosInterpreter::FloatForString(sub, nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);		// dominance coefficient, which is given in the mutation type; we check below that the value read matches the mutation type
+		double dominance_coeff = SLiM_FloatForChars(token_start, token_end);
 		
-		iss >> sub;
-		slim_objectid_t subpop_index = SLiMEidosScript::ExtractIDFromStringWithPrefix(sub, 'p', nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);
+		slim_objectid_t subpop_index = SLiM_ExtractIDFromCharsWithPrefix(token_start, token_end, 'p');
 		
-		iss >> sub;
-		int64_t generation_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);
+		int64_t generation_long = SLiM_NonnegativeIntegerForChars(token_start, token_end);
 		slim_generation_t generation = SLiMCastToGenerationTypeOrRaise(generation_long);
 		
-		iss >> sub;		// prevalence, which we discard
+		GetInputToken(token_cursor, line_end, token_start, token_end);		// prevalence, which we discard
 		
 		int8_t nucleotide = -1;
-		if (iss && !iss.eof())
+		if (GetInputToken(token_cursor, line_end, token_start, token_end))
 		{
 			// fetch the nucleotide field if it is present
-			iss >> sub;
-			if (sub == "A") nucleotide = 0;
-			else if (sub == "C") nucleotide = 1;
-			else if (sub == "G") nucleotide = 2;
-			else if (sub == "T") nucleotide = 3;
-			else EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): unrecognized value '"<< sub << "' in nucleotide field." << EidosTerminate();
+			if (InputTokenIs(token_start, token_end, "A")) nucleotide = 0;
+			else if (InputTokenIs(token_start, token_end, "C")) nucleotide = 1;
+			else if (InputTokenIs(token_start, token_end, "G")) nucleotide = 2;
+			else if (InputTokenIs(token_start, token_end, "T")) nucleotide = 3;
+			else EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): unrecognized value '"<< std::string(token_start, token_end) << "' in nucleotide field." << EidosTerminate();
 		}
 		
 		// look up the mutation type from its index
@@ -689,8 +777,8 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 		
 		Mutation *new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_id, mutation_type_ptr, position, selection_coeff, subpop_index, generation, nucleotide);
 		
-		// add it to our local map, so we can find it when making genomes, and to the population's mutation registry
-		mutations.emplace(polymorphism_id, new_mut_index);
+		// add it to our local list, so we can find it when making genomes, and to the population's mutation registry
+		polymorphism_pairs.emplace_back(polymorphism_id, new_mut_index);
 		population_.MutationRegistryAdd(new_mut);
 		
 #ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
@@ -706,36 +794,65 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 		}
 	}
 	
+	// Build the lookup from polymorphism id to mutation index used by the Genomes section.  Files written by SLiM number their
+	// polymorphisms 0..N-1, so we normally use a direct-indexed table; sparse (hand-constructed) numberings fall back to a
+	// sorted list with binary search.  In both cases the first definition of a duplicated id wins, as before.
+	std::vector<MutationIndex> polymorphism_table;
+	bool polymorphism_table_is_dense = true;
+	
+	{
+		slim_polymorphismid_t max_polymorphism_id = -1;
+		
+		for (auto &polymorphism_pair : polymorphism_pairs)
+			max_polymorphism_id = std::max(max_polymorphism_id, polymorphism_pair.first);
+		
+		if ((int64_t)max_polymorphism_id < (int64_t)polymorphism_pairs.size() * 2 + 1024)
+		{
+			polymorphism_table.resize((size_t)max_polymorphism_id + 1, -1);
+			
+			for (auto &polymorphism_pair : polymorphism_pairs)
+				if (polymorphism_table[polymorphism_pair.first] == -1)
+					polymorphism_table[polymorphism_pair.first] = polymorphism_pair.second;
+		}
+		else
+		{
+			polymorphism_table_is_dense = false;
+			std::stable_sort(polymorphism_pairs.begin(), polymorphism_pairs.end(), [](const std::pair<slim_polymorphismid_t, MutationIndex> &p1, const std::pair<slim_polymorphismid_t, MutationIndex> &p2) { return p1.first < p2.first; });
+		}
+	}
+	
 	population_.cached_tally_genome_count_ = 0;
 	
 	// If there is an Individuals section (added in SLiM 2.0), we now need to parse it since it might contain spatial positions
 	if (has_individual_pedigree_IDs)
 		gSLiM_next_pedigree_id = 0;
 	
-	if (line.find("Individuals") != std::string::npos)
+	if (InputLineContains(line_start, line_end, "Individuals"))
 	{
-		while (!infile.eof()) 
+		std::vector<std::pair<const char *, const char *>> opt_params;
+		
+		while (GetInputLine(cursor, buffer_end, line_start, line_end))
 		{
-			GetInputLine(infile, line);
-			
-			if (line.length() == 0)
+			if (line_start == line_end)
 				continue;
-			if (line.find("Genomes") != std::string::npos)
+			if (InputLineContains(line_start, line_end, "Genomes"))
 				break;
 			
-			std::istringstream iss(line);
+			token_cursor = line_start;
 			
-			iss >> sub;		// pX:iY – individual identifier
-			int pos = static_cast<int>(sub.find_first_of(":"));
-			std::string &&subpop_id_string = sub.substr(0, pos);
+			GetInputToken(token_cursor, line_end, token_start, token_end);		// pX:iY – individual identifier
+			const char *colon = (const char *)memchr(token_start, ':', (size_t)(token_end - token_start));
 			
-			slim_objectid_t subpop_id = SLiMEidosScript::ExtractIDFromStringWithPrefix(subpop_id_string, 'p', nullptr);
-			std::string &&individual_index_string = sub.substr(pos + 1, std::string::npos);
+			if (!colon)
+				colon = token_end;
 			
-			if (individual_index_string[0] != 'i')
+			slim_objectid_t subpop_id = SLiM_ExtractIDFromCharsWithPrefix(token_start, colon, 'p');
+			const char *individual_index_start = colon + 1;
+			
+			if ((individual_index_start >= token_end) || (*individual_index_start != 'i'))
 				EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): reference to individual is malformed." << EidosTerminate();
 			
-			int64_t individual_index = EidosInterpreter::NonnegativeIntegerForString(individual_index_string.c_str() + 1, nullptr);
+			int64_t individual_index = SLiM_NonnegativeIntegerForChars(individual_index_start + 1, token_end);
 			
 			Subpopulation *subpop = SubpopulationWithID(subpop_id);
 			
@@ -750,8 +867,8 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 			if (has_individual_pedigree_IDs)
 			{
 				// If pedigree IDs are present use them; if not, we'll get whatever the default IDs are from the subpop construction
-				iss >> sub;
-				int64_t pedigree_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+				GetInputToken(token_cursor, line_end, token_start, token_end);
+				int64_t pedigree_long = SLiM_NonnegativeIntegerForChars(token_start, token_end);
 				slim_pedigreeid_t pedigree_id = SLiMCastToPedigreeIDOrRaise(pedigree_long);
 				
 				if (PedigreesEnabled())
@@ -763,21 +880,22 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 				}
 			}
 			
-			iss >> sub;			// individual sex identifier (F/M/H) – added in SLiM 2.1, so we need to be robust if it is missing
+			GetInputToken(token_cursor, line_end, token_start, token_end);		// individual sex identifier (F/M/H) – added in SLiM 2.1, so we need to be robust if it is missing
 			
-			if ((sub == "F") || (sub == "M") || (sub == "H"))
-				iss >> sub;
+			if (InputTokenIs(token_start, token_end, "F") || InputTokenIs(token_start, token_end, "M") || InputTokenIs(token_start, token_end, "H"))
+				GetInputToken(token_cursor, line_end, token_start, token_end);
 			
 			;					// pX:Y – genome 1 identifier, which we do not presently need to parse [already fetched]
-			iss >> sub;			// pX:Y – genome 2 identifier, which we do not presently need to parse
+			GetInputToken(token_cursor, line_end, token_start, token_end);		// pX:Y – genome 2 identifier, which we do not presently need to parse
 			
 			// Parse the optional fields at the end of each individual line.  This is a bit tricky.
 			// First we read all of the fields in, then we decide how to use them.
-			std::vector<std::string> opt_params;
 			int opt_param_count;
 			
-			while (iss >> sub)
-				opt_params.emplace_back(sub);
+			opt_params.clear();
+			
+			while (GetInputToken(token_cursor, line_end, token_start, token_end))
+				opt_params.emplace_back(token_start, token_end);
 			
 			opt_param_count = (int)opt_params.size();
 			
@@ -791,22 +909,22 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 			else if (opt_param_count == age_output_count)
 			{
 				// only age information is present
-				individual.age_ = (slim_age_t)EidosInterpreter::NonnegativeIntegerForString(opt_params[0], nullptr);			// age
+				individual.age_ = (slim_age_t)SLiM_NonnegativeIntegerForChars(opt_params[0].first, opt_params[0].second);			// age
 			}
 #endif  // SLIM_NONWF_ONLY
 			else if (opt_param_count == spatial_dimensionality_ + age_output_count)
 			{
 				// age information is present, in addition to the correct number of spatial positions
 				if (spatial_dimensionality_ >= 1)
-					individual.spatial_x_ = EidosInterpreter::FloatForString(opt_params[0], nullptr);							// spatial position x
+					individual.spatial_x_ = SLiM_FloatForChars(opt_params[0].first, opt_params[0].second);							// spatial position x
 				if (spatial_dimensionality_ >= 2)
-					individual.spatial_y_ = EidosInterpreter::FloatForString(opt_params[1], nullptr);							// spatial position y
+					individual.spatial_y_ = SLiM_FloatForChars(opt_params[1].first, opt_params[1].second);							// spatial position y
 				if (spatial_dimensionality_ >= 3)
-					individual.spatial_z_ = EidosInterpreter::FloatForString(opt_params[2], nullptr);							// spatial position z
+					individual.spatial_z_ = SLiM_FloatForChars(opt_params[2].first, opt_params[2].second);							// spatial position z
 				
 #ifdef SLIM_NONWF_ONLY
 				if (age_output_count)
-					individual.age_ = (slim_age_t)EidosInterpreter::NonnegativeIntegerForString(opt_params[spatial_dimensionality_], nullptr);		// age
+					individual.age_ = (slim_age_t)SLiM_NonnegativeIntegerForChars(opt_params[spatial_dimensionality_].first, opt_params[spatial_dimensionality_].second);		// age
 #endif  // SLIM_NONWF_ONLY
 			}
 			else
@@ -819,29 +937,25 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 	// Now we are in the Genomes section, which should take us to the end of the file unless there is an Ancestral Sequence section
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 	
-	while (!infile.eof())
+	while (GetInputLine(cursor, buffer_end, line_start, line_end))
 	{
-		GetInputLine(infile, line);
-		
-		if (line.length() == 0)
+		if (line_start == line_end)
 			continue;
-		if (line.find("Ancestral sequence") != std::string::npos)
+		if ((*line_start != 'p') && InputLineContains(line_start, line_end, "Ancestral sequence"))	// genome lines begin with a subpopulation id
 			break;
 		
-		std::istringstream iss(line);
+		token_cursor = line_start;
 		
-		iss >> sub;
-		int pos = static_cast<int>(sub.find_first_of(":"));
-		std::string &&subpop_id_string = sub.substr(0, pos);
-		slim_objectid_t subpop_id = SLiMEidosScript::ExtractIDFromStringWithPrefix(subpop_id_string, 'p', nullptr);
+		GetInputToken(token_cursor, line_end, token_start, token_end);
+		const char *colon = (const char *)memchr(token_start, ':', (size_t)(token_end - token_start));
+		slim_objectid_t subpop_id = SLiM_ExtractIDFromCharsWithPrefix(token_start, colon ? colon : token_end, 'p');
 		
 		Subpopulation *subpop = SubpopulationWithID(subpop_id);
 		
 		if (!subpop)
 			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): referenced subpopulation p" << subpop_id << " not defined." << EidosTerminate();
 		
-		sub.erase(0, pos + 1);	// remove the subpop_id and the colon
-		int64_t genome_index_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+		int64_t genome_index_long = SLiM_NonnegativeIntegerForChars(colon ? colon + 1 : token_start, token_end);		// skip the subpop_id and the colon
 		
 		if ((genome_index_long < 0) || (genome_index_long > SLIM_MAX_SUBPOP_SIZE * 2))
 			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): genome index out of permitted range." << EidosTerminate();
@@ -850,26 +964,28 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 		Genome &genome = *subpop->parent_genomes_[genome_index];
 		
 		// Now we might have [A|X|Y] (SLiM 2.0), or we might have the first mutation id - or we might have nothing at all
-		if (iss >> sub)
+		if (GetInputToken(token_cursor, line_end, token_start, token_end))
 		{
 			// check whether this token is a genome type
-			if ((sub.compare(gStr_A) == 0) || (sub.compare(gStr_X) == 0) || (sub.compare(gStr_Y) == 0))
+			bool is_A = InputTokenIs(token_start, token_end, "A"), is_X = InputTokenIs(token_start, token_end, "X"), is_Y = InputTokenIs(token_start, token_end, "Y");
+			
+			if (is_A || is_X || is_Y)
 			{
 				// Let's do a little error-checking against what has already been instantiated for us...
-				if ((sub.compare(gStr_A) == 0) && genome.Type() != GenomeType::kAutosome)
+				if (is_A && genome.Type() != GenomeType::kAutosome)
 					EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): genome is specified as A (autosome), but the instantiated genome does not match." << EidosTerminate();
-				if ((sub.compare(gStr_X) == 0) && genome.Type() != GenomeType::kXChromosome)
+				if (is_X && genome.Type() != GenomeType::kXChromosome)
 					EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): genome is specified as X (X-chromosome), but the instantiated genome does not match." << EidosTerminate();
-				if ((sub.compare(gStr_Y) == 0) && genome.Type() != GenomeType::kYChromosome)
+				if (is_Y && genome.Type() != GenomeType::kYChromosome)
 					EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): genome is specified as Y (Y-chromosome), but the instantiated genome does not match." << EidosTerminate();
 				
-				if (iss >> sub)
+				if (GetInputToken(token_cursor, line_end, token_start, token_end))
 				{
 					// BCH 9/27/2021: We instantiate null genomes only in the case where we expect them: in sex-chromosome models,
 					// for either the X or Y (whichever is not being simulated).  In nonWF autosomal models, any genome is now
 					// allowed to be null, at the user's discretion, so we transform the instantiated genome to a null genome
 					// if necessary.  AddSubpopulation() created the genomes above, before we knew which would be null.
-					if (sub == "<null>")
+					if (InputTokenIs(token_start, token_end, "<null>"))
 					{
 						if (!genome.IsNull())
 						{
@@ -889,7 +1005,7 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 						if (genome.IsNull())
 							EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): genome is specified as non-null, but the instantiated genome is null." << EidosTerminate();
 						
-						// drop through, and sub will be interpreted as a mutation id below
+						// drop through, and the token will be interpreted as a mutation id below
 					}
 				}
 				else
@@ -902,15 +1018,26 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 			
 			do
 			{
-				int64_t polymorphismid_long = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr);
+				int64_t polymorphismid_long = SLiM_NonnegativeIntegerForChars(token_start, token_end);
 				slim_polymorphismid_t polymorphism_id = SLiMCastToPolymorphismidTypeOrRaise(polymorphismid_long);
+				MutationIndex mutation = -1;
 				
-				auto found_mut_pair = mutations.find(polymorphism_id);
+				if (polymorphism_table_is_dense)
+				{
+					if ((size_t)polymorphism_id < polymorphism_table.size())
+						mutation = polymorphism_table[polymorphism_id];
+				}
+				else
+				{
+					auto found_mut_pair = std::lower_bound(polymorphism_pairs.begin(), polymorphism_pairs.end(), polymorphism_id, [](const std::pair<slim_polymorphismid_t, MutationIndex> &p1, slim_polymorphismid_t p2) { return p1.first < p2; });
+					
+					if ((found_mut_pair != polymorphism_pairs.end()) && (found_mut_pair->first == polymorphism_id))
+						mutation = found_mut_pair->second;
+				}
 				
-				if (found_mut_pair == mutations.end()) 
+				if (mutation == -1)
 					EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromTextFile): polymorphism " << polymorphism_id << " has not been defined." << EidosTerminate();
 				
-				MutationIndex mutation = found_mut_pair->second;
 				slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)((mut_block_ptr + mutation)->position_ / mutrun_length_);
 				
 				assert(mutrun_index != -1);		// to clue in the static analyzer
@@ -925,15 +1052,17 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 				
 				current_mutrun->emplace_back(mutation);
 			}
-			while (iss >> sub);
+			while (GetInputToken(token_cursor, line_end, token_start, token_end));
 		}
 	}
 	
 	// Now we are in the Ancestral sequence section, which should take us to the end of the file
 	// Conveniently, NucleotideArray supports operator>> to read nucleotides until the EOF
-	if (line.find("Ancestral sequence") != std::string::npos)
+	if (InputLineContains(line_start, line_end, "Ancestral sequence"))
 	{
-		infile >> *(chromosome_->AncestralSequence());
+		std::istringstream sequence_stream(std::string(cursor, buffer_end));
+		
+		sequence_stream >> *(chromosome_->AncestralSequence());
 	}
 	
 	// It's a little unclear how we ought to clean up after ourselves, and this is a continuing source of bugs.  We could be loading
@@ -991,43 +1120,21 @@ slim_generation_t SLiMSim::_InitializePopulationFromTextFile(const char *p_file,
 }
 
 #ifndef __clang_analyzer__
-slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_file, EidosInterpreter *p_interpreter)
+slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(std::string &p_file_contents, EidosInterpreter *p_interpreter)
 {
-	std::size_t file_size = 0;
 	slim_generation_t file_generation;
 	int32_t spatial_output_count;
 	int age_output_count = 0;
 	int pedigree_output_count = 0;
 	bool has_nucleotides = false;
 	
-	// Read file into buf
-	std::ifstream infile(p_file, std::ios::in | std::ios::binary);
-	
-	if (!infile.is_open() || infile.eof())
-		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): could not open initialization file." << EidosTerminate();
-	
-	// Determine the file length
-	infile.seekg(0, std::ios_base::end);
-	file_size = infile.tellg();
-	
-	// Read in the entire file; we assume we have enough memory, for now
-	std::unique_ptr<char[]> raii_buf(new char[file_size]);
-	char *buf = raii_buf.get();
-	
-	if (!buf)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): could not allocate input buffer." << EidosTerminate();
-	
-	char *buf_end = buf + file_size;
-	char *p = buf;
-	
-	infile.seekg(0, std::ios_base::beg);
-	infile.read(buf, file_size);
-	
-	// Close the file; we will work only with our buffer from here on
+	// We work with the file buffer read by our caller, which holds the entire file
 	// Note that we use memcpy() to read values from the buffer, since it takes care of alignment issues
 	// for us that otherwise both the UndefinedBehaviorSanitizer.  On platforms that don't care about
 	// alignment this should compile down to the same code; on platforms that do care, it avoids a crash.
-	infile.close();
+	char *buf = &p_file_contents[0];
+	char *buf_end = buf + p_file_contents.length();
+	char *p = buf;
 	
 	int32_t section_end_tag;
 	int32_t file_version;
@@ -1055,7 +1162,7 @@ slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_fil
 			version_tag = 3;
 		}
 		
-		if ((version_tag != 1) && (version_tag != 2) && (version_tag != 3) && (version_tag != 5) && (version_tag != 6))
+		if ((version_tag != 1) && (version_tag != 2) && (version_tag != 3) && (version_tag != 5) && (version_tag != 6) && (version_tag != 7))
 			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unrecognized version (" << version_tag << ")." << EidosTerminate();
 		
 		file_version = version_tag;
@@ -1404,15 +1511,186 @@ slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_fil
 			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): missing section end after mutations." << EidosTerminate();
 	}
 	
-	// Genomes section
-	if (pedigree_output_count)
-		gSLiM_next_pedigree_id = 0;
-	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 	bool use_16_bit = (mutation_map_size <= UINT16_MAX - 1);	// 0xFFFF is reserved as the start of our various tags
 	std::unique_ptr<MutationIndex[]> raii_genomebuf(new MutationIndex[mutation_map_size]);	// allowing us to use emplace_back_bulk() for speed
 	MutationIndex *genomebuf = raii_genomebuf.get();
 	
+	// Mutation runs section, added in version 7; each distinct mutation run is read once, and then shared by the genomes that use it
+	int32_t file_mutrun_count = 0;
+	slim_position_t file_mutrun_length = 0;
+	std::vector<MutationRun_SP> mutrun_table;
+	
+	if (file_version >= 7)
+	{
+		int32_t mutrun_table_size;
+		
+		if (p + sizeof(file_mutrun_count) + sizeof(file_mutrun_length) + sizeof(mutrun_table_size) > buf_end)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unexpected EOF at mutation run table size." << EidosTerminate();
+		
+		memcpy(&file_mutrun_count, p, sizeof(file_mutrun_count));
+		p += sizeof(file_mutrun_count);
+		
+		memcpy(&file_mutrun_length, p, sizeof(file_mutrun_length));
+		p += sizeof(file_mutrun_length);
+		
+		memcpy(&mutrun_table_size, p, sizeof(mutrun_table_size));
+		p += sizeof(mutrun_table_size);
+		
+		if (mutrun_table_size < 0)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): mutation run table size out of range." << EidosTerminate();
+		
+		mutrun_table.reserve(mutrun_table_size);
+		
+		for (int32_t table_index = 0; table_index < mutrun_table_size; ++table_index)
+		{
+			int32_t mut_count;
+			
+			if (p + sizeof(mut_count) > buf_end)
+				EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unexpected EOF while reading mutation run." << EidosTerminate();
+			
+			memcpy(&mut_count, p, sizeof(mut_count));
+			p += sizeof(mut_count);
+			
+			if ((mut_count < 0) || (mut_count > mutation_map_size))
+				EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): mutation run size out of range." << EidosTerminate();
+			
+			if (use_16_bit)
+			{
+				// reading 16-bit mutation tags
+				uint16_t mutation_id;
+				
+				if (p + sizeof(mutation_id) * mut_count > buf_end)
+					EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unexpected EOF while reading mutation run." << EidosTerminate();
+				
+				for (int32_t mutcount = 0; mutcount < mut_count; ++mutcount)
+				{
+					memcpy(&mutation_id, p, sizeof(mutation_id));
+					p += sizeof(mutation_id);
+					
+					if (/*(mutation_id < 0) ||*/ (mutation_id >= mutation_map_size)) 
+						EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): mutation " << mutation_id << " has not been defined." << EidosTerminate();
+					
+					genomebuf[mutcount] = mutations[mutation_id];
+				}
+			}
+			else
+			{
+				// reading 32-bit mutation tags
+				int32_t mutation_id;
+				
+				if (p + sizeof(mutation_id) * mut_count > buf_end)
+					EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unexpected EOF while reading mutation run." << EidosTerminate();
+				
+				for (int32_t mutcount = 0; mutcount < mut_count; ++mutcount)
+				{
+					memcpy(&mutation_id, p, sizeof(mutation_id));
+					p += sizeof(mutation_id);
+					
+					if ((mutation_id < 0) || (mutation_id >= mutation_map_size)) 
+						EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): mutation " << mutation_id << " has not been defined." << EidosTerminate();
+					
+					genomebuf[mutcount] = mutations[mutation_id];
+				}
+			}
+			
+			MutationRun *mutrun = MutationRun::NewMutationRun();	// take from shared pool of used objects
+			
+			mutrun->emplace_back_bulk(genomebuf, mut_count);
+			mutrun_table.emplace_back(MutationRun_SP(mutrun));
+		}
+		
+		if (p + sizeof(section_end_tag) > buf_end)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unexpected EOF after mutation runs." << EidosTerminate();
+		else
+		{
+			memcpy(&section_end_tag, p, sizeof(section_end_tag));
+			p += sizeof(section_end_tag);
+			
+			if (section_end_tag != (int32_t)0xFFFF0000)
+				EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): missing section end after mutation runs." << EidosTerminate();
+		}
+	}
+	
+	// If the file's mutation run configuration matches ours, genomes can simply share the runs read above; otherwise (if the
+	// chromosome's mutation run count has changed, for example), the mutations in each run get redistributed into our runs
+	bool share_mutruns = ((file_mutrun_count == chromosome_->mutrun_count_) && (file_mutrun_length == chromosome_->mutrun_length_));
+	
+	if (pedigree_output_count)
+		gSLiM_next_pedigree_id = 0;
+	
+	// Individuals section, added in version 7; each individual field is a column of values for all the individuals in a subpopulation,
+	// with subpopulations in the same order as in the file, since they are kept sorted by id; before version 7, individual information
+	// is instead read along with each individual's first genome, below
+	if (file_version >= 7)
+	{
+		for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
+		{
+			Subpopulation *subpop = subpop_pair.second;
+			slim_popsize_t subpop_size = subpop->parent_subpop_size_;
+			std::vector<Individual *> &individuals = subpop->parent_individuals_;
+			
+			if (p + subpop_size * (spatial_output_count * sizeof(double) + pedigree_output_count * sizeof(slim_pedigreeid_t) + age_output_count * sizeof(slim_age_t)) > buf_end)
+				EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unexpected EOF while reading individuals." << EidosTerminate();
+			
+			for (int spatial_index = 0; spatial_index < spatial_output_count; ++spatial_index)
+			{
+				for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+				{
+					Individual *individual = individuals[individual_index];
+					double *spatial_value = ((spatial_index == 0) ? &individual->spatial_x_ : ((spatial_index == 1) ? &individual->spatial_y_ : &individual->spatial_z_));
+					
+					memcpy(spatial_value, p, sizeof(double));
+					p += sizeof(double);
+				}
+			}
+			
+			if (pedigree_output_count)
+			{
+				if (PedigreesEnabled())
+				{
+					for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+					{
+						Individual *individual = individuals[individual_index];
+						slim_pedigreeid_t pedigree_id;
+						
+						memcpy(&pedigree_id, p + individual_index * sizeof(slim_pedigreeid_t), sizeof(pedigree_id));
+						
+						individual->SetPedigreeID(pedigree_id);
+						individual->genome1_->SetGenomeID(pedigree_id * 2);
+						individual->genome2_->SetGenomeID(pedigree_id * 2 + 1);
+						gSLiM_next_pedigree_id = std::max(gSLiM_next_pedigree_id, pedigree_id + 1);
+					}
+				}
+				
+				p += subpop_size * sizeof(slim_pedigreeid_t);
+			}
+			
+#ifdef SLIM_NONWF_ONLY
+			if (age_output_count)
+			{
+				for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+				{
+					memcpy(&individuals[individual_index]->age_, p, sizeof(slim_age_t));
+					p += sizeof(slim_age_t);
+				}
+			}
+#endif  // SLIM_NONWF_ONLY
+		}
+		
+		if (p + sizeof(section_end_tag) > buf_end)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unexpected EOF after individuals." << EidosTerminate();
+		else
+		{
+			memcpy(&section_end_tag, p, sizeof(section_end_tag));
+			p += sizeof(section_end_tag);
+			
+			if (section_end_tag != (int32_t)0xFFFF0000)
+				EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): missing section end after individuals." << EidosTerminate();
+		}
+	}
+	
+	// Genomes section
 	while (true)
 	{
 		slim_objectid_t subpop_id;
@@ -1445,8 +1723,8 @@ slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_fil
 		if (!subpop)
 			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): referenced subpopulation p" << subpop_id << " not defined." << EidosTerminate();
 		
-		// Read in individual spatial position information.  Added in version 3.
-		if (spatial_output_count && ((genome_index % 2) == 0))
+		// Read in individual spatial position information.  Added in version 3, moved to the individuals section in version 7.
+		if (spatial_output_count && ((genome_index % 2) == 0) && (file_version < 7))
 		{
 			// do another buffer length check
 			if (p + spatial_output_count * sizeof(double) + sizeof(total_mutations) > buf_end)
@@ -1472,8 +1750,8 @@ slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_fil
 			}
 		}
 		
-		// Read in individual pedigree ID information.  Added in version 6.
-		if (pedigree_output_count  && ((genome_index % 2) == 0))
+		// Read in individual pedigree ID information.  Added in version 6, moved to the individuals section in version 7.
+		if (pedigree_output_count  && ((genome_index % 2) == 0) && (file_version < 7))
 		{
 			// do another buffer length check
 			if (p + sizeof(slim_pedigreeid_t) + sizeof(total_mutations) > buf_end)
@@ -1497,8 +1775,8 @@ slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_fil
 		}
 		
 #ifdef SLIM_NONWF_ONLY
-		// Read in individual age information.  Added in version 4.
-		if (age_output_count && ((genome_index % 2) == 0))
+		// Read in individual age information.  Added in version 4, moved to the individuals section in version 7.
+		if (age_output_count && ((genome_index % 2) == 0) && (file_version < 7))
 		{
 			// do another buffer length check
 			if (p + sizeof(slim_age_t) + sizeof(total_mutations) > buf_end)
@@ -1551,7 +1829,47 @@ slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_fil
 			// Read in the mutation list
 			int32_t mutcount = 0;
 			
-			if (use_16_bit)
+			if (file_version >= 7)
+			{
+				// reading 32-bit mutation run table indices; total_mutations is actually the count of mutation runs
+				int32_t genome_mutrun_count = total_mutations;
+				int32_t mutrun_table_size = (int32_t)mutrun_table.size();
+				
+				if ((genome_mutrun_count < 0) || (genome_mutrun_count != file_mutrun_count))
+					EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): genome mutation run count does not match the mutation run table." << EidosTerminate();
+				if (p + sizeof(int32_t) * genome_mutrun_count > buf_end)
+					EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): unexpected EOF while reading genome." << EidosTerminate();
+				
+				for (int32_t run_index = 0; run_index < genome_mutrun_count; ++run_index)
+				{
+					int32_t mutrun_table_index;
+					
+					memcpy(&mutrun_table_index, p, sizeof(mutrun_table_index));
+					p += sizeof(mutrun_table_index);
+					
+					if ((mutrun_table_index < 0) || (mutrun_table_index >= mutrun_table_size))
+						EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): mutation run " << mutrun_table_index << " has not been defined." << EidosTerminate();
+					
+					if (share_mutruns)
+					{
+						genome.mutruns_[run_index] = mutrun_table[mutrun_table_index];
+					}
+					else
+					{
+						MutationRun *mutrun = mutrun_table[mutrun_table_index].get();
+						int mut_count = mutrun->size();
+						
+						if (mutcount + mut_count > mutation_map_size)
+							EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromBinaryFile): genome contains more mutations than were defined." << EidosTerminate();
+						
+						std::copy(mutrun->begin_pointer_const(), mutrun->begin_pointer_const() + mut_count, genomebuf + mutcount);
+						mutcount += mut_count;
+					}
+				}
+				
+				// if the runs were shared, we are done with this genome; if not, mutcount mutations are in genomebuf, to be added below
+			}
+			else if (use_16_bit)
 			{
 				// reading 16-bit mutation tags
 				uint16_t mutation_id;
@@ -1708,7 +2026,7 @@ slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_fil
 }
 #else
 // the static analyzer has a lot of trouble understanding this method
-slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(const char *p_file, EidosInterpreter *p_interpreter)
+slim_generation_t SLiMSim::_InitializePopulationFromBinaryFile(std::string &p_file_contents, EidosInterpreter *p_interpreter)
 {
 	return 0;
 }
@@ -2155,6 +2473,39 @@ void SLiMSim::OptimizeScriptBlock(SLiMEidosBlock *p_script_block)
 //				std::cout << "NOT OPTIMIZED:" << std::endl << "   " << base_node->token_->token_string_ << std::endl;
 		}
 	}
+	
+	// Beyond those special cases, simple fitness() callbacks can be compiled to native code; those that cannot may still be evaluated
+	// across a whole subpopulation at once.  With -l 2, we report what was done with each fitness() callback.
+	if ((p_script_block->type_ == SLiMEidosBlockType::SLiMEidosFitnessCallback) || (p_script_block->type_ == SLiMEidosBlockType::SLiMEidosFitnessGlobalCallback))
+	{
+		p_script_block->CompileFitnessCallback();
+		p_script_block->ScanTreeForVectorization();
+		
+		if (SLiM_verbosity_level >= 2)
+		{
+			SLIM_OUTSTREAM << "// fitness(";
+			if (p_script_block->type_ == SLiMEidosBlockType::SLiMEidosFitnessGlobalCallback)
+				SLIM_OUTSTREAM << "NULL";
+			else
+				SLIM_OUTSTREAM << "m" << p_script_block->mutation_type_id_;
+			SLIM_OUTSTREAM << ") callback";
+			if (p_script_block->block_id_ != -1)
+				SLIM_OUTSTREAM << " s" << p_script_block->block_id_;
+			if (p_script_block->root_node_->token_->token_line_ != -1)
+				SLIM_OUTSTREAM << " (line " << (p_script_block->root_node_->token_->token_line_ + 1) << ")";
+			
+			if (p_script_block->compound_statement_node_->cached_return_value_)
+				SLIM_OUTSTREAM << ": constant return value" << std::endl;
+			else if (p_script_block->has_cached_optimization_)
+				SLIM_OUTSTREAM << ": replaced by built-in C++ code" << std::endl;
+			else if (p_script_block->compiled_callback_)
+				SLIM_OUTSTREAM << ": compiled to native code" << std::endl;
+			else if (p_script_block->vectorizable_)
+				SLIM_OUTSTREAM << ": interpreted, vectorized across individuals" << std::endl;
+			else
+				SLIM_OUTSTREAM << ": interpreted" << std::endl;
+		}
+	}
 }
 
 void SLiMSim::AddScriptBlock(SLiMEidosBlock *p_script_block, EidosInterpreter *p_interpreter, const EidosToken *p_error_token)
@@ -3767,6 +4118,10 @@ bool SLiMSim::_RunOneGenerationWF(void)
 				CrosscheckTreeSeqIntegrity();
 		}
 		
+		// Pedigree store; this needs to be done after all individuals for this generation have been born and have died
+		if (pedigree_depth_ > 0)
+			RecordPedigreeGeneration();
+		
 		// LogFile output
 		for (LogFile *log_file : log_file_registry_)
 			log_file->GenerationEndCallout();
@@ -4344,6 +4699,10 @@ bool SLiMSim::_RunOneGenerationNonWF(void)
 				CrosscheckTreeSeqIntegrity();
 		}
 		
+		// Pedigree store; this needs to be done after all individuals for this generation have been born and have died
+		if (pedigree_depth_ > 0)
+			RecordPedigreeGeneration();
+		
 		// LogFile output
 		for (LogFile *log_file : log_file_registry_)
 			log_file->GenerationEndCallout();
@@ -4425,6 +4784,10 @@ void SLiMSim::SimulationFinished(void)
 {
 	// This is an opportunity for final calculation/output when a simulation finishes
 	
+	// LogFile output that is still buffered, in binary mode
+	for (LogFile *log_file : log_file_registry_)
+		log_file->SimulationFinishedCallout();
+	
 #if MUTRUN_EXPERIMENT_OUTPUT
 	// Print a full mutation run count history if MUTRUN_EXPERIMENT_OUTPUT is enabled
 	if (SLiM_verbose_output && x_experiments_enabled_)
@@ -5176,53 +5539,258 @@ void SLiMSim::FileWriteNotification(const std::string &p_file_path, std::vector<
 
 
 //
-// TREE SEQUENCE RECORDING
+// PEDIGREE STORE
 //
 #pragma mark -
-#pragma mark Tree sequence recording
+#pragma mark Pedigree store
 #pragma mark -
 
-void SLiMSim::handle_error(std::string msg, int err)
-{
-	std::cout << "Error:" << msg << ": " << tsk_strerror(err) << std::endl;
-	EIDOS_TERMINATION << msg << ": " << tsk_strerror(err) << EidosTerminate();
-}
-
-void SLiMSim::ReorderIndividualTable(tsk_table_collection_t *p_tables, std::vector<int> p_individual_map, bool p_keep_unmapped)
+void SLiMSim::RecordPedigreeGeneration(void)
 {
-	// Modifies the tables in place so that individual number individual_map[k] becomes the k-th individual in the new tables.
-	// Discard unmapped individuals unless p_keep_unmapped is true, in which case put them at the end.
-	size_t num_individuals = p_tables->individuals.num_rows;
-	std::vector<tsk_id_t> inverse_map(num_individuals, TSK_NULL);
-	
-	for (tsk_id_t j = 0; (size_t)j < p_individual_map.size(); j++)
-		inverse_map[p_individual_map[j]] = j;
+	// Called at the end of each generation when pedigree_depth_ > 0.  All individuals born in this generation that are still
+	// alive are recorded; an individual that dies in the generation in which it was born cannot have had offspring, so it can
+	// never appear in anybody's pedigree.  Pedigree IDs are assigned sequentially, so this generation's record covers the range
+	// of pedigree IDs assigned since the last record was made; IDs of individuals that are not alive are left as unknown.
+	slim_pedigreeid_t first_id = pedigree_store_next_id_;
+	slim_pedigreeid_t end_id = gSLiM_next_pedigree_id;
 	
-	// If p_keep_unmapped is true, use the inverse table to add all unmapped individuals to the end of p_individual_map
-	if (p_keep_unmapped)
+	if (end_id > first_id)
 	{
-		for (tsk_id_t j = 0; (size_t)j < inverse_map.size(); j++)
+		pedigree_store_.emplace_back();
+		
+		PedigreeGenerationRecord &record = pedigree_store_.back();
+		
+		record.first_id_ = first_id;
+		record.parents_.resize((size_t)(end_id - first_id), std::pair<slim_pedigreeid_t, slim_pedigreeid_t>(-1, -1));
+		
+		for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
 		{
-			if (inverse_map[j] == TSK_NULL)
+			for (Individual *individual : subpop_pair.second->parent_individuals_)
 			{
-				inverse_map[j] = (tsk_id_t)p_individual_map.size();
-				p_individual_map.emplace_back(j);
+				slim_pedigreeid_t pedigree_id = individual->PedigreeID();
+				
+				if ((pedigree_id >= first_id) && (pedigree_id < end_id))
+					record.parents_[(size_t)(pedigree_id - first_id)] = std::pair<slim_pedigreeid_t, slim_pedigreeid_t>(individual->Parent1PedigreeID(), individual->Parent2PedigreeID());
 			}
 		}
-		assert(p_individual_map.size() == p_tables->individuals.num_rows);
+		
+		pedigree_store_next_id_ = end_id;
 	}
 	
-	// Make a copy of p_tables->individuals, from which we will copy rows back to p_tables->individuals
-	tsk_individual_table_t individuals_copy;
-	int ret = tsk_individual_table_copy(&p_tables->individuals, &individuals_copy, 0);
-	if (ret < 0) handle_error("reorder_individuals", ret);
-	
-	// Clear p_tables->individuals and copy rows into it in the requested order
-	tsk_individual_table_clear(&p_tables->individuals);
+	while (pedigree_store_.size() > (size_t)pedigree_depth_)
+		pedigree_store_.pop_front();
 	
-	for (tsk_id_t k : p_individual_map)
+	// memoized kinship values might depend upon what has been added or removed, so they are now invalid
+	kinship_cache_.clear();
+}
+
+void SLiMSim::ClearPedigreeStore(void)
+{
+	// Called when the population is replaced, as by readFromPopulationFile(); the pedigree IDs of the new individuals
+	// are unrelated to what we have recorded, so we start over with the next pedigree ID that will be assigned
+	pedigree_store_.clear();
+	pedigree_store_next_id_ = gSLiM_next_pedigree_id;
+	kinship_cache_.clear();
+}
+
+void SLiMSim::PedigreeParents(slim_pedigreeid_t p_id, slim_pedigreeid_t *p_parent1, slim_pedigreeid_t *p_parent2)
+{
+	// The queried individuals come first, since they might have been born in the current generation and not be recorded yet
+	for (Individual *query_ind : {kinship_query_ind1_, kinship_query_ind2_})
 	{
-		assert((size_t) k < individuals_copy.num_rows);
+		if (query_ind && (query_ind->PedigreeID() == p_id))
+		{
+			*p_parent1 = query_ind->Parent1PedigreeID();
+			*p_parent2 = query_ind->Parent2PedigreeID();
+			return;
+		}
+	}
+	
+	*p_parent1 = -1;
+	*p_parent2 = -1;
+	
+	if ((p_id == -1) || pedigree_store_.empty() || (p_id < pedigree_store_.front().first_id_) || (p_id >= pedigree_store_next_id_))
+		return;
+	
+	// binary search for the last record with first_id_ <= p_id; records cover contiguous, increasing ranges of pedigree IDs
+	auto record_iter = std::upper_bound(pedigree_store_.begin(), pedigree_store_.end(), p_id, [](slim_pedigreeid_t id, const PedigreeGenerationRecord &record) { return id < record.first_id_; });
+	const PedigreeGenerationRecord &record = *(record_iter - 1);
+	size_t index = (size_t)(p_id - record.first_id_);
+	
+	if (index < record.parents_.size())
+	{
+		*p_parent1 = record.parents_[index].first;
+		*p_parent2 = record.parents_[index].second;
+	}
+}
+
+double SLiMSim::KinshipCoefficient(slim_pedigreeid_t p_id1, slim_pedigreeid_t p_id2)
+{
+	// This is the standard recursive definition of the kinship coefficient, made tractable by memoization.  Since pedigree IDs are
+	// assigned sequentially, the individual with the larger ID cannot be an ancestor of the other, so we can always recurse upward
+	// from it.  Individuals with unknown parents (founders, and individuals older than the pedigree store) are assumed unrelated
+	// and non-inbred.  Uniparental offspring have both parents set to the same individual, so they are treated as if produced by
+	// selfing; the kinship of a clone with itself is therefore overestimated.
+	//
+	// The recursion goes about two levels deep for each generation in the pedigree store, which is too deep for the call stack with
+	// a deep store, so it is run with an explicit stack of pairs still to be calculated.  A pair stays on the stack until the pairs
+	// it depends upon have been cached, and is then calculated from them.  Pairs are kept as (larger ID, smaller ID).
+	typedef std::pair<slim_pedigreeid_t, slim_pedigreeid_t> PedigreePair;
+	
+	if ((p_id1 == -1) || (p_id2 == -1))
+		return 0.0;
+	
+	PedigreePair query_pair = (p_id1 < p_id2) ? PedigreePair(p_id2, p_id1) : PedigreePair(p_id1, p_id2);
+	auto cache_iter = kinship_cache_.find(query_pair);
+	
+	if (cache_iter != kinship_cache_.end())
+		return cache_iter->second;
+	
+	std::vector<PedigreePair> &stack = kinship_stack_;
+	
+	stack.clear();
+	stack.emplace_back(query_pair);
+	
+	while (stack.size())
+	{
+		PedigreePair pair = stack.back();
+		
+		// a pair can be pushed more than once before it is calculated, such as when an individual's parents are the same
+		if (kinship_cache_.find(pair) != kinship_cache_.end())
+		{
+			stack.pop_back();
+			continue;
+		}
+		
+		slim_pedigreeid_t parent1, parent2;
+		
+		PedigreeParents(pair.first, &parent1, &parent2);
+		
+		// the kinship of an individual with itself depends on the kinship of its parents; otherwise, on the kinships of each
+		// parent of the younger individual with the older individual
+		PedigreePair dependencies[2];
+		double dependency_kinships[2];
+		int dependency_count = (pair.first == pair.second) ? 1 : 2;
+		bool dependencies_cached = true;
+		
+		if (dependency_count == 1)
+			dependencies[0] = PedigreePair(parent1, parent2);
+		else
+		{
+			dependencies[0] = PedigreePair(parent1, pair.second);
+			dependencies[1] = PedigreePair(parent2, pair.second);
+		}
+		
+		for (int dependency_index = 0; dependency_index < dependency_count; ++dependency_index)
+		{
+			PedigreePair &dependency = dependencies[dependency_index];
+			
+			if ((dependency.first == -1) || (dependency.second == -1))
+			{
+				dependency_kinships[dependency_index] = 0.0;
+				continue;
+			}
+			
+			if (dependency.first < dependency.second)
+				std::swap(dependency.first, dependency.second);
+			
+			auto dependency_iter = kinship_cache_.find(dependency);
+			
+			if (dependency_iter != kinship_cache_.end())
+			{
+				dependency_kinships[dependency_index] = dependency_iter->second;
+			}
+			else
+			{
+				stack.emplace_back(dependency);
+				dependencies_cached = false;
+			}
+		}
+		
+		if (!dependencies_cached)
+			continue;
+		
+		double kinship;
+		
+		if (dependency_count == 1)
+			kinship = 0.5 * (1.0 + dependency_kinships[0]);
+		else
+			kinship = 0.5 * (dependency_kinships[0] + dependency_kinships[1]);
+		
+		kinship_cache_.emplace(pair, kinship);
+		stack.pop_back();
+	}
+	
+	return kinship_cache_.find(query_pair)->second;
+}
+
+double SLiMSim::KinshipOfIndividuals(Individual *p_ind1, Individual *p_ind2)
+{
+	// the cache is shared by all queries within a generation, which saves a great deal of work for batch queries, but with a deep
+	// store and a large population it could grow without bound, so it is dropped between queries once it gets too big
+	if (kinship_cache_.size() > SLIM_KINSHIP_CACHE_MAX_ENTRIES)
+		kinship_cache_.clear();
+	
+	kinship_query_ind1_ = p_ind1;
+	kinship_query_ind2_ = p_ind2;
+	
+	double kinship = KinshipCoefficient(p_ind1->PedigreeID(), p_ind2->PedigreeID());
+	
+	kinship_query_ind1_ = nullptr;
+	kinship_query_ind2_ = nullptr;
+	
+	return kinship;
+}
+
+
+//
+// TREE SEQUENCE RECORDING
+//
+#pragma mark -
+#pragma mark Tree sequence recording
+#pragma mark -
+
+void SLiMSim::handle_error(std::string msg, int err)
+{
+	std::cout << "Error:" << msg << ": " << tsk_strerror(err) << std::endl;
+	EIDOS_TERMINATION << msg << ": " << tsk_strerror(err) << EidosTerminate();
+}
+
+void SLiMSim::ReorderIndividualTable(tsk_table_collection_t *p_tables, std::vector<int> p_individual_map, bool p_keep_unmapped)
+{
+	// Modifies the tables in place so that individual number individual_map[k] becomes the k-th individual in the new tables.
+	// Discard unmapped individuals unless p_keep_unmapped is true, in which case put them at the end.
+	size_t num_individuals = p_tables->individuals.num_rows;
+	std::vector<tsk_id_t> inverse_map(num_individuals, TSK_NULL);
+	
+	for (tsk_id_t j = 0; (size_t)j < p_individual_map.size(); j++)
+		inverse_map[p_individual_map[j]] = j;
+	
+	// If p_keep_unmapped is true, use the inverse table to add all unmapped individuals to the end of p_individual_map
+	if (p_keep_unmapped)
+	{
+		for (tsk_id_t j = 0; (size_t)j < inverse_map.size(); j++)
+		{
+			if (inverse_map[j] == TSK_NULL)
+			{
+				inverse_map[j] = (tsk_id_t)p_individual_map.size();
+				p_individual_map.emplace_back(j);
+			}
+		}
+		assert(p_individual_map.size() == p_tables->individuals.num_rows);
+	}
+	
+	// Make a copy of p_tables->individuals, from which we will copy rows back to p_tables->individuals
+	tsk_individual_table_t individuals_copy;
+	int ret = tsk_individual_table_copy(&p_tables->individuals, &individuals_copy, 0);
+	if (ret < 0) handle_error("reorder_individuals", ret);
+	
+	// Clear p_tables->individuals and copy rows into it in the requested order
+	tsk_individual_table_clear(&p_tables->individuals);
+	
+	for (tsk_id_t k : p_individual_map)
+	{
+		assert((size_t) k < individuals_copy.num_rows);
 		
 		uint32_t flags = individuals_copy.flags[k];
 		double *location = individuals_copy.location + individuals_copy.location_offset[k];
@@ -5384,6 +5952,35 @@ slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start)
 	return 0;
 }
 
+void SLiMSim::SortTreeSequenceTables(tsk_table_collection_t *p_tables, tsk_flags_t p_flags)
+{
+#if 0
+	// sort the tables using tsk_table_collection_sort() to get the default behavior
+	int ret = tsk_table_collection_sort(p_tables, /* edge_start */ NULL, /* flags */ p_flags);
+	if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+#else
+	// sort the tables using our own custom edge sorter, for additional speed through inlining of the comparison function
+	// see https://github.com/tskit-dev/tskit/pull/627, https://github.com/tskit-dev/tskit/pull/711
+	// FIXME for additional speed we could perhaps be smart about only sorting the portions of the edge table
+	// that need it, but the tricky thing is that all the old stuff has to be at the bottom of the table, not the top...
+	tsk_table_sorter_t sorter;
+	int ret = tsk_table_sorter_init(&sorter, p_tables, /* flags */ p_flags);
+	if (ret != 0) handle_error("tsk_table_sorter_init", ret);
+	
+	sorter.sort_edges = slim_sort_edges;
+	
+	try {
+		ret = tsk_table_sorter_run(&sorter, NULL);
+	} catch (std::exception &e) {
+		EIDOS_TERMINATION << "ERROR (SLiMSim::SortTreeSequenceTables): (internal error) exception raised during tsk_table_sorter_run(): " << e.what() << "." << EidosTerminate();
+	}
+	if (ret != 0) handle_error("tsk_table_sorter_run", ret);
+	
+	tsk_table_sorter_free(&sorter);
+	if (ret != 0) handle_error("tsk_table_sorter_free", ret);
+#endif
+}
+
 void SLiMSim::SimplifyTreeSequence(void)
 {
 #if DEBUG
@@ -5394,6 +5991,9 @@ void SLiMSim::SimplifyTreeSequence(void)
 	if (tables_.nodes.num_rows == 0)
 		return;
 	
+	// simplification rewrites the tables, so the next treeSeqCheckpoint() has to write a new base
+	checkpoint_path_.clear();
+	
 	std::vector<tsk_id_t> samples;
 	
 	// BCH 7/27/2019: We now build a hash table containing all of the entries of remembered_genomes_,
@@ -5461,34 +6061,10 @@ void SLiMSim::SimplifyTreeSequence(void)
 	flags = 0;
 #endif
 	
-#if 0
-	// sort the tables using tsk_table_collection_sort() to get the default behavior
-	int ret = tsk_table_collection_sort(&tables_, /* edge_start */ NULL, /* flags */ flags);
-	if (ret < 0) handle_error("tsk_table_collection_sort", ret);
-#else
-	// sort the tables using our own custom edge sorter, for additional speed through inlining of the comparison function
-	// see https://github.com/tskit-dev/tskit/pull/627, https://github.com/tskit-dev/tskit/pull/711
-	// FIXME for additional speed we could perhaps be smart about only sorting the portions of the edge table
-	// that need it, but the tricky thing is that all the old stuff has to be at the bottom of the table, not the top...
-	tsk_table_sorter_t sorter;
-	int ret = tsk_table_sorter_init(&sorter, &tables_, /* flags */ flags);
-	if (ret != 0) handle_error("tsk_table_sorter_init", ret);
-	
-	sorter.sort_edges = slim_sort_edges;
-	
-	try {
-		ret = tsk_table_sorter_run(&sorter, NULL);
-	} catch (std::exception &e) {
-		EIDOS_TERMINATION << "ERROR (SLiMSim::SimplifyTreeSequence): (internal error) exception raised during tsk_table_sorter_run(): " << e.what() << "." << EidosTerminate();
-	}
-	if (ret != 0) handle_error("tsk_table_sorter_run", ret);
-	
-	tsk_table_sorter_free(&sorter);
-	if (ret != 0) handle_error("tsk_table_sorter_free", ret);
-#endif
+	SortTreeSequenceTables(&tables_, flags);
 	
 	// remove redundant sites we added
-	ret = tsk_table_collection_deduplicate_sites(&tables_, 0);
+	int ret = tsk_table_collection_deduplicate_sites(&tables_, 0);
 	if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
 	
 	// simplify
@@ -6495,87 +7071,105 @@ void SLiMSim::AddIndividualsToTable(Individual * const *p_individual, size_t p_n
 	if (p_tables == nullptr)
 		p_tables = &tables_;
 	
-	// loop over individuals and add entries to the individual table; if they are already
-	// there, we just need to update their flags, metadata, location, etc.
+	// loop over individuals and add entries to the individual table; see AddIndividualRowToTable()
 	for (size_t j = 0; j < p_num_individuals; j++)
 	{
 		Individual *ind = p_individual[j];
-		slim_pedigreeid_t ped_id = ind->PedigreeID();
-
-		std::vector<double> location;
-		location.emplace_back(ind->spatial_x_);
-		location.emplace_back(ind->spatial_y_);
-		location.emplace_back(ind->spatial_z_);
+		double location[3] = {ind->spatial_x_, ind->spatial_y_, ind->spatial_z_};
 		
 		IndividualMetadataRec metadata_rec;
 		MetadataForIndividual(ind, &metadata_rec);
 		
-		// do a fast lookup to see whether this individual is already in the individuals table
-		auto ind_pos = p_individuals_hash->find(ped_id);
-		
-		if (ind_pos == p_individuals_hash->end()) {
-			// This individual is not already in the tables.
-			tsk_id_t tsk_individual = tsk_individual_table_add_row(&p_tables->individuals,
-					p_flags, location.data(), (uint32_t)location.size(), 
-                    NULL, 0, // individual parents
-					(char *)&metadata_rec, (uint32_t)sizeof(IndividualMetadataRec));
-			if (tsk_individual < 0) handle_error("tsk_individual_table_add_row", tsk_individual);
-			
-			// Add the new individual to our hash table, for fast lookup as done above
-			p_individuals_hash->emplace(ped_id, tsk_individual);
+		AddIndividualRowToTable(ind->genome1_->tsk_node_id_, ind->genome2_->tsk_node_id_, location, &metadata_rec, p_tables, p_individuals_hash, p_flags);
+	}
+}
 
-			// Update node table
-			assert(ind->genome1_->tsk_node_id_ < (tsk_id_t) p_tables->nodes.num_rows
-				   && ind->genome2_->tsk_node_id_ < (tsk_id_t) p_tables->nodes.num_rows);
-			p_tables->nodes.individual[ind->genome1_->tsk_node_id_] = tsk_individual;
-			p_tables->nodes.individual[ind->genome2_->tsk_node_id_] = tsk_individual;
+void SLiMSim::AddIndividualRowToTable(tsk_id_t p_node1, tsk_id_t p_node2, const double *p_location, const IndividualMetadataRec *p_metadata_rec, tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash, tsk_flags_t p_flags)
+{
+	// This adds one individual, described by its nodes, location, and metadata, to the individuals table; if it is
+	// already there, we just need to update its flags, metadata, location, etc.  This is split out from
+	// AddIndividualsToTable() so that _InitializePopulationFromCheckpointFile() can add individuals that no longer exist.
+	slim_pedigreeid_t ped_id = p_metadata_rec->pedigree_id_;
+	const uint32_t location_count = 3;
+	
+	// do a fast lookup to see whether this individual is already in the individuals table
+	auto ind_pos = p_individuals_hash->find(ped_id);
+	
+	if (ind_pos == p_individuals_hash->end()) {
+		// This individual is not already in the tables.
+		tsk_id_t tsk_individual = tsk_individual_table_add_row(&p_tables->individuals,
+				p_flags, p_location, location_count, 
+				NULL, 0, // individual parents
+				(const char *)p_metadata_rec, (uint32_t)sizeof(IndividualMetadataRec));
+		if (tsk_individual < 0) handle_error("tsk_individual_table_add_row", tsk_individual);
+		
+		// Add the new individual to our hash table, for fast lookup as done above
+		p_individuals_hash->emplace(ped_id, tsk_individual);
 
-			// update remembered genomes
-			if (p_flags & SLIM_TSK_INDIVIDUAL_REMEMBERED)
-			{
-				remembered_genomes_.emplace_back(ind->genome1_->tsk_node_id_);
-				remembered_genomes_.emplace_back(ind->genome2_->tsk_node_id_);
-			}
-		} else {
-			// This individual is already there; we need to update the information.
-			tsk_id_t tsk_individual =  ind_pos->second;
-
-			assert(((size_t)tsk_individual < p_tables->individuals.num_rows)
-				   && (location.size()
-					   == (p_tables->individuals.location_offset[tsk_individual + 1]
-						   - p_tables->individuals.location_offset[tsk_individual]))
-				   && (sizeof(IndividualMetadataRec)
-					   == (p_tables->individuals.metadata_offset[tsk_individual + 1]
-						   - p_tables->individuals.metadata_offset[tsk_individual])));
-			
-			// It could have been previously inserted but not with the 
-			// SLIM_TSK_INDIVIDUAL_REMEMBERED flag: if so, it now needs adding to the
-			// list of remembered_genomes_
-			if (((p_tables->individuals.flags[tsk_individual] & SLIM_TSK_INDIVIDUAL_REMEMBERED) == 0)
-				&& (p_flags & SLIM_TSK_INDIVIDUAL_REMEMBERED))
-			{
-				remembered_genomes_.emplace_back(ind->genome1_->tsk_node_id_);
-				remembered_genomes_.emplace_back(ind->genome2_->tsk_node_id_);
-			}
+		// Update node table
+		assert(p_node1 < (tsk_id_t) p_tables->nodes.num_rows
+			   && p_node2 < (tsk_id_t) p_tables->nodes.num_rows);
+		p_tables->nodes.individual[p_node1] = tsk_individual;
+		p_tables->nodes.individual[p_node2] = tsk_individual;
+		
+		// nodes that are already in the last checkpoint record have been changed in place
+		if ((p_tables == &tables_) && !checkpoint_path_.empty())
+		{
+			if ((tsk_size_t)p_node1 < checkpoint_position_.nodes)
+				checkpoint_changed_nodes_.emplace_back(p_node1);
+			if ((tsk_size_t)p_node2 < checkpoint_position_.nodes)
+				checkpoint_changed_nodes_.emplace_back(p_node2);
+		}
 
-			memcpy(p_tables->individuals.location
-				   + p_tables->individuals.location_offset[tsk_individual],
-				   location.data(), location.size() * sizeof(double));
-			memcpy(p_tables->individuals.metadata
-					+ p_tables->individuals.metadata_offset[tsk_individual],
-					&metadata_rec, sizeof(IndividualMetadataRec));
-			p_tables->individuals.flags[tsk_individual] |= p_flags;
-			
-			// Check node table
-			assert(ind->genome1_->tsk_node_id_ < (tsk_id_t) p_tables->nodes.num_rows
-				   && ind->genome2_->tsk_node_id_ < (tsk_id_t) p_tables->nodes.num_rows);
-			
-			// BCH 4/29/2019: These asserts are, we think, not technically necessary – the code
-			// would work even if they were violated.  But they're a nice invariant to guarantee,
-			// and right now they are always true.
-			assert(p_tables->nodes.individual[ind->genome1_->tsk_node_id_] == (tsk_id_t)tsk_individual);
-			assert(p_tables->nodes.individual[ind->genome2_->tsk_node_id_] == (tsk_id_t)tsk_individual);
+		// update remembered genomes
+		if (p_flags & SLIM_TSK_INDIVIDUAL_REMEMBERED)
+		{
+			remembered_genomes_.emplace_back(p_node1);
+			remembered_genomes_.emplace_back(p_node2);
 		}
+	} else {
+		// This individual is already there; we need to update the information.
+		tsk_id_t tsk_individual =  ind_pos->second;
+
+		assert(((size_t)tsk_individual < p_tables->individuals.num_rows)
+			   && (location_count
+				   == (p_tables->individuals.location_offset[tsk_individual + 1]
+					   - p_tables->individuals.location_offset[tsk_individual]))
+			   && (sizeof(IndividualMetadataRec)
+				   == (p_tables->individuals.metadata_offset[tsk_individual + 1]
+					   - p_tables->individuals.metadata_offset[tsk_individual])));
+		
+		// It could have been previously inserted but not with the 
+		// SLIM_TSK_INDIVIDUAL_REMEMBERED flag: if so, it now needs adding to the
+		// list of remembered_genomes_
+		if (((p_tables->individuals.flags[tsk_individual] & SLIM_TSK_INDIVIDUAL_REMEMBERED) == 0)
+			&& (p_flags & SLIM_TSK_INDIVIDUAL_REMEMBERED))
+		{
+			remembered_genomes_.emplace_back(p_node1);
+			remembered_genomes_.emplace_back(p_node2);
+		}
+
+		memcpy(p_tables->individuals.location
+			   + p_tables->individuals.location_offset[tsk_individual],
+			   p_location, location_count * sizeof(double));
+		memcpy(p_tables->individuals.metadata
+				+ p_tables->individuals.metadata_offset[tsk_individual],
+				p_metadata_rec, sizeof(IndividualMetadataRec));
+		p_tables->individuals.flags[tsk_individual] |= p_flags;
+		
+		// a row that is already in the last checkpoint record has been changed in place
+		if ((p_tables == &tables_) && !checkpoint_path_.empty() && ((tsk_size_t)tsk_individual < checkpoint_position_.individuals))
+			checkpoint_changed_individuals_.emplace_back(tsk_individual);
+		
+		// Check node table
+		assert(p_node1 < (tsk_id_t) p_tables->nodes.num_rows
+			   && p_node2 < (tsk_id_t) p_tables->nodes.num_rows);
+		
+		// BCH 4/29/2019: These asserts are, we think, not technically necessary – the code
+		// would work even if they were violated.  But they're a nice invariant to guarantee,
+		// and right now they are always true.
+		assert(p_tables->nodes.individual[p_node1] == (tsk_id_t)tsk_individual);
+		assert(p_tables->nodes.individual[p_node2] == (tsk_id_t)tsk_individual);
 	}
 }
 
@@ -7270,6 +7864,49 @@ void SLiMSim::ReadTreeSequenceMetadata(tsk_table_collection_t *p_tables, slim_ge
 #endif
 }
 
+void SLiMSim::CopyTablesSharingEdgesAndSites(tsk_table_collection_t *p_source, tsk_table_collection_t *p_dest)
+{
+	// Copy everything in p_source except its edge and site tables, which are shared (not copied) into p_dest
+	// by shallow struct copy.  p_dest is then read-only with respect to edges and sites, and must be passed to
+	// UnshareEdgesAndSites() before it is freed.  We do this by temporarily swapping empty tables into
+	// p_source, so that tsk_table_collection_copy() handles everything else (metadata, indexes, etc.) for us.
+	tsk_edge_table_t empty_edges, source_edges = p_source->edges;
+	tsk_site_table_t empty_sites, source_sites = p_source->sites;
+	int ret;
+	
+	ret = tsk_edge_table_init(&empty_edges, 0);
+	if (ret != 0) handle_error("CopyTablesSharingEdgesAndSites tsk_edge_table_init()", ret);
+	ret = tsk_site_table_init(&empty_sites, 0);
+	if (ret != 0) handle_error("CopyTablesSharingEdgesAndSites tsk_site_table_init()", ret);
+	
+	p_source->edges = empty_edges;
+	p_source->sites = empty_sites;
+	
+	ret = tsk_table_collection_copy(p_source, p_dest, 0);
+	
+	p_source->edges = source_edges;
+	p_source->sites = source_sites;
+	
+	tsk_edge_table_free(&empty_edges);
+	tsk_site_table_free(&empty_sites);
+	
+	if (ret < 0) handle_error("CopyTablesSharingEdgesAndSites tsk_table_collection_copy()", ret);
+	
+	// the empty tables copied into p_dest get replaced by the shared tables
+	tsk_edge_table_free(&p_dest->edges);
+	tsk_site_table_free(&p_dest->sites);
+	
+	p_dest->edges = source_edges;
+	p_dest->sites = source_sites;
+}
+
+void SLiMSim::UnshareEdgesAndSites(tsk_table_collection_t *p_tables)
+{
+	// Forget the tables shared by CopyTablesSharingEdgesAndSites(); freeing a zeroed table is a no-op in tskit
+	memset(&p_tables->edges, 0, sizeof(tsk_edge_table_t));
+	memset(&p_tables->sites, 0, sizeof(tsk_site_table_t));
+}
+
 void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict)
 {
 #if DEBUG
@@ -7299,10 +7936,19 @@ void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 		SimplifyTreeSequence();
 	}
 	
-	// Copy the table collection so that modifications we do for writing don't affect the original tables
+	// Copy the table collection so that modifications we do for writing don't affect the original tables.
+	// If we simplified, the edge and site tables are already sorted and deduplicated, and nothing below
+	// modifies them, so the copy shares them with tables_ instead of duplicating them; they are usually
+	// the bulk of the table collection, so this greatly reduces the peak memory usage of output.
 	tsk_table_collection_t output_tables;
-	ret = tsk_table_collection_copy(&tables_, &output_tables, 0);
-	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	
+	if (p_simplify)
+		CopyTablesSharingEdgesAndSites(&tables_, &output_tables);
+	else
+	{
+		ret = tsk_table_collection_copy(&tables_, &output_tables, 0);
+		if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	}
 	
 	// Sort and deduplicate; we don't need to do this if we simplified above, since simplification does these steps
 	if (!p_simplify)
@@ -7311,8 +7957,7 @@ void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 #if DEBUG
 		flags = 0;
 #endif
-		ret = tsk_table_collection_sort(&output_tables, /* edge_start */ NULL, /* flags */ flags);
-		if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+		SortTreeSequenceTables(&output_tables, flags);
 		
 		// Remove redundant sites we added
 		ret = tsk_table_collection_deduplicate_sites(&output_tables, 0);
@@ -7480,42 +8125,348 @@ void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 		}
 	}
 	
-	// Done with our tables copy
+	// Done with our tables copy; if it shares tables with tables_, those must not be freed
+	if (p_simplify)
+		UnshareEdgesAndSites(&output_tables);
+	
 	ret = tsk_table_collection_free(&output_tables);
 	if (ret < 0) handle_error("tsk_table_collection_free", ret);
 }
 
+// treeSeqCheckpoint() files start with a header and a base: a kastore dump of tables_, followed by the ancestral sequence.
+// Each call then appends a delta record with the rows added to tables_ since the previous record, the older rows changed
+// in place since then, and the state needed to finish the tables as WriteTreeSequence() does.  Everything is in native
+// byte order, as in binary outputFull() files.  Records are prefixed by their length, so that a final record cut short
+// by an interrupted write can be ignored when reading, restoring the state saved by the record before it.
+static const int32_t SLIM_CHECKPOINT_ENDIANNESS_TAG = 0x12345678;
+static const int32_t SLIM_CHECKPOINT_VERSION = 1;
+static const int32_t SLIM_CHECKPOINT_RECORD_TAG = 0x41544C44;		// 'DLTA', reinterpreted via endianness
+
+template <typename T>
+static inline void CheckpointAppend(std::string &p_buffer, T p_value)
+{
+	p_buffer.append(reinterpret_cast<const char *>(&p_value), sizeof(T));
+}
 
-void SLiMSim::FreeTreeSequence()
+// appends rows [p_from, p_to) of a fixed-width column
+template <typename T>
+static inline void CheckpointAppendColumn(std::string &p_buffer, const T *p_column, tsk_size_t p_from, tsk_size_t p_to)
 {
-	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::FreeTreeSequence): (internal error) FreeTreeSequence() called when tree-sequence recording is not enabled." << EidosTerminate();
+	if (p_to > p_from)
+		p_buffer.append(reinterpret_cast<const char *>(p_column + p_from), (p_to - p_from) * sizeof(T));
+}
+
+// appends rows [p_from, p_to) of a ragged column, as the length of each row followed by the data of all of the rows
+template <typename T>
+static void CheckpointAppendRaggedColumn(std::string &p_buffer, const T *p_column, const tsk_size_t *p_offsets, tsk_size_t p_from, tsk_size_t p_to)
+{
+	for (tsk_size_t row = p_from; row < p_to; ++row)
+		CheckpointAppend<tsk_size_t>(p_buffer, p_offsets[row + 1] - p_offsets[row]);
 	
-	// Free any tree-sequence recording stuff that has been allocated; called when SLiMSim is getting deallocated,
-	// and also when we're wiping the slate clean with something like readFromPopulationFile().
-	tsk_table_collection_free(&tables_);
+	if (p_to > p_from)
+		p_buffer.append(reinterpret_cast<const char *>(p_column + p_offsets[p_from]), (p_offsets[p_to] - p_offsets[p_from]) * sizeof(T));
+}
+
+// the readers below advance p_cursor past what they read, and raise if that would go past p_end
+static const char *CheckpointTake(const char *&p_cursor, const char *p_end, uint64_t p_count, size_t p_size)
+{
+	if (p_count > (uint64_t)(p_end - p_cursor) / p_size)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file is truncated or malformed; this file cannot be read." << EidosTerminate();
 	
-	remembered_genomes_.clear();
-	tabled_individuals_hash_.clear();
+	const char *data = p_cursor;
+	
+	p_cursor += p_count * p_size;
+	return data;
 }
 
-void SLiMSim::RecordAllDerivedStatesFromSLiM(void)
+template <typename T>
+static inline T CheckpointRead(const char *&p_cursor, const char *p_end)
+{
+	T value;
+	
+	memcpy(&value, CheckpointTake(p_cursor, p_end, 1, sizeof(T)), sizeof(T));
+	return value;
+}
+
+// the column is never left empty, since tskit takes a null column pointer to mean that the column is absent
+template <typename T>
+static void CheckpointReadColumn(const char *&p_cursor, const char *p_end, tsk_size_t p_count, std::vector<T> &p_column)
+{
+	const char *data = CheckpointTake(p_cursor, p_end, p_count, sizeof(T));
+	
+	p_column.resize(std::max<tsk_size_t>(p_count, 1));
+	memcpy(p_column.data(), data, p_count * sizeof(T));
+}
+
+template <typename T>
+static void CheckpointReadRaggedColumn(const char *&p_cursor, const char *p_end, tsk_size_t p_count, std::vector<T> &p_column, std::vector<tsk_size_t> &p_offsets)
+{
+	const char *lengths = CheckpointTake(p_cursor, p_end, p_count, sizeof(tsk_size_t));
+	
+	p_offsets.resize(p_count + 1);
+	p_offsets[0] = 0;
+	
+	for (tsk_size_t row = 0; row < p_count; ++row)
+	{
+		tsk_size_t length;
+		
+		memcpy(&length, lengths + row * sizeof(tsk_size_t), sizeof(tsk_size_t));
+		
+		if (length > (tsk_size_t)(p_end - p_cursor))
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file is truncated or malformed; this file cannot be read." << EidosTerminate();
+		
+		p_offsets[row + 1] = p_offsets[row] + length;
+	}
+	
+	CheckpointReadColumn(p_cursor, p_end, p_offsets[p_count], p_column);
+}
+
+void SLiMSim::WriteTreeSequenceCheckpoint(std::string &p_checkpoint_path)
 {
 #if DEBUG
 	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::RecordAllDerivedStatesFromSLiM): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+		EIDOS_TERMINATION << "ERROR (SLiMSim::WriteTreeSequenceCheckpoint): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
 #endif
 	
-	// This is called when new tree sequence tables need to be built to correspond to the current state of SLiM, such as
-	// after handling a readFromPopulationFile() call.  It is guaranteed by the caller of this method that any old tree
-	// sequence recording stuff has been freed with a call to FreeTreeSequence(), and then a new recording session has
-	// been initiated with AllocateTreeSequenceTables(); it might be good for this method to do a sanity check that all
-	// of the recording tables are indeed allocated but empty, I guess.  This method then records every extant individual
-	// by making calls to SetCurrentNewIndividual(), and RecordNewGenome(). Note
-	// that modifyChild() callbacks do not happen in this scenario, so new individuals will not get retracted.  Note
-	// also that new mutations will not be added one at a time, when they are stacked; instead, each block of stacked
-	// mutations in a genome will be added with a single derived state call here.
-	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
+	std::string path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(p_checkpoint_path));
+	tsk_table_collection_t &t = tables_;
+	
+	// The population table is regenerated from the subpopulations, as in WriteTreeSequence(); it goes into each record whole
+	WritePopulationTable(&tables_);
+	
+	tsk_bookmark_t position;
+	
+	tsk_table_collection_record_num_rows(&tables_, &position);
+	
+	// Between simplifications, rows are only ever appended to tables_, apart from the in-place changes we track; if the
+	// tables have shrunk or been rewritten since the last record, or this is a different file, we start over with a new base
+	if ((path != checkpoint_path_) ||
+		(position.nodes < checkpoint_position_.nodes) || (position.edges < checkpoint_position_.edges) ||
+		(position.sites < checkpoint_position_.sites) || (position.mutations < checkpoint_position_.mutations) ||
+		(position.individuals < checkpoint_position_.individuals) ||
+		(position.migrations != checkpoint_position_.migrations) || (position.provenances != checkpoint_position_.provenances))
+	{
+		checkpoint_path_.clear();
+		
+		FILE *file = fopen(path.c_str(), "wb");
+		
+		if (!file)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::WriteTreeSequenceCheckpoint): treeSeqCheckpoint() could not open " << path << "." << EidosTerminate();
+		
+		std::string header("CKPT", 4);
+		
+		CheckpointAppend<int32_t>(header, SLIM_CHECKPOINT_ENDIANNESS_TAG);
+		CheckpointAppend<int32_t>(header, SLIM_CHECKPOINT_VERSION);
+		CheckpointAppend<int32_t>(header, (int32_t)sizeof(tsk_id_t));
+		CheckpointAppend<int32_t>(header, (int32_t)sizeof(tsk_size_t));
+		
+		bool success = (fwrite(header.data(), 1, header.length(), file) == header.length());
+		
+		if (success)
+		{
+			int ret = tsk_table_collection_dumpf(&tables_, file, 0);
+			
+			if (ret < 0)
+			{
+				fclose(file);
+				handle_error("tsk_table_collection_dumpf", ret);
+			}
+		}
+		
+		// the ancestral sequence is not kept in tables_; it is empty in non-nucleotide models
+		std::string ancestral_sequence;
+		
+		CheckpointAppend<uint64_t>(ancestral_sequence, nucleotide_based_ ? chromosome_->AncestralSequence()->size() : 0);
+		
+		if (nucleotide_based_)
+		{
+			size_t header_length = ancestral_sequence.length();
+			
+			ancestral_sequence.resize(header_length + chromosome_->AncestralSequence()->size());
+			chromosome_->AncestralSequence()->WriteNucleotidesToBuffer(&ancestral_sequence[header_length]);
+		}
+		
+		success = success && (fwrite(ancestral_sequence.data(), 1, ancestral_sequence.length(), file) == ancestral_sequence.length());
+		success = (fclose(file) == 0) && success;
+		
+		if (!success)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::WriteTreeSequenceCheckpoint): treeSeqCheckpoint() could not write " << path << "." << EidosTerminate();
+		
+		// the base holds everything up to now, so the first record after it has only the model state
+		checkpoint_position_ = position;
+		checkpoint_changed_individuals_.clear();
+		checkpoint_changed_nodes_.clear();
+	}
+	
+	const tsk_bookmark_t &from = checkpoint_position_;
+	std::string record;
+	
+	CheckpointAppend<int32_t>(record, SLIM_CHECKPOINT_RECORD_TAG);
+	CheckpointAppend<uint64_t>(record, 0);		// the length of the rest of the record, filled in at the end
+	
+	CheckpointAppend<tsk_size_t>(record, from.nodes);
+	CheckpointAppend<tsk_size_t>(record, position.nodes);
+	CheckpointAppend<tsk_size_t>(record, from.edges);
+	CheckpointAppend<tsk_size_t>(record, position.edges);
+	CheckpointAppend<tsk_size_t>(record, from.sites);
+	CheckpointAppend<tsk_size_t>(record, position.sites);
+	CheckpointAppend<tsk_size_t>(record, from.mutations);
+	CheckpointAppend<tsk_size_t>(record, position.mutations);
+	CheckpointAppend<tsk_size_t>(record, from.individuals);
+	CheckpointAppend<tsk_size_t>(record, position.individuals);
+	
+	// the rows appended since the last record
+	CheckpointAppendColumn(record, t.nodes.flags, from.nodes, position.nodes);
+	CheckpointAppendColumn(record, t.nodes.time, from.nodes, position.nodes);
+	CheckpointAppendColumn(record, t.nodes.population, from.nodes, position.nodes);
+	CheckpointAppendColumn(record, t.nodes.individual, from.nodes, position.nodes);
+	CheckpointAppendRaggedColumn(record, t.nodes.metadata, t.nodes.metadata_offset, from.nodes, position.nodes);
+	
+	CheckpointAppendColumn(record, t.edges.left, from.edges, position.edges);
+	CheckpointAppendColumn(record, t.edges.right, from.edges, position.edges);
+	CheckpointAppendColumn(record, t.edges.parent, from.edges, position.edges);
+	CheckpointAppendColumn(record, t.edges.child, from.edges, position.edges);
+	
+	CheckpointAppendColumn(record, t.sites.position, from.sites, position.sites);
+	CheckpointAppendRaggedColumn(record, t.sites.ancestral_state, t.sites.ancestral_state_offset, from.sites, position.sites);
+	CheckpointAppendRaggedColumn(record, t.sites.metadata, t.sites.metadata_offset, from.sites, position.sites);
+	
+	CheckpointAppendColumn(record, t.mutations.site, from.mutations, position.mutations);
+	CheckpointAppendColumn(record, t.mutations.node, from.mutations, position.mutations);
+	CheckpointAppendColumn(record, t.mutations.parent, from.mutations, position.mutations);
+	CheckpointAppendColumn(record, t.mutations.time, from.mutations, position.mutations);
+	CheckpointAppendRaggedColumn(record, t.mutations.derived_state, t.mutations.derived_state_offset, from.mutations, position.mutations);
+	CheckpointAppendRaggedColumn(record, t.mutations.metadata, t.mutations.metadata_offset, from.mutations, position.mutations);
+	
+	CheckpointAppendColumn(record, t.individuals.flags, from.individuals, position.individuals);
+	CheckpointAppendRaggedColumn(record, t.individuals.location, t.individuals.location_offset, from.individuals, position.individuals);
+	CheckpointAppendRaggedColumn(record, t.individuals.parents, t.individuals.parents_offset, from.individuals, position.individuals);
+	CheckpointAppendRaggedColumn(record, t.individuals.metadata, t.individuals.metadata_offset, from.individuals, position.individuals);
+	
+	// older rows that have been changed in place since the last record; see AddIndividualRowToTable()
+	std::sort(checkpoint_changed_individuals_.begin(), checkpoint_changed_individuals_.end());
+	checkpoint_changed_individuals_.erase(std::unique(checkpoint_changed_individuals_.begin(), checkpoint_changed_individuals_.end()), checkpoint_changed_individuals_.end());
+	std::sort(checkpoint_changed_nodes_.begin(), checkpoint_changed_nodes_.end());
+	checkpoint_changed_nodes_.erase(std::unique(checkpoint_changed_nodes_.begin(), checkpoint_changed_nodes_.end()), checkpoint_changed_nodes_.end());
+	
+	CheckpointAppend<uint64_t>(record, checkpoint_changed_individuals_.size());
+	
+	for (tsk_id_t row : checkpoint_changed_individuals_)
+	{
+		CheckpointAppend<tsk_id_t>(record, row);
+		CheckpointAppend<tsk_flags_t>(record, t.individuals.flags[row]);
+		CheckpointAppendRaggedColumn(record, t.individuals.location, t.individuals.location_offset, row, row + 1);
+		CheckpointAppendRaggedColumn(record, t.individuals.metadata, t.individuals.metadata_offset, row, row + 1);
+	}
+	
+	CheckpointAppend<uint64_t>(record, checkpoint_changed_nodes_.size());
+	
+	for (tsk_id_t row : checkpoint_changed_nodes_)
+	{
+		CheckpointAppend<tsk_id_t>(record, row);
+		CheckpointAppend<tsk_id_t>(record, t.nodes.individual[row]);
+	}
+	
+	CheckpointAppend<tsk_size_t>(record, t.populations.num_rows);
+	CheckpointAppendRaggedColumn(record, t.populations.metadata, t.populations.metadata_offset, 0, t.populations.num_rows);
+	
+	// the model state, which is used only from the last record: the generation for rebasing times, the top-level metadata,
+	// and the individuals alive now, in the order of the subpopulations; see WriteTreeSequence()
+	CheckpointAppend<slim_generation_t>(record, tree_seq_generation_);
+	
+	{
+		tsk_table_collection_t metadata_tables;
+		int ret = tsk_table_collection_init(&metadata_tables, 0);
+		if (ret < 0) handle_error("tsk_table_collection_init", ret);
+		
+		WriteTreeSequenceMetadata(&metadata_tables, nullptr);
+		
+		CheckpointAppend<uint64_t>(record, metadata_tables.metadata_length);
+		record.append(metadata_tables.metadata, metadata_tables.metadata_length);
+		
+		tsk_table_collection_free(&metadata_tables);
+	}
+	
+	uint64_t alive_count = 0;
+	
+	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
+		alive_count += subpop_pair.second->parent_individuals_.size();
+	
+	CheckpointAppend<uint64_t>(record, alive_count);
+	
+	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
+	{
+		for (Individual *individual : subpop_pair.second->parent_individuals_)
+		{
+			IndividualMetadataRec metadata_rec;
+			
+			MetadataForIndividual(individual, &metadata_rec);
+			
+			CheckpointAppend<tsk_id_t>(record, individual->genome1_->tsk_node_id_);
+			CheckpointAppend<tsk_id_t>(record, individual->genome2_->tsk_node_id_);
+			CheckpointAppend<double>(record, individual->spatial_x_);
+			CheckpointAppend<double>(record, individual->spatial_y_);
+			CheckpointAppend<double>(record, individual->spatial_z_);
+			CheckpointAppend<IndividualMetadataRec>(record, metadata_rec);
+		}
+	}
+	
+	uint64_t record_length = record.length() - (sizeof(int32_t) + sizeof(uint64_t));
+	
+	memcpy(&record[sizeof(int32_t)], &record_length, sizeof(uint64_t));
+	
+	std::ofstream outfile(path, std::ios::out | std::ios::binary | std::ios::app);
+	
+	if (!outfile.is_open())
+		EIDOS_TERMINATION << "ERROR (SLiMSim::WriteTreeSequenceCheckpoint): treeSeqCheckpoint() could not open " << path << "." << EidosTerminate();
+	
+	outfile.write(record.data(), record.length());
+	outfile.close();
+	
+	if (!outfile)
+	{
+		checkpoint_path_.clear();
+		EIDOS_TERMINATION << "ERROR (SLiMSim::WriteTreeSequenceCheckpoint): treeSeqCheckpoint() could not write " << path << "." << EidosTerminate();
+	}
+	
+	checkpoint_path_ = path;
+	checkpoint_position_ = position;
+	checkpoint_changed_individuals_.clear();
+	checkpoint_changed_nodes_.clear();
+}
+
+
+void SLiMSim::FreeTreeSequence()
+{
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::FreeTreeSequence): (internal error) FreeTreeSequence() called when tree-sequence recording is not enabled." << EidosTerminate();
+	
+	// Free any tree-sequence recording stuff that has been allocated; called when SLiMSim is getting deallocated,
+	// and also when we're wiping the slate clean with something like readFromPopulationFile().
+	tsk_table_collection_free(&tables_);
+	
+	remembered_genomes_.clear();
+	tabled_individuals_hash_.clear();
+	checkpoint_path_.clear();
+}
+
+void SLiMSim::RecordAllDerivedStatesFromSLiM(void)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::RecordAllDerivedStatesFromSLiM): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// This is called when new tree sequence tables need to be built to correspond to the current state of SLiM, such as
+	// after handling a readFromPopulationFile() call.  It is guaranteed by the caller of this method that any old tree
+	// sequence recording stuff has been freed with a call to FreeTreeSequence(), and then a new recording session has
+	// been initiated with AllocateTreeSequenceTables(); it might be good for this method to do a sanity check that all
+	// of the recording tables are indeed allocated but empty, I guess.  This method then records every extant individual
+	// by making calls to SetCurrentNewIndividual(), and RecordNewGenome(). Note
+	// that modifyChild() callbacks do not happen in this scenario, so new individuals will not get retracted.  Note
+	// also that new mutations will not be added one at a time, when they are stacked; instead, each block of stacked
+	// mutations in a genome will be added with a single derived state call here.
+	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
 	{
 		Subpopulation *subpop = subpop_pair.second;
 		
@@ -7646,6 +8597,43 @@ void SLiMSim::DumpMutationTable(void)
 	}
 }
 
+void SLiMSim::TreeSequenceForSample(std::vector<tsk_id_t> &p_samples, tsk_table_collection_t *p_tables, tsk_treeseq_t *p_ts)
+{
+	// Build a tree sequence for computing statistics on the current state of the model, without writing anything out.  We copy
+	// the live tables, sort/deduplicate/simplify the copy down to p_samples, and initialize p_ts from it.  Simplification places
+	// the samples first in the node table, in the order given, so on return sample k of p_samples is node k of p_ts.  The caller
+	// must free both p_ts and p_tables (with tsk_treeseq_free() and tsk_table_collection_free()) when done.
+	int ret = tsk_table_collection_copy(&tables_, p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForSample tsk_table_collection_copy()", ret);
+	
+	// our tables copy needs to have a population table now, since this is required to build a tree sequence
+	WritePopulationTable(p_tables);
+	
+	tsk_flags_t flags = TSK_NO_CHECK_INTEGRITY;
+#if DEBUG
+	flags = 0;
+#endif
+	SortTreeSequenceTables(p_tables, flags);
+	
+	ret = tsk_table_collection_deduplicate_sites(p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForSample tsk_table_collection_deduplicate_sites()", ret);
+	
+	flags = TSK_FILTER_SITES | TSK_FILTER_INDIVIDUALS | TSK_KEEP_INPUT_ROOTS;
+	if (!retain_coalescent_only_) flags |= TSK_KEEP_UNARY;
+	ret = tsk_table_collection_simplify(p_tables, p_samples.data(), (tsk_size_t)p_samples.size(), flags, NULL);
+	if (ret != 0) handle_error("TreeSequenceForSample tsk_table_collection_simplify()", ret);
+	
+	// must build indexes before compute mutation parents
+	ret = tsk_table_collection_build_index(p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForSample tsk_table_collection_build_index()", ret);
+	
+	ret = tsk_table_collection_compute_mutation_parents(p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForSample tsk_table_collection_compute_mutation_parents()", ret);
+	
+	ret = tsk_treeseq_init(p_ts, p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForSample tsk_treeseq_init()", ret);
+}
+
 void SLiMSim::CheckTreeSeqIntegrity(void)
 {
 	// Here we call tskit to check the integrity of the tree-sequence tables themselves – not against
@@ -7694,6 +8682,24 @@ void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 	if (genome_count == 0)
 		return;
 	
+	// if we are checking only a sample of the genomes (-TSXC <n>), choose that sample now; everything downstream works
+	// on the sample, since we simplify down to it, which keeps the cost of a crosscheck bounded for large models.  We use a
+	// private RNG seeded from the generation so that crosschecking does not perturb the model's own random number sequence.
+	if ((treeseq_crosschecks_sample_size_ > 0) && (genome_count > treeseq_crosschecks_sample_size_))
+	{
+		std::minstd_rand sample_rng((std::minstd_rand::result_type)(generation_ + 1));
+		
+		for (size_t sample_index = 0; sample_index < treeseq_crosschecks_sample_size_; ++sample_index)
+		{
+			std::uniform_int_distribution<size_t> sample_dist(sample_index, genome_count - 1);
+			
+			std::swap(genomes[sample_index], genomes[sample_dist(sample_rng)]);
+		}
+		
+		genomes.resize(treeseq_crosschecks_sample_size_);
+		genome_count = treeseq_crosschecks_sample_size_;
+	}
+	
 	// check for correspondence between SLiM's genomes and the tree_seq's nodes, including their metadata
 	// FIXME unimplemented
 	
@@ -7728,18 +8734,17 @@ void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 		// and we simplify down to just the extant individuals since we can't cross-check older individuals anyway...
 		if (tables_copy->nodes.num_rows != 0)
 		{
+			// the samples must be in the same order as genomes, so that genotypes line up with genome_walkers
 			std::vector<tsk_id_t> samples;
 			
-			for (auto iter : population_.subpops_)
-				for (Genome *genome : iter.second->parent_genomes_)
-					samples.emplace_back(genome->tsk_node_id_);
+			for (Genome *genome : genomes)
+				samples.emplace_back(genome->tsk_node_id_);
 			
 			tsk_flags_t flags = TSK_NO_CHECK_INTEGRITY;
 #if DEBUG
 			flags = 0;
 #endif
-			ret = tsk_table_collection_sort(tables_copy, /* edge_start */ NULL, /* flags */ flags);
-			if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+			SortTreeSequenceTables(tables_copy, flags);
 			
 			ret = tsk_table_collection_deduplicate_sites(tables_copy, 0);
 			if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
@@ -7989,11 +8994,13 @@ void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 	}
 }
 
-void SLiMSim::TSXC_Enable(void)
+void SLiMSim::TSXC_Enable(size_t p_sample_size)
 {
 	// This is called by command-line slim if a -TSXC command-line option is supplied; the point of this is to allow
 	// tree-sequence recording to be turned on, with mutation recording and runtime crosschecks, with a simple
 	// command-line flag, so that my existing test suite can be crosschecked easily.  The -TSXC flag is not public.
+	// If p_sample_size is non-zero (-TSXC <n>), each crosscheck checks only a random sample of that many genomes,
+	// which is cheap enough to do every generation even in large models; otherwise all genomes are checked.
 	recording_tree_ = true;
 	recording_mutations_ = true;
 	simplification_ratio_ = 10.0;
@@ -8001,12 +9008,16 @@ void SLiMSim::TSXC_Enable(void)
 	simplify_interval_ = 20;				// this is the initial simplification interval
 	running_coalescence_checks_ = false;
 	running_treeseq_crosschecks_ = true;
-	treeseq_crosschecks_interval_ = 50;		// check every 50th generation, otherwise it is just too slow
+	treeseq_crosschecks_sample_size_ = p_sample_size;
+	treeseq_crosschecks_interval_ = (p_sample_size ? 1 : 50);		// check every 50th generation when checking everything, otherwise it is just too slow
 	
 	pedigrees_enabled_ = true;
 	pedigrees_enabled_by_SLiM_ = true;
 	
-	SLIM_ERRSTREAM << "// ********** Turning on tree-sequence recording with crosschecks (-TSXC)." << std::endl << std::endl;
+	if (p_sample_size)
+		SLIM_ERRSTREAM << "// ********** Turning on tree-sequence recording with crosschecks of " << p_sample_size << " genomes (-TSXC " << p_sample_size << ")." << std::endl << std::endl;
+	else
+		SLIM_ERRSTREAM << "// ********** Turning on tree-sequence recording with crosschecks (-TSXC)." << std::endl << std::endl;
 }
 
 void SLiMSim::TSF_Enable(void)
@@ -9435,6 +10446,367 @@ slim_generation_t SLiMSim::_InitializePopulationFromTskitBinaryFile(const char *
 	return metadata_gen;
 }
 
+// appends the rows of one checkpoint record to p_tables and applies its in-place changes; see WriteTreeSequenceCheckpoint()
+// p_cursor is left at the model state that ends the record, which only _InitializePopulationFromCheckpointFile() needs
+static void CheckpointReplayRecord(tsk_table_collection_t *p_tables, const char *&p_cursor, const char *p_end)
+{
+	tsk_size_t table_rows[5] = {p_tables->nodes.num_rows, p_tables->edges.num_rows, p_tables->sites.num_rows, p_tables->mutations.num_rows, p_tables->individuals.num_rows};
+	tsk_size_t row_counts[5];
+	int ret;
+	
+	for (int table_index = 0; table_index < 5; ++table_index)
+	{
+		tsk_size_t from = CheckpointRead<tsk_size_t>(p_cursor, p_end);
+		tsk_size_t to = CheckpointRead<tsk_size_t>(p_cursor, p_end);
+		
+		if ((from != table_rows[table_index]) || (to < from))
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint records are out of sequence; this file cannot be read." << EidosTerminate();
+		
+		row_counts[table_index] = to - from;
+	}
+	
+	{
+		tsk_size_t count = row_counts[0];
+		std::vector<tsk_flags_t> flags;
+		std::vector<double> time;
+		std::vector<tsk_id_t> population, individual;
+		std::vector<char> metadata;
+		std::vector<tsk_size_t> metadata_offset;
+		
+		CheckpointReadColumn(p_cursor, p_end, count, flags);
+		CheckpointReadColumn(p_cursor, p_end, count, time);
+		CheckpointReadColumn(p_cursor, p_end, count, population);
+		CheckpointReadColumn(p_cursor, p_end, count, individual);
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, metadata, metadata_offset);
+		
+		if (count)
+		{
+			ret = tsk_node_table_append_columns(&p_tables->nodes, count, flags.data(), time.data(), population.data(), individual.data(), metadata.data(), metadata_offset.data());
+			if (ret < 0) SLiMSim::handle_error("tsk_node_table_append_columns", ret);
+		}
+	}
+	
+	{
+		tsk_size_t count = row_counts[1];
+		std::vector<double> left, right;
+		std::vector<tsk_id_t> parent, child;
+		
+		CheckpointReadColumn(p_cursor, p_end, count, left);
+		CheckpointReadColumn(p_cursor, p_end, count, right);
+		CheckpointReadColumn(p_cursor, p_end, count, parent);
+		CheckpointReadColumn(p_cursor, p_end, count, child);
+		
+		if (count)
+		{
+			ret = tsk_edge_table_append_columns(&p_tables->edges, count, left.data(), right.data(), parent.data(), child.data(), NULL, NULL);
+			if (ret < 0) SLiMSim::handle_error("tsk_edge_table_append_columns", ret);
+		}
+	}
+	
+	{
+		tsk_size_t count = row_counts[2];
+		std::vector<double> position;
+		std::vector<char> ancestral_state, metadata;
+		std::vector<tsk_size_t> ancestral_state_offset, metadata_offset;
+		
+		CheckpointReadColumn(p_cursor, p_end, count, position);
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, ancestral_state, ancestral_state_offset);
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, metadata, metadata_offset);
+		
+		if (count)
+		{
+			ret = tsk_site_table_append_columns(&p_tables->sites, count, position.data(), ancestral_state.data(), ancestral_state_offset.data(), metadata.data(), metadata_offset.data());
+			if (ret < 0) SLiMSim::handle_error("tsk_site_table_append_columns", ret);
+		}
+	}
+	
+	{
+		tsk_size_t count = row_counts[3];
+		std::vector<tsk_id_t> site, node, parent;
+		std::vector<double> time;
+		std::vector<char> derived_state, metadata;
+		std::vector<tsk_size_t> derived_state_offset, metadata_offset;
+		
+		CheckpointReadColumn(p_cursor, p_end, count, site);
+		CheckpointReadColumn(p_cursor, p_end, count, node);
+		CheckpointReadColumn(p_cursor, p_end, count, parent);
+		CheckpointReadColumn(p_cursor, p_end, count, time);
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, derived_state, derived_state_offset);
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, metadata, metadata_offset);
+		
+		if (count)
+		{
+			ret = tsk_mutation_table_append_columns(&p_tables->mutations, count, site.data(), node.data(), parent.data(), time.data(), derived_state.data(), derived_state_offset.data(), metadata.data(), metadata_offset.data());
+			if (ret < 0) SLiMSim::handle_error("tsk_mutation_table_append_columns", ret);
+		}
+	}
+	
+	{
+		tsk_size_t count = row_counts[4];
+		std::vector<tsk_flags_t> flags;
+		std::vector<double> location;
+		std::vector<tsk_id_t> parents;
+		std::vector<char> metadata;
+		std::vector<tsk_size_t> location_offset, parents_offset, metadata_offset;
+		
+		CheckpointReadColumn(p_cursor, p_end, count, flags);
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, location, location_offset);
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, parents, parents_offset);
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, metadata, metadata_offset);
+		
+		if (count)
+		{
+			ret = tsk_individual_table_append_columns(&p_tables->individuals, count, flags.data(), location.data(), location_offset.data(), parents.data(), parents_offset.data(), metadata.data(), metadata_offset.data());
+			if (ret < 0) SLiMSim::handle_error("tsk_individual_table_append_columns", ret);
+		}
+	}
+	
+	// older rows changed in place; their lengths cannot change
+	tsk_individual_table_t &individuals = p_tables->individuals;
+	uint64_t changed_individual_count = CheckpointRead<uint64_t>(p_cursor, p_end);
+	
+	for (uint64_t changed_index = 0; changed_index < changed_individual_count; ++changed_index)
+	{
+		tsk_id_t row = CheckpointRead<tsk_id_t>(p_cursor, p_end);
+		tsk_flags_t flags = CheckpointRead<tsk_flags_t>(p_cursor, p_end);
+		std::vector<double> location;
+		std::vector<char> metadata;
+		std::vector<tsk_size_t> location_offset, metadata_offset;
+		
+		CheckpointReadRaggedColumn(p_cursor, p_end, 1, location, location_offset);
+		CheckpointReadRaggedColumn(p_cursor, p_end, 1, metadata, metadata_offset);
+		
+		if ((row < 0) || ((tsk_size_t)row >= individuals.num_rows) ||
+			(location_offset[1] != individuals.location_offset[row + 1] - individuals.location_offset[row]) ||
+			(metadata_offset[1] != individuals.metadata_offset[row + 1] - individuals.metadata_offset[row]))
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file is truncated or malformed; this file cannot be read." << EidosTerminate();
+		
+		individuals.flags[row] = flags;
+		memcpy(individuals.location + individuals.location_offset[row], location.data(), location_offset[1] * sizeof(double));
+		memcpy(individuals.metadata + individuals.metadata_offset[row], metadata.data(), metadata_offset[1]);
+	}
+	
+	uint64_t changed_node_count = CheckpointRead<uint64_t>(p_cursor, p_end);
+	
+	for (uint64_t changed_index = 0; changed_index < changed_node_count; ++changed_index)
+	{
+		tsk_id_t row = CheckpointRead<tsk_id_t>(p_cursor, p_end);
+		tsk_id_t individual = CheckpointRead<tsk_id_t>(p_cursor, p_end);
+		
+		if ((row < 0) || ((tsk_size_t)row >= p_tables->nodes.num_rows))
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file is truncated or malformed; this file cannot be read." << EidosTerminate();
+		
+		p_tables->nodes.individual[row] = individual;
+	}
+	
+	// the population table is replaced whole
+	{
+		tsk_size_t count = CheckpointRead<tsk_size_t>(p_cursor, p_end);
+		std::vector<char> metadata;
+		std::vector<tsk_size_t> metadata_offset;
+		
+		CheckpointReadRaggedColumn(p_cursor, p_end, count, metadata, metadata_offset);
+		
+		ret = tsk_population_table_clear(&p_tables->populations);
+		if (ret < 0) SLiMSim::handle_error("tsk_population_table_clear", ret);
+		
+		if (count)
+		{
+			ret = tsk_population_table_append_columns(&p_tables->populations, count, metadata.data(), metadata_offset.data());
+			if (ret < 0) SLiMSim::handle_error("tsk_population_table_append_columns", ret);
+		}
+	}
+}
+
+slim_generation_t SLiMSim::_InitializePopulationFromCheckpointFile(const char *p_file, EidosInterpreter *p_interpreter)
+{
+	// as for _InitializePopulationFromTskitBinaryFile(), this may be called without tree-seq on, just to load genomes/mutations
+	int ret;
+	
+	if (recording_tree_)
+		FreeTreeSequence();
+	
+	bool was_recording_tree = recording_tree_;
+	
+	if (!was_recording_tree)
+	{
+		recording_tree_ = true;
+		recording_mutations_ = true;
+	}
+	
+	FILE *file = fopen(p_file, "rb");
+	
+	if (!file)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): could not open initialization file." << EidosTerminate();
+	
+	char header[4 + 4 * sizeof(int32_t)];
+	int32_t header_values[4];
+	
+	if (fread(header, 1, sizeof(header), file) != sizeof(header))
+	{
+		fclose(file);
+		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file is truncated or malformed; this file cannot be read." << EidosTerminate();
+	}
+	
+	memcpy(header_values, header + 4, sizeof(header_values));
+	
+	if ((header_values[0] != SLIM_CHECKPOINT_ENDIANNESS_TAG) || (header_values[1] != SLIM_CHECKPOINT_VERSION) || (header_values[2] != (int32_t)sizeof(tsk_id_t)) || (header_values[3] != (int32_t)sizeof(tsk_size_t)))
+	{
+		fclose(file);
+		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file was written by a different version or build of SLiM, or on a machine with different endianness; this file cannot be read." << EidosTerminate();
+	}
+	
+	// the base, followed by the ancestral sequence and the records, which we read into memory and parse in place
+	ret = tsk_table_collection_loadf(&tables_, file, 0);
+	if (ret != 0)
+	{
+		fclose(file);
+		handle_error("tsk_table_collection_loadf", ret);
+	}
+	
+	std::string contents;
+	char block[65536];
+	size_t block_length;
+	
+	while ((block_length = fread(block, 1, sizeof(block), file)) > 0)
+		contents.append(block, block_length);
+	
+	fclose(file);
+	
+	const char *cursor = contents.data();
+	const char *end = cursor + contents.length();
+	uint64_t ancestral_length = CheckpointRead<uint64_t>(cursor, end);
+	const char *ancestral_sequence = CheckpointTake(cursor, end, ancestral_length, 1);
+	
+	if (nucleotide_based_)
+	{
+		if (ancestral_length == 0)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): this is a nucleotide-based model, but there is no reference nucleotide sequence." << EidosTerminate();
+		if (ancestral_length != chromosome_->AncestralSequence()->size())
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): the reference nucleotide sequence length does not match the model." << EidosTerminate();
+		
+		chromosome_->AncestralSequence()->ReadNucleotidesFromBuffer(ancestral_sequence);
+	}
+	
+	// replay the complete records in order; a final record cut short by an interrupted write is ignored
+	const char *state = nullptr, *state_end = nullptr;
+	
+	while ((size_t)(end - cursor) >= sizeof(int32_t) + sizeof(uint64_t))
+	{
+		int32_t record_tag = CheckpointRead<int32_t>(cursor, end);
+		uint64_t record_length = CheckpointRead<uint64_t>(cursor, end);
+		
+		if (record_tag != SLIM_CHECKPOINT_RECORD_TAG)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file is truncated or malformed; this file cannot be read." << EidosTerminate();
+		if (record_length > (uint64_t)(end - cursor))
+			break;
+		
+		state_end = cursor + record_length;
+		CheckpointReplayRecord(&tables_, cursor, state_end);
+		state = cursor;
+		cursor = state_end;
+	}
+	
+	if (!state)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file contains no complete checkpoint record; this file cannot be read." << EidosTerminate();
+	
+	// Now finish the tables from the model state of the last record, as WriteTreeSequence() finishes its copy of the tables
+	// when it does not simplify; the result is what treeSeqOutput(simplify=F) would have written at the time of that record
+	slim_generation_t record_tree_seq_generation = CheckpointRead<slim_generation_t>(state, state_end);
+	uint64_t metadata_length = CheckpointRead<uint64_t>(state, state_end);
+	const char *metadata = CheckpointTake(state, state_end, metadata_length, 1);
+	uint64_t alive_count = CheckpointRead<uint64_t>(state, state_end);
+	
+	int flags = TSK_NO_CHECK_INTEGRITY;
+#if DEBUG
+	flags = 0;
+#endif
+	SortTreeSequenceTables(&tables_, flags);
+	
+	ret = tsk_table_collection_deduplicate_sites(&tables_, 0);
+	if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
+	
+	ret = tsk_table_collection_build_index(&tables_, 0);
+	if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
+	ret = tsk_table_collection_compute_mutation_parents(&tables_, 0);
+	if (ret < 0) handle_error("tsk_table_collection_compute_mutation_parents", ret);
+	
+	// add the individuals alive at the time of the record, and order them first in the individuals table, as they were
+	std::vector<int> individual_map;
+	
+	{
+		INDIVIDUALS_HASH local_individuals_lookup;
+		
+		BuildTabledIndividualsHash(&tables_, &local_individuals_lookup);
+		
+		for (uint64_t alive_index = 0; alive_index < alive_count; ++alive_index)
+		{
+			tsk_id_t node1 = CheckpointRead<tsk_id_t>(state, state_end);
+			tsk_id_t node2 = CheckpointRead<tsk_id_t>(state, state_end);
+			double location[3];
+			
+			location[0] = CheckpointRead<double>(state, state_end);
+			location[1] = CheckpointRead<double>(state, state_end);
+			location[2] = CheckpointRead<double>(state, state_end);
+			
+			IndividualMetadataRec metadata_rec = CheckpointRead<IndividualMetadataRec>(state, state_end);
+			
+			if ((node1 < 0) || ((tsk_size_t)node1 >= tables_.nodes.num_rows) || (node2 < 0) || ((tsk_size_t)node2 >= tables_.nodes.num_rows))
+				EIDOS_TERMINATION << "ERROR (SLiMSim::_InitializePopulationFromCheckpointFile): checkpoint file is truncated or malformed; this file cannot be read." << EidosTerminate();
+			
+			AddIndividualRowToTable(node1, node2, location, &metadata_rec, &tables_, &local_individuals_lookup, SLIM_TSK_INDIVIDUAL_ALIVE);
+			individual_map.emplace_back(tables_.nodes.individual[node1]);
+		}
+	}
+	
+	ReorderIndividualTable(&tables_, individual_map, true);
+	
+	{
+		INDIVIDUALS_HASH local_individuals_lookup;
+		
+		BuildTabledIndividualsHash(&tables_, &local_individuals_lookup);
+		AddParentsColumnForOutput(&tables_, &local_individuals_lookup);
+	}
+	
+	for (size_t node_index = 0; node_index < tables_.nodes.num_rows; ++node_index)
+		tables_.nodes.time[node_index] += record_tree_seq_generation;
+	
+	for (size_t mut_index = 0; mut_index < tables_.mutations.num_rows; ++mut_index)
+		tables_.mutations.time[mut_index] += record_tree_seq_generation;
+	
+	// the metadata schemas are ours, but the top-level metadata is that of the record
+	WriteTreeSequenceMetadata(&tables_, nullptr);
+	
+	ret = tsk_table_collection_set_metadata(&tables_, metadata, (tsk_size_t)metadata_length);
+	if (ret < 0) handle_error("tsk_table_collection_set_metadata", ret);
+	
+	ret = tsk_table_collection_set_time_units(&tables_, treeseq_time_unit_.c_str(), treeseq_time_unit_.length());
+	if (ret < 0) handle_error("tsk_table_collection_set_time_units", ret);
+	
+	// from here on this is a load of those tables, as in _InitializePopulationFromTskitBinaryFile()
+	ret = tsk_table_collection_drop_index(&tables_, 0);
+	if (ret != 0) handle_error("tsk_table_collection_drop_index", ret);
+	
+	RecordTablePosition();
+	
+	slim_generation_t metadata_gen;
+	SLiMModelType file_model_type;
+	int file_version;
+	
+	ReadTreeSequenceMetadata(&tables_, &metadata_gen, &file_model_type, &file_version);
+	
+	_InstantiateSLiMObjectsFromTables(p_interpreter, metadata_gen, file_model_type, file_version);
+	
+	if (!was_recording_tree)
+	{
+		FreeTreeSequence();
+		recording_tree_ = false;
+		recording_mutations_ = false;
+	}
+	
+	return metadata_gen;
+}
+
 size_t SLiMSim::MemoryUsageForTables(tsk_table_collection_t &p_tables)
 {
 	tsk_table_collection_t &t = p_tables;
@@ -33,6 +33,8 @@
 #include <iostream>
 #include <ctime>
 #include <unordered_set>
+#include <unordered_map>
+#include <deque>
 
 #include "slim_globals.h"
 #include "mutation.h"
@@ -114,9 +116,11 @@ enum class SLiMFileFormat
 	kFormatUnrecognized = 0,
 	kFormatSLiMText,				// as saved by outputFull(filePath, binary=F)
 	kFormatSLiMBinary,				// as saved by outputFull(filePath, binary=T)
+	kFormatSLiMCompressed,			// as saved by outputFull(filePath, compress=T), in either of the two formats above
 	kFormatTskitText,				// as saved by treeSeqOutput(path, binary=F)
 	kFormatTskitBinary_HDF5,		// old file format, no longer supported
 	kFormatTskitBinary_kastore,	// as saved by treeSeqOutput(path, binary=T)
+	kFormatSLiMCheckpoint,			// as saved by treeSeqCheckpoint(path)
 };
 
 
@@ -381,8 +385,8 @@ private:
 	SLiMFileFormat FormatOfPopulationFile(const std::string &p_file_string);		// determine the format of a file/folder at the given path using leading bytes, etc.
 	void InitializeFromFile(std::istream &p_infile);								// parse a input file and set up the simulation state from its contents
 	slim_generation_t InitializePopulationFromFile(const std::string &p_file_string, EidosInterpreter *p_interpreter);	// initialize the population from the file
-	slim_generation_t _InitializePopulationFromTextFile(const char *p_file, EidosInterpreter *p_interpreter);			// initialize the population from a SLiM text file
-	slim_generation_t _InitializePopulationFromBinaryFile(const char *p_file, EidosInterpreter *p_interpreter);			// initialize the population from a SLiM binary file
+	slim_generation_t _InitializePopulationFromTextFile(const std::string &p_file_contents, EidosInterpreter *p_interpreter);	// initialize the population from a SLiM text file's contents
+	slim_generation_t _InitializePopulationFromBinaryFile(std::string &p_file_contents, EidosInterpreter *p_interpreter);		// initialize the population from a SLiM binary file's contents
 	
 	// initialization completeness check counts; used only when running initialize() callbacks
 	int num_interaction_types_;
@@ -406,6 +410,25 @@ private:
 	bool pedigrees_enabled_by_user_ = false;		// pedigree tracking was turned on by the user, which is user-visible
 	bool pedigrees_enabled_by_SLiM_ = false;		// pedigree tracking has been forced on by tree-seq recording or SLiMgui, which is not user-visible
 	
+	// deep pedigree store, for kinship(): the parent pedigree IDs of every individual born in each of the last pedigree_depth_
+	// generations, kept as one record per generation covering a contiguous range of pedigree IDs (which are assigned sequentially)
+	struct PedigreeGenerationRecord {
+		slim_pedigreeid_t first_id_;														// the pedigree ID of parents_[0]
+		std::vector<std::pair<slim_pedigreeid_t, slim_pedigreeid_t>> parents_;			// parent pedigree IDs, -1 if unknown
+	};
+	struct PedigreePairHash {
+		std::size_t operator()(const std::pair<slim_pedigreeid_t, slim_pedigreeid_t> &p_pair) const { return std::hash<slim_pedigreeid_t>()(p_pair.first * 0x9E3779B97F4A7C15ULL + p_pair.second); }
+	};
+	
+#define SLIM_KINSHIP_CACHE_MAX_ENTRIES	(1 << 22)	// kinship_cache_ is cleared between queries when it gets bigger than this (roughly 200 MB)
+	
+	slim_generation_t pedigree_depth_ = 0;						// the number of generations kept in pedigree_store_; 0 means the store is off
+	std::deque<PedigreeGenerationRecord> pedigree_store_;		// the generations recorded, oldest first
+	slim_pedigreeid_t pedigree_store_next_id_ = 0;				// the first pedigree ID not yet covered by pedigree_store_
+	std::unordered_map<std::pair<slim_pedigreeid_t, slim_pedigreeid_t>, double, PedigreePairHash> kinship_cache_;	// memoized kinship values; valid until pedigree_store_ changes
+	std::vector<std::pair<slim_pedigreeid_t, slim_pedigreeid_t>> kinship_stack_;	// the work stack for KinshipCoefficient(), kept to reuse its buffer
+	Individual *kinship_query_ind1_ = nullptr, *kinship_query_ind2_ = nullptr;		// queried individuals, which might not be in pedigree_store_ yet
+	
 	// continuous space support
 	int spatial_dimensionality_ = 0;
 	bool periodic_x_ = false;
@@ -487,6 +510,7 @@ private:
 	
 	bool running_treeseq_crosschecks_ = false;	// true if crosschecks between our tree sequence tables and SLiM's data are enabled
 	int treeseq_crosschecks_interval_ = 1;		// crosschecks, if enabled, will be done every treeseq_crosschecks_interval_ generations
+	size_t treeseq_crosschecks_sample_size_ = 0;	// crosschecks, if enabled, will check a random sample of this many genomes; 0 checks all genomes
 	
 	double simplification_ratio_;				// the pre:post table size ratio we target with our automatic simplification heuristic
 	int64_t simplification_interval_;			// the generation interval between simplifications; -1 if not used (in which case the ratio is used)
@@ -501,6 +525,12 @@ private:
 												// to addSubpopSplit() arrive at successively later times; see Population::AddSubpopulationSplit()
 	std::string treeseq_time_unit_;				// set in initializeTreeSeq(), written out to .trees; has no effect on the simulation, just user data
 	
+	// treeSeqCheckpoint() appends the rows added to tables_ since its last record; anything that rewrites tables_ clears checkpoint_path_ to force a new base
+	std::string checkpoint_path_;							// the resolved path of the checkpoint file being appended to, or empty if a new base is needed
+	tsk_bookmark_t checkpoint_position_;					// the row counts of tables_ as of the last checkpoint record
+	std::vector<tsk_id_t> checkpoint_changed_individuals_;	// individuals table rows below checkpoint_position_ that have been modified in place since
+	std::vector<tsk_id_t> checkpoint_changed_nodes_;		// node table rows below checkpoint_position_ whose individual has been set since
+	
 public:
 	
 	// optimization of the pure neutral case; this is set to false if (a) a non-neutral mutation is added by the user, (b) a genomic element type is configured to use a
@@ -647,6 +677,12 @@ public:
 	inline __attribute__((always_inline)) bool SexEnabled(void) const														{ return sex_enabled_; }
 	inline __attribute__((always_inline)) bool PedigreesEnabled(void) const													{ return pedigrees_enabled_; }
 	inline __attribute__((always_inline)) bool PedigreesEnabledByUser(void) const											{ return pedigrees_enabled_by_user_; }
+	
+	void RecordPedigreeGeneration(void);
+	void ClearPedigreeStore(void);
+	void PedigreeParents(slim_pedigreeid_t p_id, slim_pedigreeid_t *p_parent1, slim_pedigreeid_t *p_parent2);
+	double KinshipCoefficient(slim_pedigreeid_t p_id1, slim_pedigreeid_t p_id2);
+	double KinshipOfIndividuals(Individual *p_ind1, Individual *p_ind2);
 	inline __attribute__((always_inline)) bool PreventIncidentalSelfing(void) const											{ return prevent_incidental_selfing_; }
 	inline __attribute__((always_inline)) GenomeType ModeledChromosomeType(void) const										{ return modeled_chromosome_type_; }
 	inline __attribute__((always_inline)) int SpatialDimensionality(void) const												{ return spatial_dimensionality_; }
@@ -694,6 +730,8 @@ public:
 	static void TreeSequenceDataToAscii(tsk_table_collection_t *p_tables);
 	static void DerivedStatesFromAscii(tsk_table_collection_t *p_tables);
 	static void DerivedStatesToAscii(tsk_table_collection_t *p_tables);
+	static void CopyTablesSharingEdgesAndSites(tsk_table_collection_t *p_source, tsk_table_collection_t *p_dest);
+	static void UnshareEdgesAndSites(tsk_table_collection_t *p_tables);
 	
 	bool SubpopulationIDInUse(slim_objectid_t p_subpop_id);
 	void RecordTablePosition(void);
@@ -703,6 +741,7 @@ public:
 	void RecordNewDerivedState(const Genome *p_genome, slim_position_t p_position, const std::vector<Mutation *> &p_derived_mutations);
 	void RetractNewIndividual(void);
 	void AddIndividualsToTable(Individual * const *p_individual, size_t p_num_individuals, tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash, tsk_flags_t p_flags);
+	void AddIndividualRowToTable(tsk_id_t p_node1, tsk_id_t p_node2, const double *p_location, const IndividualMetadataRec *p_metadata_rec, tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash, tsk_flags_t p_flags);
 	void AddCurrentGenerationToIndividuals(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
 	void UnmarkFirstGenerationSamples(tsk_table_collection_t *p_tables);
 	void RemarkFirstGenerationSamples(tsk_table_collection_t *p_tables);
@@ -712,9 +751,11 @@ public:
 	void WriteTreeSequenceMetadata(tsk_table_collection_t *p_tables, EidosDictionaryUnretained *p_metadata_dict);
 	void ReadTreeSequenceMetadata(tsk_table_collection_t *p_tables, slim_generation_t *p_generation, SLiMModelType *p_model_type, int *p_file_version);
 	void WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict);
+	void WriteTreeSequenceCheckpoint(std::string &p_checkpoint_path);
     void ReorderIndividualTable(tsk_table_collection_t *p_tables, std::vector<int> p_individual_map, bool p_keep_unmapped);
 	void AddParentsColumnForOutput(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
 	void BuildTabledIndividualsHash(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
+	void SortTreeSequenceTables(tsk_table_collection_t *p_tables, tsk_flags_t p_flags);
 	void SimplifyTreeSequence(void);
 	void CheckCoalescenceAfterSimplification(void);
 	void CheckAutoSimplification(void);
@@ -724,9 +765,10 @@ public:
 	void FreeTreeSequence();
 	void RecordAllDerivedStatesFromSLiM(void);
 	void DumpMutationTable(void);
+	void TreeSequenceForSample(std::vector<tsk_id_t> &p_samples, tsk_table_collection_t *p_tables, tsk_treeseq_t *p_ts);
 	void CheckTreeSeqIntegrity(void);		// checks the tree sequence tables themselves
 	void CrosscheckTreeSeqIntegrity(void);	// checks the tree sequence tables against SLiM's data structures
-	void TSXC_Enable(void);                 // forces tree-seq with crosschecks on; called by the undocumented -TSXC option
+	void TSXC_Enable(size_t p_sample_size);	// forces tree-seq with crosschecks on; called by the undocumented -TSXC [<n>] option
     void TSF_Enable(void);                  // forces tree-seq without crosschecks on; called by the undocumented -TSF option
 	
 	void __TabulateSubpopulationsFromTreeSequence(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, tsk_treeseq_t *p_ts, SLiMModelType p_file_model_type);
@@ -739,6 +781,7 @@ public:
 	void _InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter, slim_generation_t p_metadata_gen, SLiMModelType p_file_model_type, int p_file_version);	// given tree-seq tables, makes individuals, genomes, and mutations
 	slim_generation_t _InitializePopulationFromTskitTextFile(const char *p_file, EidosInterpreter *p_interpreter);	// initialize the population from an tskit text file
 	slim_generation_t _InitializePopulationFromTskitBinaryFile(const char *p_file, EidosInterpreter *p_interpreter);	// initialize the population from an tskit binary file
+	slim_generation_t _InitializePopulationFromCheckpointFile(const char *p_file, EidosInterpreter *p_interpreter);	// initialize the population from a treeSeqCheckpoint() file
 	size_t MemoryUsageForTables(tsk_table_collection_t &p_tables);
 	
 	//
@@ -789,6 +832,7 @@ public:
 	EidosValue_SP ExecuteMethod_createLogFile(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_deregisterScriptBlock(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_individualsWithPedigreeIDs(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
+	EidosValue_SP ExecuteMethod_kinship(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_mutationFreqsCounts(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_mutationsOfType(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_countOfMutationsOfType(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
@@ -811,6 +855,8 @@ public:
 	EidosValue_SP ExecuteMethod_treeSeqSimplify(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_treeSeqRememberIndividuals(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
+	EidosValue_SP ExecuteMethod_treeSeqCheckpoint(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
+	EidosValue_SP ExecuteMethod_treeSeqStatistic(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 };
 
 class SLiMSim_Class : public EidosDictionaryUnretained_Class
@@ -25,10 +25,12 @@
 #include "subpopulation.h"
 #include "polymorphism.h"
 #include "log_file.h"
+#include "eidos_parallel.h"
 
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <algorithm>
@@ -1119,7 +1121,7 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeSex(const std::string &p
 	return gStaticEidosValueVOID;
 }
 
-//	*********************	(void)initializeSLiMOptions([logical$ keepPedigrees = F], [string$ dimensionality = ""], [string$ periodicity = ""], [integer$ mutationRuns = 0], [logical$ preventIncidentalSelfing = F], [logical$ nucleotideBased = F])
+//	*********************	(void)initializeSLiMOptions([logical$ keepPedigrees = F], [string$ dimensionality = ""], [string$ periodicity = ""], [integer$ mutationRuns = 0], [logical$ preventIncidentalSelfing = F], [logical$ nucleotideBased = F], [integer$ pedigreeDepth = 0], [Ni$ maxThreads = NULL], [Ni$ parallelThreshold = NULL])
 //
 EidosValue_SP SLiMSim::ExecuteContextFunction_initializeSLiMOptions(const std::string &p_function_name, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -1130,6 +1132,9 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeSLiMOptions(const std::s
 	EidosValue *arg_mutationRuns_value = p_arguments[3].get();
 	EidosValue *arg_preventIncidentalSelfing_value = p_arguments[4].get();
 	EidosValue *arg_nucleotideBased_value = p_arguments[5].get();
+	EidosValue *arg_pedigreeDepth_value = p_arguments[6].get();
+	EidosValue *arg_maxThreads_value = p_arguments[7].get();
+	EidosValue *arg_parallelThreshold_value = p_arguments[8].get();
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	
 	if (num_options_declarations_ > 0)
@@ -1239,6 +1244,47 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeSLiMOptions(const std::s
 		nucleotide_based_ = nucleotide_based;
 	}
 	
+	{
+		// [integer$ pedigreeDepth = 0]
+		int64_t pedigree_depth = arg_pedigreeDepth_value->IntAtIndex(0, nullptr);
+		
+		if (pedigree_depth != 0)
+		{
+			if ((pedigree_depth < 0) || (pedigree_depth > 10000))
+				EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteContextFunction_initializeSLiMOptions): in initializeSLiMOptions(), parameter pedigreeDepth must be between 0 and 10000, inclusive." << EidosTerminate();
+			if (!pedigrees_enabled_by_user_)
+				EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteContextFunction_initializeSLiMOptions): in initializeSLiMOptions(), parameter pedigreeDepth may be non-zero only when keepPedigrees is T." << EidosTerminate();
+			
+			pedigree_depth_ = (slim_generation_t)pedigree_depth;
+		}
+	}
+	
+	{
+		// [Ni$ maxThreads = NULL]; NULL leaves the command-line setting (or the default of 1) in effect
+		if (arg_maxThreads_value->Type() != EidosValueType::kValueNULL)
+		{
+			int64_t max_threads = arg_maxThreads_value->IntAtIndex(0, nullptr);
+			
+			if ((max_threads < 0) || (max_threads > EIDOS_MAX_THREADS))
+				EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteContextFunction_initializeSLiMOptions): in initializeSLiMOptions(), parameter maxThreads must be between 0 and " << EIDOS_MAX_THREADS << ", inclusive." << EidosTerminate();
+			
+			Eidos_SetMaxThreads(max_threads);
+		}
+	}
+	
+	{
+		// [Ni$ parallelThreshold = NULL]; NULL leaves the command-line setting (or the default) in effect
+		if (arg_parallelThreshold_value->Type() != EidosValueType::kValueNULL)
+		{
+			int64_t parallel_threshold = arg_parallelThreshold_value->IntAtIndex(0, nullptr);
+			
+			if (parallel_threshold < 0)
+				EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteContextFunction_initializeSLiMOptions): in initializeSLiMOptions(), parameter parallelThreshold must be greater than or equal to 0." << EidosTerminate();
+			
+			Eidos_SetParallelThreshold(parallel_threshold);
+		}
+	}
+	
 	if (SLiM_verbosity_level >= 1)
 	{
 		output_stream << "initializeSLiMOptions(";
@@ -1296,6 +1342,27 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeSLiMOptions(const std::s
 			if (previous_params) output_stream << ", ";
 			output_stream << "nucleotideBased = " << (nucleotide_based_ ? "T" : "F");
 			previous_params = true;
+		}
+		
+		if (pedigree_depth_)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "pedigreeDepth = " << pedigree_depth_;
+			previous_params = true;
+		}
+		
+		if (arg_maxThreads_value->Type() != EidosValueType::kValueNULL)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "maxThreads = " << gEidosMaxThreads;
+			previous_params = true;
+		}
+		
+		if (arg_parallelThreshold_value->Type() != EidosValueType::kValueNULL)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "parallelThreshold = " << gEidosParallelThreshold;
+			previous_params = true;
 			(void)previous_params;	// dead store above is deliberate
 		}
 		
@@ -1543,7 +1610,7 @@ const std::vector<EidosFunctionSignature_CSP> *SLiMSim::ZeroGenerationFunctionSi
 		sim_0_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature(gStr_initializeSex, nullptr, kEidosValueMaskVOID, "SLiM"))
 										->AddString_S("chromosomeType"));	// removed ->AddNumeric_OS("xDominanceCoeff", gStaticEidosValue_Float1) in SLiM 3.7
 		sim_0_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature(gStr_initializeSLiMOptions, nullptr, kEidosValueMaskVOID, "SLiM"))
-									   ->AddLogical_OS("keepPedigrees", gStaticEidosValue_LogicalF)->AddString_OS("dimensionality", gStaticEidosValue_StringEmpty)->AddString_OS("periodicity", gStaticEidosValue_StringEmpty)->AddInt_OS("mutationRuns", gStaticEidosValue_Integer0)->AddLogical_OS("preventIncidentalSelfing", gStaticEidosValue_LogicalF)->AddLogical_OS("nucleotideBased", gStaticEidosValue_LogicalF));
+									   ->AddLogical_OS("keepPedigrees", gStaticEidosValue_LogicalF)->AddString_OS("dimensionality", gStaticEidosValue_StringEmpty)->AddString_OS("periodicity", gStaticEidosValue_StringEmpty)->AddInt_OS("mutationRuns", gStaticEidosValue_Integer0)->AddLogical_OS("preventIncidentalSelfing", gStaticEidosValue_LogicalF)->AddLogical_OS("nucleotideBased", gStaticEidosValue_LogicalF)->AddInt_OS("pedigreeDepth", gStaticEidosValue_Integer0)->AddInt_OSN("maxThreads", gStaticEidosValueNULL)->AddInt_OSN("parallelThreshold", gStaticEidosValueNULL));
 		sim_0_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature(gStr_initializeTreeSeq, nullptr, kEidosValueMaskVOID, "SLiM"))
 									   ->AddLogical_OS("recordMutations", gStaticEidosValue_LogicalT)->AddNumeric_OSN("simplificationRatio", gStaticEidosValueNULL)->AddInt_OSN("simplificationInterval", gStaticEidosValueNULL)->AddLogical_OS("checkCoalescence", gStaticEidosValue_LogicalF)->AddLogical_OS("runCrosschecks", gStaticEidosValue_LogicalF)->AddLogical_OS("retainCoalescentOnly", gStaticEidosValue_LogicalT)->AddString_OSN("timeUnit", gStaticEidosValueNULL));
 		sim_0_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature(gStr_initializeSLiMModelType, nullptr, kEidosValueMaskVOID, "SLiM"))
@@ -1947,6 +2014,7 @@ EidosValue_SP SLiMSim::ExecuteInstanceMethod(EidosGlobalStringID p_method_id, co
 		case gID_createLogFile:					return ExecuteMethod_createLogFile(p_method_id, p_arguments, p_interpreter);
 		case gID_deregisterScriptBlock:			return ExecuteMethod_deregisterScriptBlock(p_method_id, p_arguments, p_interpreter);
 		case gID_individualsWithPedigreeIDs:	return ExecuteMethod_individualsWithPedigreeIDs(p_method_id, p_arguments, p_interpreter);
+		case gID_kinship:						return ExecuteMethod_kinship(p_method_id, p_arguments, p_interpreter);
 		case gID_mutationFrequencies:
 		case gID_mutationCounts:				return ExecuteMethod_mutationFreqsCounts(p_method_id, p_arguments, p_interpreter);
 		case gID_mutationsOfType:				return ExecuteMethod_mutationsOfType(p_method_id, p_arguments, p_interpreter);
@@ -1975,6 +2043,8 @@ EidosValue_SP SLiMSim::ExecuteInstanceMethod(EidosGlobalStringID p_method_id, co
 		case gID_treeSeqSimplify:				return ExecuteMethod_treeSeqSimplify(p_method_id, p_arguments, p_interpreter);
 		case gID_treeSeqRememberIndividuals:	return ExecuteMethod_treeSeqRememberIndividuals(p_method_id, p_arguments, p_interpreter);
 		case gID_treeSeqOutput:					return ExecuteMethod_treeSeqOutput(p_method_id, p_arguments, p_interpreter);
+		case gID_treeSeqCheckpoint:				return ExecuteMethod_treeSeqCheckpoint(p_method_id, p_arguments, p_interpreter);
+		case gID_treeSeqStatistic:				return ExecuteMethod_treeSeqStatistic(p_method_id, p_arguments, p_interpreter);
 		default:								return super::ExecuteInstanceMethod(p_method_id, p_arguments, p_interpreter);
 	}
 }
@@ -2075,7 +2145,7 @@ EidosValue_SP SLiMSim::ExecuteMethod_addSubpopSplit(EidosGlobalStringID p_method
 }
 #endif	// SLIM_WF_ONLY
 
-//	*********************	– (object<LogFile>$)createLogFile(string$ filePath, [Ns initialContents = NULL], [logical$ append = F], [logical$ compress = F], [string$ sep = ","], [Ni$ logInterval = NULL], [Ni$ flushInterval = NULL])
+//	*********************	– (object<LogFile>$)createLogFile(string$ filePath, [Ns initialContents = NULL], [logical$ append = F], [logical$ compress = F], [string$ sep = ","], [Ni$ logInterval = NULL], [Ni$ flushInterval = NULL], [logical$ binary = F])
 EidosValue_SP SLiMSim::ExecuteMethod_createLogFile(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
 #pragma unused (p_method_id, p_arguments, p_interpreter)
@@ -2088,6 +2158,7 @@ EidosValue_SP SLiMSim::ExecuteMethod_createLogFile(EidosGlobalStringID p_method_
 	EidosValue_String *sep_value = (EidosValue_String *)p_arguments[4].get();
 	EidosValue *logInterval_value = p_arguments[5].get();
 	EidosValue *flushInterval_value = p_arguments[6].get();
+	EidosValue *binary_value = p_arguments[7].get();
 	
 	// process parameters
 	const std::string &filePath = filePath_value->StringRefAtIndex(0, nullptr);
@@ -2095,6 +2166,7 @@ EidosValue_SP SLiMSim::ExecuteMethod_createLogFile(EidosGlobalStringID p_method_
 	bool append = append_value->LogicalAtIndex(0, nullptr);
 	bool do_compress = compress_value->LogicalAtIndex(0, nullptr);
 	const std::string &sep = sep_value->StringRefAtIndex(0, nullptr);
+	bool binary = binary_value->LogicalAtIndex(0, nullptr);
 	bool autologging = false, explicitFlushing = false;
 	int64_t logInterval = 0, flushInterval = 0;
 	
@@ -2141,7 +2213,7 @@ EidosValue_SP SLiMSim::ExecuteMethod_createLogFile(EidosGlobalStringID p_method_
 	// Configure it
 	logfile->SetLogInterval(autologging, logInterval);
 	logfile->SetFlushInterval(explicitFlushing, flushInterval);
-	logfile->ConfigureFile(filePath, initialContents, append, do_compress, sep);
+	logfile->ConfigureFile(filePath, initialContents, append, do_compress, sep, binary);
 	
 	return result_SP;
 }
@@ -2327,6 +2399,62 @@ EidosValue_SP SLiMSim::ExecuteMethod_individualsWithPedigreeIDs(EidosGlobalStrin
 	}
 }
 
+//	*********************	– (float)kinship(object<Individual> individuals1, [No<Individual> individuals2 = NULL])
+EidosValue_SP SLiMSim::ExecuteMethod_kinship(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+#pragma unused (p_method_id, p_interpreter)
+	if (pedigree_depth_ == 0)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_kinship): kinship() may only be called when a pedigree depth has been set with initializeSLiMOptions(pedigreeDepth=...)." << EidosTerminate();
+	
+	EidosValue *individuals1_value = p_arguments[0].get();
+	EidosValue *individuals2_value = p_arguments[1].get();
+	int individuals1_count = individuals1_value->Count();
+	
+	if (individuals2_value->Type() == EidosValueType::kValueNULL)
+	{
+		// individuals2 is NULL; return the symmetric matrix of kinship among individuals1
+		EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(individuals1_count * individuals1_count);
+		
+		for (int index1 = 0; index1 < individuals1_count; ++index1)
+		{
+			Individual *ind1 = (Individual *)individuals1_value->ObjectElementAtIndex(index1, nullptr);
+			
+			for (int index2 = index1; index2 < individuals1_count; ++index2)
+			{
+				Individual *ind2 = (Individual *)individuals1_value->ObjectElementAtIndex(index2, nullptr);
+				double kinship = KinshipOfIndividuals(ind1, ind2);
+				
+				float_result->set_float_no_check(kinship, index1 + index2 * individuals1_count);
+				float_result->set_float_no_check(kinship, index2 + index1 * individuals1_count);
+			}
+		}
+		
+		const int64_t dims[2] = {individuals1_count, individuals1_count};
+		float_result->SetDimensions(2, dims);
+		
+		return EidosValue_SP(float_result);
+	}
+	
+	// otherwise, individuals1 and individuals2 are paired up elementwise, with a singleton matched against every element of the other
+	int individuals2_count = individuals2_value->Count();
+	
+	if ((individuals1_count != individuals2_count) && (individuals1_count != 1) && (individuals2_count != 1))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_kinship): kinship() requires that individuals1 and individuals2 be the same length, or that one of them be a singleton." << EidosTerminate();
+	
+	int result_count = ((individuals1_count == 0) || (individuals2_count == 0)) ? 0 : std::max(individuals1_count, individuals2_count);
+	EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(result_count);
+	
+	for (int index = 0; index < result_count; ++index)
+	{
+		Individual *ind1 = (Individual *)individuals1_value->ObjectElementAtIndex((individuals1_count == 1) ? 0 : index, nullptr);
+		Individual *ind2 = (Individual *)individuals2_value->ObjectElementAtIndex((individuals2_count == 1) ? 0 : index, nullptr);
+		
+		float_result->set_float_no_check(KinshipOfIndividuals(ind1, ind2), index);
+	}
+	
+	return EidosValue_SP(float_result);
+}
+
 //	*********************	– (float)mutationFrequencies(Nio<Subpopulation> subpops, [No<Mutation> mutations = NULL])
 //	*********************	– (integer)mutationCounts(Nio<Subpopulation> subpops, [No<Mutation> mutations = NULL])
 //
@@ -2621,7 +2749,7 @@ EidosValue_SP SLiMSim::ExecuteMethod_outputFixedMutations(EidosGlobalStringID p_
 	return gStaticEidosValueVOID;
 }
 			
-//	*********************	– (void)outputFull([Ns$ filePath = NULL], [logical$ binary = F], [logical$ append=F], [logical$ spatialPositions = T], [logical$ ages = T], [logical$ ancestralNucleotides = T], [logical$ pedigreeIDs = F])
+//	*********************	– (void)outputFull([Ns$ filePath = NULL], [logical$ binary = F], [logical$ append=F], [logical$ spatialPositions = T], [logical$ ages = T], [logical$ ancestralNucleotides = T], [logical$ pedigreeIDs = F], [logical$ compress = F])
 //
 EidosValue_SP SLiMSim::ExecuteMethod_outputFull(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -2633,6 +2761,7 @@ EidosValue_SP SLiMSim::ExecuteMethod_outputFull(EidosGlobalStringID p_method_id,
 	EidosValue *ages_value = p_arguments[4].get();
 	EidosValue *ancestralNucleotides_value = p_arguments[5].get();
 	EidosValue *pedigreeIDs_value = p_arguments[6].get();
+	EidosValue *compress_value = p_arguments[7].get();
 	
 	if (!warned_early_output_)
 	{
@@ -2653,6 +2782,7 @@ EidosValue_SP SLiMSim::ExecuteMethod_outputFull(EidosGlobalStringID p_method_id,
 	bool output_ages = ages_value->LogicalAtIndex(0, nullptr);
 	bool output_ancestral_nucs = ancestralNucleotides_value->LogicalAtIndex(0, nullptr);
 	bool output_pedigree_ids = pedigreeIDs_value->LogicalAtIndex(0, nullptr);
+	bool compress = compress_value->LogicalAtIndex(0, nullptr);
 	
 	if (output_pedigree_ids && !PedigreesEnabledByUser())
 		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_outputFull): outputFull() cannot output pedigree IDs, because pedigree recording has not been enabled." << EidosTerminate();
@@ -2661,12 +2791,40 @@ EidosValue_SP SLiMSim::ExecuteMethod_outputFull(EidosGlobalStringID p_method_id,
 	{
 		if (use_binary)
 			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_outputFull): outputFull() cannot output in binary format to the standard output stream; specify a file for output." << EidosTerminate();
+		if (compress)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_outputFull): outputFull() cannot output compressed data to the standard output stream; specify a file for output." << EidosTerminate();
 		
 		std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 		
 		output_stream << "#OUT: " << generation_ << " A" << std::endl;
 		population_.PrintAll(output_stream, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids);
 	}
+	else if (compress)
+	{
+		// Compressed output is assembled in memory and then written out in BGZF format, as independently compressed blocks, which
+		// readFromPopulationFile() decompresses; as for writeFile(), ".gz" is added if needed
+		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex(0, nullptr));
+		bool append = append_value->LogicalAtIndex(0, nullptr);
+		std::ostringstream outstream;
+		
+		if (use_binary && append)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_outputFull): outputFull() cannot append in binary format." << EidosTerminate();
+		
+		if (!Eidos_string_hasSuffix(outfile_path, ".gz"))
+			outfile_path.append(".gz");
+		
+		if (use_binary)
+		{
+			population_.PrintAllBinary(outstream, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids);
+		}
+		else
+		{
+			outstream << "#OUT: " << generation_ << " A " << outfile_path << std::endl;
+			population_.PrintAll(outstream, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids);
+		}
+		
+		Eidos_WriteBGZFFile(outfile_path, outstream.str(), append);
+	}
 	else
 	{
 		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex(0, nullptr));
@@ -3867,6 +4025,296 @@ EidosValue_SP SLiMSim::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_
 }
 
 
+// TREE SEQUENCE RECORDING
+//	*********************	- (void)treeSeqCheckpoint(string$ path)
+//
+EidosValue_SP SLiMSim::ExecuteMethod_treeSeqCheckpoint(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+#pragma unused (p_method_id, p_interpreter)
+	EidosValue *path_value = p_arguments[0].get();
+	
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqCheckpoint): treeSeqCheckpoint() may only be called when tree recording is enabled." << EidosTerminate();
+	
+	SLiMGenerationStage gen_stage = GenerationStage();
+	
+	if ((gen_stage != SLiMGenerationStage::kWFStage0ExecuteFirstScripts) && (gen_stage != SLiMGenerationStage::kWFStage1ExecuteEarlyScripts) && (gen_stage != SLiMGenerationStage::kWFStage5ExecuteLateScripts) &&
+		(gen_stage != SLiMGenerationStage::kNonWFStage0ExecuteFirstScripts) && (gen_stage != SLiMGenerationStage::kNonWFStage2ExecuteEarlyScripts) && (gen_stage != SLiMGenerationStage::kNonWFStage6ExecuteLateScripts))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqCheckpoint): treeSeqCheckpoint() may only be called from a first(), early(), or late() event." << EidosTerminate();
+	if ((executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventFirst) && (executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventEarly) && (executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventLate))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqCheckpoint): treeSeqCheckpoint() may not be called from inside a callback." << EidosTerminate();
+	
+	std::string path_string = path_value->StringAtIndex(0, nullptr);
+	
+	std::clock_t before = clock();
+	WriteTreeSequenceCheckpoint(path_string);
+	
+	// we want to exclude this method's time from mutation run experiments, as for treeSeqOutput()
+	x_excluded_clocks_ += (clock() - before);
+	
+	return gStaticEidosValueVOID;
+}
+
+
+// TREE SEQUENCE RECORDING
+//	*********************	- (float)treeSeqStatistic(string$ statistic, object<Genome> genomes, [Ni sampleSets = NULL], [Nif windows = NULL], [string$ mode = "site"])
+//
+EidosValue_SP SLiMSim::ExecuteMethod_treeSeqStatistic(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+#pragma unused (p_method_id, p_interpreter)
+	EidosValue *statistic_value = p_arguments[0].get();
+	EidosValue *genomes_value = p_arguments[1].get();
+	EidosValue *sampleSets_value = p_arguments[2].get();
+	EidosValue *windows_value = p_arguments[3].get();
+	EidosValue *mode_value = p_arguments[4].get();
+	
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() may only be called when tree recording is enabled." << EidosTerminate();
+	
+	SLiMGenerationStage gen_stage = GenerationStage();
+	
+	if ((gen_stage != SLiMGenerationStage::kWFStage0ExecuteFirstScripts) && (gen_stage != SLiMGenerationStage::kWFStage1ExecuteEarlyScripts) && (gen_stage != SLiMGenerationStage::kWFStage5ExecuteLateScripts) &&
+		(gen_stage != SLiMGenerationStage::kNonWFStage0ExecuteFirstScripts) && (gen_stage != SLiMGenerationStage::kNonWFStage2ExecuteEarlyScripts) && (gen_stage != SLiMGenerationStage::kNonWFStage6ExecuteLateScripts))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() may only be called from a first(), early(), or late() event." << EidosTerminate();
+	if ((executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventEarly) && (executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventLate))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() may not be called from inside a callback." << EidosTerminate();
+	
+	// statistic and mode
+	std::string statistic = statistic_value->StringAtIndex(0, nullptr);
+	std::string mode = mode_value->StringAtIndex(0, nullptr);
+	bool pairwise = false;
+	
+	if ((statistic == "divergence") || (statistic == "Fst"))
+		pairwise = true;
+	else if ((statistic != "diversity") && (statistic != "segregatingSites") && (statistic != "TajimasD"))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires statistic to be 'diversity', 'divergence', 'Fst', 'segregatingSites', or 'TajimasD'." << EidosTerminate();
+	
+	tsk_flags_t stat_flags;
+	
+	if (mode == "site")
+		stat_flags = TSK_STAT_SITE;
+	else if (mode == "branch")
+		stat_flags = TSK_STAT_BRANCH;
+	else
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires mode to be 'site' or 'branch'." << EidosTerminate();
+	
+	// Tajima's D is calculated from un-normalized diversity and segregating sites; everything else is per unit of sequence length
+	if (statistic != "TajimasD")
+		stat_flags |= TSK_STAT_SPAN_NORMALISE;
+	
+	// genomes and sample sets; each genome belongs to exactly one sample set, and the sets are numbered from 0 without gaps
+	int genome_count = genomes_value->Count();
+	
+	if (genome_count == 0)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires at least one genome." << EidosTerminate();
+	if ((sampleSets_value->Type() != EidosValueType::kValueNULL) && (sampleSets_value->Count() != genome_count))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires sampleSets to be NULL or the same length as genomes." << EidosTerminate();
+	
+	std::vector<int64_t> set_of_genome(genome_count, 0);
+	int64_t set_count = 1;
+	
+	if (sampleSets_value->Type() != EidosValueType::kValueNULL)
+	{
+		for (int genome_index = 0; genome_index < genome_count; ++genome_index)
+		{
+			int64_t set_index = sampleSets_value->IntAtIndex(genome_index, nullptr);
+			
+			if ((set_index < 0) || (set_index >= genome_count))
+				EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires the values in sampleSets to be in [0, n-1] for n genomes." << EidosTerminate();
+			
+			set_of_genome[genome_index] = set_index;
+			set_count = std::max(set_count, set_index + 1);
+		}
+	}
+	
+	std::vector<tsk_size_t> set_sizes(set_count, 0);
+	
+	for (int64_t set_index : set_of_genome)
+		set_sizes[set_index]++;
+	
+	for (tsk_size_t set_size : set_sizes)
+		if (set_size == 0)
+			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires every sample set from 0 to the largest value in sampleSets to contain at least one genome." << EidosTerminate();
+	
+	if (pairwise && (set_count < 2))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires at least two sample sets for statistic '" << statistic << "'." << EidosTerminate();
+	
+	// gather the tskit node ids of the genomes, grouped by sample set; after simplification sample k is node k
+	std::vector<tsk_id_t> samples;
+	std::vector<tsk_id_t> sample_nodes;
+	
+	samples.reserve(genome_count);
+	sample_nodes.reserve(genome_count);
+	
+	for (int64_t set_index = 0; set_index < set_count; ++set_index)
+	{
+		for (int genome_index = 0; genome_index < genome_count; ++genome_index)
+		{
+			if (set_of_genome[genome_index] == set_index)
+			{
+				Genome *genome = (Genome *)genomes_value->ObjectElementAtIndex(genome_index, nullptr);
+				
+				if (genome->IsNull())
+					EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() cannot compute statistics for null genomes." << EidosTerminate();
+				
+				sample_nodes.emplace_back((tsk_id_t)samples.size());
+				samples.emplace_back(genome->tsk_node_id_);
+			}
+		}
+	}
+	
+	{
+		std::vector<tsk_id_t> sorted_samples(samples);
+		
+		std::sort(sorted_samples.begin(), sorted_samples.end());
+		
+		if (std::adjacent_find(sorted_samples.begin(), sorted_samples.end()) != sorted_samples.end())
+			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires that genomes not contain duplicates." << EidosTerminate();
+	}
+	
+	// windows; by default there is one window spanning the whole chromosome
+	double sequence_length = tables_.sequence_length;
+	std::vector<double> windows;
+	
+	if (windows_value->Type() == EidosValueType::kValueNULL)
+	{
+		windows.emplace_back(0.0);
+		windows.emplace_back(sequence_length);
+	}
+	else
+	{
+		int windows_count = windows_value->Count();
+		
+		for (int window_index = 0; window_index < windows_count; ++window_index)
+			windows.emplace_back(windows_value->FloatAtIndex(window_index, nullptr));
+		
+		if ((windows_count < 2) || (windows.front() != 0.0) || (windows.back() != sequence_length))
+			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires windows to begin at 0 and end at the chromosome length (the last base position plus one)." << EidosTerminate();
+		
+		for (int window_index = 1; window_index < windows_count; ++window_index)
+			if (!(windows[window_index] > windows[window_index - 1]))
+				EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqStatistic): treeSeqStatistic() requires windows to be strictly increasing." << EidosTerminate();
+	}
+	
+	tsk_size_t window_count = (tsk_size_t)windows.size() - 1;
+	
+	// pairs of sample sets for pairwise statistics, in the order (0,1), (0,2), ..., (1,2), ...
+	std::vector<tsk_id_t> index_tuples;
+	
+	if (pairwise)
+	{
+		for (tsk_id_t set1 = 0; set1 < set_count; ++set1)
+			for (tsk_id_t set2 = set1 + 1; set2 < set_count; ++set2)
+			{
+				index_tuples.emplace_back(set1);
+				index_tuples.emplace_back(set2);
+			}
+	}
+	
+	tsk_size_t pair_count = (tsk_size_t)(index_tuples.size() / 2);
+	tsk_size_t output_count = (pairwise ? pair_count : (tsk_size_t)set_count);
+	std::vector<double> result(window_count * output_count);
+	
+	// build a tree sequence from a simplified copy of the live tables and compute on it; it never touches disk
+	std::clock_t before = clock();
+	tsk_table_collection_t tables_copy;
+	tsk_treeseq_t ts;
+	int ret;
+	
+	TreeSequenceForSample(samples, &tables_copy, &ts);
+	
+	if ((statistic == "diversity") || (statistic == "segregatingSites"))
+	{
+		auto stat_function = (statistic == "diversity") ? tsk_treeseq_diversity : tsk_treeseq_segregating_sites;
+		
+		ret = stat_function(&ts, (tsk_size_t)set_count, set_sizes.data(), sample_nodes.data(), window_count, windows.data(), result.data(), stat_flags);
+		if (ret != 0) handle_error("treeSeqStatistic()", ret);
+	}
+	else if (statistic == "divergence")
+	{
+		ret = tsk_treeseq_divergence(&ts, (tsk_size_t)set_count, set_sizes.data(), sample_nodes.data(), pair_count, index_tuples.data(), window_count, windows.data(), result.data(), stat_flags);
+		if (ret != 0) handle_error("treeSeqStatistic()", ret);
+	}
+	else if (statistic == "Fst")
+	{
+		// Hudson's Fst, as computed by tskit's Python API: 1 - 2 * (d1 + d2) / (d1 + d2 + 2 * d12)
+		std::vector<double> diversity(window_count * set_count);
+		
+		ret = tsk_treeseq_diversity(&ts, (tsk_size_t)set_count, set_sizes.data(), sample_nodes.data(), window_count, windows.data(), diversity.data(), stat_flags);
+		if (ret != 0) handle_error("treeSeqStatistic()", ret);
+		
+		ret = tsk_treeseq_divergence(&ts, (tsk_size_t)set_count, set_sizes.data(), sample_nodes.data(), pair_count, index_tuples.data(), window_count, windows.data(), result.data(), stat_flags);
+		if (ret != 0) handle_error("treeSeqStatistic()", ret);
+		
+		for (tsk_size_t window_index = 0; window_index < window_count; ++window_index)
+			for (tsk_size_t pair_index = 0; pair_index < pair_count; ++pair_index)
+			{
+				double within = diversity[window_index * set_count + index_tuples[pair_index * 2]] + diversity[window_index * set_count + index_tuples[pair_index * 2 + 1]];
+				double &between = result[window_index * pair_count + pair_index];
+				
+				between = 1.0 - 2.0 * within / (within + 2.0 * between);
+			}
+	}
+	else	// statistic == "TajimasD"
+	{
+		// Tajima's D from the un-normalized diversity (T) and segregating sites (S), as computed by tskit's Python API
+		std::vector<double> segregating_sites(window_count * set_count);
+		
+		ret = tsk_treeseq_diversity(&ts, (tsk_size_t)set_count, set_sizes.data(), sample_nodes.data(), window_count, windows.data(), result.data(), stat_flags);
+		if (ret != 0) handle_error("treeSeqStatistic()", ret);
+		
+		ret = tsk_treeseq_segregating_sites(&ts, (tsk_size_t)set_count, set_sizes.data(), sample_nodes.data(), window_count, windows.data(), segregating_sites.data(), stat_flags);
+		if (ret != 0) handle_error("treeSeqStatistic()", ret);
+		
+		for (int64_t set_index = 0; set_index < set_count; ++set_index)
+		{
+			double n = (double)set_sizes[set_index];
+			double h = 0.0, g = 0.0;
+			
+			for (tsk_size_t i = 1; i < set_sizes[set_index]; ++i)
+			{
+				h += 1.0 / i;
+				g += 1.0 / ((double)i * i);
+			}
+			
+			double a = (n + 1) / (3 * (n - 1) * h) - 1 / (h * h);
+			double b = 2 * (n * n + n + 3) / (9 * n * (n - 1)) - (n + 2) / (h * n) + g / (h * h);
+			
+			for (tsk_size_t window_index = 0; window_index < window_count; ++window_index)
+			{
+				double &T = result[window_index * set_count + set_index];
+				double S = segregating_sites[window_index * set_count + set_index];
+				
+				T = (T - S / h) / std::sqrt(a * S + (b / (h * h + g)) * S * (S - 1));
+			}
+		}
+	}
+	
+	ret = tsk_treeseq_free(&ts);
+	if (ret != 0) handle_error("treeSeqStatistic() tsk_treeseq_free()", ret);
+	
+	ret = tsk_table_collection_free(&tables_copy);
+	if (ret != 0) handle_error("treeSeqStatistic() tsk_table_collection_free()", ret);
+	
+	// we want to exclude this method's time from mutation run experiments, since it typically executes infrequently and takes a long time
+	x_excluded_clocks_ += (clock() - before);
+	
+	// tskit returns results window-major; with windows supplied we return a matrix with one row per window
+	EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(window_count * output_count);
+	
+	for (tsk_size_t window_index = 0; window_index < window_count; ++window_index)
+		for (tsk_size_t output_index = 0; output_index < output_count; ++output_index)
+			float_result->set_float_no_check(result[window_index * output_count + output_index], window_index + output_index * window_count);
+	
+	if (windows_value->Type() != EidosValueType::kValueNULL)
+	{
+		const int64_t dims[2] = {(int64_t)window_count, (int64_t)output_count};
+		float_result->SetDimensions(2, dims);
+	}
+	
+	return EidosValue_SP(float_result);
+}
+
 //
 //	SLiMSim_Class
 //
@@ -3926,14 +4374,15 @@ const std::vector<EidosMethodSignature_CSP> *SLiMSim_Class::Methods(void) const
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_addSubpop, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_Subpopulation_Class))->AddIntString_S("subpopID")->AddInt_S("size")->AddFloat_OS("sexRatio", gStaticEidosValue_Float0Point5)->AddLogical_OS("haploid", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_addSubpopSplit, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_Subpopulation_Class))->AddIntString_S("subpopID")->AddInt_S("size")->AddIntObject_S("sourceSubpop", gSLiM_Subpopulation_Class)->AddFloat_OS("sexRatio", gStaticEidosValue_Float0Point5));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_countOfMutationsOfType, kEidosValueMaskInt | kEidosValueMaskSingleton))->AddIntObject_S("mutType", gSLiM_MutationType_Class));
-		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_createLogFile, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_LogFile_Class))->AddString_S(gEidosStr_filePath)->AddString_ON("initialContents", gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("compress", gStaticEidosValue_LogicalF)->AddString_OS("sep", gStaticEidosValue_StringComma)->AddInt_OSN("logInterval", gStaticEidosValueNULL)->AddInt_OSN("flushInterval", gStaticEidosValueNULL));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_createLogFile, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_LogFile_Class))->AddString_S(gEidosStr_filePath)->AddString_ON("initialContents", gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("compress", gStaticEidosValue_LogicalF)->AddString_OS("sep", gStaticEidosValue_StringComma)->AddInt_OSN("logInterval", gStaticEidosValueNULL)->AddInt_OSN("flushInterval", gStaticEidosValueNULL)->AddLogical_OS("binary", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_deregisterScriptBlock, kEidosValueMaskVOID))->AddIntObject("scriptBlocks", gSLiM_SLiMEidosBlock_Class));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_individualsWithPedigreeIDs, kEidosValueMaskObject, gSLiM_Individual_Class))->AddInt("pedigreeIDs")->AddIntObject_ON("subpops", gSLiM_Subpopulation_Class, gStaticEidosValueNULL));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_kinship, kEidosValueMaskFloat))->AddObject("individuals1", gSLiM_Individual_Class)->AddObject_ON("individuals2", gSLiM_Individual_Class, gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_mutationCounts, kEidosValueMaskInt))->AddIntObject_N("subpops", gSLiM_Subpopulation_Class)->AddObject_ON("mutations", gSLiM_Mutation_Class, gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_mutationFrequencies, kEidosValueMaskFloat))->AddIntObject_N("subpops", gSLiM_Subpopulation_Class)->AddObject_ON("mutations", gSLiM_Mutation_Class, gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_mutationsOfType, kEidosValueMaskObject, gSLiM_Mutation_Class))->AddIntObject_S("mutType", gSLiM_MutationType_Class));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputFixedMutations, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF));
-		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputFull, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("binary", gStaticEidosValue_LogicalF)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("spatialPositions", gStaticEidosValue_LogicalT)->AddLogical_OS("ages", gStaticEidosValue_LogicalT)->AddLogical_OS("ancestralNucleotides", gStaticEidosValue_LogicalT)->AddLogical_OS("pedigreeIDs", gStaticEidosValue_LogicalF));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputFull, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("binary", gStaticEidosValue_LogicalF)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("spatialPositions", gStaticEidosValue_LogicalT)->AddLogical_OS("ages", gStaticEidosValue_LogicalT)->AddLogical_OS("ancestralNucleotides", gStaticEidosValue_LogicalT)->AddLogical_OS("pedigreeIDs", gStaticEidosValue_LogicalF)->AddLogical_OS("compress", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputMutations, kEidosValueMaskVOID))->AddObject("mutations", gSLiM_Mutation_Class)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputUsage, kEidosValueMaskVOID)));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_readFromPopulationFile, kEidosValueMaskInt | kEidosValueMaskSingleton))->AddString_S(gEidosStr_filePath));
@@ -3956,6 +4405,8 @@ const std::vector<EidosMethodSignature_CSP> *SLiMSim_Class::Methods(void) const
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqSimplify, kEidosValueMaskVOID)));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqRememberIndividuals, kEidosValueMaskVOID))->AddObject("individuals", gSLiM_Individual_Class)->AddLogical_OS("permanent", gStaticEidosValue_LogicalT));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqOutput, kEidosValueMaskVOID))->AddString_S("path")->AddLogical_OS("simplify", gStaticEidosValue_LogicalT)->AddLogical_OS("includeModel", gStaticEidosValue_LogicalT)->AddObject_OSN("metadata", nullptr, gStaticEidosValueNULL)->AddLogical_OS("_binary", gStaticEidosValue_LogicalT));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqCheckpoint, kEidosValueMaskVOID))->AddString_S("path"));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqStatistic, kEidosValueMaskFloat))->AddString_S("statistic")->AddObject("genomes", gSLiM_Genome_Class)->AddInt_ON("sampleSets", gStaticEidosValueNULL)->AddNumeric_ON("windows", gStaticEidosValueNULL)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton("site"))));
 		
 		std::sort(methods->begin(), methods->end(), CompareEidosCallSignatures);
 	}
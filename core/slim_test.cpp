@@ -263,6 +263,24 @@ void SLiMAssertScriptStop(const std::string &p_script_string, int p_lineNumber)
 	gEidosErrorContext.executingRuntimeScript = false;
 }
 
+// Records the result of a check made in C++ rather than in script, such as a check of the bytes of a file written by a script
+void SLiMAssertCondition(bool p_condition, const std::string &p_description, int p_lineNumber)
+{
+	if (p_condition)
+	{
+		gSLiMTestSuccessCount++;
+	}
+	else
+	{
+		gSLiMTestFailureCount++;
+		
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << p_description << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : condition not satisfied." << std::endl;
+	}
+}
+
 
 // Test subfunction prototypes
 static void _RunBasicTests(void);
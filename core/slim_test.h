@@ -31,6 +31,7 @@ int RunSLiMTests(void);
 extern void SLiMAssertScriptSuccess(const std::string &p_script_string, int p_lineNumber = -1);
 extern void SLiMAssertScriptRaise(const std::string &p_script_string, const int p_bad_line, const int p_bad_position, const std::string &p_reason_snip, int p_lineNumber = -1);
 extern void SLiMAssertScriptStop(const std::string &p_script_string, int p_lineNumber = -1);
+extern void SLiMAssertCondition(bool p_condition, const std::string &p_description, int p_lineNumber = -1);
 
 
 // Conceptually, all the slim_test_X.cpp stuff is a single source file, and all the details below are private.
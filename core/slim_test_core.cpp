@@ -23,6 +23,7 @@
 #include "eidos_globals.h"
 
 #include <string>
+#include <limits>
 
 
 #pragma mark initialize() tests
@@ -238,6 +239,10 @@ void _RunInitTests(void)
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(keepPedigrees=NULL); stop(); }", 1, 15, "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality=NULL); stop(); }", 1, 15, "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(mutationRuns=NULL); stop(); }", 1, 15, "cannot be type NULL", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=0); stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=10); stop(); }", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(pedigreeDepth=10); stop(); }", 1, 15, "only when keepPedigrees is T", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=-1); stop(); }", 1, 15, "must be between 0 and 10000", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(preventIncidentalSelfing=NULL); stop(); }", 1, 15, "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality='foo'); stop(); }", 1, 15, "legal non-empty values", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality='y'); stop(); }", 1, 15, "legal non-empty values", __LINE__);
@@ -454,6 +459,17 @@ void _RunSLiMSimTests(std::string temp_path)
 	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T); }" + gen1_setup_p1 + "10 { i1 = p1.individuals; ids = i1.pedigreeID; i2 = sim.individualsWithPedigreeIDs(ids, 1); if (identical(i1, i2)) stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T); }" + gen1_setup_p1 + "10 { i1 = sample(p1.individuals, 1000, replace=T); ids = i1.pedigreeID; i2 = sim.individualsWithPedigreeIDs(ids, 1); if (identical(i1, i2)) stop(); }", __LINE__);
 	
+	// Test sim - (float)kinship(object<Individual> individuals1, [No<Individual> individuals2 = NULL])
+	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(keepPedigrees=T); }" + gen1_setup_p1 + "1 { sim.kinship(p1.individuals); }", 1, 307, "pedigree depth has been set", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=5); }" + gen1_setup_p1 + "1 { sim.kinship(p1.individuals[0:1], p1.individuals[0:2]); }", 1, 324, "be the same length", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=5); }" + gen1_setup_p1 + "1 { k = sim.kinship(p1.individuals); if (identical(dim(k), c(10, 10)) & all(k == matrix(rep(c(0.5, rep(0.0, 10)), 10)[0:99], nrow=10))) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=5); }" + gen1_setup_p1 + "1 { k = sim.kinship(p1.individuals[0], p1.individuals); if (identical(k, c(0.5, rep(0.0, 9)))) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=5); }" + gen1_setup_p1 + "1 late() { ok = T; for (x in p1.individuals) for (y in p1.individuals) { px = x.pedigreeParentIDs; py = y.pedigreeParentIDs; if ((px[0] == px[1]) | (py[0] == py[1])) next; k = sim.kinship(x, y); shared = sum(match(px, py) >= 0); if (x == y) { if (k != 0.5) ok = F; } else if (k != c(0.0, 0.125, 0.25)[shared]) ok = F; } if (ok) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=5); }" + gen1_setup_p1 + "20 late() { k = sim.kinship(p1.individuals); if (all(k >= 0.0) & all(k <= 1.0) & identical(k, t(k)) & all(sim.kinship(p1.individuals, p1.individuals) >= 0.5)) stop(); }", __LINE__);
+	
+	// a pedigree store at the maximum depth; in a population of two, kinship approaches 1 only if the whole depth is used
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, pedigreeDepth=10000); }" + gen1_setup + "1 { sim.addSubpop('p1', 2); } 10002 late() { k = sim.kinship(p1.individuals); if (all(k > 0.99) & all(k <= 1.0) & identical(k, t(k))) stop(); }", __LINE__);
+	
 	// Test sim - (float)mutationFrequencies(Nio<Subpopulation> subpops, [object<Mutation> mutations])
 	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "1 { sim.mutationFrequencies(p1); }", __LINE__);
 	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "1 { sim.mutationFrequencies(c(p1, p2)); }", __LINE__);
@@ -506,6 +522,7 @@ void _RunSLiMSimTests(std::string temp_path)
 	SLiMAssertScriptSuccess(gen1_setup_i1x + "1 late() { sim.outputFull(ages=T); }", __LINE__);
 	SLiMAssertScriptSuccess(gen1_setup_i1x + "1 late() { sim.outputFull(ages=F); }", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "1 late() { sim.outputFull(NULL, T); }", 1, 308, "cannot output in binary format", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "1 late() { sim.outputFull(compress=T); }", 1, 308, "cannot output compressed data", __LINE__);
 	if (Eidos_TemporaryDirectoryExists())
 	{
 		SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "1 late() { sim.outputFull('" + temp_path + "/slimOutputFullTest.txt'); }", __LINE__);								// legal, output to file path; this test might work only on Un*x systems
@@ -524,6 +541,46 @@ void _RunSLiMSimTests(std::string temp_path)
 	if (Eidos_TemporaryDirectoryExists())
 		SLiMAssertScriptSuccess(gen1_setup_highmut_p1 + "5 late() { sim.outputMutations(sim.mutations, '" + temp_path + "/slimOutputMutationsTest.txt'); }", __LINE__);
 	
+	// Test sim - (object<LogFile>$)createLogFile(...); with a flushInterval, uncompressed rows are buffered, and flush() or readFile() writes them out; binary chunks are written by flush()
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { log = sim.createLogFile('" + temp_path + "/slimLogFileTest1.csv', flushInterval=10); log.addGeneration(); log.logRow(); log.logRow(); if (identical(readFile('" + temp_path + "/slimLogFileTest1.csv'), c('generation', '1', '1'))) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { log = sim.createLogFile('" + temp_path + "/slimLogFileTest2.csv', flushInterval=2); log.addGeneration(); log.logRow(); log.logRow(); log.logRow(); log.flush(); log.logRow(); if (size(readFile('" + temp_path + "/slimLogFileTest2.csv')) == 5) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { log = sim.createLogFile('" + temp_path + "/slimLogFileTest3.bin', binary=T); log.addGeneration(); log.addCustomColumn('s', 'NULL;'); log.logRow(); if (size(readFile('" + temp_path + "/slimLogFileTest3.bin')) == 0 & log.getValue('generation') == 1) { log.flush(); if (size(readFile('" + temp_path + "/slimLogFileTest3.bin')) > 0) stop(); } }", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { sim.createLogFile(P, compress=T, binary=T); } 1 { defineConstant('P', '" + temp_path + "/slimLogFileTest4.bin'); }", 1, 258, "binary output cannot be compressed", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { sim.createLogFile(P, initialContents='x', binary=T); } 1 { defineConstant('P', '" + temp_path + "/slimLogFileTest4.bin'); }", 1, 258, "initialContents cannot be supplied", __LINE__);
+		
+		// The exact bytes of a binary log: header, chunk tag and row count, and each column type with its NA encoding; the rows are
+		// still buffered when stop() is called, and must be handed to Eidos to be written out by the exit flush
+		std::string bin_path = temp_path + "/slimLogFileTest5.bin";
+		std::string bin_contents;
+		
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { log = sim.createLogFile('" + bin_path + "', binary=T); log.addGeneration(); log.addCustomColumn('f', '(sim.generation == 2) ? NULL else sim.generation / 2;'); log.addCustomColumn('l', '(sim.generation == 3) ? NULL else (sim.generation != 2);'); log.addCustomColumn('s', '(sim.generation == 2) ? NULL else ((sim.generation == 3) ? \"c\" else \"ab\");'); log.addCustomColumn('n', 'NULL;'); log.addCustomColumn('m', '(sim.generation == 1) ? 1 else 2.5;'); } 1:4 late() { sim.logFiles.logRow(); } 4 late() { stop(); }", __LINE__);
+		SLiMAssertCondition(Eidos_ReadFileContents(bin_path, bin_contents) && (bin_contents.size() == 0), "binary log rows not written before the exit flush", __LINE__);
+		
+		Eidos_FlushFiles();
+		
+		std::string expected;
+		auto append_int32 = [&expected](int32_t p_value) { expected.append(reinterpret_cast<const char *>(&p_value), sizeof(p_value)); };
+		auto append_int64 = [&expected](int64_t p_value) { expected.append(reinterpret_cast<const char *>(&p_value), sizeof(p_value)); };
+		auto append_double = [&expected](double p_value) { expected.append(reinterpret_cast<const char *>(&p_value), sizeof(p_value)); };
+		
+		append_int32(0x12345678); append_int32(1); append_int32(6);										// header tag, version, column count
+		append_int32(10); expected.append("generation");
+		for (const char *name : {"f", "l", "s", "n", "m"}) { append_int32(1); expected.append(name); }
+		append_int32(0x43484E4B); append_int64(4);														// 'CHNK', row count
+		expected.push_back(2); for (int64_t generation = 1; generation <= 4; ++generation) append_int64(generation);		// int
+		expected.push_back(3); append_double(0.5); append_double(std::numeric_limits<double>::quiet_NaN()); append_double(1.5); append_double(2.0);	// float, NA is NaN
+		expected.push_back(1); expected.append("\x01\x00\xFF\x01", 4);										// logical, NA is -1
+		expected.push_back(4); append_int32(2); append_int32(2); expected.append("ab"); append_int32(1); expected.append("c");	// string dictionary
+		append_int32(0); append_int32(-1); append_int32(1); append_int32(0);								// string indices, NA is -1
+		expected.push_back(0);																				// all NA, no data
+		expected.push_back(3); append_double(1.0); append_double(2.5); append_double(2.5); append_double(2.5);	// int and float values promote to float
+		
+		SLiMAssertCondition(expected.size() == 200, "expected binary log size", __LINE__);
+		SLiMAssertCondition(Eidos_ReadFileContents(bin_path, bin_contents) && (bin_contents == expected), "binary log bytes after the exit flush", __LINE__);
+	}
+	
 	// Test - (void)readFromPopulationFile(string$ filePath)
 	if (Eidos_TemporaryDirectoryExists())
 	{
@@ -534,8 +591,29 @@ void _RunSLiMSimTests(std::string temp_path)
 		SLiMAssertScriptSuccess(gen1_setup_i1x + "1 { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest_POSITIONS.txt'); }", __LINE__);
 		SLiMAssertScriptSuccess(gen1_setup_i1x + "1 { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest_POSITIONS.slimbinary'); }", __LINE__);
 		SLiMAssertScriptRaise(gen1_setup + "1 { sim.readFromPopulationFile('" + temp_path + "/notAFile.foo'); }", 1, 220, "does not exist or is empty", __LINE__);
+		SLiMAssertScriptStop(gen1_setup + "1 { writeFile('" + temp_path + "/slimOutputFullTestGz.txt', readFile('" + temp_path + "/slimOutputFullTest.txt'), compress=T); g = sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTestGz.txt.gz'); if (size(sim.subpopulations) == 3 & g == 1) stop(); }", __LINE__);		// a gzip-compressed text file
+		SLiMAssertScriptRaise(gen1_setup + "1 late() { sim.readFromPopulationFile(P); } 1 { defineConstant('P', '" + temp_path + "/slimNotAPopulation.txt.gz'); writeFile(P, 'foo', compress=T); }", 1, 227, "must be in SLiM's text or binary format", __LINE__);
 		SLiMAssertScriptSuccess(gen1_setup_p1 + "1 { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest.txt'); if (size(sim.subpopulations) != 3) stop(); }", __LINE__);			// legal; should wipe previous state
 		SLiMAssertScriptSuccess(gen1_setup_p1 + "1 { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest.slimbinary'); if (size(sim.subpopulations) != 3) stop(); }", __LINE__);	// legal; should wipe previous state
+		
+		// individual information (written in columns in binary files) and mutations should round-trip in all formats, compressed or not
+		std::string roundtrip_setup("initialize() { initializeSLiMModelType('nonWF'); initializeSLiMOptions(keepPedigrees=T, dimensionality='xy'); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 20); sim.addSubpop('p3', 10); } early() { for (s in sim.subpopulations) s.fitnessScaling = 15 / s.individualCount; } ");
+		std::string roundtrip_check("inds = sim.subpopulations.individuals; inds.x = runif(size(inds)); inds.y = runif(size(inds)); X = inds.x; Y = inds.y; A = inds.age; I = inds.pedigreeID; G = inds.genomes.genomePedigreeID; M = inds.genomes.positionsOfMutationsOfType(m1); C = inds.genomes.countOfMutationsOfType(m1); ");
+		std::string roundtrip_compare("inds = sim.subpopulations.individuals; if (identical(inds.x, X) & identical(inds.y, Y) & identical(inds.age, A) & identical(inds.pedigreeID, I) & identical(inds.genomes.genomePedigreeID, G) & identical(inds.genomes.positionsOfMutationsOfType(m1), M) & identical(inds.genomes.countOfMutationsOfType(m1), C)) stop(); }");
+		
+		SLiMAssertScriptStop(roundtrip_setup + "10 late() { " + roundtrip_check + "sim.outputFull('" + temp_path + "/slimOutputFullTest_RT1.slimbinary', binary=T, pedigreeIDs=T); sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest_RT1.slimbinary'); " + roundtrip_compare, __LINE__);
+		SLiMAssertScriptStop(roundtrip_setup + "10 late() { " + roundtrip_check + "sim.outputFull('" + temp_path + "/slimOutputFullTest_RT2.slimbinary', binary=T, pedigreeIDs=T, compress=T); if (fileExists('" + temp_path + "/slimOutputFullTest_RT2.slimbinary')) stop('no .gz'); sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest_RT2.slimbinary.gz'); " + roundtrip_compare, __LINE__);
+		SLiMAssertScriptStop(roundtrip_setup + "10 late() { " + roundtrip_check + "sim.outputFull('" + temp_path + "/slimOutputFullTest_RT3.txt.gz', pedigreeIDs=T, compress=T); sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest_RT3.txt.gz'); X = asFloat(asString(X)); Y = asFloat(asString(Y)); inds = sim.subpopulations.individuals; inds.x = asFloat(asString(inds.x)); inds.y = asFloat(asString(inds.y)); " + roundtrip_compare, __LINE__);
+		
+		// binary files share mutation runs between genomes; check that they are restored both when the mutation run configuration matches and when it does not
+		SLiMAssertScriptSuccess(gen1_setup_highmut_p1 + "20 late() { sim.outputFull('" + temp_path + "/slimOutputFullTest_MUTRUNS.slimbinary', binary=T); writeFile('" + temp_path + "/slimOutputFullTest_MUTRUNS.txt', asString(p1.genomes.positionsOfMutationsOfType(m1))); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup + "1 { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest_MUTRUNS.slimbinary'); if (!identical(p1.genomes.positionsOfMutationsOfType(m1), asInteger(readFile('" + temp_path + "/slimOutputFullTest_MUTRUNS.txt')))) stop('mismatch'); stop(); }", __LINE__);
+		SLiMAssertScriptStop("initialize() { initializeSLiMOptions(mutationRuns=7); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); } 1 { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest_MUTRUNS.slimbinary'); if (!identical(p1.genomes.positionsOfMutationsOfType(m1), asInteger(readFile('" + temp_path + "/slimOutputFullTest_MUTRUNS.txt')))) stop('mismatch'); stop(); }", __LINE__);
+		
+		// hand-constructed file with comments, CRLF line endings, and sparse polymorphism ids
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 { writeFile('" + temp_path + "/slimReadTextTest.txt', c('#OUT: 1 A', 'Version: 3', 'Populations:', 'p1 2 H   // a comment', 'Mutations:', '5 100 m1 10 0 0.5 p1 1 2\\r', '1000000 101 m1 20 0 0.5 p1 1 1', 'Individuals:', 'p1:i0 H p1:0 p1:1', 'p1:i1 H p1:2 p1:3', 'Genomes:', 'p1:0 A 5 1000000', 'p1:1 A 5\\r', 'p1:2 A', 'p1:3 A')); "
+			"sim.readFromPopulationFile('" + temp_path + "/slimReadTextTest.txt'); if (!identical(sort(sim.mutations.id), c(100,101))) stop('ids'); if (!identical(p1.genomes.countOfMutationsOfType(m1), c(2,1,0,0))) stop('counts'); stop(); }", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { sim.readFromPopulationFile(P); } 1 { defineConstant('P', '" + temp_path + "/slimReadTextTest2.txt'); writeFile(P, c('#OUT: 1 A', 'Version: 3', 'Populations:', 'p1 1 H', 'Mutations:', '0 100 m1 10 0 0.5 p1 1 2', 'Genomes:', 'p1:0 A 0 7', 'p1:1 A')); }", 1, 258, "polymorphism 7 has not been defined", __LINE__);
 	}
 	
 	// Test sim - (object<SLiMEidosBlock>)registerFirstEvent(Nis$ id, string$ source, [integer$ start], [integer$ end])
@@ -1129,6 +1207,7 @@ void _RunSubpopulationTests(void)
 	SLiMAssertScriptStop(gen1_setup_sex_p1 + "1 late() { p1.outputVCFSample(5, F, 'M', T); stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_sex_p1 + "1 late() { p1.outputVCFSample(5, F, 'F', T); stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_sex_p1 + "1 late() { p1.outputVCFSample(5, F, '*', T); stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { p1.outputVCFSample(5, compress=T); stop(); }", 1, 257, "requires a filePath", __LINE__);
 	
 	// Test Subpopulation - (void)setCloningRate(numeric rate)
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 { p1.setCloningRate(0.0); } 10 { if (p1.cloningRate == 0.0) stop(); }", __LINE__);
@@ -1896,6 +1975,24 @@ void _RunSLiMEidosBlockTests(void)
 	
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "fitness(m1) { mut; homozygous; individual; genome1; genome2; subpop; return relFitness; } 100 { stop(); }", __LINE__);
 	
+	// callback frames are reused across invocations, so check that local variables and parameters do not leak from one invocation into the next
+	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "fitness(m1) { if (exists('x')) stop(); x = mut.id; return relFitness; } 100 { ; }", __LINE__);
+	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "fitness(NULL) { if (exists('x')) stop(); x = individual.index; return relFitness; } 100 { ; }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "fitness(NULL) { x = individual.index; if (individual.index == 5) { if (x == 5) stop(); } return relFitness; } 100 { ; }", __LINE__);
+	
+	// callbacks of the form { return <expr>; } are evaluated vectorized across the subpopulation, and must give the same results as individual evaluation
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 late() { p1.individuals.tagF = (0:9) * 0.1; } fitness(NULL, p1) { return 1.0 + individual.tagF * 2; } 2 early() { if (identical(p1.cachedFitness(NULL), 1.0 + (0:9) * 0.1 * 2)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 late() { defineConstant('K', 0.5); p1.individuals.tagF = (0:9) * 0.1; } fitness(NULL, p1) { return 1.0 + individual.tagF * K; } 2 early() { if (identical(p1.cachedFitness(NULL), 1.0 + (0:9) * 0.1 * 0.5)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 late() { p1.individuals.tagF = (0:9) * 0.1; } fitness(NULL, p1) { return individual.tagF; } fitness(NULL, p1) { return 2.0 + subpop.id; } 2 early() { if (identical(p1.cachedFitness(NULL), (0:9) * 0.1 * 3.0)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 late() { p1.individuals.tagF = (0:9) * 0.1; p1.genomes.addNewDrawnMutation(m1, 5); p1.individuals[0:4].genome1.addNewDrawnMutation(m1, 10); } fitness(m1, p1) { return relFitness + individual.tagF * (0.5 + asFloat(homozygous)); } 2 early() { w = sapply(p1.individuals, 'x1 = applyValue.genome1; x2 = applyValue.genome2; m = unique(c(x1.mutations, x2.mutations)); hom = asFloat(x1.containsMutations(m) & x2.containsMutations(m)); product(1.0 + applyValue.tagF * (0.5 + hom));'); if (all(abs(p1.cachedFitness(NULL) - w) < 1e-12)) stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "fitness(NULL) { return individual.index; } 100 { ; }", 1, 293, "return value", __LINE__);
+	
+	// callbacks built from float arithmetic, comparisons, ternaries, and simple math functions are compiled, and must give the same results as the interpreter
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 late() { p1.individuals.tagF = (0:9) * 0.1; p1.genomes.addNewDrawnMutation(m1, 5); p1.individuals[0:4].genome1.addNewDrawnMutation(m1, 10); } fitness(m1, p1) { return homozygous ? relFitness * 2.0 else relFitness * 1.5; } fitness(NULL, p1) { return (individual.tagF > 0.45) ? 2.0 else 1.0; } 2 early() { w = sapply(p1.individuals, 'x1 = applyValue.genome1; x2 = applyValue.genome2; m = unique(c(x1.mutations, x2.mutations)); hom = x1.containsMutations(m) & x2.containsMutations(m); product(ifelse(hom, 2.0, 1.5)) * ifelse(applyValue.tagF > 0.45, 2.0, 1.0);'); if (identical(p1.cachedFitness(NULL), w)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 late() { p1.individuals.tagF = (0:9) * 0.1; } fitness(NULL, p1) { return 1.5 + 2.0 * dnorm(individual.tagF, 0.5, 0.2) - sqrt(exp(-individual.tagF)); } 2 early() { x = (0:9) * 0.1; if (all(abs(p1.cachedFitness(NULL) - (1.5 + 2.0 * dnorm(x, 0.5, 0.2) - sqrt(exp(-x)))) < 1e-12)) stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "fitness(NULL) { return 1.0 + individual.tagF; } 100 { ; }", 1, 333, "before being set", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "1 late() { p1.individuals.tagF = 1.0; } fitness(NULL) { return 2.0 * dnorm(individual.tagF, 0.0, -1.0); } 100 { ; }", 1, 362, "requires sd > 0.0", __LINE__);
+	
 	// mateChoice() callbacks
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mateChoice() { return weights; } 10 { stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mateChoice() { stop(); } 10 { ; }", __LINE__);
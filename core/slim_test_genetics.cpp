@@ -886,6 +886,19 @@ void _RunGenomeTests(std::string temp_path)
 		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { sample(p1.genomes[!p1.genomes.isNullGenome], 100, T).outputMS('" + temp_path + "/slimOutputMSTest5.txt'); stop(); }", __LINE__);
 	}
 	
+	// Test Genome + (void)outputMS(..., [logical$ compress = F], [logical$ index = F]) and + (o<Mutation>)readFromMS(s$ filePath, io<MutationType> mutationType, [Ni haplotypes = NULL])
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { p1.genomes.outputMS(NULL, compress=T); }", 1, 265, "requires a filePath when compress is T", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { p1.genomes.outputMS(NULL, index=T); }", 1, 265, "requires a filePath when index is T", __LINE__);
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { g = p1.genomes; g.outputMS('" + temp_path + "/slimReadMSTest1.txt'); sim.addSubpop('p2', 10); p2.genomes.readFromMS('" + temp_path + "/slimReadMSTest1.txt', m1); ok = T; for (i in 0:19) if (!identical(g[i].mutations.position, p2.genomes[i].mutations.position)) ok = F; if (ok) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { g = p1.genomes; g.outputMS('" + temp_path + "/slimReadMSTest2.txt', compress=T); sim.addSubpop('p2', 10); h = c(19, 0, 7, 7, 3, 12, 5, 18, 1, 2, 4, 6, 8, 9, 10, 11, 13, 14, 15, 16); p2.genomes.readFromMS('" + temp_path + "/slimReadMSTest2.txt.gz', m1, h); ok = T; for (i in 0:19) if (!identical(g[h[i]].mutations.position, p2.genomes[i].mutations.position)) ok = F; if (ok) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { g = p1.genomes; g.outputMS('" + temp_path + "/slimReadMSTest3.txt', compress=T, index=T); sim.addSubpop('p2', 10); h = c(19, 0, 7, 7, 3, 12, 5, 18, 1, 2, 4, 6, 8, 9, 10, 11, 13, 14, 15, 16); p2.genomes.readFromMS('" + temp_path + "/slimReadMSTest3.txt.gz', m1, h); ok = T; for (i in 0:19) if (!identical(g[h[i]].mutations.position, p2.genomes[i].mutations.position)) ok = F; if (fileExists('" + temp_path + "/slimReadMSTest3.txt.gz.msi') & ok) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { g = p1.genomes; g.outputMS('" + temp_path + "/slimReadMSTest4.txt', index=T); sim.addSubpop('p2', 1); p2.genomes.readFromMS('" + temp_path + "/slimReadMSTest4.txt', m1, c(17, 2)); if (identical(g[17].mutations.position, p2.genomes[0].mutations.position) & identical(g[2].mutations.position, p2.genomes[1].mutations.position)) stop(); }", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { p1.genomes.outputMS(P, append=T, index=T); } 1 { defineConstant('P', '" + temp_path + "/slimReadMSTest5.txt'); }", 1, 265, "cannot write an index when append is T", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_highmut_p1 + "10 late() { p1.genomes.readFromMS(P, m1, 1:20); } 10 { defineConstant('P', '" + temp_path + "/slimReadMSTest6.txt.gz'); p1.genomes.outputMS(P, compress=T, index=T); }", 1, 266, "out of range", __LINE__);
+	}
+	
 	// Test Genome + (void)output([Ns$ filePath])
 	SLiMAssertScriptStop(gen1_setup_p1 + "10 late() { sample(p1.genomes, 0, T).output(); stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "10 late() { sample(p1.genomes, 100, T).output(); stop(); }", __LINE__);
@@ -939,6 +952,33 @@ void _RunGenomeTests(std::string temp_path)
 		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { sample(p1.individuals, 0, T).genomes.outputVCF('" + temp_path + "/slimOutputVCFTest7.txt', F); stop(); }", __LINE__);
 		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { sample(p1.individuals, 100, T).genomes.outputVCF('" + temp_path + "/slimOutputVCFTest8.txt', F); stop(); }", __LINE__);
 	}
+	
+	// Test Genome + (void)outputVCF(..., [logical$ compress = F]); compressed output is BGZF, which readFromVCF() decompresses
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { p1.genomes.outputVCF(compress=T); }", 1, 265, "requires a filePath", __LINE__);
+	
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptStop(gen1_setup_p1 + "10 late() { p1.genomes.outputVCF('" + temp_path + "/slimOutputVCFTest9.vcf', compress=T); if (fileExists('" + temp_path + "/slimOutputVCFTest9.vcf.gz') & !fileExists('" + temp_path + "/slimOutputVCFTest9.vcf')) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { g = p1.genomes; g.outputVCF('" + temp_path + "/slimOutputVCFTest10.vcf', compress=T); sim.addSubpop('p2', 10); p2.genomes.readFromVCF('" + temp_path + "/slimOutputVCFTest10.vcf.gz', m1); ok = T; for (i in 0:19) if (!identical(sort(g[i].mutations.position), sort(p2.genomes[i].mutations.position))) ok = F; if (ok) stop(); }", __LINE__);
+	}
+	
+	// Test Genome + (void)outputGenotypeMatrix(s$ filePath, [logical$ append = F], [logical$ filterMonomorphic = F])
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { p1.genomes.outputGenotypeMatrix('" + temp_path + "/slimOutputMatrixTest1.bin'); if (fileExists('" + temp_path + "/slimOutputMatrixTest1.bin')) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { p1.genomes.outputGenotypeMatrix('" + temp_path + "/slimOutputMatrixTest2.bin', filterMonomorphic=T); p1.genomes.outputGenotypeMatrix('" + temp_path + "/slimOutputMatrixTest2.bin', append=T); stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.genomes[integer(0)].outputGenotypeMatrix('" + temp_path + "/slimOutputMatrixTest3.bin'); stop(); }", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_sex_p1 + "1 late() { p1.genomes.outputGenotypeMatrix(P); } 1 { defineConstant('P', '" + temp_path + "/slimOutputMatrixTest4.bin'); }", 1, 285, "cannot output null genomes", __LINE__);
+	}
+	
+	// Test Genome + (o<Mutation>)readFromVCF(s$ filePath = NULL, [Nio<MutationType> mutationType = NULL])
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptStop(gen1_setup_p1 + "10 late() { g = p1.genomes; g.outputVCF('" + temp_path + "/slimReadVCFTest1.vcf'); sim.addSubpop('p2', 10); p2.genomes.readFromVCF('" + temp_path + "/slimReadVCFTest1.vcf', m1); ok = T; for (i in 0:19) if (!identical(sort(g[i].mutations.position), sort(p2.genomes[i].mutations.position))) ok = F; if (ok) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { writeFile('" + temp_path + "/slimReadVCFTest2.vcf', c('##fileformat=VCFv4.2\\r', '#CHROM\\tPOS\\tID\\tREF\\tALT\\tQUAL\\tFILTER\\tINFO\\tFORMAT\\ti0\\ti1\\r', '1\\t10\\t.\\tA\\tC,G\\t1000\\tPASS\\t.\\tGT:DP\\t1|0:5\\t2/1:7\\r', '1\\t5\\t.\\tA\\tT\\t1000\\tPASS\\t.\\tGT\\t0|0\\t0|1\\r')); g = p1.genomes[0:3]; g.removeMutations(); muts = g.readFromVCF('" + temp_path + "/slimReadVCFTest2.vcf', m1); if (identical(muts.position, c(4, 9, 9)) & identical(g.countOfMutationsOfType(m1), c(1, 0, 1, 2))) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { writeFile('" + temp_path + "/slimReadVCFTest3.vcf', c('##fileformat=VCFv4.2', '#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\ti0\ti1', '1\t10\t.\tA\tC,G\t1000\tPASS\t.\tGT:DP\t1|0:5\t2/1:7', '1\t5\t.\tA\tT\t1000\tPASS\t.\tGT\t0|0\t0|1'), compress=T); g = p1.genomes[0:3]; g.removeMutations(); muts = g.readFromVCF('" + temp_path + "/slimReadVCFTest3.vcf.gz', m1); if (identical(muts.position, c(4, 9, 9)) & identical(g.countOfMutationsOfType(m1), c(1, 0, 1, 2))) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { g = p1.genomes; g.outputVCF('" + temp_path + "/slimReadVCFTest4.vcf'); sim.addSubpop('p2', 10); p2.genomes.readFromVCF('" + temp_path + "/slimReadVCFTest4.vcf', m1); g.readFromVCF('" + temp_path + "/slimReadVCFTest4.vcf', m1); ok = T; for (i in 0:19) { p = g[i].mutations.position; q = p2.genomes[i].mutations.position; if (!identical(p, sort(c(q, q)))) ok = F; } if (ok) stop(); }", __LINE__);
+	}
 }
 
 
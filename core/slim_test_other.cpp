@@ -21,6 +21,7 @@
 #include "slim_test.h"
 
 #include "eidos_globals.h"
+#include "../treerec/tskit/tables.h"
 
 #include <string>
 
@@ -1003,6 +1004,19 @@ void _RunTreeSeqTests(std::string temp_path)
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 { sim.treeSeqRememberIndividuals(p1.individuals, permanent=F); } 100 { sim.treeSeqSimplify(); stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1: { sim.treeSeqRememberIndividuals(p1.individuals, permanent=F); } 100 { sim.treeSeqSimplify(); stop(); }", __LINE__);
 	
+	// treeSeqStatistic()
+	SLiMAssertScriptRaise(gen1_setup_p1 + "10 { sim.treeSeqStatistic('diversity', p1.genomes); }", 1, 252, "tree recording is enabled", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 { sim.treeSeqStatistic('foo', p1.genomes); }", 1, 290, "requires statistic to be", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 { sim.treeSeqStatistic('diversity', p1.genomes, mode='foo'); }", 1, 290, "requires mode to be", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 { sim.treeSeqStatistic('Fst', p1.genomes); }", 1, 290, "at least two sample sets", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 { sim.treeSeqStatistic('diversity', p1.genomes, rep(c(0, 2), 10)); }", 1, 290, "contain at least one genome", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 { sim.treeSeqStatistic('diversity', p1.genomes[c(0, 0)]); }", 1, 290, "not contain duplicates", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 { sim.treeSeqStatistic('diversity', p1.genomes, windows=c(0, 500)); }", 1, 290, "requires windows to begin at 0", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 late() { f = sim.mutationFrequencies(p1); d1 = sum(2 * f * (1 - f)) * 20 / 19 / 100000; d2 = sim.treeSeqStatistic('diversity', p1.genomes); if (abs(d1 - d2) <= 0.01 * d1) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 late() { s = sim.treeSeqStatistic('segregatingSites', p1.genomes, windows=c(0, 50000, 100000)); if (identical(dim(s), c(2, 1)) & (abs(mean(s) - sim.treeSeqStatistic('segregatingSites', p1.genomes)) < 1e-12)) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 late() { sets = rep(0:2, 7)[0:19]; s = sim.treeSeqStatistic('divergence', p1.genomes, sets, c(0, 100000), 'branch'); f = sim.treeSeqStatistic('Fst', p1.genomes, sets); if (identical(dim(s), c(1, 3)) & (size(f) == 3) & all(s > 0)) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 late() { d = sim.treeSeqStatistic('TajimasD', p1.genomes, rep(0:1, 10)); if (size(d) == 2) stop(); }", __LINE__);
+	
 	// treeSeqOutput()
 	if (Eidos_TemporaryDirectoryExists())
 	{
@@ -1015,6 +1029,33 @@ void _RunTreeSeqTests(std::string temp_path)
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_2.trees', simplify=T, includeModel=F, _binary=F); stop(); }", __LINE__);
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_3.trees', simplify=F, includeModel=F, _binary=T); stop(); }", __LINE__);
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_4.trees', simplify=T, includeModel=F, _binary=T); stop(); }", __LINE__);
+		
+		// simplified output shares the edge and site tables with the live tables; check that they are left intact
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(runCrosschecks=T); } " + gen1_setup_p1 + "50 { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_5.trees', simplify=T); } 100 { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_5.trees', simplify=T); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_5.trees'); } 101 { stop(); }", __LINE__);
+		
+		// treeSeqCheckpoint() restores the state treeSeqOutput(simplify=F) writes at the same point: through delta records that carry
+		// in-place changes to remembered individuals, after a simplification that forces a new base, and past a partly written record.
+		// The tables written after each restore are compared below, since remembered individuals are not all visible from script.
+		std::string checkpoint_setup("initialize() { initializeSLiMModelType('nonWF'); initializeSLiMOptions(keepPedigrees=T, dimensionality='xy'); initializeTreeSeq(simplificationRatio=INF, runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); defineConstant('P', '" + temp_path + "/SLiM_treeSeq_6.ckpt'); defineConstant('TS', '" + temp_path + "/SLiM_treeSeq_6_'); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 20); sim.addSubpop('p3', 10); } early() { for (s in sim.subpopulations) s.fitnessScaling = 15 / s.individualCount; } late() { inds = sim.subpopulations.individuals; inds.x = runif(size(inds)); inds.y = runif(size(inds)); } ");
+		std::string checkpoint_compare("function (l$)compare(l$ truncate) { path = TS + sim.generation; sim.treeSeqCheckpoint(P); if (truncate) writeFile(P, 'DLTAxxxxxxxx', append=T); sim.treeSeqOutput(path + '.trees', simplify=F); g = sim.readFromPopulationFile(P); sim.treeSeqOutput(path + '_ckpt.trees', simplify=F, includeModel=F); inds = sim.subpopulations.individuals; I = inds.pedigreeID; X = inds.x; G = inds.genomes.genomePedigreeID; M = inds.genomes.positionsOfMutationsOfType(m1); S = sort(sim.mutations.id); D = sim.treeSeqStatistic('diversity', sim.subpopulations.genomes, mode='branch'); if (sim.readFromPopulationFile(path + '.trees') != g) return F; sim.treeSeqOutput(path + '_trees.trees', simplify=F, includeModel=F); inds = sim.subpopulations.individuals; return identical(I, inds.pedigreeID) & identical(X, inds.x) & identical(G, inds.genomes.genomePedigreeID) & identical(M, inds.genomes.positionsOfMutationsOfType(m1)) & identical(S, sort(sim.mutations.id)) & identical(D, sim.treeSeqStatistic('diversity', sim.subpopulations.genomes, mode='branch')); } ");
+		
+		SLiMAssertScriptStop(checkpoint_setup + checkpoint_compare + "8 late() { sim.treeSeqRememberIndividuals(p1.individuals, permanent=F); } 10 late() { sim.treeSeqCheckpoint(P); } 15 late() { sim.treeSeqRememberIndividuals(sim.subpopulations.individuals); } 20 late() { if (!compare(F)) stop('mismatch at 20'); } 25 late() { sim.treeSeqCheckpoint(P); } 27 late() { sim.treeSeqSimplify(); } 30 late() { if (!compare(T)) stop('mismatch at 30'); } 35 late() { stop(); }", __LINE__);
+		
+		for (std::string generation : {"20", "30"})
+		{
+			tsk_table_collection_t checkpoint_tables, trees_tables;
+			bool loaded = (tsk_table_collection_load(&checkpoint_tables, (temp_path + "/SLiM_treeSeq_6_" + generation + "_ckpt.trees").c_str(), 0) == 0);
+			
+			loaded = (tsk_table_collection_load(&trees_tables, (temp_path + "/SLiM_treeSeq_6_" + generation + "_trees.trees").c_str(), 0) == 0) && loaded;
+			
+			SLiMAssertCondition(loaded && tsk_table_collection_equals(&checkpoint_tables, &trees_tables, TSK_CMP_IGNORE_PROVENANCE), "tables restored from treeSeqCheckpoint() in generation " + generation, __LINE__);
+			
+			tsk_table_collection_free(&checkpoint_tables);
+			tsk_table_collection_free(&trees_tables);
+		}
+		
+		SLiMAssertScriptStop("initialize() { initializeSLiMModelType('nonWF'); initializeSLiMOptions(keepPedigrees=T, dimensionality='xy'); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); } 1 early() { if ((sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_6.ckpt') == 30) & (size(sim.subpopulations) == 2)) stop(); }", __LINE__);		// without tree recording; depends on the test above
+		SLiMAssertScriptRaise(gen1_setup_p1 + "10 { sim.treeSeqCheckpoint('" + temp_path + "/SLiM_treeSeq_7.ckpt'); }", 1, 252, "tree recording is enabled", __LINE__);
 	}
 }
 
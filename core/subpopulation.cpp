@@ -30,6 +30,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 #include <assert.h>
 #include <string>
@@ -1414,6 +1415,31 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 	individual_cached_fitness_OVERRIDE_ = false;
 #endif
 	
+	// If the fitness() callbacks allow it, evaluate them vectorized across the whole subpopulation up front; the loops below then use the
+	// precomputed chromosomal fitness values, and ApplyGlobalFitnessCallbacks() returns precomputed values.  See the header for details.
+	bool vectorized_fitness_callbacks = false;
+	
+	fitness_callbacks_recording_ = false;
+	fitness_callbacks_replaying_ = false;
+	global_fitness_callbacks_replaying_ = false;
+	
+	if (!pure_neutral)
+	{
+		bool fitness_callbacks_vectorizable = false, global_callbacks_vectorizable = false;
+		bool vectorization_allowed = true;
+		
+		if (fitness_callbacks_exist && !skip_chromosomal_fitness)
+			vectorization_allowed = _CallbacksAreVectorizable(p_fitness_callbacks, &fitness_callbacks_vectorizable);
+		if (vectorization_allowed && global_fitness_callbacks_exist)
+			vectorization_allowed = _CallbacksAreVectorizable(p_global_fitness_callbacks, &global_callbacks_vectorizable);
+		
+		if (vectorization_allowed && (fitness_callbacks_vectorizable || global_callbacks_vectorizable))
+		{
+			_PrecomputeVectorizedFitness(p_fitness_callbacks, p_global_fitness_callbacks, fitness_callbacks_vectorizable, fitness_callbacks_exist, skip_chromosomal_fitness, single_callback_mut_type, subpop_fitness_scaling);
+			vectorized_fitness_callbacks = true;
+		}
+	}
+	
 	// calculate fitnesses in parent population and cache the values
 	if (sex_enabled_)
 	{
@@ -1477,7 +1503,9 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 				
 				if (fitness > 0.0)
 				{
-					if (!fitness_callbacks_exist)
+					if (vectorized_fitness_callbacks)
+						fitness *= vectorized_chromosomal_fitness_[female_index];
+					else if (!fitness_callbacks_exist)
 						fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(female_index);
 					else if (single_fitness_callback)
 						fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(female_index, p_fitness_callbacks, single_callback_mut_type);
@@ -1556,7 +1584,9 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 				
 				if (fitness > 0.0)
 				{
-					if (!fitness_callbacks_exist)
+					if (vectorized_fitness_callbacks)
+						fitness *= vectorized_chromosomal_fitness_[male_index];
+					else if (!fitness_callbacks_exist)
 						fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(male_index);
 					else if (single_fitness_callback)
 						fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(male_index, p_fitness_callbacks, single_callback_mut_type);
@@ -1642,7 +1672,9 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 				
 				if (fitness > 0)
 				{
-					if (!fitness_callbacks_exist)
+					if (vectorized_fitness_callbacks)
+						fitness *= vectorized_chromosomal_fitness_[individual_index];
+					else if (!fitness_callbacks_exist)
 						fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(individual_index);
 					else if (single_fitness_callback)
 						fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(individual_index, p_fitness_callbacks, single_callback_mut_type);
@@ -1798,13 +1830,46 @@ void Subpopulation::UpdateWFFitnessBuffers(bool p_pure_neutral)
 
 double Subpopulation::ApplyFitnessCallbacks(MutationIndex p_mutation, int p_homozygous, double p_computed_fitness, std::vector<SLiMEidosBlock*> &p_fitness_callbacks, Individual *p_individual, Genome *p_genome1, Genome *p_genome2)
 {
+	if (fitness_callbacks_recording_)
+	{
+		// In the recording pass for vectorized callbacks, we record each invocation that would execute a callback, and return a placeholder
+		// value of 1.0; that keeps the caller from short-circuiting on a zero fitness, so that all potentially needed invocations get recorded
+		slim_objectid_t mutation_type_id = (gSLiM_Mutation_Block + p_mutation)->mutation_type_ptr_->mutation_type_id_;
+		
+		for (SLiMEidosBlock *fitness_callback : p_fitness_callbacks)
+		{
+			if (fitness_callback->active_)
+			{
+				slim_objectid_t callback_mutation_type_id = fitness_callback->mutation_type_id_;
+				
+				if ((callback_mutation_type_id == -1) || (callback_mutation_type_id == mutation_type_id))
+				{
+					fitness_callback_records_.emplace_back(SLiMFitnessCallbackRecord{p_mutation, p_homozygous, p_individual->index_, p_computed_fitness});
+					return 1.0;
+				}
+			}
+		}
+		
+		return p_computed_fitness;
+	}
+	
+	if (fitness_callbacks_replaying_)
+	{
+		// In the replay pass, invocations arrive in the order they were recorded, so the next record is the one we want; if it is not (the
+		// recording pass might have short-circuited earlier than we do, due to underflow), we fall through and execute the callbacks here
+		if ((fitness_callback_replay_cursor_ < fitness_callback_replay_end_) && (fitness_callback_records_[fitness_callback_replay_cursor_].mutation_ == p_mutation))
+			return fitness_callback_records_[fitness_callback_replay_cursor_++].rel_fitness_;
+	}
+	
 #if defined(SLIMGUI) && (SLIMPROFILING == 1)
 	// PROFILING
 	SLIM_PROFILE_BLOCK_START();
 #endif
 	
 	slim_objectid_t mutation_type_id = (gSLiM_Mutation_Block + p_mutation)->mutation_type_ptr_->mutation_type_id_;
+#if DEBUG_POINTS_ENABLED
 	SLiMSim &sim = population_.sim_;
+#endif
 	
 	for (SLiMEidosBlock *fitness_callback : p_fitness_callbacks)
 	{
@@ -1880,70 +1945,13 @@ double Subpopulation::ApplyFitnessCallbacks(MutationIndex p_mutation, int p_homo
 				}
 				else
 				{
-					// local variables for the callback parameters that we might need to allocate here, and thus need to free below
-					EidosValue_Object_singleton local_mut(gSLiM_Mutation_Block + p_mutation, gSLiM_Mutation_Class);
-					EidosValue_Float_singleton local_relFitness(p_computed_fitness);
+					// Run the compiled form of the callback if it has one; that bails to the interpreter for inputs the interpreter would raise on
+					double compiled_fitness;
 					
-					// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
-					{
-						EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim.SymbolTable());
-						EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-						EidosFunctionMap &function_map = sim.FunctionMap();
-						EidosInterpreter interpreter(fitness_callback->compound_statement_node_, client_symbols, function_map, &sim, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
-						
-						if (fitness_callback->contains_self_)
-							callback_symbols.InitializeConstantSymbolEntry(fitness_callback->SelfSymbolTableEntry());		// define "self"
-						
-						// Set all of the callback's parameters; note we use InitializeConstantSymbolEntry() for speed.
-						// We can use that method because we know the lifetime of the symbol table is shorter than that of
-						// the value objects, and we know that the values we are setting here will not change (the objects
-						// referred to by the values may change, but the values themselves will not change).
-						if (fitness_callback->contains_mut_)
-						{
-							local_mut.StackAllocated();			// prevent Eidos_intrusive_ptr from trying to delete this
-							callback_symbols.InitializeConstantSymbolEntry(gID_mut, EidosValue_SP(&local_mut));
-						}
-						if (fitness_callback->contains_relFitness_)
-						{
-							local_relFitness.StackAllocated();		// prevent Eidos_intrusive_ptr from trying to delete this
-							callback_symbols.InitializeConstantSymbolEntry(gID_relFitness, EidosValue_SP(&local_relFitness));
-						}
-						if (fitness_callback->contains_individual_)
-							callback_symbols.InitializeConstantSymbolEntry(gID_individual, p_individual->CachedEidosValue());
-						if (fitness_callback->contains_genome1_)
-							callback_symbols.InitializeConstantSymbolEntry(gID_genome1, p_genome1->CachedEidosValue());
-						if (fitness_callback->contains_genome2_)
-							callback_symbols.InitializeConstantSymbolEntry(gID_genome2, p_genome2->CachedEidosValue());
-						if (fitness_callback->contains_subpop_)
-							callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
-						
-						// p_homozygous == -1 means the mutation is opposed by a NULL chromosome; otherwise, 0 means heterozyg., 1 means homozyg.
-						// that gets translated into Eidos values of NULL, F, and T, respectively
-						if (fitness_callback->contains_homozygous_)
-						{
-							if (p_homozygous == -1)
-								callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, gStaticEidosValueNULL);
-							else
-								callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, (p_homozygous != 0) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
-						}
-						
-						try
-						{
-							// Interpret the script; the result from the interpretation must be a singleton double used as a new fitness value
-							EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(fitness_callback->script_);
-							EidosValue *result = result_SP.get();
-							
-							if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != 1))
-								EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyFitnessCallbacks): fitness() callbacks must provide a float singleton return value." << EidosTerminate(fitness_callback->identifier_token_);
-							
-							p_computed_fitness = result->FloatAtIndex(0, nullptr);
-						}
-						catch (...)
-						{
-							throw;
-						}
-						
-					}
+					if (fitness_callback->compiled_callback_ && fitness_callback->compiled_callback_->Evaluate(p_computed_fitness, p_homozygous, gSLiM_Mutation_Block + p_mutation, p_individual, &compiled_fitness))
+						p_computed_fitness = compiled_fitness;
+					else
+						p_computed_fitness = _ExecuteFitnessCallback(fitness_callback, p_mutation, p_homozygous, p_computed_fitness, p_individual, p_genome1, p_genome2);
 				}
 			}
 		}
@@ -1960,6 +1968,10 @@ double Subpopulation::ApplyFitnessCallbacks(MutationIndex p_mutation, int p_homo
 // This calculates the effects of global fitness callbacks, i.e. those with muttype==NULL and which therefore do not reference any mutation
 double Subpopulation::ApplyGlobalFitnessCallbacks(std::vector<SLiMEidosBlock*> &p_fitness_callbacks, slim_popsize_t p_individual_index)
 {
+	// When the global callbacks have been vectorized, UpdateFitness() has already computed our result
+	if (global_fitness_callbacks_replaying_)
+		return vectorized_global_fitness_[p_individual_index];
+	
 #if defined(SLIMGUI) && (SLIMPROFILING == 1)
 	// PROFILING
 	SLIM_PROFILE_BLOCK_START();
@@ -1969,7 +1981,9 @@ double Subpopulation::ApplyGlobalFitnessCallbacks(std::vector<SLiMEidosBlock*> &
 	Individual *individual = parent_individuals_[p_individual_index];
 	Genome *genome1 = parent_genomes_[p_individual_index * 2];
 	Genome *genome2 = parent_genomes_[p_individual_index * 2 + 1];
+#if DEBUG_POINTS_ENABLED
 	SLiMSim &sim = population_.sim_;
+#endif
 	
 	for (SLiMEidosBlock *fitness_callback : p_fitness_callbacks)
 	{
@@ -2041,69 +2055,594 @@ double Subpopulation::ApplyGlobalFitnessCallbacks(std::vector<SLiMEidosBlock*> &
 			}
 			else
 			{
-				// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
+				// Run the compiled form of the callback if it has one; that bails to the interpreter for inputs the interpreter would raise on
+				double compiled_fitness;
+				
+				if (fitness_callback->compiled_callback_ && fitness_callback->compiled_callback_->Evaluate(1.0, -1, nullptr, individual, &compiled_fitness))
+					computed_fitness *= compiled_fitness;
+				else
+					computed_fitness *= _ExecuteGlobalFitnessCallback(fitness_callback, individual, genome1, genome2);
+			}
+			
+			// If any callback puts us at or below zero, we can short-circuit the rest
+			if (computed_fitness <= 0.0)
+			{
+				computed_fitness = 0.0;
+				break;
+			}
+		}
+	}
+	
+#if defined(SLIMGUI) && (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(population_.sim_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosFitnessGlobalCallback)]);
+#endif
+	
+	return computed_fitness;
+}
+
+// Execute one mutation-type fitness() callback in the interpreter, for ApplyFitnessCallbacks() and the vectorized evaluation path
+double Subpopulation::_ExecuteFitnessCallback(SLiMEidosBlock *p_fitness_callback, MutationIndex p_mutation, int p_homozygous, double p_rel_fitness, Individual *p_individual, Genome *p_genome1, Genome *p_genome2)
+{
+	// local variables for the callback parameters that we might need to allocate here, and thus need to free below
+	EidosValue_Object_singleton local_mut(gSLiM_Mutation_Block + p_mutation, gSLiM_Mutation_Class);
+	EidosValue_Float_singleton local_relFitness(p_rel_fitness);
+	
+	SLiMCallbackInvocation invocation(p_fitness_callback, population_.sim_);
+	EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+	EidosInterpreter &interpreter = invocation.Interpreter();
+	
+	if (p_fitness_callback->contains_self_)
+		callback_symbols.InitializeConstantSymbolEntry(p_fitness_callback->SelfSymbolTableEntry());		// define "self"
+	
+	// Set all of the callback's parameters; note we use InitializeConstantSymbolEntry() for speed.
+	// We can use that method because we know the lifetime of the symbol table is shorter than that of
+	// the value objects, and we know that the values we are setting here will not change (the objects
+	// referred to by the values may change, but the values themselves will not change).
+	if (p_fitness_callback->contains_mut_)
+	{
+		local_mut.StackAllocated();			// prevent Eidos_intrusive_ptr from trying to delete this
+		callback_symbols.InitializeConstantSymbolEntry(gID_mut, EidosValue_SP(&local_mut));
+	}
+	if (p_fitness_callback->contains_relFitness_)
+	{
+		local_relFitness.StackAllocated();		// prevent Eidos_intrusive_ptr from trying to delete this
+		callback_symbols.InitializeConstantSymbolEntry(gID_relFitness, EidosValue_SP(&local_relFitness));
+	}
+	if (p_fitness_callback->contains_individual_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_individual, p_individual->CachedEidosValue());
+	if (p_fitness_callback->contains_genome1_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_genome1, p_genome1->CachedEidosValue());
+	if (p_fitness_callback->contains_genome2_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_genome2, p_genome2->CachedEidosValue());
+	if (p_fitness_callback->contains_subpop_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+	
+	// p_homozygous == -1 means the mutation is opposed by a NULL chromosome; otherwise, 0 means heterozyg., 1 means homozyg.
+	// that gets translated into Eidos values of NULL, F, and T, respectively
+	if (p_fitness_callback->contains_homozygous_)
+	{
+		if (p_homozygous == -1)
+			callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, gStaticEidosValueNULL);
+		else
+			callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, (p_homozygous != 0) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+	}
+	
+	// Interpret the script; the result from the interpretation must be a singleton double used as a new fitness value
+	EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(p_fitness_callback->script_);
+	EidosValue *result = result_SP.get();
+	
+	if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != 1))
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyFitnessCallbacks): fitness() callbacks must provide a float singleton return value." << EidosTerminate(p_fitness_callback->identifier_token_);
+	
+	return result->FloatAtIndex(0, nullptr);
+}
+
+// Execute one global fitness(NULL) callback in the interpreter, for ApplyGlobalFitnessCallbacks() and the vectorized evaluation path
+double Subpopulation::_ExecuteGlobalFitnessCallback(SLiMEidosBlock *p_fitness_callback, Individual *p_individual, Genome *p_genome1, Genome *p_genome2)
+{
+	SLiMCallbackInvocation invocation(p_fitness_callback, population_.sim_);
+	EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+	EidosInterpreter &interpreter = invocation.Interpreter();
+	
+	if (p_fitness_callback->contains_self_)
+		callback_symbols.InitializeConstantSymbolEntry(p_fitness_callback->SelfSymbolTableEntry());		// define "self"
+	
+	// Set all of the callback's parameters; see _ExecuteFitnessCallback()
+	if (p_fitness_callback->contains_mut_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_mut, gStaticEidosValueNULL);
+	if (p_fitness_callback->contains_relFitness_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_relFitness, gStaticEidosValue_Float1);
+	if (p_fitness_callback->contains_individual_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_individual, p_individual->CachedEidosValue());
+	if (p_fitness_callback->contains_genome1_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_genome1, p_genome1->CachedEidosValue());
+	if (p_fitness_callback->contains_genome2_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_genome2, p_genome2->CachedEidosValue());
+	if (p_fitness_callback->contains_subpop_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+	if (p_fitness_callback->contains_homozygous_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, gStaticEidosValueNULL);
+	
+	// Interpret the script; the result from the interpretation must be a singleton double used as a new fitness value
+	EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(p_fitness_callback->script_);
+	EidosValue *result = result_SP.get();
+	
+	if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != 1))
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyGlobalFitnessCallbacks): fitness() callbacks must provide a float singleton return value." << EidosTerminate(p_fitness_callback->identifier_token_);
+	
+	return result->FloatAtIndex(0, nullptr);
+}
+
+// Check whether a list of fitness() callbacks can be evaluated vectorized; every active callback must either be vectorizable, or be handled in C++,
+// and all identifiers used by vectorizable callbacks, other than their parameters, must be singletons.  Anything else might have side effects, or
+// might depend on the order of invocation, so it has to be executed once per invocation.  *p_any_vectorizable is set to T if any active callback
+// is vectorizable; if none is, vectorization is allowed but would gain little.
+bool Subpopulation::_CallbacksAreVectorizable(std::vector<SLiMEidosBlock*> &p_callbacks, bool *p_any_vectorizable)
+{
+	SLiMSim &sim = population_.sim_;
+	
+#if DEBUG_POINTS_ENABLED
+	// debug points are reported for each invocation of a callback, so we can't vectorize while any are set
+	EidosInterpreterDebugPointsSet *debug_points = sim.DebugPoints();
+	
+	if (debug_points && debug_points->set.size())
+		return false;
+#endif
+	
+	EidosSymbolTable &symbols = sim.SymbolTable();
+	
+	for (SLiMEidosBlock *fitness_callback : p_callbacks)
+	{
+		if (fitness_callback->active_)
+		{
+			if (fitness_callback->vectorizable_)
+			{
+				for (EidosGlobalStringID symbol_id : fitness_callback->vectorized_uniform_ids_)
 				{
-					EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim.SymbolTable());
-					EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-					EidosFunctionMap &function_map = sim.FunctionMap();
-					EidosInterpreter interpreter(fitness_callback->compound_statement_node_, client_symbols, function_map, &sim, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+					if (!symbols.ContainsSymbol(symbol_id))
+						return false;
 					
-					if (fitness_callback->contains_self_)
-						callback_symbols.InitializeConstantSymbolEntry(fitness_callback->SelfSymbolTableEntry());		// define "self"
+					EidosValue *symbol_value = symbols.GetValueRawOrRaiseForSymbol(symbol_id);
 					
-					// Set all of the callback's parameters; note we use InitializeConstantSymbolEntry() for speed.
-					// We can use that method because we know the lifetime of the symbol table is shorter than that of
-					// the value objects, and we know that the values we are setting here will not change (the objects
-					// referred to by the values may change, but the values themselves will not change).
-					if (fitness_callback->contains_mut_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_mut, gStaticEidosValueNULL);
-					if (fitness_callback->contains_relFitness_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_relFitness, gStaticEidosValue_Float1);
-					if (fitness_callback->contains_individual_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_individual, individual->CachedEidosValue());
-					if (fitness_callback->contains_genome1_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_genome1, genome1->CachedEidosValue());
-					if (fitness_callback->contains_genome2_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_genome2, genome2->CachedEidosValue());
-					if (fitness_callback->contains_subpop_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
-					if (fitness_callback->contains_homozygous_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, gStaticEidosValueNULL);
+					if ((symbol_value->Count() != 1) || (symbol_value->DimensionCount() != 1))
+						return false;
+				}
+				
+				*p_any_vectorizable = true;
+			}
+			else if (!fitness_callback->compound_statement_node_->cached_return_value_ && !fitness_callback->has_cached_optimization_ && !fitness_callback->compiled_callback_)
+			{
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
+
+// Compute the chromosomal fitness, and the effect of global fitness(NULL) callbacks, for every individual in the parental generation, using vectorized
+// callback evaluation; the results are used by UpdateFitness().  The sequence of callback evaluations differs from the non-vectorized case, but since
+// vectorized callbacks are pure functions of their parameters, and other callbacks are handled in C++, the results are identical.  The recording pass
+// records all invocations up to any zero fitness from a mutation without a callback, rather than up to the first zero fitness overall; the extra
+// invocations have no effect on the result, apart from possibly raising an error (such as reading an unset tag value) that would otherwise be skipped.
+void Subpopulation::_PrecomputeVectorizedFitness(std::vector<SLiMEidosBlock*> &p_fitness_callbacks, std::vector<SLiMEidosBlock*> &p_global_fitness_callbacks, bool p_record_fitness_callbacks, bool p_fitness_callbacks_exist, bool p_skip_chromosomal_fitness, MutationType *p_single_callback_mut_type, double p_subpop_fitness_scaling)
+{
+	// individuals with a fitness scaling of zero are not evaluated at all, as in UpdateFitness()
+	std::vector<slim_popsize_t> live_indices;
+	
+	live_indices.reserve(parent_subpop_size_);
+	
+	for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
+		if (p_subpop_fitness_scaling * parent_individuals_[individual_index]->fitness_scaling_ > 0.0)
+			live_indices.emplace_back(individual_index);
+	
+	if (!p_skip_chromosomal_fitness)
+	{
+		if (p_record_fitness_callbacks)
+		{
+			// record the callback invocations for all individuals, then evaluate the callbacks over the records
+			fitness_callback_records_.clear();
+			fitness_callback_record_starts_.resize(parent_subpop_size_ + 1);
+			fitness_callbacks_recording_ = true;
+			
+			size_t live_index = 0;
+			
+			for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
+			{
+				fitness_callback_record_starts_[individual_index] = fitness_callback_records_.size();
+				
+				if ((live_index < live_indices.size()) && (live_indices[live_index] == individual_index))
+				{
+					if (p_single_callback_mut_type)
+						FitnessOfParentWithGenomeIndices_SingleCallback(individual_index, p_fitness_callbacks, p_single_callback_mut_type);
+					else
+						FitnessOfParentWithGenomeIndices_Callbacks(individual_index, p_fitness_callbacks);
 					
-					try
+					live_index++;
+				}
+			}
+			
+			fitness_callback_record_starts_[parent_subpop_size_] = fitness_callback_records_.size();
+			fitness_callbacks_recording_ = false;
+			
+			_EvaluateVectorizedFitnessCallbacks(p_fitness_callbacks);
+			
+			fitness_callbacks_replaying_ = true;
+		}
+		
+		// compute chromosomal fitness values, replaying the recorded callback results if we have them
+		vectorized_chromosomal_fitness_.resize(parent_subpop_size_);
+		
+		for (slim_popsize_t individual_index : live_indices)
+		{
+			double w;
+			
+			if (fitness_callbacks_replaying_)
+			{
+				fitness_callback_replay_cursor_ = fitness_callback_record_starts_[individual_index];
+				fitness_callback_replay_end_ = fitness_callback_record_starts_[individual_index + 1];
+			}
+			
+			if (!p_fitness_callbacks_exist)
+				w = FitnessOfParentWithGenomeIndices_NoCallbacks(individual_index);
+			else if (p_single_callback_mut_type)
+				w = FitnessOfParentWithGenomeIndices_SingleCallback(individual_index, p_fitness_callbacks, p_single_callback_mut_type);
+			else
+				w = FitnessOfParentWithGenomeIndices_Callbacks(individual_index, p_fitness_callbacks);
+			
+			vectorized_chromosomal_fitness_[individual_index] = w;
+		}
+		
+		fitness_callbacks_replaying_ = false;
+		
+		// global callbacks are made only for individuals whose fitness is still positive, as in UpdateFitness()
+		auto live_end = std::remove_if(live_indices.begin(), live_indices.end(), [this, p_subpop_fitness_scaling](slim_popsize_t individual_index) {
+			double fitness = p_subpop_fitness_scaling * parent_individuals_[individual_index]->fitness_scaling_;
+			
+			fitness *= vectorized_chromosomal_fitness_[individual_index];
+			return !(fitness > 0.0);
+		});
+		
+		live_indices.erase(live_end, live_indices.end());
+	}
+	
+	if (p_global_fitness_callbacks.size())
+	{
+		vectorized_global_fitness_.assign(parent_subpop_size_, 1.0);
+		
+		_EvaluateVectorizedGlobalFitnessCallbacks(p_global_fitness_callbacks, live_indices);
+		
+		global_fitness_callbacks_replaying_ = true;
+	}
+}
+
+// Evaluate the mutation-type fitness() callbacks over the records made by the recording pass, replacing each record's rel_fitness_ with the result
+void Subpopulation::_EvaluateVectorizedFitnessCallbacks(std::vector<SLiMEidosBlock*> &p_fitness_callbacks)
+{
+#if defined(SLIMGUI) && (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+	SLiMFitnessCallbackRecord *records = fitness_callback_records_.data();
+	size_t record_count = fitness_callback_records_.size();
+	std::vector<size_t> batch;
+	std::vector<slim_popsize_t> individual_indices;
+	
+	for (SLiMEidosBlock *fitness_callback : p_fitness_callbacks)
+	{
+		if (!fitness_callback->active_)
+			continue;
+		
+		slim_objectid_t callback_mutation_type_id = fitness_callback->mutation_type_id_;
+		const EidosASTNode *compound_statement_node = fitness_callback->compound_statement_node_;
+		
+		// homozygous is NULL for mutations opposed by a null genome, and T/F otherwise, so we evaluate those two cases in separate batches
+		bool split_null_homozygous = (fitness_callback->vectorizable_ && fitness_callback->contains_homozygous_);
+		
+		for (int null_batch = 0; null_batch <= (split_null_homozygous ? 1 : 0); ++null_batch)
+		{
+			batch.clear();
+			
+			for (size_t record_index = 0; record_index < record_count; ++record_index)
+			{
+				SLiMFitnessCallbackRecord &record = records[record_index];
+				
+				if ((callback_mutation_type_id != -1) && ((gSLiM_Mutation_Block + record.mutation_)->mutation_type_ptr_->mutation_type_id_ != callback_mutation_type_id))
+					continue;
+				if (split_null_homozygous && ((record.homozygous_ == -1) != (null_batch == 1)))
+					continue;
+				
+				batch.emplace_back(record_index);
+			}
+			
+			size_t batch_count = batch.size();
+			
+			if (batch_count == 0)
+				continue;
+			
+			if (compound_statement_node->cached_return_value_)
+			{
+				EidosValue *result = compound_statement_node->cached_return_value_.get();
+				
+				if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != 1))
+					EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyFitnessCallbacks): fitness() callbacks must provide a float singleton return value." << EidosTerminate(fitness_callback->identifier_token_);
+				
+				double value = result->FloatAtIndex(0, nullptr);
+				
+				for (size_t record_index : batch)
+					records[record_index].rel_fitness_ = value;
+			}
+			else if (fitness_callback->has_cached_optimization_)
+			{
+				if (fitness_callback->has_cached_opt_reciprocal)
+				{
+					double A = fitness_callback->cached_opt_A_;
+					
+					for (size_t record_index : batch)
+						records[record_index].rel_fitness_ = (A / records[record_index].rel_fitness_);
+				}
+				else
+				{
+					EIDOS_TERMINATION << "ERROR (Subpopulation::_EvaluateVectorizedFitnessCallbacks): (internal error) cached optimization flag mismatch" << EidosTerminate(fitness_callback->identifier_token_);
+				}
+			}
+			else if (fitness_callback->compiled_callback_)
+			{
+				// compiled callbacks run natively for each record, with the interpreter taking any records they bail on
+				const SLiMCompiledCallback *compiled_callback = fitness_callback->compiled_callback_;
+				
+				for (size_t record_index : batch)
+				{
+					SLiMFitnessCallbackRecord &record = records[record_index];
+					slim_popsize_t individual_index = record.individual_index_;
+					Individual *individual = parent_individuals_[individual_index];
+					double compiled_fitness;
+					
+					if (compiled_callback->Evaluate(record.rel_fitness_, record.homozygous_, gSLiM_Mutation_Block + record.mutation_, individual, &compiled_fitness))
+						record.rel_fitness_ = compiled_fitness;
+					else
+						record.rel_fitness_ = _ExecuteFitnessCallback(fitness_callback, record.mutation_, record.homozygous_, record.rel_fitness_, individual, parent_genomes_[individual_index * 2], parent_genomes_[individual_index * 2 + 1]);
+				}
+			}
+			else
+			{
+				// set up vectors for the per-invocation parameters used by the callback
+				EidosValue_SP mut_value, relFitness_value, homozygous_value;
+				
+				if (fitness_callback->contains_mut_)
+				{
+					EidosValue_Object_vector *mut_vector = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object_vector(gSLiM_Mutation_Class))->resize_no_initialize_RR(batch_count);
+					mut_value = EidosValue_SP(mut_vector);
+					
+					for (size_t batch_index = 0; batch_index < batch_count; ++batch_index)
+						mut_vector->set_object_element_no_check_no_previous_RR(gSLiM_Mutation_Block + records[batch[batch_index]].mutation_, batch_index);
+				}
+				if (fitness_callback->contains_relFitness_)
+				{
+					EidosValue_Float_vector *relFitness_vector = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(batch_count);
+					relFitness_value = EidosValue_SP(relFitness_vector);
+					
+					for (size_t batch_index = 0; batch_index < batch_count; ++batch_index)
+						relFitness_vector->set_float_no_check(records[batch[batch_index]].rel_fitness_, batch_index);
+				}
+				if (fitness_callback->contains_homozygous_)
+				{
+					if (null_batch)
 					{
-						// Interpret the script; the result from the interpretation must be a singleton double used as a new fitness value
-						EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(fitness_callback->script_);
-						EidosValue *result = result_SP.get();
-						
-						if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != 1))
-							EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyGlobalFitnessCallbacks): fitness() callbacks must provide a float singleton return value." << EidosTerminate(fitness_callback->identifier_token_);
-						
-						computed_fitness *= result->FloatAtIndex(0, nullptr);
+						homozygous_value = gStaticEidosValueNULL;
 					}
-					catch (...)
+					else
 					{
-						throw;
+						EidosValue_Logical *homozygous_vector = (new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(batch_count);
+						homozygous_value = EidosValue_SP(homozygous_vector);
+						
+						for (size_t batch_index = 0; batch_index < batch_count; ++batch_index)
+							homozygous_vector->set_logical_no_check(records[batch[batch_index]].homozygous_ != 0, batch_index);
 					}
+				}
+				
+				individual_indices.resize(batch_count);
+				
+				for (size_t batch_index = 0; batch_index < batch_count; ++batch_index)
+					individual_indices[batch_index] = records[batch[batch_index]].individual_index_;
+				
+				EidosValue_SP result_SP = _ExecuteVectorizedFitnessCallback(fitness_callback, individual_indices, mut_value, relFitness_value, homozygous_value);
+				EidosValue *result = result_SP.get();
+				
+				if (result->Count() == 1)
+				{
+					double value = result->FloatAtIndex(0, nullptr);
+					
+					for (size_t record_index : batch)
+						records[record_index].rel_fitness_ = value;
+				}
+				else
+				{
+					const double *values = result->FloatVector()->data();
 					
+					for (size_t batch_index = 0; batch_index < batch_count; ++batch_index)
+						records[batch[batch_index]].rel_fitness_ = values[batch_index];
 				}
 			}
+		}
+	}
+	
+#if defined(SLIMGUI) && (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(population_.sim_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosFitnessCallback)]);
+#endif
+}
+
+// Evaluate the global fitness(NULL) callbacks for the given individuals, multiplying the results into vectorized_global_fitness_; as in
+// ApplyGlobalFitnessCallbacks(), an individual whose fitness reaches zero is not passed to any further callbacks
+void Subpopulation::_EvaluateVectorizedGlobalFitnessCallbacks(std::vector<SLiMEidosBlock*> &p_fitness_callbacks, std::vector<slim_popsize_t> &p_individual_indices)
+{
+#if defined(SLIMGUI) && (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+	double *global_fitness = vectorized_global_fitness_.data();
+	
+	for (SLiMEidosBlock *fitness_callback : p_fitness_callbacks)
+	{
+		if (!fitness_callback->active_)
+			continue;
+		if (p_individual_indices.size() == 0)
+			break;
+		
+		const EidosASTNode *compound_statement_node = fitness_callback->compound_statement_node_;
+		
+		if (compound_statement_node->cached_return_value_)
+		{
+			EidosValue *result = compound_statement_node->cached_return_value_.get();
 			
-			// If any callback puts us at or below zero, we can short-circuit the rest
-			if (computed_fitness <= 0.0)
+			if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != 1))
+				EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyGlobalFitnessCallbacks): fitness() callbacks must provide a float singleton return value." << EidosTerminate(fitness_callback->identifier_token_);
+			
+			double value = result->FloatAtIndex(0, nullptr);
+			
+			for (slim_popsize_t individual_index : p_individual_indices)
+				global_fitness[individual_index] *= value;
+		}
+		else if (fitness_callback->has_cached_optimization_)
+		{
+			if (fitness_callback->has_cached_opt_dnorm1_)
 			{
-				computed_fitness = 0.0;
-				break;
+				double A = fitness_callback->cached_opt_A_;
+				double B = fitness_callback->cached_opt_B_;
+				double C = fitness_callback->cached_opt_C_;
+				double D = fitness_callback->cached_opt_D_;
+				
+				for (slim_popsize_t individual_index : p_individual_indices)
+					global_fitness[individual_index] *= (D + (gsl_ran_gaussian_pdf(parent_individuals_[individual_index]->TagFloat() - A, B) / C));
+			}
+			else
+			{
+				EIDOS_TERMINATION << "ERROR (Subpopulation::_EvaluateVectorizedGlobalFitnessCallbacks): (internal error) cached optimization flag mismatch" << EidosTerminate(fitness_callback->identifier_token_);
 			}
 		}
+		else if (fitness_callback->compiled_callback_)
+		{
+			const SLiMCompiledCallback *compiled_callback = fitness_callback->compiled_callback_;
+			
+			for (slim_popsize_t individual_index : p_individual_indices)
+			{
+				Individual *individual = parent_individuals_[individual_index];
+				double compiled_fitness;
+				
+				if (compiled_callback->Evaluate(1.0, -1, nullptr, individual, &compiled_fitness))
+					global_fitness[individual_index] *= compiled_fitness;
+				else
+					global_fitness[individual_index] *= _ExecuteGlobalFitnessCallback(fitness_callback, individual, parent_genomes_[individual_index * 2], parent_genomes_[individual_index * 2 + 1]);
+			}
+		}
+		else
+		{
+			EidosValue_SP result_SP = _ExecuteVectorizedFitnessCallback(fitness_callback, p_individual_indices, gStaticEidosValueNULL, gStaticEidosValue_Float1, gStaticEidosValueNULL);
+			EidosValue *result = result_SP.get();
+			size_t individual_count = p_individual_indices.size();
+			
+			if (result->Count() == 1)
+			{
+				double value = result->FloatAtIndex(0, nullptr);
+				
+				for (slim_popsize_t individual_index : p_individual_indices)
+					global_fitness[individual_index] *= value;
+			}
+			else
+			{
+				const double *values = result->FloatVector()->data();
+				
+				for (size_t values_index = 0; values_index < individual_count; ++values_index)
+					global_fitness[p_individual_indices[values_index]] *= values[values_index];
+			}
+		}
+		
+		// If any callback puts an individual at or below zero, it is not passed to the remaining callbacks
+		auto live_end = std::remove_if(p_individual_indices.begin(), p_individual_indices.end(), [global_fitness](slim_popsize_t individual_index) {
+			if (global_fitness[individual_index] <= 0.0)
+			{
+				global_fitness[individual_index] = 0.0;
+				return true;
+			}
+			return false;
+		});
+		
+		p_individual_indices.erase(live_end, p_individual_indices.end());
 	}
 	
 #if defined(SLIMGUI) && (SLIMPROFILING == 1)
 	// PROFILING
 	SLIM_PROFILE_BLOCK_END(population_.sim_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosFitnessGlobalCallback)]);
 #endif
+}
+
+// Execute a vectorizable fitness() callback once, with vectors bound to its per-invocation parameters; the given values for mut, relFitness, and
+// homozygous are used if the callback uses those parameters, and the individual/genome1/genome2 vectors are built from p_individual_indices
+EidosValue_SP Subpopulation::_ExecuteVectorizedFitnessCallback(SLiMEidosBlock *p_fitness_callback, const std::vector<slim_popsize_t> &p_individual_indices, EidosValue_SP p_mut, EidosValue_SP p_relFitness, EidosValue_SP p_homozygous)
+{
+	size_t invocation_count = p_individual_indices.size();
+	SLiMCallbackInvocation invocation(p_fitness_callback, population_.sim_);
+	EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+	EidosInterpreter &interpreter = invocation.Interpreter();
 	
-	return computed_fitness;
+	if (p_fitness_callback->contains_self_)
+		callback_symbols.InitializeConstantSymbolEntry(p_fitness_callback->SelfSymbolTableEntry());		// define "self"
+	
+	if (p_fitness_callback->contains_mut_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_mut, p_mut);
+	if (p_fitness_callback->contains_relFitness_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_relFitness, p_relFitness);
+	if (p_fitness_callback->contains_homozygous_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, p_homozygous);
+	if (p_fitness_callback->contains_subpop_)
+		callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+	
+	if (p_fitness_callback->contains_individual_)
+	{
+		EidosValue_Object_vector *individual_vector = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object_vector(gSLiM_Individual_Class))->resize_no_initialize(invocation_count);
+		
+		for (size_t invocation_index = 0; invocation_index < invocation_count; ++invocation_index)
+			individual_vector->set_object_element_no_check_NORR(parent_individuals_[p_individual_indices[invocation_index]], invocation_index);
+		
+		callback_symbols.InitializeConstantSymbolEntry(gID_individual, EidosValue_SP(individual_vector));
+	}
+	if (p_fitness_callback->contains_genome1_)
+	{
+		EidosValue_Object_vector *genome1_vector = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object_vector(gSLiM_Genome_Class))->resize_no_initialize(invocation_count);
+		
+		for (size_t invocation_index = 0; invocation_index < invocation_count; ++invocation_index)
+			genome1_vector->set_object_element_no_check_NORR(parent_genomes_[p_individual_indices[invocation_index] * 2], invocation_index);
+		
+		callback_symbols.InitializeConstantSymbolEntry(gID_genome1, EidosValue_SP(genome1_vector));
+	}
+	if (p_fitness_callback->contains_genome2_)
+	{
+		EidosValue_Object_vector *genome2_vector = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object_vector(gSLiM_Genome_Class))->resize_no_initialize(invocation_count);
+		
+		for (size_t invocation_index = 0; invocation_index < invocation_count; ++invocation_index)
+			genome2_vector->set_object_element_no_check_NORR(parent_genomes_[p_individual_indices[invocation_index] * 2 + 1], invocation_index);
+		
+		callback_symbols.InitializeConstantSymbolEntry(gID_genome2, EidosValue_SP(genome2_vector));
+	}
+	
+	// The result must be a float vector with one value per invocation, or a singleton that applies to all of them; the error message is
+	// the one the non-vectorized case would give, since that is the error the user's callback has in either case
+	EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(p_fitness_callback->script_);
+	EidosValue *result = result_SP.get();
+	
+	if ((result->Type() != EidosValueType::kValueFloat) || ((result->Count() != (int)invocation_count) && (result->Count() != 1)))
+	{
+		if (p_fitness_callback->type_ == SLiMEidosBlockType::SLiMEidosFitnessGlobalCallback)
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyGlobalFitnessCallbacks): fitness() callbacks must provide a float singleton return value." << EidosTerminate(p_fitness_callback->identifier_token_);
+		else
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyFitnessCallbacks): fitness() callbacks must provide a float singleton return value." << EidosTerminate(p_fitness_callback->identifier_token_);
+	}
+	
+	return result_SP;
 }
 
 // FitnessOfParentWithGenomeIndices has three versions, for no callbacks, a single callback, and multiple callbacks.  This is for two reasons.  First,
@@ -3041,10 +3580,9 @@ void Subpopulation::ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_r
 				// This code is similar to Population::ExecuteScript, but we set up an additional symbol table, and we use the return value
 				// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
 				{
-					EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim.SymbolTable());
-					EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-					EidosFunctionMap &function_map = sim.FunctionMap();
-					EidosInterpreter interpreter(reproduction_callback->compound_statement_node_, client_symbols, function_map, &sim, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+					SLiMCallbackInvocation invocation(reproduction_callback, sim);
+					EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+					EidosInterpreter &interpreter = invocation.Interpreter();
 					
 					if (reproduction_callback->contains_self_)
 						callback_symbols.InitializeConstantSymbolEntry(reproduction_callback->SelfSymbolTableEntry());		// define "self"
@@ -3244,10 +3782,9 @@ bool Subpopulation::ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survi
 				
 				// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
 				{
-					EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &sim.SymbolTable());
-					EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-					EidosFunctionMap &function_map = sim.FunctionMap();
-					EidosInterpreter interpreter(survival_callback->compound_statement_node_, client_symbols, function_map, &sim, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+					SLiMCallbackInvocation invocation(survival_callback, sim);
+					EidosSymbolTable &callback_symbols = invocation.CallbackSymbols();
+					EidosInterpreter &interpreter = invocation.Interpreter();
 					
 					if (survival_callback->contains_self_)
 						callback_symbols.InitializeConstantSymbolEntry(survival_callback->SelfSymbolTableEntry());		// define "self"
@@ -6835,7 +7372,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_spatialMapValue(EidosGlobalStringID p
 
 //	*********************	– (void)outputMSSample(integer$ sampleSize, [logical$ replace = T], [string$ requestedSex = "*"], [Ns$ filePath = NULL], [logical$ append=F], [logical$ filterMonomorphic = F])
 //	*********************	– (void)outputSample(integer$ sampleSize, [logical$ replace = T], [string$ requestedSex = "*"], [Ns$ filePath = NULL], [logical$ append=F])
-//	*********************	– (void)outputVCFSample(integer$ sampleSize, [logical$ replace = T], [string$ requestedSex = "*"], [logical$ outputMultiallelics = T], [Ns$ filePath = NULL], [logical$ append=F], [logical$ simplifyNucleotides = F], [logical$ outputNonnucleotides = T])
+//	*********************	– (void)outputVCFSample(integer$ sampleSize, [logical$ replace = T], [string$ requestedSex = "*"], [logical$ outputMultiallelics = T], [Ns$ filePath = NULL], [logical$ append=F], [logical$ simplifyNucleotides = F], [logical$ outputNonnucleotides = T], [logical$ compress = F])
 //
 EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -6849,6 +7386,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	EidosValue *filterMonomorphic_arg = ((p_method_id == gID_outputMSSample) ? p_arguments[5].get() : nullptr);
 	EidosValue *simplifyNucleotides_arg = ((p_method_id == gID_outputVCFSample) ? p_arguments[6].get() : nullptr);
 	EidosValue *outputNonnucleotides_arg = ((p_method_id == gID_outputVCFSample) ? p_arguments[7].get() : nullptr);
+	EidosValue *compress_arg = ((p_method_id == gID_outputVCFSample) ? p_arguments[8].get() : nullptr);
 	
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	SLiMSim &sim = population_.sim_;
@@ -6905,24 +7443,43 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	if (p_method_id == gID_outputMSSample)
 		filter_monomorphic = filterMonomorphic_arg->LogicalAtIndex(0, nullptr);
 	
-	// Figure out the right output stream
+	bool compress = false;
+	
+	if (p_method_id == gID_outputVCFSample)
+		compress = compress_arg->LogicalAtIndex(0, nullptr);
+	
+	// Figure out the right output stream; compressed output is assembled in memory and then written out as BGZF
 	std::ofstream outfile;
+	std::ostringstream compress_buffer;
 	bool has_file = false;
+	bool append = false;
 	std::string outfile_path;
 	
 	if (filePath_arg->Type() != EidosValueType::kValueNULL)
 	{
 		outfile_path = Eidos_ResolvedPath(filePath_arg->StringAtIndex(0, nullptr));
-		bool append = append_arg->LogicalAtIndex(0, nullptr);
-		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		append = append_arg->LogicalAtIndex(0, nullptr);
 		has_file = true;
 		
-		if (!outfile.is_open())
-			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() could not open "<< outfile_path << "." << EidosTerminate();
+		if (compress)
+		{
+			if (!Eidos_string_hasSuffix(outfile_path, ".gz"))
+				outfile_path.append(".gz");
+		}
+		else
+		{
+			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+			
+			if (!outfile.is_open())
+				EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() could not open "<< outfile_path << "." << EidosTerminate();
+		}
+	}
+	else if (compress)
+	{
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() requires a filePath when compress is T." << EidosTerminate();
 	}
 	
-	std::ostream &out = *(has_file ? dynamic_cast<std::ostream *>(&outfile) : dynamic_cast<std::ostream *>(&output_stream));
+	std::ostream &out = *(has_file ? (compress ? dynamic_cast<std::ostream *>(&compress_buffer) : dynamic_cast<std::ostream *>(&outfile)) : dynamic_cast<std::ostream *>(&output_stream));
 	
 	if (!has_file || (p_method_id == gID_outputSample))
 	{
@@ -6956,7 +7513,12 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 		population_.PrintSample_VCF(out, *this, sample_size, replace, requested_sex, output_multiallelics, simplify_nucs, output_nonnucs);
 	
 	if (has_file)
-		outfile.close(); 
+	{
+		if (compress)
+			Eidos_WriteBGZFFile(outfile_path, compress_buffer.str(), append);
+		else
+			outfile.close();
+	}
 	
 	return gStaticEidosValueVOID;
 }
@@ -7131,7 +7693,7 @@ const std::vector<EidosMethodSignature_CSP> *Subpopulation_Class::Methods(void)
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_spatialMapImage, kEidosValueMaskObject | kEidosValueMaskSingleton, gEidosImage_Class))->AddString_S("name")->AddInt_OSN(gEidosStr_width, gStaticEidosValueNULL)->AddInt_OSN(gEidosStr_height, gStaticEidosValueNULL)->AddLogical_OS("centers", gStaticEidosValue_LogicalF)->AddLogical_OS("color", gStaticEidosValue_LogicalT));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_spatialMapValue, kEidosValueMaskFloat))->AddString_S("name")->AddFloat("point"));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputMSSample, kEidosValueMaskVOID))->AddInt_S("sampleSize")->AddLogical_OS("replace", gStaticEidosValue_LogicalT)->AddString_OS("requestedSex", gStaticEidosValue_StringAsterisk)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("filterMonomorphic", gStaticEidosValue_LogicalF));
-		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputVCFSample, kEidosValueMaskVOID))->AddInt_S("sampleSize")->AddLogical_OS("replace", gStaticEidosValue_LogicalT)->AddString_OS("requestedSex", gStaticEidosValue_StringAsterisk)->AddLogical_OS("outputMultiallelics", gStaticEidosValue_LogicalT)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("simplifyNucleotides", gStaticEidosValue_LogicalF)->AddLogical_OS("outputNonnucleotides", gStaticEidosValue_LogicalT));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputVCFSample, kEidosValueMaskVOID))->AddInt_S("sampleSize")->AddLogical_OS("replace", gStaticEidosValue_LogicalT)->AddString_OS("requestedSex", gStaticEidosValue_StringAsterisk)->AddLogical_OS("outputMultiallelics", gStaticEidosValue_LogicalT)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("simplifyNucleotides", gStaticEidosValue_LogicalF)->AddLogical_OS("outputNonnucleotides", gStaticEidosValue_LogicalT)->AddLogical_OS("compress", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputSample, kEidosValueMaskVOID))->AddInt_S("sampleSize")->AddLogical_OS("replace", gStaticEidosValue_LogicalT)->AddString_OS("requestedSex", gStaticEidosValue_StringAsterisk)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_configureDisplay, kEidosValueMaskVOID))->AddFloat_ON("center", gStaticEidosValueNULL)->AddFloat_OSN("scale", gStaticEidosValueNULL)->AddString_OSN("color", gStaticEidosValueNULL));
 		
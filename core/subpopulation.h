@@ -77,6 +77,16 @@
 class Population;
 
 
+// A recorded invocation of a mutation-type fitness() callback; see UpdateFitness() and ApplyFitnessCallbacks()
+struct SLiMFitnessCallbackRecord
+{
+	MutationIndex mutation_;					// the mutation, bound to mut
+	int homozygous_;							// -1 (opposed by a null genome), 0 (heterozygous), or 1 (homozygous), bound to homozygous
+	slim_popsize_t individual_index_;			// the index of the individual in parent_individuals_
+	double rel_fitness_;						// the value bound to relFitness, replaced by the callback results
+};
+
+
 extern EidosClass *gSLiM_Subpopulation_Class;
 
 
@@ -245,6 +255,22 @@ public:
 	double individual_cached_fitness_OVERRIDE_value_;
 #endif
 	
+	// Vectorized fitness() callbacks.  When every active fitness() callback is either vectorizable (see SLiMEidosBlock::ScanTreeForVectorization())
+	// or handled in C++ (constant or cached-optimization callbacks), UpdateFitness() evaluates the callbacks once over all of the invocations in the
+	// subpopulation, rather than once per invocation.  For mutation-type callbacks, a recording pass first collects the invocations that would be
+	// made, in the order they would be made; the callbacks are then evaluated over those records, and a replay pass feeds the results back to
+	// ApplyFitnessCallbacks() as the chromosomal fitness of each individual is computed.  Global fitness(NULL) callbacks are simply evaluated for
+	// every individual whose fitness is still positive, and ApplyGlobalFitnessCallbacks() returns the precomputed values.
+	bool fitness_callbacks_recording_ = false;						// T during the recording pass; ApplyFitnessCallbacks() records and returns 1.0
+	bool fitness_callbacks_replaying_ = false;						// T during the replay pass; ApplyFitnessCallbacks() returns recorded values
+	bool global_fitness_callbacks_replaying_ = false;				// T while ApplyGlobalFitnessCallbacks() should return vectorized_global_fitness_ values
+	std::vector<SLiMFitnessCallbackRecord> fitness_callback_records_;	// the recorded invocations of mutation-type callbacks, in order
+	std::vector<size_t> fitness_callback_record_starts_;			// the index in fitness_callback_records_ of the first record for each individual
+	size_t fitness_callback_replay_cursor_ = 0;						// the next record to be replayed
+	size_t fitness_callback_replay_end_ = 0;						// the end of the records for the individual being replayed
+	std::vector<double> vectorized_chromosomal_fitness_;			// the chromosomal (mutation-based) fitness of each individual
+	std::vector<double> vectorized_global_fitness_;					// the product of the global fitness(NULL) callbacks for each individual
+	
 	// SEX ONLY; the default values here are for the non-sex case
 	bool sex_enabled_ = false;										// the subpopulation needs to have easy reference to whether its individuals are sexual or not...
 	GenomeType modeled_chromosome_type_ = GenomeType::kAutosome;	// ...and needs to know what type of chromosomes its individuals are modeling; this should match SLiMSim
@@ -390,6 +416,15 @@ public:
 	
 	double ApplyFitnessCallbacks(MutationIndex p_mutation, int p_homozygous, double p_computed_fitness, std::vector<SLiMEidosBlock*> &p_fitness_callbacks, Individual *p_individual, Genome *p_genome1, Genome *p_genome2);
 	double ApplyGlobalFitnessCallbacks(std::vector<SLiMEidosBlock*> &p_fitness_callbacks, slim_popsize_t p_individual_index);
+	double _ExecuteFitnessCallback(SLiMEidosBlock *p_fitness_callback, MutationIndex p_mutation, int p_homozygous, double p_rel_fitness, Individual *p_individual, Genome *p_genome1, Genome *p_genome2);
+	double _ExecuteGlobalFitnessCallback(SLiMEidosBlock *p_fitness_callback, Individual *p_individual, Genome *p_genome1, Genome *p_genome2);
+	
+	// vectorized evaluation of fitness() callbacks across the whole subpopulation; see fitness_callbacks_recording_
+	bool _CallbacksAreVectorizable(std::vector<SLiMEidosBlock*> &p_callbacks, bool *p_any_vectorizable);
+	void _PrecomputeVectorizedFitness(std::vector<SLiMEidosBlock*> &p_fitness_callbacks, std::vector<SLiMEidosBlock*> &p_global_fitness_callbacks, bool p_record_fitness_callbacks, bool p_fitness_callbacks_exist, bool p_skip_chromosomal_fitness, MutationType *p_single_callback_mut_type, double p_subpop_fitness_scaling);
+	void _EvaluateVectorizedFitnessCallbacks(std::vector<SLiMEidosBlock*> &p_fitness_callbacks);
+	void _EvaluateVectorizedGlobalFitnessCallbacks(std::vector<SLiMEidosBlock*> &p_fitness_callbacks, std::vector<slim_popsize_t> &p_individual_indices);
+	EidosValue_SP _ExecuteVectorizedFitnessCallback(SLiMEidosBlock *p_fitness_callback, const std::vector<slim_popsize_t> &p_individual_indices, EidosValue_SP p_mut, EidosValue_SP p_relFitness, EidosValue_SP p_homozygous);
 	
 #ifdef SLIM_WF_ONLY
 	void TallyLifetimeReproductiveOutput(void);
@@ -79,6 +79,7 @@ SOURCES += \
     eidos_functions.cpp \
     eidos_globals.cpp \
     eidos_interpreter.cpp \
+    eidos_parallel.cpp \
     eidos_property_signature.cpp \
     eidos_rng.cpp \
     eidos_script.cpp \
@@ -109,11 +110,13 @@ HEADERS += \
     eidos_functions.h \
     eidos_globals.h \
     eidos_interpreter.h \
+    eidos_parallel.h \
     eidos_intrusive_ptr.h \
     eidos_object_pool.h \
     eidos_property_signature.h \
     eidos_rng.h \
     eidos_script.h \
+    eidos_simd.h \
     eidos_symbol_table.h \
     eidos_test_builtins.h \
     eidos_test.h \
@@ -50,6 +50,24 @@ EidosASTNode::~EidosASTNode(void)
 		delete argument_cache_;
 		argument_cache_ = nullptr;
 	}
+	
+	if (scalar_bytecode_)
+	{
+		delete scalar_bytecode_;
+		scalar_bytecode_ = nullptr;
+	}
+	
+	if (fused_expression_)
+	{
+		delete fused_expression_;
+		fused_expression_ = nullptr;
+	}
+	
+	if (folded_constant_)
+	{
+		delete folded_constant_;
+		folded_constant_ = nullptr;
+	}
 }
 
 void EidosASTNode::AddChild(EidosASTNode *p_child_node)
@@ -79,6 +97,15 @@ void EidosASTNode::OptimizeTree(void) const
 	_OptimizeEvaluators();		// cache evaluator functions in cached_evaluator_ for fast node evaluation
 	_OptimizeFor();				// cache information about for loops that allows them to be accelerated at runtime
 	_OptimizeAssignments();		// cache information about assignments that allows simple increment/decrement assignments to be accelerated
+	
+	if (gEidosScalarBytecode)
+		_OptimizeBytecode();	// compile scalar operator subtrees to bytecode, replacing their cached evaluator; must come after _OptimizeEvaluators()
+	
+	if (gEidosVectorFusion)
+		_OptimizeFusion();		// compile element-wise vector subtrees to fused programs, wrapping their cached evaluator; must come after _OptimizeBytecode()
+	
+	if (gEidosConstantFolding)
+		_OptimizeFolding();		// set up folding of pure subtrees over constants, wrapping their cached evaluator; must come last
 }
 
 void EidosASTNode::_OptimizeConstants(void) const
@@ -373,6 +400,525 @@ void EidosASTNode::_OptimizeAssignments(void) const
 	}
 }
 
+void EidosASTNode::_OptimizeBytecode(void) const
+{
+	EidosTokenType token_type = token_->token_type_;
+	
+	switch (token_type)
+	{
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenExp:
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		case EidosTokenType::kTokenNot:
+		{
+			// An operator node; try to compile the whole subtree under it.  If that succeeds, our children will be evaluated
+			// by the bytecode, so there is no need to look at them further; if it fails, the subtree is not entirely scalar-
+			// compatible, but parts of it might be, so we fall through to recurse.  Running OptimizeTree() again recompiles.
+			if (scalar_bytecode_)
+			{
+				delete scalar_bytecode_;
+				scalar_bytecode_ = nullptr;
+			}
+			
+			EidosScalarBytecode *bytecode = new EidosScalarBytecode();
+			
+			if (cached_evaluator_ && _CompileBytecode(bytecode, 0, EIDOS_BYTECODE_LOGICAL | EIDOS_BYTECODE_INT | EIDOS_BYTECODE_FLOAT))
+			{
+				bytecode->fallback_evaluator_ = cached_evaluator_;
+				scalar_bytecode_ = bytecode;
+				cached_evaluator_ = &EidosInterpreter::Evaluate_ScalarBytecode;
+				return;
+			}
+			
+			delete bytecode;
+			break;
+		}
+		default:
+			break;
+	}
+	
+	for (auto child : children_)
+		child->_OptimizeBytecode();
+}
+
+bool EidosASTNode::_CompileBytecode(EidosScalarBytecode *p_bytecode, int p_register, uint8_t p_accept_mask) const
+{
+	// Appends the instructions for the subtree rooted at this node to p_bytecode, leaving its result in p_register; p_accept_mask
+	// gives the operand types that our consumer can accept.  Returns false if the subtree contains anything we can't compile.
+	// Note that every leaf we allow must be free of side effects, since a bail re-evaluates the subtree (apart from property leaves
+	// that have already been evaluated, which Evaluate_ScalarBytecode() hands to the tree-walking evaluator).
+	const uint8_t numeric_mask = EIDOS_BYTECODE_INT | EIDOS_BYTECODE_FLOAT;
+	const uint8_t comparable_mask = EIDOS_BYTECODE_LOGICAL | EIDOS_BYTECODE_INT | EIDOS_BYTECODE_FLOAT;
+	size_t child_count = children_.size();
+	uint8_t binary_operand_mask = 0;
+	EidosBytecodeInstruction instruction;
+	
+	if (p_register >= EIDOS_BYTECODE_MAX_REGISTERS)
+		return false;
+	
+	instruction.reg_ = (uint8_t)p_register;
+	instruction.operand_count_ = 1;
+	instruction.accept_mask_ = p_accept_mask;
+	instruction.node_ = this;
+	instruction.constant_.type_ = 0;
+	instruction.constant_.int_ = 0;
+	
+	switch (token_->token_type_)
+	{
+		case EidosTokenType::kTokenNumber:
+		case EidosTokenType::kTokenIdentifier:
+		{
+			if (cached_literal_value_)
+			{
+				// numbers and built-in constants like T and PI are loaded from the instruction itself
+				EidosValue *literal = cached_literal_value_.get();
+				
+				if ((literal->Count() != 1) || (literal->DimensionCount() != 1))
+					return false;
+				
+				switch (literal->Type())
+				{
+					case EidosValueType::kValueLogical:
+						instruction.constant_.type_ = EIDOS_BYTECODE_LOGICAL;
+						instruction.constant_.logical_ = literal->LogicalAtIndex(0, nullptr);
+						break;
+					case EidosValueType::kValueInt:
+						instruction.constant_.type_ = EIDOS_BYTECODE_INT;
+						instruction.constant_.int_ = literal->IntAtIndex(0, nullptr);
+						break;
+					case EidosValueType::kValueFloat:
+						instruction.constant_.type_ = EIDOS_BYTECODE_FLOAT;
+						instruction.constant_.float_ = literal->FloatAtIndex(0, nullptr);
+						break;
+					default:
+						return false;
+				}
+				
+				instruction.op_ = EidosBytecodeOp::kLoadConstant;
+			}
+			else if ((token_->token_type_ == EidosTokenType::kTokenIdentifier) && (child_count == 0))
+			{
+				instruction.op_ = EidosBytecodeOp::kLoadIdentifier;
+			}
+			else
+			{
+				return false;
+			}
+			break;
+		}
+		case EidosTokenType::kTokenDot:
+		{
+			// property references, including chains like x.y.z, but only with a plain identifier at the root
+			const EidosASTNode *object_node = this;
+			
+			while (object_node->token_->token_type_ == EidosTokenType::kTokenDot)
+			{
+				if ((object_node->children_.size() != 2) || (object_node->children_[1]->token_->token_type_ != EidosTokenType::kTokenIdentifier))
+					return false;
+				
+				object_node = object_node->children_[0];
+			}
+			
+			if ((object_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || object_node->cached_literal_value_ || !cached_evaluator_)
+				return false;
+			
+			// Evaluate_ScalarBytecode() keeps the value of each property leaf on the stack, in case it bails
+			if (++p_bytecode->property_leaf_count_ > EIDOS_BYTECODE_MAX_PROPERTY_LEAVES)
+				return false;
+			
+			instruction.op_ = EidosBytecodeOp::kLoadProperty;
+			break;
+		}
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		{
+			if (child_count == 1)
+			{
+				if (!children_[0]->_CompileBytecode(p_bytecode, p_register, numeric_mask))
+					return false;
+				
+				instruction.op_ = ((token_->token_type_ == EidosTokenType::kTokenPlus) ? EidosBytecodeOp::kUnaryPlus : EidosBytecodeOp::kUnaryMinus);
+				break;
+			}
+			
+			instruction.op_ = ((token_->token_type_ == EidosTokenType::kTokenPlus) ? EidosBytecodeOp::kPlus : EidosBytecodeOp::kMinus);
+			binary_operand_mask = numeric_mask;
+			break;
+		}
+		case EidosTokenType::kTokenMult:	instruction.op_ = EidosBytecodeOp::kMult;	binary_operand_mask = numeric_mask;		break;
+		case EidosTokenType::kTokenDiv:		instruction.op_ = EidosBytecodeOp::kDiv;	binary_operand_mask = numeric_mask;		break;
+		case EidosTokenType::kTokenMod:		instruction.op_ = EidosBytecodeOp::kMod;	binary_operand_mask = numeric_mask;		break;
+		case EidosTokenType::kTokenExp:		instruction.op_ = EidosBytecodeOp::kExp;	binary_operand_mask = numeric_mask;		break;
+		case EidosTokenType::kTokenEq:		instruction.op_ = EidosBytecodeOp::kEq;		binary_operand_mask = comparable_mask;	break;
+		case EidosTokenType::kTokenNotEq:	instruction.op_ = EidosBytecodeOp::kNotEq;	binary_operand_mask = comparable_mask;	break;
+		case EidosTokenType::kTokenLt:		instruction.op_ = EidosBytecodeOp::kLt;		binary_operand_mask = comparable_mask;	break;
+		case EidosTokenType::kTokenLtEq:	instruction.op_ = EidosBytecodeOp::kLtEq;	binary_operand_mask = comparable_mask;	break;
+		case EidosTokenType::kTokenGt:		instruction.op_ = EidosBytecodeOp::kGt;		binary_operand_mask = comparable_mask;	break;
+		case EidosTokenType::kTokenGtEq:	instruction.op_ = EidosBytecodeOp::kGtEq;	binary_operand_mask = comparable_mask;	break;
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		{
+			// & and | take any number of operands, and evaluate all of them (they do not short-circuit, unlike && and ||)
+			if ((child_count < 2) || (p_register + child_count > EIDOS_BYTECODE_MAX_REGISTERS))
+				return false;
+			
+			for (size_t child_index = 0; child_index < child_count; ++child_index)
+				if (!children_[child_index]->_CompileBytecode(p_bytecode, p_register + (int)child_index, EIDOS_BYTECODE_LOGICAL))
+					return false;
+			
+			instruction.op_ = ((token_->token_type_ == EidosTokenType::kTokenAnd) ? EidosBytecodeOp::kAnd : EidosBytecodeOp::kOr);
+			instruction.operand_count_ = (uint8_t)child_count;
+			break;
+		}
+		case EidosTokenType::kTokenNot:
+		{
+			if ((child_count != 1) || !children_[0]->_CompileBytecode(p_bytecode, p_register, EIDOS_BYTECODE_LOGICAL))
+				return false;
+			
+			instruction.op_ = EidosBytecodeOp::kNot;
+			break;
+		}
+		default:
+			return false;
+	}
+	
+	if (binary_operand_mask)
+	{
+		// binary operators evaluate their left operand into our register, and their right operand into the next one
+		if ((child_count != 2) || !children_[0]->_CompileBytecode(p_bytecode, p_register, binary_operand_mask) || !children_[1]->_CompileBytecode(p_bytecode, p_register + 1, binary_operand_mask))
+			return false;
+	}
+	
+	p_bytecode->instructions_.emplace_back(instruction);
+	return true;
+}
+
+void EidosASTNode::_OptimizeFusion(void) const
+{
+	if (fused_expression_)
+	{
+		// OptimizeTree() is being run again; restore the evaluator we wrapped, unless _OptimizeEvaluators() already replaced it
+		if (cached_evaluator_ == &EidosInterpreter::Evaluate_Fused)
+			cached_evaluator_ = fused_expression_->fallback_evaluator_;
+		
+		delete fused_expression_;
+		fused_expression_ = nullptr;
+	}
+	
+	switch (token_->token_type_)
+	{
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenExp:
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+		case EidosTokenType::kTokenLParen:
+		{
+			// An operator or function call node; try to compile the whole subtree under it, as for _OptimizeBytecode().  Fusing a
+			// single operation saves nothing, since its result has to be materialized anyway, so we require at least two.
+			EidosFusedExpression *fused = new EidosFusedExpression();
+			int op_count = 0;
+			
+			if (cached_evaluator_ && _CompileFusion(fused, 0, true, &op_count) && (op_count >= 2))
+			{
+				fused->fallback_evaluator_ = cached_evaluator_;
+				fused_expression_ = fused;
+				cached_evaluator_ = &EidosInterpreter::Evaluate_Fused;
+				return;
+			}
+			
+			delete fused;
+			break;
+		}
+		default:
+			break;
+	}
+	
+	for (auto child : children_)
+		child->_OptimizeFusion();
+}
+
+// Built-in functions that can be fused, all of which take a single numeric argument x; sum() and mean() are allowed only at the root
+static const std::pair<const char *, EidosFusionOp> gEidosFusableFunctions[] = {
+	{"exp", EidosFusionOp::kFunctionExp}, {"log", EidosFusionOp::kFunctionLog}, {"log10", EidosFusionOp::kFunctionLog10}, {"log2", EidosFusionOp::kFunctionLog2},
+	{"sqrt", EidosFusionOp::kFunctionSqrt}, {"abs", EidosFusionOp::kFunctionAbs}, {"sin", EidosFusionOp::kFunctionSin}, {"cos", EidosFusionOp::kFunctionCos},
+	{"tan", EidosFusionOp::kFunctionTan}, {"floor", EidosFusionOp::kFunctionFloor}, {"ceil", EidosFusionOp::kFunctionCeil}, {"round", EidosFusionOp::kFunctionRound},
+	{"trunc", EidosFusionOp::kFunctionTrunc}, {"sum", EidosFusionOp::kSum}, {"mean", EidosFusionOp::kMean}
+};
+
+bool EidosASTNode::_CompileFusion(EidosFusedExpression *p_fused, int p_register, bool p_is_root, int *p_op_count) const
+{
+	// Appends the instructions for the subtree rooted at this node to p_fused, leaving its result in p_register; p_is_root is true
+	// only for the node being fused, which alone may be a comparison or a reduction.  Returns false if the subtree contains anything
+	// we can't compile.  As for _CompileBytecode(), every leaf we allow must be free of side effects, since a bail re-evaluates.
+	size_t child_count = children_.size();
+	bool is_binary = false;
+	EidosFusionInstruction instruction;
+	
+	if (p_register >= EIDOS_FUSION_MAX_REGISTERS)
+		return false;
+	
+	instruction.reg_ = (uint8_t)p_register;
+	instruction.leaf_ = 0;
+	instruction.constant_is_int_ = false;
+	instruction.constant_ = 0.0;
+	instruction.constant_int_ = 0;
+	instruction.node_ = this;
+	
+	switch (token_->token_type_)
+	{
+		case EidosTokenType::kTokenNumber:
+		case EidosTokenType::kTokenIdentifier:
+		{
+			if (cached_literal_value_)
+			{
+				// numbers and built-in constants like PI are loaded from the instruction itself
+				EidosValue *literal = cached_literal_value_.get();
+				EidosValueType literal_type = literal->Type();
+				
+				if ((literal->Count() != 1) || (literal->DimensionCount() != 1) || ((literal_type != EidosValueType::kValueInt) && (literal_type != EidosValueType::kValueFloat)))
+					return false;
+				
+				instruction.op_ = EidosFusionOp::kLoadConstant;
+				instruction.constant_is_int_ = (literal_type == EidosValueType::kValueInt);
+				instruction.constant_ = literal->FloatAtIndex(0, nullptr);
+				
+				if (instruction.constant_is_int_)
+					instruction.constant_int_ = literal->IntAtIndex(0, nullptr);
+			}
+			else if ((token_->token_type_ == EidosTokenType::kTokenIdentifier) && (child_count == 0))
+			{
+				instruction.op_ = EidosFusionOp::kLoadIdentifier;
+			}
+			else
+			{
+				return false;
+			}
+			break;
+		}
+		case EidosTokenType::kTokenDot:
+		{
+			// property references, including chains like x.y.z, but only with a plain identifier at the root
+			const EidosASTNode *object_node = this;
+			
+			while (object_node->token_->token_type_ == EidosTokenType::kTokenDot)
+			{
+				if ((object_node->children_.size() != 2) || (object_node->children_[1]->token_->token_type_ != EidosTokenType::kTokenIdentifier))
+					return false;
+				
+				object_node = object_node->children_[0];
+			}
+			
+			if ((object_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || object_node->cached_literal_value_ || !cached_evaluator_)
+				return false;
+			
+			instruction.op_ = EidosFusionOp::kLoadProperty;
+			break;
+		}
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		{
+			if (child_count == 1)
+			{
+				// unary plus changes nothing for a numeric operand, so it compiles to nothing; a non-numeric operand bails anyway
+				if (!children_[0]->_CompileFusion(p_fused, p_register, false, p_op_count))
+					return false;
+				
+				if (token_->token_type_ == EidosTokenType::kTokenPlus)
+					return true;
+				
+				instruction.op_ = EidosFusionOp::kUnaryMinus;
+				break;
+			}
+			
+			instruction.op_ = ((token_->token_type_ == EidosTokenType::kTokenPlus) ? EidosFusionOp::kPlus : EidosFusionOp::kMinus);
+			is_binary = true;
+			break;
+		}
+		case EidosTokenType::kTokenMult:	instruction.op_ = EidosFusionOp::kMult;		is_binary = true;	break;
+		case EidosTokenType::kTokenDiv:		instruction.op_ = EidosFusionOp::kDiv;		is_binary = true;	break;
+		case EidosTokenType::kTokenExp:		instruction.op_ = EidosFusionOp::kExp;		is_binary = true;	break;
+		case EidosTokenType::kTokenEq:		instruction.op_ = EidosFusionOp::kEq;		is_binary = true;	break;
+		case EidosTokenType::kTokenNotEq:	instruction.op_ = EidosFusionOp::kNotEq;	is_binary = true;	break;
+		case EidosTokenType::kTokenLt:		instruction.op_ = EidosFusionOp::kLt;		is_binary = true;	break;
+		case EidosTokenType::kTokenLtEq:	instruction.op_ = EidosFusionOp::kLtEq;		is_binary = true;	break;
+		case EidosTokenType::kTokenGt:		instruction.op_ = EidosFusionOp::kGt;		is_binary = true;	break;
+		case EidosTokenType::kTokenGtEq:	instruction.op_ = EidosFusionOp::kGtEq;		is_binary = true;	break;
+		case EidosTokenType::kTokenLParen:
+		{
+			// a call to one of the functions above, with a single positional argument
+			const EidosASTNode *call_name_node = (child_count ? children_[0] : nullptr);
+			
+			if ((child_count != 2) || (call_name_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || !call_name_node->cached_signature_ ||
+				(children_[1]->token_->token_type_ == EidosTokenType::kTokenAssign))
+				return false;
+			
+			const std::string &call_name = call_name_node->cached_signature_->call_name_;
+			auto function_iter = std::find_if(std::begin(gEidosFusableFunctions), std::end(gEidosFusableFunctions), [&call_name](const std::pair<const char *, EidosFusionOp> &function) { return call_name == function.first; });
+			
+			if (function_iter == std::end(gEidosFusableFunctions))
+				return false;
+			
+			instruction.op_ = function_iter->second;
+			
+			if (((instruction.op_ == EidosFusionOp::kSum) || (instruction.op_ == EidosFusionOp::kMean)) && !p_is_root)
+				return false;
+			
+			if (!children_[1]->_CompileFusion(p_fused, p_register, false, p_op_count))
+				return false;
+			break;
+		}
+		default:
+			return false;
+	}
+	
+	if ((instruction.op_ >= EidosFusionOp::kEq) && (instruction.op_ <= EidosFusionOp::kGtEq) && !p_is_root)
+		return false;
+	
+	if (is_binary)
+	{
+		// binary operators evaluate their left operand into our register, and their right operand into the next one
+		if ((child_count != 2) || !children_[0]->_CompileFusion(p_fused, p_register, false, p_op_count) || !children_[1]->_CompileFusion(p_fused, p_register + 1, false, p_op_count))
+			return false;
+	}
+	
+	if ((instruction.op_ == EidosFusionOp::kLoadIdentifier) || (instruction.op_ == EidosFusionOp::kLoadProperty))
+	{
+		if (p_fused->leaf_count_ >= EIDOS_FUSION_MAX_LEAVES)
+			return false;
+		
+		instruction.leaf_ = (uint8_t)p_fused->leaf_count_++;
+	}
+	else if (instruction.op_ != EidosFusionOp::kLoadConstant)
+	{
+		(*p_op_count)++;
+	}
+	
+	if (p_fused->instructions_.size() >= EIDOS_FUSION_MAX_INSTRUCTIONS)
+		return false;
+	
+	p_fused->register_count_ = std::max(p_fused->register_count_, p_register + (is_binary ? 2 : 1));
+	p_fused->instructions_.emplace_back(instruction);
+	return true;
+}
+
+// Built-in functions that are deterministic and free of side effects, and thus safe to fold when their arguments are constant;
+// anything that draws random numbers, looks at or modifies symbols or other state, or produces output must not be listed here
+static const char *const gEidosFoldableFunctionNames[] = {
+	"abs", "acos", "asin", "atan", "atan2", "ceil", "cos", "exp", "floor", "log", "log10", "log2", "round", "sin", "sqrt", "tan", "trunc",
+	"cumProduct", "cumSum", "max", "mean", "min", "pmax", "pmin", "product", "sd", "sum",
+	"all", "any", "ifelse", "identical", "c", "rep", "repEach", "rev", "seq", "seqLen", "size", "length",
+	"asFloat", "asInteger", "asLogical", "asString", "float", "integer", "logical", "string",
+	"isFloat", "isInteger", "isLogical", "isNULL", "isString", "nchar", "paste", "paste0"
+};
+
+bool EidosASTNode::_OptimizeFolding(void) const
+{
+	// Returns true if the subtree rooted at this node is pure: built only from operators, calls to the built-in functions listed
+	// above, literals, and identifiers.  Such subtrees, other than bare leaves, get an EidosFoldedConstant; whether a given subtree
+	// actually folds is decided at runtime by EidosInterpreter::Evaluate_Folded(), since only then do we know which identifiers
+	// are constants.  Every pure node gets one, not just maximal ones, so that pure parts of a subtree that cannot fold still can.
+	if (folded_constant_)
+	{
+		// OptimizeTree() is being run again; restore the evaluator we wrapped, unless _OptimizeEvaluators() already replaced it
+		if (cached_evaluator_ == &EidosInterpreter::Evaluate_Folded)
+			cached_evaluator_ = folded_constant_->fallback_evaluator_;
+		
+		delete folded_constant_;
+		folded_constant_ = nullptr;
+	}
+	
+	bool pure = true;
+	
+	switch (token_->token_type_)
+	{
+		case EidosTokenType::kTokenNumber:
+		case EidosTokenType::kTokenString:
+			return true;
+		case EidosTokenType::kTokenIdentifier:
+			return (children_.size() == 0);
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenExp:
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		case EidosTokenType::kTokenNot:
+		case EidosTokenType::kTokenColon:
+		case EidosTokenType::kTokenConditional:
+		{
+			for (auto child : children_)
+				pure = child->_OptimizeFolding() && pure;
+			
+			// a range over two numbers is already cached by Evaluate_RangeExpr()
+			if ((token_->token_type_ == EidosTokenType::kTokenColon) && (children_.size() == 2) &&
+				(children_[0]->token_->token_type_ == EidosTokenType::kTokenNumber) && (children_[1]->token_->token_type_ == EidosTokenType::kTokenNumber))
+				return true;
+			break;
+		}
+		case EidosTokenType::kTokenLParen:
+		{
+			// a function call; the call name node is not evaluated, and named arguments are assignment nodes whose value is evaluated
+			const EidosASTNode *call_name_node = (children_.size() ? children_[0] : nullptr);
+			
+			if (!call_name_node || (call_name_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || !call_name_node->cached_signature_ ||
+				(std::find_if(std::begin(gEidosFoldableFunctionNames), std::end(gEidosFoldableFunctionNames), [call_name_node](const char *name) { return call_name_node->cached_signature_->call_name_ == name; }) == std::end(gEidosFoldableFunctionNames)))
+				pure = false;
+			
+			for (size_t child_index = 1; child_index < children_.size(); ++child_index)
+			{
+				const EidosASTNode *argument_node = children_[child_index];
+				
+				if ((argument_node->token_->token_type_ == EidosTokenType::kTokenAssign) && (argument_node->children_.size() == 2))
+					pure = argument_node->children_[1]->_OptimizeFolding() && pure;
+				else
+					pure = argument_node->_OptimizeFolding() && pure;
+			}
+			break;
+		}
+		default:
+		{
+			for (auto child : children_)
+				child->_OptimizeFolding();
+			return false;
+		}
+	}
+	
+	if (pure && cached_evaluator_)
+	{
+		folded_constant_ = new EidosFoldedConstant();
+		folded_constant_->fallback_evaluator_ = cached_evaluator_;
+		cached_evaluator_ = &EidosInterpreter::Evaluate_Folded;
+	}
+	
+	return pure;
+}
+
 bool EidosASTNode::HasCachedNumericValue(void) const
 {
 	if ((token_->token_type_ == EidosTokenType::kTokenNumber) && cached_literal_value_ && (cached_literal_value_->Count() == 1))
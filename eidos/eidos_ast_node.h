@@ -64,6 +64,159 @@ struct EidosASTNode_ArgumentCache
 	bool argument_buffer_in_use_;										// prevents argument_buffer_ from being overwritten by recursion
 };
 
+// scalar bytecode for operator subtrees; compiled by EidosASTNode::_OptimizeBytecode() and run by EidosInterpreter::Evaluate_ScalarBytecode()
+// a maximal subtree of arithmetic/comparison/logical operators whose leaves are numeric literals, identifiers, or property references is
+// flattened into a postorder instruction list that runs over a small file of typed registers, with no EidosValue allocated for intermediate
+// results; if a leaf turns out not to be a singleton int/float/logical, or an integer operation overflows, execution bails out to the tree-
+// walking evaluator, which re-evaluates the (side-effect-free) subtree and produces the exact same result or error it always has; property
+// leaves already evaluated before the bail are handed to it rather than evaluated again, since a property of a large vector can be costly
+#define EIDOS_BYTECODE_MAX_REGISTERS			32
+#define EIDOS_BYTECODE_MAX_PROPERTY_LEAVES		8
+
+enum class EidosBytecodeOp : uint8_t {
+	kLoadConstant = 0,		// constant_ -> reg_
+	kLoadIdentifier,		// look up identifier node_ -> reg_
+	kLoadProperty,			// evaluate property reference node_ -> reg_
+	kUnaryPlus,				// reg_ -> reg_
+	kUnaryMinus,			// -reg_ -> reg_
+	kPlus,					// reg_ + reg_+1 -> reg_, and similarly for the binary operators below
+	kMinus,
+	kMult,
+	kDiv,
+	kMod,
+	kExp,
+	kEq,
+	kNotEq,
+	kLt,
+	kLtEq,
+	kGt,
+	kGtEq,
+	kAnd,					// reg_ & ... & reg_+operand_count_-1 -> reg_
+	kOr,					// reg_ | ... | reg_+operand_count_-1 -> reg_
+	kNot					// !reg_ -> reg_
+};
+
+// type bits for EidosBytecodeInstruction::accept_mask_
+#define EIDOS_BYTECODE_LOGICAL	0x01
+#define EIDOS_BYTECODE_INT		0x02
+#define EIDOS_BYTECODE_FLOAT	0x04
+
+struct EidosBytecodeRegister
+{
+	uint8_t type_;							// EIDOS_BYTECODE_LOGICAL, EIDOS_BYTECODE_INT, or EIDOS_BYTECODE_FLOAT
+	union {
+		eidos_logical_t logical_;
+		int64_t int_;
+		double float_;
+	};
+};
+
+struct EidosBytecodeInstruction
+{
+	EidosBytecodeOp op_;
+	uint8_t reg_;							// the destination register, which is also the first operand register
+	uint8_t operand_count_;					// the number of operand registers, for kAnd and kOr
+	uint8_t accept_mask_;					// the types the consumer of this instruction's result accepts without raising; anything else bails
+	const EidosASTNode *node_;				// the node evaluated by kLoadIdentifier and kLoadProperty
+	EidosBytecodeRegister constant_;		// the value loaded by kLoadConstant
+};
+
+struct EidosScalarBytecode
+{
+	std::vector<EidosBytecodeInstruction> instructions_;
+	EidosEvaluationMethod fallback_evaluator_;	// the tree-walking evaluator for the compiled node, used when execution bails
+	int property_leaf_count_ = 0;				// the number of kLoadProperty instructions, at most EIDOS_BYTECODE_MAX_PROPERTY_LEAVES
+	uint32_t run_count_ = 0;					// the number of runs that completed in bytecode
+	uint32_t bail_count_ = 0;					// the number of runs that bailed; when bails dominate, the node reverts to fallback_evaluator_
+};
+
+// fused evaluation of element-wise vector expressions; compiled by EidosASTNode::_OptimizeFusion() and run by EidosInterpreter::Evaluate_Fused()
+// a subtree of arithmetic operators and element-wise math functions like exp() and sqrt(), over the same leaves as scalar bytecode, would
+// normally allocate a full-length vector for every operator; fused, it runs block by block through a postorder instruction list, keeping
+// intermediate results in small cache-resident register buffers and materializing only the final result.  The root may also be a
+// comparison, producing a logical vector, or sum() or mean(), producing a singleton with no vector materialized at all.  Whatever the fused
+// form cannot reproduce exactly (integer arithmetic, matrices, non-conformable or zero-length operands) bails to the tree-walking evaluator
+// as scalar bytecode does, as do all-singleton operands, which scalar bytecode handles better.  Subtrees that turn out to involve only
+// singletons, like 2*sigma^2, are computed once up front, with the usual integer semantics, and then applied to every element as a
+// constant.  Results are bit-identical either way.
+#define EIDOS_FUSION_MAX_REGISTERS		8
+#define EIDOS_FUSION_MAX_LEAVES			16
+#define EIDOS_FUSION_MAX_INSTRUCTIONS	64
+#define EIDOS_FUSION_BLOCK_SIZE			256
+
+enum class EidosFusionOp : uint8_t {
+	kLoadConstant = 0,		// constant_ -> reg_
+	kLoadIdentifier,		// look up identifier node_ -> reg_, as leaf leaf_
+	kLoadProperty,			// evaluate property reference node_ -> reg_, as leaf leaf_
+	kUnaryMinus,			// -reg_ -> reg_
+	kPlus,					// reg_ + reg_+1 -> reg_, and similarly for the binary operators below
+	kMinus,
+	kMult,
+	kDiv,
+	kExp,
+	kFunctionExp,			// exp(reg_) -> reg_, and similarly for the element-wise functions below
+	kFunctionLog,
+	kFunctionLog10,
+	kFunctionLog2,
+	kFunctionSqrt,
+	kFunctionAbs,
+	kFunctionSin,
+	kFunctionCos,
+	kFunctionTan,
+	kFunctionFloor,
+	kFunctionCeil,
+	kFunctionRound,
+	kFunctionTrunc,
+	kEq,					// reg_ == reg_+1 -> result, and similarly for the comparisons below; only as the last instruction
+	kNotEq,
+	kLt,
+	kLtEq,
+	kGt,
+	kGtEq,
+	kSum,					// sum(reg_) -> result; only as the last instruction
+	kMean					// mean(reg_) -> result; only as the last instruction
+};
+
+struct EidosFusionInstruction
+{
+	EidosFusionOp op_;
+	uint8_t reg_;							// the destination register, which is also the first operand register
+	uint8_t leaf_;							// the leaf index loaded by kLoadIdentifier and kLoadProperty
+	uint8_t constant_is_int_;				// true if the value loaded by kLoadConstant is an integer, in constant_int_
+	double constant_;						// the value loaded by kLoadConstant, as a float
+	int64_t constant_int_;					// the value loaded by kLoadConstant, if it is an integer
+	const EidosASTNode *node_;				// the node evaluated by kLoadIdentifier and kLoadProperty
+};
+
+struct EidosFusedExpression
+{
+	std::vector<EidosFusionInstruction> instructions_;
+	int leaf_count_ = 0;						// the number of kLoadIdentifier and kLoadProperty instructions
+	int register_count_ = 0;					// the number of registers used
+	EidosEvaluationMethod fallback_evaluator_;	// the evaluator for the node before fusion, used when execution bails
+	uint32_t run_count_ = 0;					// the number of runs that completed fused
+	uint32_t bail_count_ = 0;					// the number of runs that bailed; when bails dominate, the node reverts to fallback_evaluator_
+};
+
+// constant folding for pure subtrees; set up by EidosASTNode::_OptimizeFolding() and run by EidosInterpreter::Evaluate_Folded()
+// a subtree built only from operators, pure built-in functions, literals, and identifiers is a folding candidate; the first time it
+// is evaluated, if every identifier in it turns out to be an intrinsic constant or a constant from defineConstant() (including -d
+// constants on the command line), its value is kept and returned on later evaluations without re-evaluating the subtree, which
+// also makes branches on constant conditions and loop-invariant constant expressions free; gEidosDefinedConstantsEpoch changes
+// whenever a defined constant could have changed value, which invalidates the kept value.  If any identifier is not a constant,
+// the node reverts permanently to fallback_evaluator_; all evaluation goes through fallback_evaluator_, so errors never change
+// Only small values are kept: a kept value is shared with every variable it is assigned to, so the first in-place modification
+// of such a variable copies it, and for a large vector that copy costs as much as re-evaluating the subtree, while the kept value
+// itself stays in memory for as long as the script does; a subtree with a larger value also reverts to fallback_evaluator_
+#define EIDOS_FOLDED_CONSTANT_MAX_COUNT		32
+
+struct EidosFoldedConstant
+{
+	EidosEvaluationMethod fallback_evaluator_;	// the evaluator for the node before folding, used to compute the folded value
+	EidosValue_SP value_;						// the folded value, or nullptr if not yet folded
+	uint32_t epoch_ = 0;						// the value of gEidosDefinedConstantsEpoch when value_ was computed
+};
+
 // A class representing a node in a parse tree for a script
 class EidosASTNode
 {
@@ -90,6 +243,9 @@ public:
 	mutable bool hit_eof_in_tolerant_parse_ = false;					// only valid for compound statement nodes; used by the type-interpreter to handle scoping
 	
 	mutable EidosASTNode_ArgumentCache *argument_cache_ = nullptr;		// OWNED POINTER: an argument cache struct, allocated on demand for function/method call nodes
+	mutable EidosScalarBytecode *scalar_bytecode_ = nullptr;			// OWNED POINTER: compiled bytecode for a scalar operator subtree rooted at this node
+	mutable EidosFusedExpression *fused_expression_ = nullptr;			// OWNED POINTER: a fused program for an element-wise vector subtree rooted at this node
+	mutable EidosFoldedConstant *folded_constant_ = nullptr;			// OWNED POINTER: constant folding state for a pure subtree rooted at this node
 	
 #if defined(SLIMGUI) && (SLIMPROFILING == 1)
 	// PROFILING
@@ -120,6 +276,11 @@ public:
 	void _OptimizeFor(void) const;										// determine whether/how for-loop index variables need to be set up
 	void _OptimizeForScan(const std::string &p_for_index_identifier, uint8_t *p_references, uint8_t *p_assigns) const;	// internal method
 	void _OptimizeAssignments(void) const;								// detect and mark simple increment/decrement assignments on a variable
+	void _OptimizeBytecode(void) const;									// compile scalar operator subtrees to bytecode; see EidosScalarBytecode
+	bool _CompileBytecode(EidosScalarBytecode *p_bytecode, int p_register, uint8_t p_accept_mask) const;	// internal method
+	void _OptimizeFusion(void) const;									// compile element-wise vector subtrees to fused programs; see EidosFusedExpression
+	bool _CompileFusion(EidosFusedExpression *p_fused, int p_register, bool p_is_root, int *p_op_count) const;	// internal method
+	bool _OptimizeFolding(void) const;									// set up constant folding for pure subtrees; see EidosFoldedConstant
 	
 	bool HasCachedNumericValue(void) const;
 	double CachedNumericValue(void) const;
@@ -22,7 +22,8 @@
 #include "eidos_functions.h"
 
 #include <fstream>
-#include <regex>
+#include <sstream>
+#include <cstring>
 #include <limits>
 #include <string>
 #include <algorithm>
@@ -525,6 +526,126 @@ static EidosValue_SP Eidos_Instantiate_EidosDataFrame(const std::vector<EidosVal
 	return result_SP;
 }
 
+// Recognizes NAN, and INF or INFINITY with an optional sign, case-insensitively, returning the corresponding value in p_value
+static bool _Eidos_CSVSpecialFloat(const char *p_string, double *p_value)
+{
+	// most values cannot be one of these, so check the first letter before doing any real work
+	const char *ptr = p_string;
+	
+	if ((*ptr == '+') || (*ptr == '-'))
+		ptr++;
+	
+	if ((*ptr != 'n') && (*ptr != 'N') && (*ptr != 'i') && (*ptr != 'I'))
+		return false;
+	
+	std::string value_string(p_string);
+	
+	if (Eidos_string_equalsCaseInsensitive(value_string, "NAN"))
+		*p_value = std::numeric_limits<double>::quiet_NaN();
+	else if (Eidos_string_equalsCaseInsensitive(value_string, "INF") ||
+		Eidos_string_equalsCaseInsensitive(value_string, "INFINITY") ||
+		Eidos_string_equalsCaseInsensitive(value_string, "+INF") ||
+		Eidos_string_equalsCaseInsensitive(value_string, "+INFINITY"))
+		*p_value = std::numeric_limits<double>::infinity();
+	else if (Eidos_string_equalsCaseInsensitive(value_string, "-INF") ||
+		Eidos_string_equalsCaseInsensitive(value_string, "-INFINITY"))
+		*p_value = -std::numeric_limits<double>::infinity();
+	else
+		return false;
+	
+	return true;
+}
+
+static bool _Eidos_CSVIsSpecialFloat(const char *p_string)
+{
+	double value;
+	
+	return _Eidos_CSVSpecialFloat(p_string, &value);
+}
+
+// Returns the next line of a buffer being parsed by readCSV(), null-terminated in place, or nullptr at the end of the buffer.  As with
+// getline(), a final line with no newline is still returned; it is terminated by the null that std::string keeps after its contents.
+static char *_Eidos_CSVNextLine(char *&p_next_line_ptr, char *p_buffer_end)
+{
+	if (p_next_line_ptr >= p_buffer_end)
+		return nullptr;
+	
+	char *line_start = p_next_line_ptr;
+	char *newline = (char *)memchr(line_start, '\n', p_buffer_end - line_start);
+	
+	if (newline)
+	{
+		*newline = 0;
+		p_next_line_ptr = newline + 1;
+	}
+	else
+	{
+		p_next_line_ptr = p_buffer_end;
+	}
+	
+	return line_start;
+}
+
+static inline bool _Eidos_CSVIsDigit(char p_ch)
+{
+	return ((p_ch >= '0') && (p_ch <= '9'));
+}
+
+// These match the patterns [+-]?[0-9]+ and [+-]?[0-9]+(<dec>[0-9]*)?([eE][+-]?[0-9]+)? against a whole string, for guessing column types
+static bool _Eidos_CSVMatchesInteger(const char *p_string)
+{
+	const char *ptr = p_string;
+	
+	if ((*ptr == '+') || (*ptr == '-'))
+		ptr++;
+	
+	if (!_Eidos_CSVIsDigit(*ptr))
+		return false;
+	
+	while (_Eidos_CSVIsDigit(*ptr))
+		ptr++;
+	
+	return (*ptr == 0);
+}
+
+static bool _Eidos_CSVMatchesFloat(const char *p_string, char p_dec)
+{
+	const char *ptr = p_string;
+	
+	if ((*ptr == '+') || (*ptr == '-'))
+		ptr++;
+	
+	if (!_Eidos_CSVIsDigit(*ptr))
+		return false;
+	
+	while (_Eidos_CSVIsDigit(*ptr))
+		ptr++;
+	
+	if (*ptr == p_dec)
+	{
+		ptr++;
+		
+		while (_Eidos_CSVIsDigit(*ptr))
+			ptr++;
+	}
+	
+	if ((*ptr == 'e') || (*ptr == 'E'))
+	{
+		ptr++;
+		
+		if ((*ptr == '+') || (*ptr == '-'))
+			ptr++;
+		
+		if (!_Eidos_CSVIsDigit(*ptr))
+			return false;
+		
+		while (_Eidos_CSVIsDigit(*ptr))
+			ptr++;
+	}
+	
+	return (*ptr == 0);
+}
+
 //	(object<DataFrame>$)readCSV(string$ filePath, [ls colNames = T], [Ns$ colTypes = NULL], [string$ sep = ","], [string$ quote = "\""], [string$ dec = "."], [string$ comment = ""])
 static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -540,7 +661,10 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 	std::string base_path = filePath_value->StringAtIndex(0, nullptr);
 	std::string file_path = Eidos_ResolvedPath(base_path);
 	
-	std::ifstream file_stream(file_path.c_str());
+	// write out any appended data still buffered for this file, so that we read what has been written so far
+	Eidos_FlushFile(file_path);
+	
+	std::ifstream file_stream(file_path.c_str(), std::ios_base::in | std::ios_base::binary);
 	
 	if (!file_stream.is_open())
 	{
@@ -548,6 +672,35 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_readCSV): function readCSV() could not read file at path " << file_path << "." << std::endl;
 		return gStaticEidosValueNULL;
 	}
+	
+	// Read the whole file in one block; it is then parsed in place, rather than being copied line by line through getline()
+	std::string file_buffer;
+	
+	file_stream.seekg(0, std::ios_base::end);
+	std::streamoff file_size = file_stream.tellg();
+	
+	if (file_size >= 0)
+	{
+		file_buffer.resize((size_t)file_size);
+		file_stream.seekg(0, std::ios_base::beg);
+		file_stream.read(&file_buffer[0], file_size);
+	}
+	else
+	{
+		// not seekable, such as a pipe; fall back to reading through the stream buffer
+		std::ostringstream file_contents;
+		
+		file_stream.clear();
+		file_contents << file_stream.rdbuf();
+		file_buffer = file_contents.str();
+	}
+	
+	if (file_stream.bad())
+	{
+		if (!gEidosSuppressWarnings)
+			p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_readCSV): function readCSV() encountered stream errors while reading file at path " << file_path << "." << std::endl;
+		return gStaticEidosValueNULL;
+	}
 
 	// Figure out our various separators/delimiters
 	std::string sep_string = sep_value->StringAtIndex(0, nullptr);
@@ -576,15 +729,20 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 	
 	// Read lines and split each line up into components; this is non-trivial since it involves parsing out quoted strings and unquoting them
 	// Check that each line has the same number of components as we go along, to avoid having to make an extra pass
-	std::string line;
-	std::vector<std::vector<std::string>> rows;
+	// Elements are unquoted and null-terminated in place in file_buffer, which is safe because an element never grows when unquoted, and
+	// the character after it has always been consumed by the time it is terminated; the elements of all rows are then kept as pointers
+	// into the buffer in one flat vector, in row-major order, avoiding a std::string and a vector allocation per element and row
+	char *next_line_ptr = &file_buffer[0];
+	char *buffer_end = next_line_ptr + file_buffer.length();
+	char *line;
+	std::vector<char *> cells;
 	int ncols = -1, line_number = 0;
 	
-	while (getline(file_stream, line))
+	while ((line = _Eidos_CSVNextLine(next_line_ptr, buffer_end)))
 	{
 		// split line into strings based on sep, quote, and comment
-		std::vector<std::string> row;
-		const char *line_ptr = line.data();
+		size_t row_start = cells.size();
+		char *line_ptr = line;
 		char ch = *line_ptr;
 		
 		line_number++;		// after this increment, this has the line number (1-based) we are current parsing
@@ -603,7 +761,8 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			if ((ch == 0) || (comment && (ch == comment)))
 			{
 				// empty element and then end the line
-				row.emplace_back();
+				*line_ptr = 0;
+				cells.emplace_back(line_ptr);
 				break;
 			}
 			
@@ -611,7 +770,8 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			// we make the empty element, eat the separator, and loop back for the next element
 			if (ch == sep)
 			{
-				row.emplace_back();
+				*line_ptr = 0;
+				cells.emplace_back(line_ptr);
 				ch = *(++line_ptr);
 				continue;
 			}
@@ -620,8 +780,9 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			// note that leading whitespace is part of the element, and indicates an unquoted element
 			if (ch == quote)
 			{
-				// quoted string: read until the end quote, unquoting doubled quotes
-				std::string element_string;
+				// quoted string: read until the end quote, unquoting doubled quotes; the unquoted element is written over the quoted text
+				char *element_start = line_ptr;
+				char *element_write_ptr = element_start;
 				
 				// eat the quote and get the next character
 				ch = *(++line_ptr);
@@ -634,12 +795,12 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 					if (ch == 0)
 					{
 						// we reached the end of the line, but we're still inside the quoted element; incorporate the implied newline and keep going
-						if (!getline(file_stream, line))
+						if (!(line = _Eidos_CSVNextLine(next_line_ptr, buffer_end)))
 							EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an unexpected end-of-file inside a quoted element, at line " << line_number << "." << EidosTerminate(nullptr);
 						
-						element_string.append(1, '\n');
+						*(element_write_ptr++) = '\n';
 						line_number++;
-						line_ptr = line.data();
+						line_ptr = line;
 						ch = *line_ptr;
 					}
 					else if (ch == quote)
@@ -651,7 +812,7 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 						if (ch == quote)
 						{
 							// doubled quote; append one quote and continue
-							element_string.append(1, quote);
+							*(element_write_ptr++) = quote;
 							ch = *(++line_ptr);
 						}
 						else
@@ -677,25 +838,27 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 					else
 					{
 						// this character is part of the element; the above cases are the only exceptions
-						element_string.append(1, ch);
+						*(element_write_ptr++) = ch;
 						ch = *(++line_ptr);
 					}
 				}
 				while (true);
 				
 				// add the completed element to the row
-				row.emplace_back(element_string);
+				*element_write_ptr = 0;
+				cells.emplace_back(element_start);
 			}
 			else
 			{
 				// unquoted string: read until a separator, comment, or null
-				std::string element_string;
+				char *element_start = line_ptr;
+				char *element_end;
 				
 				do
 				{
-					// at the top of the loop, ch has a valid character to be added to the element; do so
-					element_string.append(1, ch);
+					// at the top of the loop, ch is a valid character of the element; move past it
 					ch = *(++line_ptr);
+					element_end = line_ptr;
 					
 					// now decide what to do about the next character
 					if (ch == 0)
@@ -723,7 +886,8 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 				while (true);
 				
 				// add the completed element to the row
-				row.emplace_back(element_string);
+				*element_end = 0;
+				cells.emplace_back(element_start);
 			}
 			
 			// if we ended the line above without seeing a separator, we do not expect another element; the row is done
@@ -733,21 +897,21 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 		}
 		while (true);
 		
-		// check the column count, and if it passes, append this row to our buffer and move on
-		if (ncols == -1)
-			ncols = (int)row.size();
-		else if (ncols != (int)row.size())
-			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an inconsistent column count in CSV file (" << row.size() << " observed, " << ncols << " previously), at line " << line_number << "." << EidosTerminate(nullptr);
+		// check the column count, and if it passes, move on; the row's elements are already in cells
+		size_t row_size = cells.size() - row_start;
 		
-		rows.emplace_back(row);
+		if (ncols == -1)
+		{
+			ncols = (int)row_size;
+			cells.reserve(ncols * (std::count(next_line_ptr, buffer_end, '\n') + 2));
+		}
+		else if (ncols != (int)row_size)
+			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an inconsistent column count in CSV file (" << row_size << " observed, " << ncols << " previously), at line " << line_number << "." << EidosTerminate(nullptr);
 	}
 	
-	if (file_stream.bad())
-	{
-		if (!gEidosSuppressWarnings)
-			p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_readCSV): function readCSV() encountered stream errors while reading file at path " << file_path << "." << std::endl;
-		return gStaticEidosValueNULL;
-	}
+	// Row r, column c is at cells[first_row_cell + r * ncols + c]; the header row, if any, is skipped by advancing first_row_cell
+	int nrows = (ncols > 0) ? (int)(cells.size() / ncols) : 0;
+	size_t first_row_cell = 0;
 	
 	// Decide on the name for each column, using colNames and/or defaults
 	// If a header line is expected, this removes the first input line to act as the header
@@ -756,11 +920,12 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 	if ((colNames_value->Type() == EidosValueType::kValueLogical) && (colNames_value->Count() == 1) && (colNames_value->LogicalAtIndex(0, nullptr) == true))
 	{
 		// colNames == T means "a header row is present, use it"
-		if (rows.size() == 0)
+		if (nrows == 0)
 			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() found no header row, but colNames==T indicating that one is expected." << EidosTerminate(nullptr);
 		
-		columnNames = rows[0];
-		rows.erase(rows.begin());
+		columnNames.assign(cells.begin(), cells.begin() + ncols);	// constructs a std::string for each name
+		first_row_cell = ncols;
+		nrows--;
 	}
 	else if ((colNames_value->Type() == EidosValueType::kValueLogical) && (colNames_value->Count() == 1) && (colNames_value->LogicalAtIndex(0, nullptr) == false))
 	{
@@ -844,15 +1009,9 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 		has_null_coltype = true;
 	}
 	
-	// Resolve the type for columns that we're supposed to guess on
+	// Resolve the type for columns that we're supposed to guess on; this used to use <regex>, but matching by hand is much faster
 	if (has_null_coltype)
 	{
-		if (!Eidos_RegexWorks())
-			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_grep): This build of Eidos does not have a working <regex> library, due to a bug in the underlying C++ standard library provided by the system.  Calls to readCSV() that require guessing the type of a column (which uses regex) are therefore not allowed.  This problem might be resolved by updating your compiler or toolchain, or by upgrading to a more recent version of your operating system." << EidosTerminate(nullptr);
-	
-		std::regex integer_regex("[+-]?[0-9]+", std::regex_constants::ECMAScript);
-		std::regex float_regex(std::string("[+-]?[0-9]+(\\") + std::string(1, dec) + std::string("[0-9]*)?([eE][+-]?[0-9]+)?"), std::regex_constants::ECMAScript);
-		
 		for (int col_index = 0; col_index < ncols; ++col_index)
 		{
 			if (coltypes[col_index] == EidosValueType::kValueNULL)
@@ -862,11 +1021,11 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 				
 				if (coltype == EidosValueType::kValueLogical)
 				{
-					for (const auto &row : rows)
+					for (int row_index = 0; row_index < nrows; ++row_index)
 					{
-						const std::string &row_value = row[col_index];
+						const char *row_value = cells[first_row_cell + row_index * (size_t)ncols + col_index];
 						
-						if ((row_value != "T") && (row_value != "TRUE") && (row_value != "true") && (row_value != "F") && (row_value != "FALSE") && (row_value != "false"))
+						if (strcmp(row_value, "T") && strcmp(row_value, "TRUE") && strcmp(row_value, "true") && strcmp(row_value, "F") && strcmp(row_value, "FALSE") && strcmp(row_value, "false"))
 						{
 							coltype = EidosValueType::kValueInt;	// try integer next
 							break;
@@ -876,11 +1035,11 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 				
 				if (coltype == EidosValueType::kValueInt)
 				{
-					for (const auto &row : rows)
+					for (int row_index = 0; row_index < nrows; ++row_index)
 					{
-						const std::string &row_value = row[col_index];
+						const char *row_value = cells[first_row_cell + row_index * (size_t)ncols + col_index];
 						
-						if (!std::regex_match(row_value, integer_regex))
+						if (!_Eidos_CSVMatchesInteger(row_value))
 						{
 							coltype = EidosValueType::kValueFloat;	// try float next
 							break;
@@ -890,24 +1049,15 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 				
 				if (coltype == EidosValueType::kValueFloat)
 				{
-					for (const auto &row : rows)
+					for (int row_index = 0; row_index < nrows; ++row_index)
 					{
-						const std::string &row_value = row[col_index];
+						const char *row_value = cells[first_row_cell + row_index * (size_t)ncols + col_index];
 						
-						if (Eidos_string_equalsCaseInsensitive(row_value, "NAN") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "INF") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "INFINITY") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "-INF") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "-INFINITY") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "+INF") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "+INFINITY"))
+						if (_Eidos_CSVMatchesFloat(row_value, dec) || _Eidos_CSVIsSpecialFloat(row_value))
 							continue;
 						
-						if (!std::regex_match(row_value, float_regex))
-						{
-							coltype = EidosValueType::kValueString;	// string is the fallback
-							break;
-						}
+						coltype = EidosValueType::kValueString;	// string is the fallback
+						break;
 					}
 				}
 				
@@ -924,8 +1074,6 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 	objectElement->Release();	// objectElement is now retained by result_SP, so we can release it
 	
 	// Put the row data into the DataFrame, column by column
-	int nrows = (int)rows.size();
-	
 	for (int col_index = 0; col_index < ncols; ++col_index)
 	{
 		EidosValueType coltype = coltypes[col_index];
@@ -946,11 +1094,11 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			
 			for (int row_index = 0; row_index < nrows; ++row_index)
 			{
-				const std::string &row_value = rows[row_index][col_index];
+				const char *row_value = cells[first_row_cell + row_index * (size_t)ncols + col_index];
 				
-				if ((row_value == "T") || (row_value == "TRUE") || (row_value == "true"))
+				if (!strcmp(row_value, "T") || !strcmp(row_value, "TRUE") || !strcmp(row_value, "true"))
 					logical_column->set_logical_no_check(true, row_index);
-				else if ((row_value == "F") || (row_value == "FALSE") || (row_value == "false"))
+				else if (!strcmp(row_value, "F") || !strcmp(row_value, "FALSE") || !strcmp(row_value, "false"))
 					logical_column->set_logical_no_check(false, row_index);
 				else
 					EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): (internal error) unexpected value '" << row_value << "' in logical column." << EidosTerminate(nullptr);
@@ -963,14 +1111,13 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			
 			for (int row_index = 0; row_index < nrows; ++row_index)
 			{
-				const std::string &row_value = rows[row_index][col_index];
-				const char *row_cstr = row_value.c_str();
+				const char *row_value = cells[first_row_cell + row_index * (size_t)ncols + col_index];
 				char *last_used_char = nullptr;
 				
 				errno = 0;
-				int64_t int_value = strtoll(row_cstr, &last_used_char, 10);
+				int64_t int_value = strtoll(row_value, &last_used_char, 10);
 				
-				if (errno || (last_used_char == row_cstr))
+				if (errno || (last_used_char == row_value))
 					EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): value '" << row_value << "' could not be represented as an integer (strtoll conversion error)." << EidosTerminate(nullptr);
 				
 				integer_column->set_int_no_check(int_value, row_index);
@@ -983,37 +1130,26 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			
 			for (int row_index = 0; row_index < nrows; ++row_index)
 			{
-				std::string &row_value = rows[row_index][col_index];	// non-const here so we can fix the decimal separator
+				char *row_value = cells[first_row_cell + row_index * (size_t)ncols + col_index];	// non-const here so we can fix the decimal separator
 				double float_value;
 				
-				if (Eidos_string_equalsCaseInsensitive(row_value, "NAN"))
-					float_value = std::numeric_limits<double>::quiet_NaN();
-				else if (Eidos_string_equalsCaseInsensitive(row_value, "INF") ||
-					Eidos_string_equalsCaseInsensitive(row_value, "INFINITY") ||
-					Eidos_string_equalsCaseInsensitive(row_value, "+INF") ||
-					Eidos_string_equalsCaseInsensitive(row_value, "+INFINITY"))
-					float_value = std::numeric_limits<double>::infinity();
-				else if (Eidos_string_equalsCaseInsensitive(row_value, "-INF") ||
-					Eidos_string_equalsCaseInsensitive(row_value, "-INFINITY"))
-					float_value = -std::numeric_limits<double>::infinity();
-				else
+				if (!_Eidos_CSVSpecialFloat(row_value, &float_value))
 				{
 					if (dec != '.')
 					{
 						// We are in the C locale, so strtod() expects a '.' decimal separator.
-						size_t dec_pos = row_value.find(dec);
+						char *dec_ptr = strchr(row_value, dec);
 						
-						if (dec_pos != std::string::npos)
-							row_value.replace(dec_pos, 1, 1, '.');
+						if (dec_ptr)
+							*dec_ptr = '.';
 					}
 					
-					const char *row_cstr = row_value.c_str();
 					char *last_used_char = nullptr;
 					
 					errno = 0;
-					float_value = strtod(row_cstr, &last_used_char);
+					float_value = strtod(row_value, &last_used_char);
 					
-					if (errno || (last_used_char == row_cstr))
+					if (errno || (last_used_char == row_value))
 						EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): value '" << row_value << "' could not be represented as a float (strtod conversion error)." << EidosTerminate(nullptr);
 				}
 				
@@ -1027,7 +1163,7 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			
 			for (int row_index = 0; row_index < nrows; ++row_index)
 			{
-				const std::string &row_value = rows[row_index][col_index];
+				const char *row_value = cells[first_row_cell + row_index * (size_t)ncols + col_index];
 				
 				string_column->PushString(row_value);
 			}
@@ -60,10 +60,15 @@ void EidosTestElement::Print(std::ostream &p_ostream) const
 	p_ostream << Class()->ClassName();	// standard EidosObject behavior (not Dictionary behavior)
 }
 
+int64_t EidosTestElement::s_yolk_read_count_ = 0;
+
 EidosValue_SP EidosTestElement::GetProperty(EidosGlobalStringID p_property_id)
 {
 	if (p_property_id == gEidosID__yolk)				// ACCELERATED
+	{
+		s_yolk_read_count_++;
 		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(yolk_));
+	}
 	else if (p_property_id == gEidosID__increment)
 	{
 		EidosTestElement *inc_element = new EidosTestElement(yolk_ + 1);
@@ -80,6 +85,8 @@ EidosValue_SP EidosTestElement::GetProperty(EidosGlobalStringID p_property_id)
 
 EidosValue *EidosTestElement::GetProperty_Accelerated__yolk(EidosObject **p_elements, size_t p_elements_size)
 {
+	s_yolk_read_count_++;
+	
 	EidosValue_Int_vector *int_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector())->resize_no_initialize(p_elements_size);
 	
 	for (size_t element_index = 0; element_index < p_elements_size; ++element_index)
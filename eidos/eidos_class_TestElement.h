@@ -42,6 +42,8 @@ private:
 	int64_t yolk_;
 	
 public:
+	static int64_t s_yolk_read_count_;		// the number of _yolk property reads, so self-tests can check that the interpreter does not repeat them
+	
 	EidosTestElement(const EidosTestElement &p_original) = delete;	// no copy-construct
 	EidosTestElement& operator=(const EidosTestElement&) = delete;	// no copying
 	
@@ -23,6 +23,8 @@
 #include "eidos_interpreter.h"
 #include "eidos_rng.h"
 #include "eidos_beep.h"
+#include "eidos_simd.h"
+#include "eidos_parallel.h"
 
 #include <ctime>
 #include <chrono>
@@ -1542,8 +1544,7 @@ EidosValue_SP Eidos_ExecuteFunction_abs(const std::vector<EidosValue_SP> &p_argu
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-				float_result->set_float_no_check(fabs(float_data[value_index]), value_index);
+			Eidos_SIMD_Abs_F64(float_data, float_result->data(), x_count);
 		}
 	}
 	
@@ -1865,10 +1866,29 @@ EidosValue_SP Eidos_ExecuteFunction_exp(const std::vector<EidosValue_SP> &p_argu
 	else
 	{
 		EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
+		double *float_result_data = float_result->data();
 		result_SP = EidosValue_SP(float_result);
 		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			float_result->set_float_no_check(exp(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		// exp() and log() stay with the C library, rather than a vectorized approximation, so that results are identical
+		// across platforms and builds; reading the operand buffer directly avoids a virtual call per element
+		if (x_value->Type() == EidosValueType::kValueFloat)
+		{
+			const double *float_data = x_value->FloatVector()->data();
+			
+			Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [float_data, float_result_data](int, int64_t p_begin, int64_t p_end) {
+				for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					float_result_data[value_index] = exp(float_data[value_index]);
+			});
+		}
+		else
+		{
+			const int64_t *int_data = x_value->IntVector()->data();
+			
+			Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [int_data, float_result_data](int, int64_t p_begin, int64_t p_end) {
+				for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					float_result_data[value_index] = exp((double)int_data[value_index]);
+			});
+		}
 	}
 	
 	result_SP->CopyDimensionsFromValue(x_value);
@@ -2217,10 +2237,28 @@ EidosValue_SP Eidos_ExecuteFunction_log(const std::vector<EidosValue_SP> &p_argu
 	else
 	{
 		EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
+		double *float_result_data = float_result->data();
 		result_SP = EidosValue_SP(float_result);
 		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			float_result->set_float_no_check(log(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		// see exp() regarding the use of the C library here
+		if (x_value->Type() == EidosValueType::kValueFloat)
+		{
+			const double *float_data = x_value->FloatVector()->data();
+			
+			Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [float_data, float_result_data](int, int64_t p_begin, int64_t p_end) {
+				for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					float_result_data[value_index] = log(float_data[value_index]);
+			});
+		}
+		else
+		{
+			const int64_t *int_data = x_value->IntVector()->data();
+			
+			Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [int_data, float_result_data](int, int64_t p_begin, int64_t p_end) {
+				for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					float_result_data[value_index] = log((double)int_data[value_index]);
+			});
+		}
 	}
 	
 	result_SP->CopyDimensionsFromValue(x_value);
@@ -3908,10 +3946,29 @@ EidosValue_SP Eidos_ExecuteFunction_sqrt(const std::vector<EidosValue_SP> &p_arg
 	else
 	{
 		EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
+		double *float_result_data = float_result->data();
 		result_SP = EidosValue_SP(float_result);
 		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			float_result->set_float_no_check(sqrt(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		if (x_value->Type() == EidosValueType::kValueFloat)
+		{
+			const double *float_data = x_value->FloatVector()->data();
+			
+			Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [float_data, float_result_data](int, int64_t p_begin, int64_t p_end) {
+				Eidos_SIMD_Sqrt_F64(float_data + p_begin, float_result_data + p_begin, p_end - p_begin);
+			});
+		}
+		else
+		{
+			// convert into the result buffer and take the square root in place
+			const int64_t *int_data = x_value->IntVector()->data();
+			
+			Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [int_data, float_result_data](int, int64_t p_begin, int64_t p_end) {
+				for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					float_result_data[value_index] = (double)int_data[value_index];
+				
+				Eidos_SIMD_Sqrt_F64(float_result_data + p_begin, float_result_data + p_begin, p_end - p_begin);
+			});
+		}
 	}
 	
 	result_SP->CopyDimensionsFromValue(x_value);
@@ -3940,27 +3997,12 @@ EidosValue_SP Eidos_ExecuteFunction_sum(const std::vector<EidosValue_SP> &p_argu
 			const int64_t *int_data = x_value->IntVector()->data();
 			int64_t sum = 0;
 			double sum_d = 0;
-			bool fits_in_integer = true;
 			
 			// We do a tricky thing here.  We want to try to compute in integer, but switch to float if we overflow.
 			// If we do overflow, we want to minimize numerical error by accumulating in integer for as long as we
 			// can, and then throwing the integer accumulator over into the float accumulator only when it is about
-			// to overflow.  We perform both computations in parallel, and use integer for the result if we can.
-			for (int value_index = 0; value_index < x_count; ++value_index)
-			{
-				int64_t old_sum = sum;
-				int64_t temp = int_data[value_index];
-				
-				bool overflow = Eidos_add_overflow(old_sum, temp, &sum);
-				
-				// switch to float computation on overflow, and accumulate in the float sum just before overflow
-				if (overflow)
-				{
-					fits_in_integer = false;
-					sum_d += old_sum;
-					sum = temp;		// start integer accumulation again from 0 until it overflows again
-				}
-			}
+			// to overflow.  Eidos_SIMD_Sum_I64() does that, summing blocks that cannot overflow with vector adds.
+			bool fits_in_integer = !Eidos_SIMD_Sum_I64(int_data, x_count, &sum, &sum_d);
 			
 			sum_d += sum;			// add in whatever integer accumulation has not overflowed
 			
@@ -3992,10 +4034,7 @@ EidosValue_SP Eidos_ExecuteFunction_sum(const std::vector<EidosValue_SP> &p_argu
 	{
 		// EidosValue_Logical does not have a singleton subclass, so we can always use the fast API
 		const eidos_logical_t *logical_data = x_value->LogicalVector()->data();
-		int64_t sum = 0;
-		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			sum += logical_data[value_index];
+		int64_t sum = Eidos_SIMD_Sum_Logical(logical_data, x_count);
 		
 		result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(sum));
 	}
@@ -4392,24 +4431,8 @@ EidosValue_SP Eidos_ExecuteFunction_mean(const std::vector<EidosValue_SP> &p_arg
 			const int64_t *int_data = x_value->IntVector()->data();
 			int64_t sum_i = 0;
 			
-			// We do a tricky thing here.  We want to try to compute in integer, but switch to float if we overflow.
-			// If we do overflow, we want to minimize numerical error by accumulating in integer for as long as we
-			// can, and then throwing the integer accumulator over into the float accumulator only when it is about
-			// to overflow.  We perform both computations in parallel, and use integer for the result if we can.
-			for (int value_index = 0; value_index < x_count; ++value_index)
-			{
-				int64_t old_sum = sum_i;
-				int64_t temp = int_data[value_index];
-				
-				bool overflow = Eidos_add_overflow(old_sum, temp, &sum_i);
-				
-				// switch to float computation on overflow, and accumulate in the float sum just before overflow
-				if (overflow)
-				{
-					sum += old_sum;
-					sum_i = temp;		// start integer accumulation again from 0 until it overflows again
-				}
-			}
+			// See sum() for the integer-then-float accumulation strategy used here
+			Eidos_SIMD_Sum_I64(int_data, x_count, &sum_i, &sum);
 			
 			sum += sum_i;			// add in whatever integer accumulation has not overflowed
 		}
@@ -4435,10 +4458,7 @@ EidosValue_SP Eidos_ExecuteFunction_mean(const std::vector<EidosValue_SP> &p_arg
 		{
 			// Accelerated logical case
 			const eidos_logical_t *logical_data = x_value->LogicalVector()->data();
-			int64_t logical_sum = 0;
-			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-				logical_sum += logical_data[value_index];
+			int64_t logical_sum = Eidos_SIMD_Sum_Logical(logical_data, x_count);
 			
 			sum = logical_sum;	// avoid floating-point roundoff issues
 		}
@@ -4711,14 +4731,8 @@ EidosValue_SP Eidos_ExecuteFunction_pmax(const std::vector<EidosValue_SP> &p_arg
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-			{
-				// if there is a NAN the result is always NAN
-				if (std::isnan(float0_data[value_index]) || std::isnan(y_singleton_value))
-					float_result->set_float_no_check(std::numeric_limits<double>::quiet_NaN(), value_index);
-				else
-					float_result->set_float_no_check(std::max(float0_data[value_index], y_singleton_value), value_index);
-			}
+			// if there is a NAN the result is always NAN
+			Eidos_SIMD_PMaxMin_F64<true>(float0_data, &y_singleton_value, true, float_result->data(), x_count);
 		}
 		else if (x_type == EidosValueType::kValueString)
 		{
@@ -4761,14 +4775,8 @@ EidosValue_SP Eidos_ExecuteFunction_pmax(const std::vector<EidosValue_SP> &p_arg
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-			{
-				// if there is a NAN the result is always NAN
-				if (std::isnan(float0_data[value_index]) || std::isnan(float1_data[value_index]))
-					float_result->set_float_no_check(std::numeric_limits<double>::quiet_NaN(), value_index);
-				else
-					float_result->set_float_no_check(std::max(float0_data[value_index], float1_data[value_index]), value_index);
-			}
+			// if there is a NAN the result is always NAN
+			Eidos_SIMD_PMaxMin_F64<true>(float0_data, float1_data, false, float_result->data(), x_count);
 		}
 		else if (x_type == EidosValueType::kValueString)
 		{
@@ -4877,14 +4885,8 @@ EidosValue_SP Eidos_ExecuteFunction_pmin(const std::vector<EidosValue_SP> &p_arg
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-			{
-				// if there is a NAN the result is always NAN
-				if (std::isnan(float0_data[value_index]) || std::isnan(y_singleton_value))
-					float_result->set_float_no_check(std::numeric_limits<double>::quiet_NaN(), value_index);
-				else
-					float_result->set_float_no_check(std::min(float0_data[value_index], y_singleton_value), value_index);
-			}
+			// if there is a NAN the result is always NAN
+			Eidos_SIMD_PMaxMin_F64<false>(float0_data, &y_singleton_value, true, float_result->data(), x_count);
 		}
 		else if (x_type == EidosValueType::kValueString)
 		{
@@ -4927,14 +4929,8 @@ EidosValue_SP Eidos_ExecuteFunction_pmin(const std::vector<EidosValue_SP> &p_arg
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-			{
-				// if there is a NAN the result is always NAN
-				if (std::isnan(float0_data[value_index]) || std::isnan(float1_data[value_index]))
-					float_result->set_float_no_check(std::numeric_limits<double>::quiet_NaN(), value_index);
-				else
-					float_result->set_float_no_check(std::min(float0_data[value_index], float1_data[value_index]), value_index);
-			}
+			// if there is a NAN the result is always NAN
+			Eidos_SIMD_PMaxMin_F64<false>(float0_data, float1_data, false, float_result->data(), x_count);
 		}
 		else if (x_type == EidosValueType::kValueString)
 		{
@@ -5209,15 +5205,36 @@ EidosValue_SP Eidos_ExecuteFunction_sd(const std::vector<EidosValue_SP> &p_argum
 		double mean = 0;
 		double sd = 0;
 		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			mean += x_value->FloatAtIndex(value_index, nullptr);
-		
-		mean /= x_count;
-		
-		for (int value_index = 0; value_index < x_count; ++value_index)
+		// Both passes accumulate sequentially, as sum() does, so the result does not depend on the build's vector width
+		if (x_value->Type() == EidosValueType::kValueFloat)
 		{
-			double temp = (x_value->FloatAtIndex(value_index, nullptr) - mean);
-			sd += temp * temp;
+			const double *float_data = x_value->FloatVector()->data();
+			
+			for (int value_index = 0; value_index < x_count; ++value_index)
+				mean += float_data[value_index];
+			
+			mean /= x_count;
+			
+			for (int value_index = 0; value_index < x_count; ++value_index)
+			{
+				double temp = (float_data[value_index] - mean);
+				sd += temp * temp;
+			}
+		}
+		else
+		{
+			const int64_t *int_data = x_value->IntVector()->data();
+			
+			for (int value_index = 0; value_index < x_count; ++value_index)
+				mean += (double)int_data[value_index];
+			
+			mean /= x_count;
+			
+			for (int value_index = 0; value_index < x_count; ++value_index)
+			{
+				double temp = ((double)int_data[value_index] - mean);
+				sd += temp * temp;
+			}
 		}
 		
 		sd = sqrt(sd / (x_count - 1));
@@ -7247,22 +7264,58 @@ EidosValue_SP Eidos_ExecuteFunction_sample(const std::vector<EidosValue_SP> &p_a
 				// with replacement, we can just do a series of independent draws
 				result_SP = x_value->NewMatchingType();
 				EidosValue *result = result_SP.get();
+				int chunk_count = Eidos_ParallelChunkCount((sample_size > INT64_MAX / x_count) ? INT64_MAX : sample_size * x_count);
 				
-				for (int64_t samples_generated = 0; samples_generated < sample_size; ++samples_generated)
+				if (chunk_count > 1)
 				{
-					double rose = Eidos_rng_uniform(EIDOS_GSL_RNG) * weights_sum;
-					double rose_sum = 0.0;
-					int rose_index;
+					// each draw scans the weights, so large samples are worth doing in parallel; the random numbers are all drawn
+					// here first, from the one generator in the same order as the serial code below, so the result is identical
+					std::vector<double> roses(sample_size);
+					std::vector<int> rose_indices(sample_size);
+					
+					for (int64_t samples_generated = 0; samples_generated < sample_size; ++samples_generated)
+						roses[samples_generated] = Eidos_rng_uniform(EIDOS_GSL_RNG) * weights_sum;
 					
-					for (rose_index = 0; rose_index < x_count - 1; ++rose_index)	// -1 so roundoff gives the result to the last contender
+					Eidos_ParallelFor(sample_size, chunk_count, [&roses, &rose_indices, weights_float, x_count](int, int64_t p_begin, int64_t p_end) {
+						for (int64_t samples_generated = p_begin; samples_generated < p_end; ++samples_generated)
+						{
+							double rose = roses[samples_generated];
+							double rose_sum = 0.0;
+							int rose_index;
+							
+							for (rose_index = 0; rose_index < x_count - 1; ++rose_index)	// -1 so roundoff gives the result to the last contender
+							{
+								rose_sum += weights_float[rose_index];
+								
+								if (rose <= rose_sum)
+									break;
+							}
+							
+							rose_indices[samples_generated] = rose_index;
+						}
+					});
+					
+					for (int64_t samples_generated = 0; samples_generated < sample_size; ++samples_generated)
+						result->PushValueFromIndexOfEidosValue(rose_indices[samples_generated], *x_value, nullptr);
+				}
+				else
+				{
+					for (int64_t samples_generated = 0; samples_generated < sample_size; ++samples_generated)
 					{
-						rose_sum += weights_float[rose_index];
+						double rose = Eidos_rng_uniform(EIDOS_GSL_RNG) * weights_sum;
+						double rose_sum = 0.0;
+						int rose_index;
 						
-						if (rose <= rose_sum)
-							break;
+						for (rose_index = 0; rose_index < x_count - 1; ++rose_index)	// -1 so roundoff gives the result to the last contender
+						{
+							rose_sum += weights_float[rose_index];
+							
+							if (rose <= rose_sum)
+								break;
+						}
+						
+						result->PushValueFromIndexOfEidosValue(rose_index, *x_value, nullptr);
 					}
-					
-					result->PushValueFromIndexOfEidosValue(rose_index, *x_value, nullptr);
 				}
 			}
 			else
@@ -7348,22 +7401,57 @@ EidosValue_SP Eidos_ExecuteFunction_sample(const std::vector<EidosValue_SP> &p_a
 				// with replacement, we can just do a series of independent draws
 				result_SP = x_value->NewMatchingType();
 				EidosValue *result = result_SP.get();
+				int chunk_count = Eidos_ParallelChunkCount((sample_size > INT64_MAX / x_count) ? INT64_MAX : sample_size * x_count);
 				
-				for (int64_t samples_generated = 0; samples_generated < sample_size; ++samples_generated)
+				if (chunk_count > 1)
 				{
-					int64_t rose = (int64_t)ceil(Eidos_rng_uniform(EIDOS_GSL_RNG) * weights_sum);
-					int64_t rose_sum = 0;
-					int rose_index;
+					// see the float case above regarding this parallel path
+					std::vector<int64_t> roses(sample_size);
+					std::vector<int> rose_indices(sample_size);
+					
+					for (int64_t samples_generated = 0; samples_generated < sample_size; ++samples_generated)
+						roses[samples_generated] = (int64_t)ceil(Eidos_rng_uniform(EIDOS_GSL_RNG) * weights_sum);
 					
-					for (rose_index = 0; rose_index < x_count - 1; ++rose_index)	// -1 so roundoff gives the result to the last contender
+					Eidos_ParallelFor(sample_size, chunk_count, [&roses, &rose_indices, weights_int, x_count](int, int64_t p_begin, int64_t p_end) {
+						for (int64_t samples_generated = p_begin; samples_generated < p_end; ++samples_generated)
+						{
+							int64_t rose = roses[samples_generated];
+							int64_t rose_sum = 0;
+							int rose_index;
+							
+							for (rose_index = 0; rose_index < x_count - 1; ++rose_index)	// -1 so roundoff gives the result to the last contender
+							{
+								rose_sum += weights_int[rose_index];
+								
+								if (rose <= rose_sum)
+									break;
+							}
+							
+							rose_indices[samples_generated] = rose_index;
+						}
+					});
+					
+					for (int64_t samples_generated = 0; samples_generated < sample_size; ++samples_generated)
+						result->PushValueFromIndexOfEidosValue(rose_indices[samples_generated], *x_value, nullptr);
+				}
+				else
+				{
+					for (int64_t samples_generated = 0; samples_generated < sample_size; ++samples_generated)
 					{
-						rose_sum += weights_int[rose_index];
+						int64_t rose = (int64_t)ceil(Eidos_rng_uniform(EIDOS_GSL_RNG) * weights_sum);
+						int64_t rose_sum = 0;
+						int rose_index;
 						
-						if (rose <= rose_sum)
-							break;
+						for (rose_index = 0; rose_index < x_count - 1; ++rose_index)	// -1 so roundoff gives the result to the last contender
+						{
+							rose_sum += weights_int[rose_index];
+							
+							if (rose <= rose_sum)
+								break;
+						}
+						
+						result->PushValueFromIndexOfEidosValue(rose_index, *x_value, nullptr);
 					}
-					
-					result->PushValueFromIndexOfEidosValue(rose_index, *x_value, nullptr);
 				}
 			}
 			else
@@ -8539,13 +8627,17 @@ EidosValue_SP Eidos_ExecuteFunction_match(const std::vector<EidosValue_SP> &p_ar
 					EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_match): (internal error) function match() encountered a raise from its internal hash table (kValueInt); please report this." << EidosTerminate(nullptr);
 				}
 				
-				for (int value_index = 0; value_index < x_count; ++value_index)
-				{
-					auto find_iter = fromValueToIndex.find(int_data0[value_index]);
-					int64_t find_index = (find_iter == fromValueToIndex.end()) ? -1 : find_iter->second;
-					
-					int_result->set_int_no_check(find_index, value_index);
-				}
+				// lookups in the finished table are read-only, so large inputs can be looked up in parallel
+				int64_t *result_data = int_result->data();
+				
+				Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [&int_data0, &fromValueToIndex, result_data](int, int64_t p_begin, int64_t p_end) {
+					for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					{
+						auto find_iter = fromValueToIndex.find(int_data0[value_index]);
+						
+						result_data[value_index] = (find_iter == fromValueToIndex.end()) ? -1 : find_iter->second;
+					}
+				});
 			}
 			else
 			{
@@ -8585,13 +8677,17 @@ EidosValue_SP Eidos_ExecuteFunction_match(const std::vector<EidosValue_SP> &p_ar
 					EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_match): (internal error) function match() encountered a raise from its internal hash table (kValueFloat); please report this." << EidosTerminate(nullptr);
 				}
 				
-				for (int value_index = 0; value_index < x_count; ++value_index)
-				{
-					auto find_iter = fromValueToIndex.find(float_data0[value_index]);
-					int64_t find_index = (find_iter == fromValueToIndex.end()) ? -1 : find_iter->second;
-					
-					int_result->set_int_no_check(find_index, value_index);
-				}
+				// see above regarding parallel lookups
+				int64_t *result_data = int_result->data();
+				
+				Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [&float_data0, &fromValueToIndex, result_data](int, int64_t p_begin, int64_t p_end) {
+					for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					{
+						auto find_iter = fromValueToIndex.find(float_data0[value_index]);
+						
+						result_data[value_index] = (find_iter == fromValueToIndex.end()) ? -1 : find_iter->second;
+					}
+				});
 			}
 			else
 			{
@@ -8633,13 +8729,17 @@ EidosValue_SP Eidos_ExecuteFunction_match(const std::vector<EidosValue_SP> &p_ar
 					EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_match): (internal error) function match() encountered a raise from its internal hash table (kValueString); please report this." << EidosTerminate(nullptr);
 				}
 				
-				for (int value_index = 0; value_index < x_count; ++value_index)
-				{
-					auto find_iter = fromValueToIndex.find(string_vec0[value_index]);
-					int64_t find_index = (find_iter == fromValueToIndex.end()) ? -1 : find_iter->second;
-					
-					int_result->set_int_no_check(find_index, value_index);
-				}
+				// see above regarding parallel lookups
+				int64_t *result_data = int_result->data();
+				
+				Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [&string_vec0, &fromValueToIndex, result_data](int, int64_t p_begin, int64_t p_end) {
+					for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					{
+						auto find_iter = fromValueToIndex.find(string_vec0[value_index]);
+						
+						result_data[value_index] = (find_iter == fromValueToIndex.end()) ? -1 : find_iter->second;
+					}
+				});
 			}
 			else
 			{
@@ -8677,13 +8777,17 @@ EidosValue_SP Eidos_ExecuteFunction_match(const std::vector<EidosValue_SP> &p_ar
 					EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_match): (internal error) function match() encountered a raise from its internal hash table (kValueObject); please report this." << EidosTerminate(nullptr);
 				}
 				
-				for (int value_index = 0; value_index < x_count; ++value_index)
-				{
-					auto find_iter = fromValueToIndex.find(objelement_vec0[value_index]);
-					int64_t find_index = (find_iter == fromValueToIndex.end()) ? -1 : find_iter->second;
-					
-					int_result->set_int_no_check(find_index, value_index);
-				}
+				// see above regarding parallel lookups
+				int64_t *result_data = int_result->data();
+				
+				Eidos_ParallelFor(x_count, Eidos_ParallelChunkCount(x_count), [&objelement_vec0, &fromValueToIndex, result_data](int, int64_t p_begin, int64_t p_end) {
+					for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+					{
+						auto find_iter = fromValueToIndex.find(objelement_vec0[value_index]);
+						
+						result_data[value_index] = (find_iter == fromValueToIndex.end()) ? -1 : find_iter->second;
+					}
+				});
 			}
 			else
 			{
@@ -8985,13 +9089,41 @@ EidosValue_SP Eidos_ExecuteFunction_tabulate(const std::vector<EidosValue_SP> &p
 	
 	// do the tabulation
 	int64_t *result_data = int_result->data();
+	int chunk_count = Eidos_ParallelChunkCount(bin_count);
 	
-	for (int value_index = 0; value_index < bin_count; ++value_index)
+	if ((chunk_count > 1) && ((maxbin + 1) * chunk_count <= bin_count))
 	{
-		int64_t value = int_data[value_index];
+		// tabulate each chunk into its own set of bins, then add them up; we only do this when the bins are small compared
+		// to the data, since the per-chunk bins cost memory and time in proportion to maxbin
+		std::vector<std::vector<int64_t>> chunk_bins(chunk_count);
 		
-		if ((value >= 0) && (value <= maxbin))
-			result_data[value]++;
+		Eidos_ParallelFor(bin_count, chunk_count, [int_data, maxbin, &chunk_bins](int p_chunk, int64_t p_begin, int64_t p_end) {
+			std::vector<int64_t> &bins = chunk_bins[p_chunk];
+			
+			bins.resize(maxbin + 1, 0);
+			
+			for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+			{
+				int64_t value = int_data[value_index];
+				
+				if ((value >= 0) && (value <= maxbin))
+					bins[value]++;
+			}
+		});
+		
+		for (const std::vector<int64_t> &bins : chunk_bins)
+			for (int result_index = 0; result_index <= maxbin; ++result_index)
+				result_data[result_index] += bins[result_index];
+	}
+	else
+	{
+		for (int value_index = 0; value_index < bin_count; ++value_index)
+		{
+			int64_t value = int_data[value_index];
+			
+			if ((value >= 0) && (value <= maxbin))
+				result_data[value]++;
+		}
 	}
 	
 	return result_SP;
@@ -9018,9 +9150,42 @@ EidosValue_SP Eidos_ExecuteFunction_which(const std::vector<EidosValue_SP> &p_ar
 	EidosValue_Int_vector *int_result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector();
 	result_SP = EidosValue_SP(int_result);
 	
-	for (int value_index = 0; value_index < x_count; ++value_index)
-		if (logical_data[value_index])
-			int_result->push_int(value_index);
+	int chunk_count = Eidos_ParallelChunkCount(x_count);
+	
+	if (chunk_count > 1)
+	{
+		// count the T values in each chunk, then have each chunk write its indices starting at the total for the chunks before it
+		std::vector<int64_t> chunk_offsets(chunk_count + 1, 0);
+		
+		Eidos_ParallelFor(x_count, chunk_count, [logical_data, &chunk_offsets](int p_chunk, int64_t p_begin, int64_t p_end) {
+			int64_t true_count = 0;
+			
+			for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+				true_count += (logical_data[value_index] ? 1 : 0);
+			
+			chunk_offsets[p_chunk + 1] = true_count;
+		});
+		
+		for (int chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+			chunk_offsets[chunk_index + 1] += chunk_offsets[chunk_index];
+		
+		int_result->resize_no_initialize(chunk_offsets[chunk_count]);
+		int64_t *result_data = int_result->data();
+		
+		Eidos_ParallelFor(x_count, chunk_count, [logical_data, result_data, &chunk_offsets](int p_chunk, int64_t p_begin, int64_t p_end) {
+			int64_t *result_ptr = result_data + chunk_offsets[p_chunk];
+			
+			for (int64_t value_index = p_begin; value_index < p_end; ++value_index)
+				if (logical_data[value_index])
+					*(result_ptr++) = value_index;
+		});
+	}
+	else
+	{
+		for (int value_index = 0; value_index < x_count; ++value_index)
+			if (logical_data[value_index])
+				int_result->push_int(value_index);
+	}
 	
 	return result_SP;
 }
@@ -11011,6 +11176,9 @@ EidosValue_SP Eidos_ExecuteFunction_deleteFile(const std::vector<EidosValue_SP>
 	std::string base_path = filePath_value->StringAtIndex(0, nullptr);
 	std::string file_path = Eidos_ResolvedPath(base_path);
 	
+	// write out any appended data still buffered for this file first, so that a later append starts a fresh file (and gzip stream)
+	Eidos_FlushFile(file_path);
+	
 	result_SP = ((remove(file_path.c_str()) == 0) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
 	
 	return result_SP;
@@ -11122,7 +11290,10 @@ EidosValue_SP Eidos_ExecuteFunction_readFile(const std::vector<EidosValue_SP> &p
 	EidosValue *filePath_value = p_arguments[0].get();
 	std::string base_path = filePath_value->StringAtIndex(0, nullptr);
 	std::string file_path = Eidos_ResolvedPath(base_path);
-	
+
+	// write out any appended data still buffered for this file, so that we read what has been written so far
+	Eidos_FlushFile(file_path);
+
 	// read the contents in
 	std::ifstream file_stream(file_path.c_str());
 	
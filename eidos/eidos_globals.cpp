@@ -29,6 +29,7 @@
 #include "eidos_class_DataFrame.h"
 #include "eidos_class_Image.h"
 #include "eidos_class_TestElement.h"
+#include "lodepng.h"
 
 #include <stdlib.h>
 #include <execinfo.h>
@@ -88,8 +89,12 @@ static_assert(sizeof(char *) == 8, "SLiM must be built for 64-bit, not 32-bit.")
 
 
 bool eidos_do_memory_checks = true;
+bool gEidosScalarBytecode = true;
+bool gEidosVectorFusion = true;
+bool gEidosConstantFolding = true;
 
 EidosSymbolTable *gEidosConstantsSymbolTable = nullptr;
+uint32_t gEidosDefinedConstantsEpoch = 0;
 
 int gEidosFloatOutputPrecision = 6;
 
@@ -1565,36 +1570,99 @@ int Eidos_mkstemps_directory(char *p_pattern, int p_suffix_len)
 // This contains all unflushed append data for zip files written by writeFile(); see Eidos_FlushFiles() below
 std::unordered_map<std::string, std::string> gEidosBufferedZipAppendData;
 
-// This flushes the bytes in outstring to the file at file_path, with gzip append
-bool _Eidos_FlushZipBuffer(const std::string &file_path, const std::string &outstring)
+// This contains all unflushed append data for uncompressed files, which are buffered only when the caller asks for kNoFlush
+std::unordered_map<std::string, std::string> gEidosBufferedAppendData;
+
+// This flushes the bytes in outstring to the file at file_path, with a plain append
+bool _Eidos_FlushAppendBuffer(const std::string &file_path, const std::string &outstring)
 {
-	//std::cout << "_Eidos_FlushZipBuffer() called for " << file_path << std::endl;
+	std::ofstream file_stream(file_path.c_str(), std::ios_base::app | std::ios_base::out | std::ios_base::binary);
 	
-	gzFile gzf = z_gzopen(file_path.c_str(), "ab");
-	
-	if (!gzf)
+	if (!file_stream.is_open())
 		return false;
 	
-	const char *outcstr = outstring.c_str();
-	size_t outcstr_length = outstring.length();
+	file_stream.write(outstring.data(), (std::streamsize)outstring.length());
+	file_stream.close();
+	
+	return !file_stream.fail();
+}
+
+// This contains the deflate stream in progress for each zip file being appended to, so that successive flushes of buffered data
+// continue one gzip member, with its dictionary, rather than each starting a new member; see _Eidos_FlushZipBuffer() below
+static std::unordered_map<std::string, z_stream *> gEidosZipAppendStreams;
+
+static void _Eidos_DiscardZipStream(const std::string &file_path)
+{
+	auto stream_iter = gEidosZipAppendStreams.find(file_path);
+	
+	if (stream_iter != gEidosZipAppendStreams.end())
+	{
+		deflateEnd(stream_iter->second);
+		delete stream_iter->second;
+		gEidosZipAppendStreams.erase(stream_iter);
+	}
+}
+
+// This compresses the bytes in outstring onto the end of the file at file_path, continuing the deflate stream for that path if there
+// is one.  p_zlib_flush is Z_NO_FLUSH to just continue the stream, or Z_FINISH to write the gzip trailer and end the stream, leaving
+// a complete gzip member in the file (as is done for forced flushes and at exit); nothing here needs an fsync().
+bool _Eidos_FlushZipBuffer(const std::string &file_path, const std::string &outstring, int p_zlib_flush)
+{
+	//std::cout << "_Eidos_FlushZipBuffer() called for " << file_path << std::endl;
 	
-	// do the writing with zlib
-	bool success = false;
-	int retval = gzbuffer(gzf, 128*1024L);	// bigger buffer for greater speed
+	auto stream_iter = gEidosZipAppendStreams.find(file_path);
+	z_stream *zs;
 	
-	if (retval != -1)
+	if (stream_iter == gEidosZipAppendStreams.end())
 	{
-		retval = gzwrite(gzf, outcstr, (unsigned)outcstr_length);
+		zs = new z_stream;
+		zs->zalloc = Z_NULL;
+		zs->zfree = Z_NULL;
+		zs->opaque = Z_NULL;
 		
-		if ((retval != 0) || (outcstr_length == 0))	// writing 0 bytes returns 0, which is supposed to be an error code
+		// a windowBits of 15 + 16 requests a gzip header and trailer around the deflate data, as gzopen() would produce
+		if (deflateInit2(zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
 		{
-			retval = gzclose_w(gzf);
-			
-			if (retval == Z_OK)
-				success = true;
+			delete zs;
+			return false;
 		}
+		
+		gEidosZipAppendStreams.emplace(file_path, zs);
+	}
+	else
+	{
+		zs = stream_iter->second;
 	}
 	
+	std::string compressed;
+	unsigned char out_buffer[32 * 1024];
+	int retval;
+	
+	zs->next_in = (Bytef *)outstring.data();
+	zs->avail_in = (uInt)outstring.length();
+	
+	do
+	{
+		zs->next_out = out_buffer;
+		zs->avail_out = sizeof(out_buffer);
+		
+		retval = deflate(zs, p_zlib_flush);
+		
+		if (retval == Z_STREAM_ERROR)
+			break;
+		
+		compressed.append((const char *)out_buffer, sizeof(out_buffer) - zs->avail_out);
+	}
+	while (zs->avail_out == 0);
+	
+	bool success = ((retval != Z_STREAM_ERROR) && (zs->avail_in == 0));
+	
+	if ((p_zlib_flush == Z_FINISH) || !success)
+		_Eidos_DiscardZipStream(file_path);
+	
+	if (success && compressed.length())
+		success = _Eidos_FlushAppendBuffer(file_path, compressed);
+	
 	return success;
 }
 #endif
@@ -1605,26 +1673,77 @@ void Eidos_FlushFile(const std::string &p_file_path)
 #if EIDOS_BUFFER_ZIP_APPENDS
 	auto buffer_iter = gEidosBufferedZipAppendData.find(p_file_path);
 	
-	if (buffer_iter != gEidosBufferedZipAppendData.end())
+	if ((buffer_iter != gEidosBufferedZipAppendData.end()) || (gEidosZipAppendStreams.find(p_file_path) != gEidosZipAppendStreams.end()))
+	{
+		// finish the gzip member, so the file on disk is complete
+		bool result = _Eidos_FlushZipBuffer(p_file_path, (buffer_iter != gEidosBufferedZipAppendData.end()) ? buffer_iter->second : std::string(), Z_FINISH);
+		
+		if (!result)
+			EIDOS_TERMINATION << "ERROR (Eidos_FlushFile): Flush of gzip data to file " << p_file_path << " failed!" << EidosTerminate(nullptr);
+		
+		if (buffer_iter != gEidosBufferedZipAppendData.end())
+			gEidosBufferedZipAppendData.erase(buffer_iter);
+	}
+	
+	buffer_iter = gEidosBufferedAppendData.find(p_file_path);
+	
+	if (buffer_iter != gEidosBufferedAppendData.end())
 	{
-		bool result = _Eidos_FlushZipBuffer(buffer_iter->first, buffer_iter->second);
+		bool result = _Eidos_FlushAppendBuffer(buffer_iter->first, buffer_iter->second);
 		
 		if (!result)
-			EIDOS_TERMINATION << "ERROR (Eidos_FlushFile): Flush of gzip data to file " << buffer_iter->first << " failed!" << EidosTerminate(nullptr);
+			EIDOS_TERMINATION << "ERROR (Eidos_FlushFile): Flush of buffered data to file " << buffer_iter->first << " failed!" << EidosTerminate(nullptr);
 		
-		gEidosBufferedZipAppendData.erase(buffer_iter);
+		gEidosBufferedAppendData.erase(buffer_iter);
 	}
 #endif
 }
 
+// Callbacks registered by clients that buffer file data of their own; see Eidos_FlushFiles()
+static std::vector<std::pair<EidosFlushCallback, void *>> gEidosFlushCallbacks;
+
+void Eidos_RegisterFlushCallback(EidosFlushCallback p_callback, void *p_context)
+{
+	gEidosFlushCallbacks.emplace_back(p_callback, p_context);
+}
+
+void Eidos_UnregisterFlushCallback(EidosFlushCallback p_callback, void *p_context)
+{
+	auto callback_iter = std::find(gEidosFlushCallbacks.begin(), gEidosFlushCallbacks.end(), std::make_pair(p_callback, p_context));
+	
+	if (callback_iter != gEidosFlushCallbacks.end())
+		gEidosFlushCallbacks.erase(callback_iter);
+}
+
+void Eidos_BufferAppendData(const std::string &p_file_path, const std::string &p_data)
+{
+#if EIDOS_BUFFER_ZIP_APPENDS
+	gEidosBufferedAppendData[p_file_path].append(p_data);
+#else
+	std::ofstream file_stream(p_file_path.c_str(), std::ios_base::app | std::ios_base::out | std::ios_base::binary);
+	
+	if (file_stream.is_open())
+		file_stream.write(p_data.data(), p_data.size());
+	
+	if (!file_stream)
+		std::cerr << std::endl << "ERROR (Eidos_BufferAppendData): Write of data to file " << p_file_path << " failed!" << std::endl;
+#endif
+}
+
 // This flushes all outstanding buffered zip data to the appropriate files
 void Eidos_FlushFiles(void)
 {
+	// Let clients with buffered data of their own hand it to us first; we iterate over a copy in case a callback unregisters
+	std::vector<std::pair<EidosFlushCallback, void *>> callbacks(gEidosFlushCallbacks);
+	
+	for (auto &callback_pair : callbacks)
+		callback_pair.first(callback_pair.second);
+	
 #if EIDOS_BUFFER_ZIP_APPENDS
-	// Write out buffered data in gEidosBufferedZipAppendData to the appropriate files, using zlib's gzip append mode
+	// Write out buffered data in gEidosBufferedZipAppendData to the appropriate files, finishing their gzip members
 	for (auto &buffer_pair : gEidosBufferedZipAppendData)
 	{
-		bool result = _Eidos_FlushZipBuffer(buffer_pair.first, buffer_pair.second);
+		bool result = _Eidos_FlushZipBuffer(buffer_pair.first, buffer_pair.second, Z_FINISH);
 		
 		if (!result)
 		{
@@ -1634,6 +1753,31 @@ void Eidos_FlushFiles(void)
 	}
 	
 	gEidosBufferedZipAppendData.clear();
+	
+	// Finish any gzip members still in progress that had no buffered data left
+	std::vector<std::string> open_stream_paths;
+	
+	for (auto &stream_pair : gEidosZipAppendStreams)
+		open_stream_paths.emplace_back(stream_pair.first);
+	
+	for (const std::string &stream_path : open_stream_paths)
+	{
+		bool result = _Eidos_FlushZipBuffer(stream_path, std::string(), Z_FINISH);
+		
+		if (!result)
+			std::cerr << std::endl << "ERROR (Eidos_FlushFiles): Flush of gzip data to file " << stream_path << " failed!" << std::endl;
+	}
+	
+	// Write out buffered data in gEidosBufferedAppendData to the appropriate files, as plain appends
+	for (auto &buffer_pair : gEidosBufferedAppendData)
+	{
+		bool result = _Eidos_FlushAppendBuffer(buffer_pair.first, buffer_pair.second);
+		
+		if (!result)
+			std::cerr << std::endl << "ERROR (Eidos_FlushFiles): Flush of buffered data to file " << buffer_pair.first << " failed!" << std::endl;
+	}
+	
+	gEidosBufferedAppendData.clear();
 #endif
 }
 
@@ -1641,6 +1785,16 @@ void Eidos_WriteToFile(const std::string &p_file_path, std::vector<const std::st
 {
 	// note that we add a newline after the last line in all cases, so that appending new content to a file produces correct line breaks
 	
+#if EIDOS_BUFFER_ZIP_APPENDS
+	// a non-appending write replaces the file, so any data still buffered for appending to the old file is moot
+	if (!p_append)
+	{
+		gEidosBufferedZipAppendData.erase(p_file_path);
+		gEidosBufferedAppendData.erase(p_file_path);
+		_Eidos_DiscardZipStream(p_file_path);
+	}
+#endif
+	
 	if (p_compress)
 	{
 		// compression using zlib; very different from the no-compression case, unfortunately, because here we use C-based APIs
@@ -1662,11 +1816,14 @@ void Eidos_WriteToFile(const std::string &p_file_path, std::vector<const std::st
 				buffer.append(1, '\n');
 			}
 			
-			// if the buffer data exceeds a (somewhat arbitrary) 128K buffer maximum, write it out and remove the buffer entry
+			// if the buffer data exceeds a (somewhat arbitrary) 128K buffer maximum, compress it onto the file and remove the buffer entry,
+			// continuing the gzip member; a forced flush (as LogFile does for each flushInterval) instead finishes the member, so that the
+			// file on disk is a complete, valid gzip file even if the process is killed before it exits; the next append starts a new
+			// member, which gzip readers treat as a continuation of the same file
 			if ((p_flush_option == EidosFileFlush::kForceFlush) ||
 				((p_flush_option == EidosFileFlush::kDefaultFlush) && (buffer.length() > 1024L * 128L)))
 			{
-				bool result = _Eidos_FlushZipBuffer(p_file_path, buffer);
+				bool result = _Eidos_FlushZipBuffer(p_file_path, buffer, (p_flush_option == EidosFileFlush::kForceFlush) ? Z_FINISH : Z_NO_FLUSH);
 				gEidosBufferedZipAppendData.erase(buffer_iter);
 				
 				if (!result)
@@ -1715,20 +1872,321 @@ void Eidos_WriteToFile(const std::string &p_file_path, std::vector<const std::st
 	}
 	else
 	{
-		// no compression
+		// no compression; appends are buffered in memory only on request (kNoFlush), since the file is otherwise expected
+		// to be up to date after every write, and otherwise any previously buffered data is written out ahead of the new lines
+		#if EIDOS_BUFFER_ZIP_APPENDS
+		std::string buffered_data;
+		
+		if (p_append)
+		{
+			auto buffer_iter = gEidosBufferedAppendData.find(p_file_path);
+			
+			if (p_flush_option == EidosFileFlush::kNoFlush)
+			{
+				if (buffer_iter == gEidosBufferedAppendData.end())
+					buffer_iter = gEidosBufferedAppendData.emplace(p_file_path, "").first;
+				
+				std::string &buffer = buffer_iter->second;
+				
+				for (const std::string *content_line : p_contents)
+				{
+					buffer.append(*content_line);
+					buffer.append(1, '\n');
+				}
+				
+				return;
+			}
+			
+			if (buffer_iter != gEidosBufferedAppendData.end())
+			{
+				std::swap(buffered_data, buffer_iter->second);
+				gEidosBufferedAppendData.erase(buffer_iter);
+			}
+		}
+		#endif
+		
 		std::ofstream file_stream(p_file_path.c_str(), p_append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
 		
 		if (!file_stream.is_open())
 			EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not write to file at path " << p_file_path << "." << EidosTerminate(nullptr);
 		
+		#if EIDOS_BUFFER_ZIP_APPENDS
+		file_stream.write(buffered_data.data(), (std::streamsize)buffered_data.length());
+		#endif
+		
 		for (const std::string *content_line : p_contents)
-			file_stream << *content_line << std::endl;
+			file_stream << *content_line << '\n';
 		
 		if (file_stream.bad())
 			EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): encountered stream errors while writing to file at path " << p_file_path << "." << EidosTerminate(nullptr);
 	}
 }
 
+// BGZF is the blocked gzip variant used by htslib (bgzip, tabix, bcftools): a series of independent gzip members, each holding at
+// most 64 KB of compressed data and tagged with a "BC" extra field giving the block size, followed by an empty end-of-file block.
+// It is readable by any gzip decompressor, but unlike the output of gzwrite() it can also be indexed without recompression.
+static const size_t EIDOS_BGZF_BLOCK_MAX_SIZE = 0x10000;
+static const size_t EIDOS_BGZF_HEADER_SIZE = 18;
+static const size_t EIDOS_BGZF_FOOTER_SIZE = 8;
+
+static bool _Eidos_DeflateBGZFBlock(const char *p_data, size_t p_length, int p_level, unsigned char *p_block, size_t *p_block_size)
+{
+	z_stream zs;
+	
+	zs.zalloc = Z_NULL;
+	zs.zfree = Z_NULL;
+	zs.opaque = Z_NULL;
+	
+	if (deflateInit2(&zs, p_level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)		// negative window bits: raw deflate, we write the gzip wrapper
+		return false;
+	
+	zs.next_in = (Bytef *)p_data;
+	zs.avail_in = (uInt)p_length;
+	zs.next_out = p_block + EIDOS_BGZF_HEADER_SIZE;
+	zs.avail_out = (uInt)(EIDOS_BGZF_BLOCK_MAX_SIZE - EIDOS_BGZF_HEADER_SIZE - EIDOS_BGZF_FOOTER_SIZE);
+	
+	int retval = deflate(&zs, Z_FINISH);
+	size_t compressed_size = zs.total_out;
+	
+	deflateEnd(&zs);
+	
+	if (retval != Z_STREAM_END)
+		return false;		// did not fit in one block; the caller retries without compression
+	
+	size_t block_size = EIDOS_BGZF_HEADER_SIZE + compressed_size + EIDOS_BGZF_FOOTER_SIZE;
+	static const unsigned char header[16] = {0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0};
+	uLong crc = crc32(crc32(0L, Z_NULL, 0), (const Bytef *)p_data, (uInt)p_length);
+	unsigned char *footer = p_block + EIDOS_BGZF_HEADER_SIZE + compressed_size;
+	
+	memcpy(p_block, header, 16);
+	p_block[16] = (unsigned char)((block_size - 1) & 0xff);
+	p_block[17] = (unsigned char)((block_size - 1) >> 8);
+	
+	for (int byte_index = 0; byte_index < 4; ++byte_index)
+	{
+		footer[byte_index] = (unsigned char)((crc >> (8 * byte_index)) & 0xff);
+		footer[4 + byte_index] = (unsigned char)((p_length >> (8 * byte_index)) & 0xff);
+	}
+	
+	*p_block_size = block_size;
+	return true;
+}
+
+void Eidos_WriteBGZFFile(const std::string &p_file_path, const std::string &p_contents, bool p_append, std::vector<int64_t> *p_block_offsets)
+{
+	// note that unlike Eidos_WriteToFile(), p_contents is written exactly as given; the caller supplies any line endings
+	FILE *file = fopen(p_file_path.c_str(), p_append ? "ab" : "wb");
+	
+	if (!file)
+		EIDOS_TERMINATION << "#ERROR (Eidos_WriteBGZFFile): could not write to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+	
+	// if requested, we report the file offset of each data block, and then of the end-of-file block; block i holds the input
+	// bytes starting at i * EIDOS_BGZF_BLOCK_INPUT_SIZE, so these offsets are enough to seek to any position in p_contents
+	int64_t file_offset = 0;
+	
+	if (p_block_offsets)
+	{
+		p_block_offsets->clear();
+		
+		if (p_append && (fseek(file, 0, SEEK_END) == 0))
+			file_offset = (int64_t)ftell(file);
+	}
+	
+	std::vector<unsigned char> block(EIDOS_BGZF_BLOCK_MAX_SIZE);
+	const char *data = p_contents.data();
+	size_t remaining = p_contents.length();
+	bool failed = false;
+	
+	while (remaining > 0)
+	{
+		size_t chunk_length = std::min(remaining, EIDOS_BGZF_BLOCK_INPUT_SIZE);
+		size_t block_size;
+	
+		// incompressible input can expand slightly; level 0 (stored) always fits, given the input block size
+		if (!_Eidos_DeflateBGZFBlock(data, chunk_length, Z_DEFAULT_COMPRESSION, block.data(), &block_size) &&
+			!_Eidos_DeflateBGZFBlock(data, chunk_length, 0, block.data(), &block_size))
+		{
+			failed = true;
+			break;
+		}
+	
+		if (fwrite(block.data(), 1, block_size, file) != block_size)
+		{
+			failed = true;
+			break;
+		}
+	
+		if (p_block_offsets)
+			p_block_offsets->emplace_back(file_offset);
+		
+		file_offset += block_size;
+		data += chunk_length;
+		remaining -= chunk_length;
+	}
+	
+	// the empty end-of-file marker block; an appended file will contain several of these, which readers skip over
+	static const unsigned char eof_block[28] = {0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, 0x1b, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	
+	if (!failed && (fwrite(eof_block, 1, 28, file) != 28))
+		failed = true;
+	
+	if (p_block_offsets)
+		p_block_offsets->emplace_back(file_offset);
+	
+	if ((fclose(file) != 0) || failed)
+		EIDOS_TERMINATION << "#ERROR (Eidos_WriteBGZFFile): encountered errors while writing to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+}
+
+// Decompresses one gzip member starting at p_data, appending its contents to p_contents; the length of the member is returned in
+// p_member_length.  The deflate data is inflated by lodepng, since the bundled zlib has only the compression side.  lodepng does
+// not tell us where the deflate data ended, so the end of a member is found from its "BC" extra field if it is a BGZF block, and
+// otherwise by finding its trailer (the CRC-32 and length of what we just decompressed) followed by another member or the end.
+static bool _Eidos_GunzipMember(const unsigned char *p_data, size_t p_length, std::string &p_contents, size_t *p_member_length)
+{
+	if ((p_length < 18) || (p_data[0] != 0x1f) || (p_data[1] != 0x8b) || (p_data[2] != 8))
+		return false;
+	
+	unsigned char flags = p_data[3];
+	size_t header_length = 10;
+	size_t bgzf_block_size = 0;
+	
+	if (flags & 0x04)	// FEXTRA
+	{
+		size_t extra_length = p_data[10] | ((size_t)p_data[11] << 8);
+		size_t extra_pos = 12;
+		
+		header_length = 12 + extra_length;
+		if (header_length > p_length)
+			return false;
+		
+		while (extra_pos + 4 <= header_length)
+		{
+			size_t subfield_length = p_data[extra_pos + 2] | ((size_t)p_data[extra_pos + 3] << 8);
+			
+			if ((p_data[extra_pos] == 'B') && (p_data[extra_pos + 1] == 'C') && (subfield_length == 2) && (extra_pos + 6 <= header_length))
+				bgzf_block_size = (p_data[extra_pos + 4] | ((size_t)p_data[extra_pos + 5] << 8)) + 1;
+			
+			extra_pos += 4 + subfield_length;
+		}
+	}
+	if (flags & 0x08)	// FNAME
+	{
+		const void *name_end = memchr(p_data + header_length, 0, p_length - header_length);
+		
+		if (!name_end)
+			return false;
+		header_length = (const unsigned char *)name_end - p_data + 1;
+	}
+	if (flags & 0x10)	// FCOMMENT
+	{
+		const void *comment_end = memchr(p_data + header_length, 0, p_length - header_length);
+		
+		if (!comment_end)
+			return false;
+		header_length = (const unsigned char *)comment_end - p_data + 1;
+	}
+	if (flags & 0x02)	// FHCRC
+		header_length += 2;
+	
+	if (header_length + 8 > p_length)
+		return false;
+	
+	size_t deflate_length = ((bgzf_block_size >= header_length + 8) && (bgzf_block_size <= p_length)) ? (bgzf_block_size - header_length - 8) : (p_length - header_length);
+	unsigned char *inflated = nullptr;
+	size_t inflated_size = 0;
+	unsigned error = lodepng_inflate(&inflated, &inflated_size, p_data + header_length, deflate_length, &lodepng_default_decompress_settings);
+	
+	if (error)
+	{
+		free(inflated);
+		return false;
+	}
+	
+	uLong crc = crc32(crc32(0L, Z_NULL, 0), (const Bytef *)inflated, (uInt)inflated_size);
+	unsigned char trailer[8];
+	
+	for (int byte_index = 0; byte_index < 4; ++byte_index)
+	{
+		trailer[byte_index] = (unsigned char)((crc >> (8 * byte_index)) & 0xff);
+		trailer[4 + byte_index] = (unsigned char)((inflated_size >> (8 * byte_index)) & 0xff);
+	}
+	
+	if (inflated_size)
+		p_contents.append((const char *)inflated, inflated_size);
+	free(inflated);
+	
+	if (bgzf_block_size)
+	{
+		*p_member_length = bgzf_block_size;
+		return ((bgzf_block_size <= p_length) && (memcmp(p_data + bgzf_block_size - 8, trailer, 8) == 0));
+	}
+	
+	for (size_t trailer_pos = header_length; trailer_pos + 8 <= p_length; ++trailer_pos)
+	{
+		const unsigned char *found = (const unsigned char *)memchr(p_data + trailer_pos, trailer[0], p_length - 7 - trailer_pos);
+		
+		if (!found)
+			break;
+		
+		trailer_pos = found - p_data;
+		
+		if (memcmp(found, trailer, 8) == 0)
+		{
+			size_t member_end = trailer_pos + 8;
+			
+			if ((member_end == p_length) || ((member_end + 1 < p_length) && (p_data[member_end] == 0x1f) && (p_data[member_end + 1] == 0x8b)))
+			{
+				*p_member_length = member_end;
+				return true;
+			}
+		}
+	}
+	
+	return false;
+}
+
+bool Eidos_GunzipContents(const char *p_data, size_t p_length, std::string &p_contents)
+{
+	const unsigned char *data = (const unsigned char *)p_data;
+	
+	while (p_length > 0)
+	{
+		size_t member_length;
+		
+		if (!_Eidos_GunzipMember(data, p_length, p_contents, &member_length))
+			return false;
+		
+		data += member_length;
+		p_length -= member_length;
+	}
+	
+	return true;
+}
+
+bool Eidos_ReadFileContents(const std::string &p_file_path, std::string &p_contents)
+{
+	std::ifstream file_stream(p_file_path.c_str(), std::ios_base::in | std::ios_base::binary);
+	
+	p_contents.clear();
+	
+	if (!file_stream.is_open())
+		return false;
+	
+	file_stream.seekg(0, std::ios_base::end);
+	std::streamoff file_length = file_stream.tellg();
+	
+	if (file_length < 0)
+		return false;
+	
+	file_stream.seekg(0, std::ios_base::beg);
+	p_contents.resize((size_t)file_length);
+	
+	if (file_length > 0)
+		file_stream.read(&p_contents[0], file_length);
+	
+	return !file_stream.fail();
+}
+
 
 #pragma mark -
 #pragma mark Utility functions
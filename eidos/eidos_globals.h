@@ -164,6 +164,18 @@ extern bool gEidosSuppressWarnings;
 // Flags for various runtime checks that can be turned on or off; in SLiM, -x turns these off.
 extern bool eidos_do_memory_checks;
 
+// Compilation of scalar operator subtrees to bytecode in EidosASTNode::OptimizeTree(); on by default, -noBytecode turns it off.
+// This exists so that the tree-walking interpreter can be checked and timed on its own; results should never differ either way.
+extern bool gEidosScalarBytecode;
+
+// Fusion of element-wise vector subtrees in EidosASTNode::OptimizeTree(); on by default, -noFusion turns it off.  As with
+// gEidosScalarBytecode, this exists for checking and timing; results should never differ either way.
+extern bool gEidosVectorFusion;
+
+// Folding of pure subtrees over constants in EidosASTNode::OptimizeTree(); on by default, -noFolding turns it off.  As with
+// gEidosScalarBytecode, this exists for checking and timing; results should never differ either way.
+extern bool gEidosConstantFolding;
+
 // To leak-check slim, a few steps are recommended (BCH 5/1/2019):
 //
 //	- turn on Malloc Scribble so spurious pointers left over in deallocated blocks are not taken to be live references
@@ -429,20 +441,49 @@ int Eidos_mkstemps_directory(char *p_pattern, int p_suffix_len);
 
 #if EIDOS_BUFFER_ZIP_APPENDS	// implementation details for Eidos_FlushFiles(); for internal use only
 extern std::unordered_map<std::string, std::string> gEidosBufferedZipAppendData;	// filename -> text
-bool _Eidos_FlushZipBuffer(const std::string &p_file_path, const std::string &p_outstring);
+bool _Eidos_FlushZipBuffer(const std::string &p_file_path, const std::string &p_outstring, int p_zlib_flush);	// p_zlib_flush is a zlib flush constant such as Z_FINISH
+extern std::unordered_map<std::string, std::string> gEidosBufferedAppendData;		// filename -> text, for uncompressed appends with kNoFlush
+bool _Eidos_FlushAppendBuffer(const std::string &p_file_path, const std::string &p_outstring);
 #endif
 
 void Eidos_FlushFile(const std::string &p_file_path);
 void Eidos_FlushFiles(void);			// This should be called at the end of execution, or any other appropriate time, to flush buffered file append data
 
+// Clients that buffer file data of their own, such as SLiM's binary log files, register a callback that Eidos_FlushFiles()
+// calls first, so that their data is written out at exit along with ours; the callback must not raise, and should hand its
+// data to Eidos_BufferAppendData(), which buffers raw bytes for a plain append to the file at the next flush
+typedef void (*EidosFlushCallback)(void *p_context);
+void Eidos_RegisterFlushCallback(EidosFlushCallback p_callback, void *p_context);
+void Eidos_UnregisterFlushCallback(EidosFlushCallback p_callback, void *p_context);
+void Eidos_BufferAppendData(const std::string &p_file_path, const std::string &p_data);
+
 enum class EidosFileFlush {
-	kNoFlush = 0,		// no flush, no matter what
+	kNoFlush = 0,		// no flush, no matter what; uncompressed appends are then buffered in memory too
 	kDefaultFlush,		// flush if the buffer is over a threshold number of bytes
 	kForceFlush			// flush, no matter what; not recommended with compression
 };
 
 void Eidos_WriteToFile(const std::string &p_file_path, std::vector<const std::string *> p_contents, bool p_append, bool p_compress, EidosFileFlush p_flush_option);
 
+// Writing a complete file in BGZF format (blocked gzip, as produced by bgzip), which gzip tools can read and htslib tools can index.
+// If p_block_offsets is non-NULL, it receives the file offset of each block, followed by the offset of the end-of-file block; each
+// block holds EIDOS_BGZF_BLOCK_INPUT_SIZE bytes of p_contents (except the last), so callers can build their own indices from these.
+static const size_t EIDOS_BGZF_BLOCK_INPUT_SIZE = 0xff00;		// the same input block size as htslib, so stored blocks still fit
+void Eidos_WriteBGZFFile(const std::string &p_file_path, const std::string &p_contents, bool p_append, std::vector<int64_t> *p_block_offsets = nullptr);
+
+// Decompressing gzip data held in memory, such as a whole file or a range of BGZF blocks, appending the result to p_contents.  Any
+// number of concatenated gzip members may be given, as produced by bgzip or by appending with Eidos_WriteToFile().  Returns false
+// if the data is not valid gzip data; p_contents may then contain a partial result.
+bool Eidos_GunzipContents(const char *p_data, size_t p_length, std::string &p_contents);
+
+// Whether data read from a file, as by Eidos_ReadFileContents(), starts with the gzip magic number and should be decompressed
+inline bool Eidos_ContentsAreGzipped(const std::string &p_contents) { return (p_contents.length() >= 2) && ((unsigned char)p_contents[0] == 0x1F) && ((unsigned char)p_contents[1] == 0x8B); }
+
+// Reading a whole file into memory with a single large read, which is much faster than line-by-line reading with std::getline()
+// for large files.  Returns false if the file could not be opened or read; p_contents is replaced, not appended to.  Note that
+// gzip-compressed input is returned as-is (i.e., still compressed); callers that accept it can use Eidos_GunzipContents().
+bool Eidos_ReadFileContents(const std::string &p_file_path, std::string &p_contents);
+
 
 // *******************************************************************************************************************
 //
@@ -23,6 +23,7 @@
 #include "eidos_ast_node.h"
 #include "eidos_rng.h"
 #include "eidos_call_signature.h"
+#include "eidos_simd.h"
 
 #include <sstream>
 #include <stdexcept>
@@ -613,7 +614,9 @@ void EidosInterpreter::_ProcessSubsetAssignment(EidosValue_SP *p_base_value_ptr,
 		{
 			EIDOS_ASSERT_CHILD_COUNT_X(p_parent_node, "identifier", "EidosInterpreter::_ProcessSubsetAssignment", 0, parent_token);
 			
-			EidosValue_SP identifier_value_SP = global_symbols_->GetValueOrRaiseForASTNode(p_parent_node);
+			// We're going to modify the value in place, so we need one that isn't shared with anybody else; values are shared
+			// copy-on-write by the symbol table, and the copy happens here if necessary
+			EidosValue_SP identifier_value_SP = global_symbols_->GetValueForModificationOrRaiseForASTNode(p_parent_node);
 			EidosValue *identifier_value = identifier_value_SP.get();
 			
 			// OK, a little bit of trickiness here.  We've got the base value from the symbol table.  The problem is that it
@@ -1848,6 +1851,19 @@ EidosValue_SP EidosInterpreter::Evaluate_MemberRef(const EidosASTNode *p_node)
 	}
 #endif
 	
+	if (bailed_leaf_count_)
+	{
+		// this may be a property leaf that was already evaluated before a bail; see _EvaluateBailedNode().  Each is used only once
+		for (int leaf_index = 0; leaf_index < bailed_leaf_count_; ++leaf_index)
+		{
+			if (bailed_leaf_nodes_[leaf_index] == p_node)
+			{
+				bailed_leaf_nodes_[leaf_index] = nullptr;
+				return std::move(bailed_leaf_values_[leaf_index]);
+			}
+		}
+	}
+	
 	// When not logging execution, we can use a fast code path that assumes no logging
 	EidosToken *operator_token = p_node->token_;
 	EidosValue_SP result_SP;
@@ -1907,6 +1923,68 @@ EidosValue_SP EidosInterpreter::Evaluate_MemberRef(const EidosASTNode *p_node)
 	return result_SP;
 }
 
+// Fast-path support for the binary operators.  Two int/float singletons with no dimensions are by far the most common operands
+// in scalar code (callbacks, loop bodies), and can be handled without virtual calls, type promotion, or dimension bookkeeping;
+// the guard below is cheap enough that every binary operator just checks it up front.  Note that singletons can have dimensions,
+// since matrix() etc. can be given a singleton.  Integer overflow is not handled here; we fall through to the general case to raise.
+static inline __attribute__((always_inline)) bool Eidos_NumericSingletonOperands(const EidosValue *p_first, const EidosValue *p_second)
+{
+	if (!p_first->IsSingleton() || !p_second->IsSingleton() || p_first->IsArray() || p_second->IsArray())
+		return false;
+	
+	EidosValueType first_type = p_first->Type();
+	EidosValueType second_type = p_second->Type();
+	
+	return ((first_type == EidosValueType::kValueInt) || (first_type == EidosValueType::kValueFloat)) && ((second_type == EidosValueType::kValueInt) || (second_type == EidosValueType::kValueFloat));
+}
+
+static inline __attribute__((always_inline)) int64_t Eidos_IntSingletonValue(const EidosValue *p_value)
+{
+	return static_cast<const EidosValue_Int_singleton *>(p_value)->IntValue();
+}
+
+static inline __attribute__((always_inline)) double Eidos_NumericSingletonAsFloat(const EidosValue *p_value)
+{
+	if (p_value->Type() == EidosValueType::kValueInt)
+		return (double)static_cast<const EidosValue_Int_singleton *>(p_value)->IntValue();
+	
+	return static_cast<const EidosValue_Float_singleton *>(p_value)->FloatValue();
+}
+
+// Make a singleton result for the fast paths above.  An operand that we hold the only reference to (the result of a function call
+// or subset, typically) can't be seen by anybody else, so if it is of the right type we overwrite it and return it, saving an allocation.
+static inline __attribute__((always_inline)) EidosValue_SP Eidos_IntSingletonResult(EidosValue_SP &p_first, EidosValue_SP &p_second, int64_t p_value)
+{
+	if ((p_first->Type() == EidosValueType::kValueInt) && (p_first->UseCount() == 1) && !p_first->Invisible())
+	{
+		static_cast<EidosValue_Int_singleton *>(p_first.get())->SetValue(p_value);
+		return std::move(p_first);
+	}
+	if ((p_second->Type() == EidosValueType::kValueInt) && (p_second->UseCount() == 1) && !p_second->Invisible())
+	{
+		static_cast<EidosValue_Int_singleton *>(p_second.get())->SetValue(p_value);
+		return std::move(p_second);
+	}
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(p_value));
+}
+
+static inline __attribute__((always_inline)) EidosValue_SP Eidos_FloatSingletonResult(EidosValue_SP &p_first, EidosValue_SP &p_second, double p_value)
+{
+	if ((p_first->Type() == EidosValueType::kValueFloat) && (p_first->UseCount() == 1) && !p_first->Invisible())
+	{
+		static_cast<EidosValue_Float_singleton *>(p_first.get())->SetValue(p_value);
+		return std::move(p_first);
+	}
+	if ((p_second->Type() == EidosValueType::kValueFloat) && (p_second->UseCount() == 1) && !p_second->Invisible())
+	{
+		static_cast<EidosValue_Float_singleton *>(p_second.get())->SetValue(p_value);
+		return std::move(p_second);
+	}
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(p_value));
+}
+
 EidosValue_SP EidosInterpreter::Evaluate_Plus(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Plus()");
@@ -1935,6 +2013,28 @@ EidosValue_SP EidosInterpreter::Evaluate_Plus(const EidosASTNode *p_node)
 		EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 		EidosValueType second_child_type = second_child_value->Type();
 		
+		if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+		{
+			// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+			if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+			{
+				int64_t int_result;
+				
+				if (!Eidos_add_overflow(Eidos_IntSingletonValue(first_child_value.get()), Eidos_IntSingletonValue(second_child_value.get()), &int_result))
+					result_SP = Eidos_IntSingletonResult(first_child_value, second_child_value, int_result);
+			}
+			else
+			{
+				result_SP = Eidos_FloatSingletonResult(first_child_value, second_child_value, Eidos_NumericSingletonAsFloat(first_child_value.get()) + Eidos_NumericSingletonAsFloat(second_child_value.get()));
+			}
+			
+			if (result_SP)
+			{
+				EIDOS_EXIT_EXECUTION_LOG("Evaluate_Plus()");
+				return result_SP;
+			}
+		}
+		
 		int first_child_count = first_child_value->Count();
 		int second_child_count = second_child_value->Count();
 		
@@ -2302,6 +2402,28 @@ EidosValue_SP EidosInterpreter::Evaluate_Minus(const EidosASTNode *p_node)
 		EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 		EidosValueType second_child_type = second_child_value->Type();
 		
+		if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+		{
+			// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+			if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+			{
+				int64_t int_result;
+				
+				if (!Eidos_sub_overflow(Eidos_IntSingletonValue(first_child_value.get()), Eidos_IntSingletonValue(second_child_value.get()), &int_result))
+					result_SP = Eidos_IntSingletonResult(first_child_value, second_child_value, int_result);
+			}
+			else
+			{
+				result_SP = Eidos_FloatSingletonResult(first_child_value, second_child_value, Eidos_NumericSingletonAsFloat(first_child_value.get()) - Eidos_NumericSingletonAsFloat(second_child_value.get()));
+			}
+			
+			if (result_SP)
+			{
+				EIDOS_EXIT_EXECUTION_LOG("Evaluate_Minus()");
+				return result_SP;
+			}
+		}
+		
 		if ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): operand type " << second_child_type << " is not supported by the '-' operator." << EidosTerminate(operator_token);
 		
@@ -2525,6 +2647,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		EidosValue_SP result_SP = Eidos_FloatSingletonResult(first_child_value, second_child_value, fmod(Eidos_NumericSingletonAsFloat(first_child_value.get()), Eidos_NumericSingletonAsFloat(second_child_value.get())));
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_Mod()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -2665,6 +2796,30 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		EidosValue_SP result_SP;
+		
+		if ((first_child_value->Type() == EidosValueType::kValueInt) && (second_child_value->Type() == EidosValueType::kValueInt))
+		{
+			int64_t int_result;
+			
+			if (!Eidos_mul_overflow(Eidos_IntSingletonValue(first_child_value.get()), Eidos_IntSingletonValue(second_child_value.get()), &int_result))
+				result_SP = Eidos_IntSingletonResult(first_child_value, second_child_value, int_result);
+		}
+		else
+		{
+			result_SP = Eidos_FloatSingletonResult(first_child_value, second_child_value, Eidos_NumericSingletonAsFloat(first_child_value.get()) * Eidos_NumericSingletonAsFloat(second_child_value.get()));
+		}
+		
+		if (result_SP)
+		{
+			EIDOS_EXIT_EXECUTION_LOG("Evaluate_Mult()");
+			return result_SP;
+		}
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -2870,6 +3025,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		EidosValue_SP result_SP = Eidos_FloatSingletonResult(first_child_value, second_child_value, Eidos_NumericSingletonAsFloat(first_child_value.get()) / Eidos_NumericSingletonAsFloat(second_child_value.get()));
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_Div()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -3050,6 +3214,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		EidosValue_SP result_SP = Eidos_FloatSingletonResult(first_child_value, second_child_value, pow(Eidos_NumericSingletonAsFloat(first_child_value.get()), Eidos_NumericSingletonAsFloat(second_child_value.get())));
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_Exp()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -3721,6 +3894,16 @@ EidosValue_SP EidosInterpreter::Evaluate_Assign(const EidosASTNode *p_node)
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Assign): identifier '" << lvalue_node->token_->token_string_ << "' cannot be redefined because it is a constant." << EidosTerminate(p_node->token_);
 		
 		EidosValue *lvalue = lvalue_SP.get();
+		
+		// vectors are shared copy-on-write between symbols, so if anybody else holds this value (beyond the symbol table and
+		// lvalue_SP), we need to get a private copy from the symbol table before we modify it in place below
+		if (!lvalue->IsSingleton() && (lvalue->UseCount() > 2))
+		{
+			lvalue_SP.reset();
+			lvalue_SP = global_symbols_->GetValueForModificationOrRaiseForASTNode(lvalue_node);
+			lvalue = lvalue_SP.get();
+		}
+		
 		int lvalue_count = lvalue->Count();
 		
 		// somewhat unusually, we will now modify the lvalue in place, for speed; this is legal since we just got
@@ -4007,6 +4190,61 @@ EidosValue_SP EidosInterpreter::Evaluate_Assign_R(const EidosASTNode *p_node)
 	EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Assign_R): the R-style assignment operator <- is not legal in Eidos.  For assignment, use operator =, like \"a = b;\".  For comparison to a negative quantity, use spaces to fix the tokenization, like \"a < -b;\"." << EidosTerminate(operator_token);
 }
 
+// Handles the comparison operators for int-to-int and float-to-float operands, where at least one operand is a
+// non-singleton vector, with the kernels in eidos_simd.h.  Returns nullptr in all other cases, which the operators
+// handle with their general loops; the caller has already checked matrix/array conformability.
+template <EidosComparisonOperator OP>
+static EidosValue_Logical_SP _NumericVectorComparison(EidosValue *p_first_value, EidosValue *p_second_value)
+{
+	EidosValueType value_type = p_first_value->Type();
+	
+	if ((value_type != p_second_value->Type()) || ((value_type != EidosValueType::kValueInt) && (value_type != EidosValueType::kValueFloat)))
+		return EidosValue_Logical_SP();
+	
+	int first_count = p_first_value->Count();
+	int second_count = p_second_value->Count();
+	bool first_is_singleton = (first_count == 1);
+	bool second_is_singleton = (second_count == 1);
+	int result_count;
+	
+	if ((first_count == second_count) && !first_is_singleton)
+		result_count = first_count;
+	else if (first_is_singleton && !second_is_singleton)
+		result_count = second_count;
+	else if (second_is_singleton && !first_is_singleton)
+		result_count = first_count;
+	else
+		return EidosValue_Logical_SP();
+	
+	if (result_count == 0)
+		return EidosValue_Logical_SP();
+	
+	EidosValue_Logical_SP result_SP = EidosValue_Logical_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Logical());
+	eidos_logical_t *result_data = result_SP->resize_no_initialize(result_count)->data();
+	
+	if (value_type == EidosValueType::kValueFloat)
+	{
+		// singletons may be EidosValue_Float_singleton, which has no buffer, so we point at a local copy
+		double first_singleton_value = (first_is_singleton ? p_first_value->FloatAtIndex(0, nullptr) : 0.0);
+		double second_singleton_value = (second_is_singleton ? p_second_value->FloatAtIndex(0, nullptr) : 0.0);
+		const double *first_data = (first_is_singleton ? &first_singleton_value : p_first_value->FloatVector()->data());
+		const double *second_data = (second_is_singleton ? &second_singleton_value : p_second_value->FloatVector()->data());
+		
+		Eidos_SIMD_Compare_F64<OP>(first_data, first_is_singleton, second_data, second_is_singleton, result_data, result_count);
+	}
+	else
+	{
+		int64_t first_singleton_value = (first_is_singleton ? p_first_value->IntAtIndex(0, nullptr) : 0);
+		int64_t second_singleton_value = (second_is_singleton ? p_second_value->IntAtIndex(0, nullptr) : 0);
+		const int64_t *first_data = (first_is_singleton ? &first_singleton_value : p_first_value->IntVector()->data());
+		const int64_t *second_data = (second_is_singleton ? &second_singleton_value : p_second_value->IntVector()->data());
+		
+		Eidos_SIMD_Compare_I64<OP>(first_data, first_is_singleton, second_data, second_is_singleton, result_data, result_count);
+	}
+	
+	return result_SP;
+}
+
 EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Eq()");
@@ -4018,6 +4256,22 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		bool comparison;
+		
+		if ((first_child_value->Type() == EidosValueType::kValueInt) && (second_child_value->Type() == EidosValueType::kValueInt))
+			comparison = (Eidos_IntSingletonValue(first_child_value.get()) == Eidos_IntSingletonValue(second_child_value.get()));
+		else
+			comparison = (Eidos_NumericSingletonAsFloat(first_child_value.get()) == Eidos_NumericSingletonAsFloat(second_child_value.get()));
+		
+		result_SP = (comparison ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_Eq()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -4039,7 +4293,13 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Eq): non-conformable array operands to the '==' operator." << EidosTerminate(operator_token);
 		
-		if (first_child_count == second_child_count)
+		EidosValue_Logical_SP vector_result_SP = _NumericVectorComparison<EidosComparisonOperator::kEqual>(first_child_value.get(), second_child_value.get());
+		
+		if (vector_result_SP)
+		{
+			result_SP = std::move(vector_result_SP);
+		}
+		else if (first_child_count == second_child_count)
 		{
 			if (first_child_count == 1)
 			{
@@ -4255,6 +4515,22 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		bool comparison;
+		
+		if ((first_child_value->Type() == EidosValueType::kValueInt) && (second_child_value->Type() == EidosValueType::kValueInt))
+			comparison = (Eidos_IntSingletonValue(first_child_value.get()) < Eidos_IntSingletonValue(second_child_value.get()));
+		else
+			comparison = (Eidos_NumericSingletonAsFloat(first_child_value.get()) < Eidos_NumericSingletonAsFloat(second_child_value.get()));
+		
+		result_SP = (comparison ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_Lt()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -4278,7 +4554,13 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Lt): non-conformable array operands to the '<' operator." << EidosTerminate(operator_token);
 		
-		if (first_child_count == second_child_count)
+		EidosValue_Logical_SP vector_result_SP = _NumericVectorComparison<EidosComparisonOperator::kLess>(first_child_value.get(), second_child_value.get());
+		
+		if (vector_result_SP)
+		{
+			result_SP = std::move(vector_result_SP);
+		}
+		else if (first_child_count == second_child_count)
 		{
 			if (first_child_count == 1)
 			{
@@ -4402,6 +4684,22 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		bool comparison;
+		
+		if ((first_child_value->Type() == EidosValueType::kValueInt) && (second_child_value->Type() == EidosValueType::kValueInt))
+			comparison = (Eidos_IntSingletonValue(first_child_value.get()) <= Eidos_IntSingletonValue(second_child_value.get()));
+		else
+			comparison = (Eidos_NumericSingletonAsFloat(first_child_value.get()) <= Eidos_NumericSingletonAsFloat(second_child_value.get()));
+		
+		result_SP = (comparison ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_LtEq()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -4425,7 +4723,13 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_LtEq): non-conformable array operands to the '<=' operator." << EidosTerminate(operator_token);
 		
-		if (first_child_count == second_child_count)
+		EidosValue_Logical_SP vector_result_SP = _NumericVectorComparison<EidosComparisonOperator::kLessOrEqual>(first_child_value.get(), second_child_value.get());
+		
+		if (vector_result_SP)
+		{
+			result_SP = std::move(vector_result_SP);
+		}
+		else if (first_child_count == second_child_count)
 		{
 			if (first_child_count == 1)
 			{
@@ -4549,6 +4853,22 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		bool comparison;
+		
+		if ((first_child_value->Type() == EidosValueType::kValueInt) && (second_child_value->Type() == EidosValueType::kValueInt))
+			comparison = (Eidos_IntSingletonValue(first_child_value.get()) > Eidos_IntSingletonValue(second_child_value.get()));
+		else
+			comparison = (Eidos_NumericSingletonAsFloat(first_child_value.get()) > Eidos_NumericSingletonAsFloat(second_child_value.get()));
+		
+		result_SP = (comparison ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_Gt()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -4572,7 +4892,13 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Gt): non-conformable array operands to the '>' operator." << EidosTerminate(operator_token);
 		
-		if (first_child_count == second_child_count)
+		EidosValue_Logical_SP vector_result_SP = _NumericVectorComparison<EidosComparisonOperator::kGreater>(first_child_value.get(), second_child_value.get());
+		
+		if (vector_result_SP)
+		{
+			result_SP = std::move(vector_result_SP);
+		}
+		else if (first_child_count == second_child_count)
 		{
 			if (first_child_count == 1)
 			{
@@ -4696,6 +5022,22 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		bool comparison;
+		
+		if ((first_child_value->Type() == EidosValueType::kValueInt) && (second_child_value->Type() == EidosValueType::kValueInt))
+			comparison = (Eidos_IntSingletonValue(first_child_value.get()) >= Eidos_IntSingletonValue(second_child_value.get()));
+		else
+			comparison = (Eidos_NumericSingletonAsFloat(first_child_value.get()) >= Eidos_NumericSingletonAsFloat(second_child_value.get()));
+		
+		result_SP = (comparison ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_GtEq()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -4719,7 +5061,13 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_GtEq): non-conformable array operands to the '>=' operator." << EidosTerminate(operator_token);
 		
-		if (first_child_count == second_child_count)
+		EidosValue_Logical_SP vector_result_SP = _NumericVectorComparison<EidosComparisonOperator::kGreaterOrEqual>(first_child_value.get(), second_child_value.get());
+		
+		if (vector_result_SP)
+		{
+			result_SP = std::move(vector_result_SP);
+		}
+		else if (first_child_count == second_child_count)
 		{
 			if (first_child_count == 1)
 			{
@@ -4843,6 +5191,22 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
 	
+	if (Eidos_NumericSingletonOperands(first_child_value.get(), second_child_value.get()))
+	{
+		// fast path for int/float singletons; see Eidos_NumericSingletonOperands()
+		bool comparison;
+		
+		if ((first_child_value->Type() == EidosValueType::kValueInt) && (second_child_value->Type() == EidosValueType::kValueInt))
+			comparison = (Eidos_IntSingletonValue(first_child_value.get()) != Eidos_IntSingletonValue(second_child_value.get()));
+		else
+			comparison = (Eidos_NumericSingletonAsFloat(first_child_value.get()) != Eidos_NumericSingletonAsFloat(second_child_value.get()));
+		
+		result_SP = (comparison ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_NotEq()");
+		return result_SP;
+	}
+	
 	EidosValueType first_child_type = first_child_value->Type();
 	EidosValueType second_child_type = second_child_value->Type();
 	
@@ -4864,7 +5228,13 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_NotEq): non-conformable array operands to the '!=' operator." << EidosTerminate(operator_token);
 		
-		if (first_child_count == second_child_count)
+		EidosValue_Logical_SP vector_result_SP = _NumericVectorComparison<EidosComparisonOperator::kNotEqual>(first_child_value.get(), second_child_value.get());
+		
+		if (vector_result_SP)
+		{
+			result_SP = std::move(vector_result_SP);
+		}
+		else if (first_child_count == second_child_count)
 		{
 			if (first_child_count == 1)
 			{
@@ -5175,6 +5545,669 @@ EidosValue_SP EidosInterpreter::NumericValueForString(const std::string &p_numbe
 	}
 }
 
+// Load a singleton int/float/logical value into a bytecode register; anything else causes a bail to the tree-walking evaluator
+static inline __attribute__((always_inline)) bool Eidos_LoadBytecodeRegister(EidosValue *p_value, EidosBytecodeRegister *p_register)
+{
+	if (p_value->DimensionCount() != 1)
+		return false;
+	
+	switch (p_value->Type())
+	{
+		case EidosValueType::kValueInt:
+			if (p_value->IsSingleton())
+				p_register->int_ = ((EidosValue_Int_singleton *)p_value)->IntValue();
+			else if (p_value->Count() == 1)
+				p_register->int_ = p_value->IntAtIndex(0, nullptr);
+			else
+				return false;
+			p_register->type_ = EIDOS_BYTECODE_INT;
+			return true;
+		case EidosValueType::kValueFloat:
+			if (p_value->IsSingleton())
+				p_register->float_ = ((EidosValue_Float_singleton *)p_value)->FloatValue();
+			else if (p_value->Count() == 1)
+				p_register->float_ = p_value->FloatAtIndex(0, nullptr);
+			else
+				return false;
+			p_register->type_ = EIDOS_BYTECODE_FLOAT;
+			return true;
+		case EidosValueType::kValueLogical:
+			if (p_value->Count() != 1)
+				return false;
+			p_register->logical_ = p_value->LogicalAtIndex(0, nullptr);
+			p_register->type_ = EIDOS_BYTECODE_LOGICAL;
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Register conversions following EidosTypeForPromotion(); logical converts to 0/1
+static inline __attribute__((always_inline)) int64_t Eidos_BytecodeRegisterInt(const EidosBytecodeRegister *p_register)
+{
+	return (p_register->type_ == EIDOS_BYTECODE_INT) ? p_register->int_ : (p_register->logical_ ? 1 : 0);
+}
+
+static inline __attribute__((always_inline)) double Eidos_BytecodeRegisterFloat(const EidosBytecodeRegister *p_register)
+{
+	if (p_register->type_ == EIDOS_BYTECODE_FLOAT)
+		return p_register->float_;
+	if (p_register->type_ == EIDOS_BYTECODE_INT)
+		return (double)p_register->int_;
+	return (p_register->logical_ ? 1.0 : 0.0);
+}
+
+// Comparison of two registers with promotion: float if either is float, otherwise integer (which handles logical correctly too)
+#define EIDOS_BYTECODE_COMPARE(op)	\
+	if ((reg->type_ == EIDOS_BYTECODE_FLOAT) || (reg[1].type_ == EIDOS_BYTECODE_FLOAT))	\
+		reg->logical_ = (Eidos_BytecodeRegisterFloat(reg) op Eidos_BytecodeRegisterFloat(reg + 1));	\
+	else	\
+		reg->logical_ = (Eidos_BytecodeRegisterInt(reg) op Eidos_BytecodeRegisterInt(reg + 1));	\
+	reg->type_ = EIDOS_BYTECODE_LOGICAL;
+
+EidosValue_SP EidosInterpreter::_EvaluateBailedNode(const EidosASTNode *p_node, EidosEvaluationMethod p_fallback_evaluator, const EidosASTNode **p_leaf_nodes, EidosValue_SP *p_leaf_values, int p_leaf_count)
+{
+	// Evaluate p_node with the evaluator that a bailing Evaluate_ScalarBytecode() or Evaluate_Fused() wraps, handing it the property
+	// leaves already evaluated (a nullptr node is skipped); Evaluate_MemberRef() picks them up by node, so that the only leaves the
+	// fallback evaluates are those the caller did not get to.  The fallback of a fused node is often scalar bytecode, which may bail
+	// in turn, so any leaves handed down by an enclosing bail are saved and restored around the call, even if it raises.
+	if (p_leaf_count == 0)
+		return (this->*p_fallback_evaluator)(p_node);
+	
+	const EidosASTNode **saved_leaf_nodes = bailed_leaf_nodes_;
+	EidosValue_SP *saved_leaf_values = bailed_leaf_values_;
+	int saved_leaf_count = bailed_leaf_count_;
+	EidosValue_SP result_SP;
+	
+	bailed_leaf_nodes_ = p_leaf_nodes;
+	bailed_leaf_values_ = p_leaf_values;
+	bailed_leaf_count_ = p_leaf_count;
+	
+	try {
+		result_SP = (this->*p_fallback_evaluator)(p_node);
+	} catch (...) {
+		bailed_leaf_nodes_ = saved_leaf_nodes;
+		bailed_leaf_values_ = saved_leaf_values;
+		bailed_leaf_count_ = saved_leaf_count;
+		throw;
+	}
+	
+	bailed_leaf_nodes_ = saved_leaf_nodes;
+	bailed_leaf_values_ = saved_leaf_values;
+	bailed_leaf_count_ = saved_leaf_count;
+	
+	return result_SP;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"	// every register is written by a load or an operator before it is read, but the compiler can't see that
+EidosValue_SP EidosInterpreter::Evaluate_ScalarBytecode(const EidosASTNode *p_node)
+{
+	// Run the bytecode compiled for p_node by EidosASTNode::_OptimizeBytecode().  The compiler guarantees that every operand register
+	// holds a type its operator accepts (checked against accept_mask_ as each result is produced), so the operators below cannot
+	// raise; all that can go wrong is a non-scalar leaf or an integer overflow, and both of those bail to the tree-walking evaluator.
+	// Leaves are evaluated in the same order as the tree-walking evaluator would, so errors raised by leaves themselves are identical;
+	// on a bail, property leaves evaluated so far are handed to the tree-walking evaluator rather than evaluated again.
+	EidosScalarBytecode *bytecode = p_node->scalar_bytecode_;
+	
+#if DEBUG || defined(EIDOS_GUI)
+	// the execution log is produced by the tree-walking evaluators, so use them while logging
+	if (logging_execution_)
+		return (this->*(bytecode->fallback_evaluator_))(p_node);
+#endif
+	
+	EidosBytecodeRegister registers[EIDOS_BYTECODE_MAX_REGISTERS];
+	const EidosASTNode *property_nodes[EIDOS_BYTECODE_MAX_PROPERTY_LEAVES];
+	EidosValue_SP property_values[EIDOS_BYTECODE_MAX_PROPERTY_LEAVES];
+	int property_count = 0;
+	
+	for (const EidosBytecodeInstruction &instruction : bytecode->instructions_)
+	{
+		EidosBytecodeRegister *reg = registers + instruction.reg_;
+		
+		switch (instruction.op_)
+		{
+			case EidosBytecodeOp::kLoadConstant:
+				*reg = instruction.constant_;
+				break;
+			case EidosBytecodeOp::kLoadIdentifier:
+			{
+				// this is the same lookup as Evaluate_Identifier(), so that an undefined identifier raises the same error
+				EidosValue_SP identifier_value = global_symbols_->GetValueOrRaiseForASTNode(instruction.node_);
+				
+				if (!Eidos_LoadBytecodeRegister(identifier_value.get(), reg))
+					goto bail;
+				break;
+			}
+			case EidosBytecodeOp::kLoadProperty:
+			{
+				// the value is kept until we return, so that if we bail, the tree-walking evaluator can use it
+				EidosValue_SP &property_value = property_values[property_count];
+				
+				property_value = FastEvaluateNode(instruction.node_);
+				property_nodes[property_count++] = instruction.node_;
+				
+				if (!Eidos_LoadBytecodeRegister(property_value.get(), reg))
+					goto bail;
+				break;
+			}
+			case EidosBytecodeOp::kUnaryPlus:
+				break;
+			case EidosBytecodeOp::kUnaryMinus:
+				if (reg->type_ == EIDOS_BYTECODE_INT)
+				{
+					if (Eidos_sub_overflow((int64_t)0, reg->int_, &reg->int_))
+						goto bail;
+				}
+				else
+					reg->float_ = -reg->float_;
+				break;
+			case EidosBytecodeOp::kPlus:
+				if ((reg->type_ == EIDOS_BYTECODE_INT) && (reg[1].type_ == EIDOS_BYTECODE_INT))
+				{
+					if (Eidos_add_overflow(reg->int_, reg[1].int_, &reg->int_))
+						goto bail;
+				}
+				else
+				{
+					reg->float_ = Eidos_BytecodeRegisterFloat(reg) + Eidos_BytecodeRegisterFloat(reg + 1);
+					reg->type_ = EIDOS_BYTECODE_FLOAT;
+				}
+				break;
+			case EidosBytecodeOp::kMinus:
+				if ((reg->type_ == EIDOS_BYTECODE_INT) && (reg[1].type_ == EIDOS_BYTECODE_INT))
+				{
+					if (Eidos_sub_overflow(reg->int_, reg[1].int_, &reg->int_))
+						goto bail;
+				}
+				else
+				{
+					reg->float_ = Eidos_BytecodeRegisterFloat(reg) - Eidos_BytecodeRegisterFloat(reg + 1);
+					reg->type_ = EIDOS_BYTECODE_FLOAT;
+				}
+				break;
+			case EidosBytecodeOp::kMult:
+				if ((reg->type_ == EIDOS_BYTECODE_INT) && (reg[1].type_ == EIDOS_BYTECODE_INT))
+				{
+					if (Eidos_mul_overflow(reg->int_, reg[1].int_, &reg->int_))
+						goto bail;
+				}
+				else
+				{
+					reg->float_ = Eidos_BytecodeRegisterFloat(reg) * Eidos_BytecodeRegisterFloat(reg + 1);
+					reg->type_ = EIDOS_BYTECODE_FLOAT;
+				}
+				break;
+			case EidosBytecodeOp::kDiv:
+				reg->float_ = Eidos_BytecodeRegisterFloat(reg) / Eidos_BytecodeRegisterFloat(reg + 1);
+				reg->type_ = EIDOS_BYTECODE_FLOAT;
+				break;
+			case EidosBytecodeOp::kMod:
+				reg->float_ = fmod(Eidos_BytecodeRegisterFloat(reg), Eidos_BytecodeRegisterFloat(reg + 1));
+				reg->type_ = EIDOS_BYTECODE_FLOAT;
+				break;
+			case EidosBytecodeOp::kExp:
+				reg->float_ = pow(Eidos_BytecodeRegisterFloat(reg), Eidos_BytecodeRegisterFloat(reg + 1));
+				reg->type_ = EIDOS_BYTECODE_FLOAT;
+				break;
+			case EidosBytecodeOp::kEq:		EIDOS_BYTECODE_COMPARE(==);	break;
+			case EidosBytecodeOp::kNotEq:	EIDOS_BYTECODE_COMPARE(!=);	break;
+			case EidosBytecodeOp::kLt:		EIDOS_BYTECODE_COMPARE(<);	break;
+			case EidosBytecodeOp::kLtEq:	EIDOS_BYTECODE_COMPARE(<=);	break;
+			case EidosBytecodeOp::kGt:		EIDOS_BYTECODE_COMPARE(>);	break;
+			case EidosBytecodeOp::kGtEq:	EIDOS_BYTECODE_COMPARE(>=);	break;
+			case EidosBytecodeOp::kAnd:
+				for (int operand_index = 1; operand_index < instruction.operand_count_; ++operand_index)
+					reg->logical_ = (reg->logical_ && reg[operand_index].logical_);
+				break;
+			case EidosBytecodeOp::kOr:
+				for (int operand_index = 1; operand_index < instruction.operand_count_; ++operand_index)
+					reg->logical_ = (reg->logical_ || reg[operand_index].logical_);
+				break;
+			case EidosBytecodeOp::kNot:
+				reg->logical_ = !reg->logical_;
+				break;
+		}
+		
+		if (!(reg->type_ & instruction.accept_mask_))
+			goto bail;
+	}
+	
+	bytecode->run_count_++;
+	
+	switch (registers[0].type_)
+	{
+		case EIDOS_BYTECODE_INT:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(registers[0].int_));
+		case EIDOS_BYTECODE_FLOAT:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(registers[0].float_));
+		default:					return (registers[0].logical_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+	}
+	
+bail:
+	// re-evaluate the subtree with the tree-walking evaluator; if this node keeps bailing (usually because it sees vectors), stop trying
+	bytecode->bail_count_++;
+	
+	if ((bytecode->bail_count_ >= 16) && (bytecode->bail_count_ > bytecode->run_count_))
+		p_node->cached_evaluator_ = bytecode->fallback_evaluator_;
+	
+	return _EvaluateBailedNode(p_node, bytecode->fallback_evaluator_, property_nodes, property_values, property_count);
+}
+#pragma GCC diagnostic pop
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"	// every register is written by a load or an operator before it is read, but the compiler can't see that
+EidosValue_SP EidosInterpreter::Evaluate_Fused(const EidosASTNode *p_node)
+{
+	// Run the fused program compiled for p_node by EidosASTNode::_OptimizeFusion().  A first pass evaluates the leaves, in the same
+	// order as the tree-walking evaluator would, works out the type of every intermediate result, and computes the value of every
+	// intermediate result that involves only singletons; it bails as soon as it sees anything the fused loop can't reproduce
+	// exactly, before evaluating any later leaf, so errors raised by leaves are identical, and property leaves evaluated up to
+	// that point are handed to the fallback rather than evaluated again.  The second pass runs the program block
+	// by block; each register points into a leaf's own data or into its buffer, or is nullptr until a singleton value is needed.
+	EidosFusedExpression *fused = p_node->fused_expression_;
+	
+#if DEBUG || defined(EIDOS_GUI)
+	// the execution log is produced by the tree-walking evaluators, so use them while logging
+	if (logging_execution_)
+		return (this->*(fused->fallback_evaluator_))(p_node);
+#endif
+	
+	const std::vector<EidosFusionInstruction> &instructions = fused->instructions_;
+	int instruction_count = (int)instructions.size();
+	EidosValue_SP leaf_values[EIDOS_FUSION_MAX_LEAVES];
+	bool register_is_int[EIDOS_FUSION_MAX_REGISTERS + 1] = {};
+	bool register_is_singleton[EIDOS_FUSION_MAX_REGISTERS + 1] = {};
+	int64_t singleton_int[EIDOS_FUSION_MAX_REGISTERS + 1] = {};
+	double singleton_float[EIDOS_FUSION_MAX_REGISTERS + 1] = {};
+	double singleton_results[EIDOS_FUSION_MAX_INSTRUCTIONS];
+	uint64_t singleton_mask = 0;
+	int length = 1;
+	
+	for (int instruction_index = 0; instruction_index < instruction_count; ++instruction_index)
+	{
+		const EidosFusionInstruction &instruction = instructions[instruction_index];
+		int reg = instruction.reg_;
+		bool is_int = register_is_int[reg], is_singleton = register_is_singleton[reg];
+		int64_t a_int = singleton_int[reg];
+		double a_float = (is_int ? (double)a_int : singleton_float[reg]);
+		bool b_is_int = register_is_int[reg + 1], b_is_singleton = register_is_singleton[reg + 1];
+		int64_t b_int = singleton_int[reg + 1];
+		double b_float = (b_is_int ? (double)b_int : singleton_float[reg + 1]);
+		
+		switch (instruction.op_)
+		{
+			case EidosFusionOp::kLoadConstant:
+				register_is_int[reg] = instruction.constant_is_int_;
+				register_is_singleton[reg] = true;
+				singleton_int[reg] = instruction.constant_int_;
+				singleton_float[reg] = instruction.constant_;
+				break;
+			case EidosFusionOp::kLoadIdentifier:
+			case EidosFusionOp::kLoadProperty:
+			{
+				// identifiers use the same lookup as Evaluate_Identifier(), so that an undefined identifier raises the same error
+				EidosValue_SP leaf_value = ((instruction.op_ == EidosFusionOp::kLoadIdentifier) ? global_symbols_->GetValueOrRaiseForASTNode(instruction.node_) : FastEvaluateNode(instruction.node_));
+				EidosValue *leaf = leaf_value.get();
+				EidosValueType leaf_type = leaf->Type();
+				int leaf_count = leaf->Count();
+				
+				if (((leaf_type != EidosValueType::kValueInt) && (leaf_type != EidosValueType::kValueFloat)) || (leaf->DimensionCount() != 1) || (leaf_count == 0))
+					goto bail;
+				
+				register_is_int[reg] = (leaf_type == EidosValueType::kValueInt);
+				register_is_singleton[reg] = (leaf_count == 1);
+				
+				// operands must be conformable: all of the same length, apart from singletons, which are applied to every element
+				if (leaf_count == 1)
+				{
+					if (leaf_type == EidosValueType::kValueInt)
+						singleton_int[reg] = leaf->IntAtIndex(0, nullptr);
+					else
+						singleton_float[reg] = leaf->FloatAtIndex(0, nullptr);
+				}
+				else if (length == 1)
+					length = leaf_count;
+				else if (leaf_count != length)
+					goto bail;
+				
+				leaf_values[instruction.leaf_] = std::move(leaf_value);
+				break;
+			}
+			case EidosFusionOp::kUnaryMinus:
+				if (is_int)
+				{
+					// integer negation is done, with its overflow check, only for a singleton
+					if (!is_singleton || Eidos_sub_overflow((int64_t)0, a_int, &singleton_int[reg]))
+						goto bail;
+				}
+				else
+					singleton_float[reg] = -a_float;
+				break;
+			case EidosFusionOp::kPlus:
+			case EidosFusionOp::kMinus:
+			case EidosFusionOp::kMult:
+				register_is_singleton[reg] = (is_singleton && b_is_singleton);
+				
+				if (is_int && b_is_int)
+				{
+					// integer arithmetic is done, with its overflow checks, only for singletons
+					bool overflow = true;
+					
+					if (register_is_singleton[reg])
+					{
+						if (instruction.op_ == EidosFusionOp::kPlus)			overflow = Eidos_add_overflow(a_int, b_int, &singleton_int[reg]);
+						else if (instruction.op_ == EidosFusionOp::kMinus)		overflow = Eidos_sub_overflow(a_int, b_int, &singleton_int[reg]);
+						else													overflow = Eidos_mul_overflow(a_int, b_int, &singleton_int[reg]);
+					}
+					
+					if (overflow)
+						goto bail;
+				}
+				else
+				{
+					register_is_int[reg] = false;
+					
+					if (instruction.op_ == EidosFusionOp::kPlus)			singleton_float[reg] = a_float + b_float;
+					else if (instruction.op_ == EidosFusionOp::kMinus)		singleton_float[reg] = a_float - b_float;
+					else													singleton_float[reg] = a_float * b_float;
+				}
+				break;
+			case EidosFusionOp::kDiv:
+			case EidosFusionOp::kExp:
+				register_is_int[reg] = false;
+				register_is_singleton[reg] = (is_singleton && b_is_singleton);
+				singleton_float[reg] = ((instruction.op_ == EidosFusionOp::kDiv) ? a_float / b_float : pow(a_float, b_float));
+				break;
+			case EidosFusionOp::kFunctionAbs:
+				if (is_int)
+				{
+					// the absolute value of INT64_MIN cannot be represented, and abs() raises for it
+					if (!is_singleton || (a_int == INT64_MIN))
+						goto bail;
+					singleton_int[reg] = llabs(a_int);
+				}
+				else
+					singleton_float[reg] = fabs(a_float);
+				break;
+			case EidosFusionOp::kFunctionFloor:
+			case EidosFusionOp::kFunctionCeil:
+			case EidosFusionOp::kFunctionRound:
+			case EidosFusionOp::kFunctionTrunc:
+			case EidosFusionOp::kSum:
+			case EidosFusionOp::kMean:
+				// these raise, or take an integer path of their own, for an integer operand
+				if (is_int)
+					goto bail;
+				
+				if (instruction.op_ == EidosFusionOp::kFunctionFloor)			singleton_float[reg] = floor(a_float);
+				else if (instruction.op_ == EidosFusionOp::kFunctionCeil)		singleton_float[reg] = ceil(a_float);
+				else if (instruction.op_ == EidosFusionOp::kFunctionRound)		singleton_float[reg] = round(a_float);
+				else if (instruction.op_ == EidosFusionOp::kFunctionTrunc)		singleton_float[reg] = trunc(a_float);
+				break;
+			case EidosFusionOp::kFunctionExp:		register_is_int[reg] = false;	singleton_float[reg] = exp(a_float);		break;
+			case EidosFusionOp::kFunctionLog:		register_is_int[reg] = false;	singleton_float[reg] = log(a_float);		break;
+			case EidosFusionOp::kFunctionLog10:		register_is_int[reg] = false;	singleton_float[reg] = log10(a_float);		break;
+			case EidosFusionOp::kFunctionLog2:		register_is_int[reg] = false;	singleton_float[reg] = log2(a_float);		break;
+			case EidosFusionOp::kFunctionSqrt:		register_is_int[reg] = false;	singleton_float[reg] = sqrt(a_float);		break;
+			case EidosFusionOp::kFunctionSin:		register_is_int[reg] = false;	singleton_float[reg] = sin(a_float);		break;
+			case EidosFusionOp::kFunctionCos:		register_is_int[reg] = false;	singleton_float[reg] = cos(a_float);		break;
+			case EidosFusionOp::kFunctionTan:		register_is_int[reg] = false;	singleton_float[reg] = tan(a_float);		break;
+			case EidosFusionOp::kEq:
+			case EidosFusionOp::kNotEq:
+			case EidosFusionOp::kLt:
+			case EidosFusionOp::kLtEq:
+			case EidosFusionOp::kGt:
+			case EidosFusionOp::kGtEq:
+				// integers are compared as integers, not in float; this is the root, so the result is not needed here
+				if (is_int && b_is_int)
+					goto bail;
+				register_is_singleton[reg] = (is_singleton && b_is_singleton);
+				break;
+		}
+		
+		if (register_is_singleton[reg])
+		{
+			singleton_mask |= ((uint64_t)1 << instruction_index);
+			singleton_results[instruction_index] = (register_is_int[reg] ? (double)singleton_int[reg] : singleton_float[reg]);
+		}
+	}
+	
+	// with no vector operands the result is a singleton, which scalar bytecode and the tree-walking evaluator handle better
+	if (length == 1)
+		goto bail;
+	
+	{
+		EidosFusionOp root_op = instructions.back().op_;
+		EidosValue_SP result_SP;
+		double *float_result = nullptr;
+		eidos_logical_t *logical_result = nullptr;
+		double accumulator = 0;
+		
+		if ((root_op >= EidosFusionOp::kEq) && (root_op <= EidosFusionOp::kGtEq))
+		{
+			EidosValue_Logical *logical_result_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(length);
+			result_SP = EidosValue_SP(logical_result_value);
+			logical_result = logical_result_value->data();
+		}
+		else if ((root_op != EidosFusionOp::kSum) && (root_op != EidosFusionOp::kMean))
+		{
+			EidosValue_Float_vector *float_result_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(length);
+			result_SP = EidosValue_SP(float_result_value);
+			float_result = float_result_value->data();
+		}
+		
+		double buffers[EIDOS_FUSION_MAX_REGISTERS + 1][EIDOS_FUSION_BLOCK_SIZE];
+		const double *registers[EIDOS_FUSION_MAX_REGISTERS + 1] = {};
+		
+		for (int block_start = 0; block_start < length; block_start += EIDOS_FUSION_BLOCK_SIZE)
+		{
+			int block_count = std::min(EIDOS_FUSION_BLOCK_SIZE, length - block_start);
+			
+			for (int instruction_index = 0; instruction_index < instruction_count; ++instruction_index)
+			{
+				const EidosFusionInstruction &instruction = instructions[instruction_index];
+				int reg = instruction.reg_;
+				double *out = buffers[reg];
+				
+				if (singleton_mask & ((uint64_t)1 << instruction_index))
+				{
+					// a singleton result, computed above; it is filled into the buffer below only if a vector operation uses it
+					singleton_float[reg] = singleton_results[instruction_index];
+					registers[reg] = nullptr;
+					continue;
+				}
+				
+				if ((instruction.op_ == EidosFusionOp::kLoadIdentifier) || (instruction.op_ == EidosFusionOp::kLoadProperty))
+				{
+					EidosValue *leaf = leaf_values[instruction.leaf_].get();
+					
+					if (leaf->Type() == EidosValueType::kValueFloat)
+						registers[reg] = leaf->FloatVector()->data() + block_start;
+					else
+					{
+						const int64_t *int_data = leaf->IntVector()->data() + block_start;
+						
+						for (int i = 0; i < block_count; ++i)
+							out[i] = (double)int_data[i];
+						registers[reg] = out;
+					}
+					continue;
+				}
+				
+				// fill in singleton operands of binary operations; a unary operation on a singleton is itself a singleton, handled above
+				bool is_binary = (((instruction.op_ >= EidosFusionOp::kPlus) && (instruction.op_ <= EidosFusionOp::kExp)) || ((instruction.op_ >= EidosFusionOp::kEq) && (instruction.op_ <= EidosFusionOp::kGtEq)));
+				
+				for (int operand_reg = reg; operand_reg <= reg + (is_binary ? 1 : 0); ++operand_reg)
+				{
+					if (!registers[operand_reg])
+					{
+						std::fill(buffers[operand_reg], buffers[operand_reg] + block_count, singleton_float[operand_reg]);
+						registers[operand_reg] = buffers[operand_reg];
+					}
+				}
+				
+				const double *a = registers[reg];
+				const double *b = registers[reg + 1];	// only meaningful for binary operations
+				
+				switch (instruction.op_)
+				{
+					case EidosFusionOp::kLoadConstant:
+					case EidosFusionOp::kLoadIdentifier:
+					case EidosFusionOp::kLoadProperty:	break;		// handled above
+					case EidosFusionOp::kUnaryMinus:	for (int i = 0; i < block_count; ++i) out[i] = -a[i];				break;
+					case EidosFusionOp::kPlus:			for (int i = 0; i < block_count; ++i) out[i] = a[i] + b[i];			break;
+					case EidosFusionOp::kMinus:			for (int i = 0; i < block_count; ++i) out[i] = a[i] - b[i];			break;
+					case EidosFusionOp::kMult:			for (int i = 0; i < block_count; ++i) out[i] = a[i] * b[i];			break;
+					case EidosFusionOp::kDiv:			for (int i = 0; i < block_count; ++i) out[i] = a[i] / b[i];			break;
+					case EidosFusionOp::kExp:			for (int i = 0; i < block_count; ++i) out[i] = pow(a[i], b[i]);		break;
+					case EidosFusionOp::kFunctionExp:	for (int i = 0; i < block_count; ++i) out[i] = exp(a[i]);			break;
+					case EidosFusionOp::kFunctionLog:	for (int i = 0; i < block_count; ++i) out[i] = log(a[i]);			break;
+					case EidosFusionOp::kFunctionLog10:	for (int i = 0; i < block_count; ++i) out[i] = log10(a[i]);			break;
+					case EidosFusionOp::kFunctionLog2:	for (int i = 0; i < block_count; ++i) out[i] = log2(a[i]);			break;
+					case EidosFusionOp::kFunctionSqrt:	for (int i = 0; i < block_count; ++i) out[i] = sqrt(a[i]);			break;
+					case EidosFusionOp::kFunctionAbs:	for (int i = 0; i < block_count; ++i) out[i] = fabs(a[i]);			break;
+					case EidosFusionOp::kFunctionSin:	for (int i = 0; i < block_count; ++i) out[i] = sin(a[i]);			break;
+					case EidosFusionOp::kFunctionCos:	for (int i = 0; i < block_count; ++i) out[i] = cos(a[i]);			break;
+					case EidosFusionOp::kFunctionTan:	for (int i = 0; i < block_count; ++i) out[i] = tan(a[i]);			break;
+					case EidosFusionOp::kFunctionFloor:	for (int i = 0; i < block_count; ++i) out[i] = floor(a[i]);			break;
+					case EidosFusionOp::kFunctionCeil:	for (int i = 0; i < block_count; ++i) out[i] = ceil(a[i]);			break;
+					case EidosFusionOp::kFunctionRound:	for (int i = 0; i < block_count; ++i) out[i] = round(a[i]);			break;
+					case EidosFusionOp::kFunctionTrunc:	for (int i = 0; i < block_count; ++i) out[i] = trunc(a[i]);			break;
+					case EidosFusionOp::kEq:			for (int i = 0; i < block_count; ++i) logical_result[block_start + i] = (a[i] == b[i]);		break;
+					case EidosFusionOp::kNotEq:			for (int i = 0; i < block_count; ++i) logical_result[block_start + i] = (a[i] != b[i]);		break;
+					case EidosFusionOp::kLt:			for (int i = 0; i < block_count; ++i) logical_result[block_start + i] = (a[i] < b[i]);		break;
+					case EidosFusionOp::kLtEq:			for (int i = 0; i < block_count; ++i) logical_result[block_start + i] = (a[i] <= b[i]);		break;
+					case EidosFusionOp::kGt:			for (int i = 0; i < block_count; ++i) logical_result[block_start + i] = (a[i] > b[i]);		break;
+					case EidosFusionOp::kGtEq:			for (int i = 0; i < block_count; ++i) logical_result[block_start + i] = (a[i] >= b[i]);		break;
+					case EidosFusionOp::kSum:
+					case EidosFusionOp::kMean:
+						// accumulate in order, exactly as sum() and mean() do
+						for (int i = 0; i < block_count; ++i)
+							accumulator += a[i];
+						break;
+				}
+				
+				registers[reg] = out;
+			}
+			
+			if (float_result)
+				std::copy(registers[0], registers[0] + block_count, float_result + block_start);
+		}
+		
+		fused->run_count_++;
+		
+		if (root_op == EidosFusionOp::kSum)
+			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(accumulator));
+		if (root_op == EidosFusionOp::kMean)
+			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(accumulator / length));
+		return result_SP;
+	}
+	
+bail:
+	// re-evaluate the subtree with the tree-walking evaluator; if this node keeps bailing (usually because it sees singletons), stop trying
+	fused->bail_count_++;
+	
+	if ((fused->bail_count_ >= 16) && (fused->bail_count_ > fused->run_count_))
+		p_node->cached_evaluator_ = fused->fallback_evaluator_;
+	
+	// hand any property leaves we have already evaluated to the fallback, indexed by leaf as in leaf_values
+	const EidosASTNode *leaf_nodes[EIDOS_FUSION_MAX_LEAVES] = {};
+	int leaf_count = 0;
+	
+	for (const EidosFusionInstruction &instruction : instructions)
+	{
+		if ((instruction.op_ == EidosFusionOp::kLoadProperty) && leaf_values[instruction.leaf_])
+		{
+			leaf_nodes[instruction.leaf_] = instruction.node_;
+			leaf_count = std::max(leaf_count, instruction.leaf_ + 1);
+		}
+	}
+	
+	return _EvaluateBailedNode(p_node, fused->fallback_evaluator_, leaf_nodes, leaf_values, leaf_count);
+}
+#pragma GCC diagnostic pop
+
+bool EidosInterpreter::_FoldedNodeIsConstant(const EidosASTNode *p_node)
+{
+	// Returns true if every identifier evaluated within a pure subtree (see EidosASTNode::_OptimizeFolding()) is an intrinsic or
+	// defined constant with a non-object value; objects are excluded since their state, unlike their identity, is not constant
+	const std::vector<EidosASTNode *> &children = p_node->children_;
+	EidosTokenType token_type = p_node->token_->token_type_;
+	
+	if (token_type == EidosTokenType::kTokenIdentifier)
+	{
+		if (p_node->cached_literal_value_)
+			return true;
+		
+		EidosValue *constant_value = global_symbols_->GetValueRawForDefinedConstant(p_node->cached_stringID_);
+		
+		return (constant_value && (constant_value->Type() != EidosValueType::kValueObject));
+	}
+	
+	if (token_type == EidosTokenType::kTokenLParen)
+	{
+		// skip the call name node, and evaluate only the value of named arguments
+		for (size_t child_index = 1; child_index < children.size(); ++child_index)
+		{
+			const EidosASTNode *argument_node = children[child_index];
+			
+			if (argument_node->token_->token_type_ == EidosTokenType::kTokenAssign)
+				argument_node = argument_node->children_[1];
+			
+			if (!_FoldedNodeIsConstant(argument_node))
+				return false;
+		}
+		
+		return true;
+	}
+	
+	for (const EidosASTNode *child : children)
+		if (!_FoldedNodeIsConstant(child))
+			return false;
+	
+	return true;
+}
+
+EidosValue_SP EidosInterpreter::Evaluate_Folded(const EidosASTNode *p_node)
+{
+	// Return the folded value for p_node if we have one; otherwise, evaluate it and fold it if it turns out to be constant.  If it
+	// does not, it never will in practice (short of a variable being removed and a constant defined with the same name), so we stop
+	// checking by restoring the fallback evaluator, as we also do for values too large to keep.  A folded value is shared, like
+	// cached literal values, so its users copy it before modifying it.  See EidosFoldedConstant.
+	EidosFoldedConstant *folded = p_node->folded_constant_;
+	
+#if DEBUG || defined(EIDOS_GUI)
+	// the execution log is produced by the tree-walking evaluators, so use them while logging
+	if (logging_execution_)
+		return (this->*(folded->fallback_evaluator_))(p_node);
+#endif
+	
+	if (folded->value_ && (folded->epoch_ == gEidosDefinedConstantsEpoch))
+		return folded->value_;
+	
+	folded->value_.reset();
+	
+	if (!_FoldedNodeIsConstant(p_node))
+	{
+		p_node->cached_evaluator_ = folded->fallback_evaluator_;
+		return (this->*(folded->fallback_evaluator_))(p_node);
+	}
+	
+	EidosValue_SP result_SP = (this->*(folded->fallback_evaluator_))(p_node);
+	
+	if (result_SP->Count() > EIDOS_FOLDED_CONSTANT_MAX_COUNT)
+	{
+		// too large to be worth keeping; see EidosFoldedConstant
+		p_node->cached_evaluator_ = folded->fallback_evaluator_;
+	}
+	else if (!result_SP->Invisible())
+	{
+		folded->value_ = result_SP;
+		folded->epoch_ = gEidosDefinedConstantsEpoch;
+	}
+	
+	return result_SP;
+}
+
 EidosValue_SP EidosInterpreter::Evaluate_Number(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Number()");
@@ -5959,6 +6992,8 @@ EidosValue_SP EidosInterpreter::Evaluate_For(const EidosASTNode *p_node)
 					EidosValue_Logical_SP index_value_SP = EidosValue_Logical_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Logical());
 					EidosValue_Logical *index_value = index_value_SP->resize_no_initialize(1);
 					
+					index_value->MarkUnshareable();		// not a singleton, so it would otherwise be shared by assignments like x = i;
+					
 					index_value->set_logical_no_check(false, 0);	// initial placeholder
 					
 					global_symbols_->SetValueForSymbolNoCopy(identifier_name, std::move(index_value_SP));
@@ -100,6 +100,12 @@ private:
 	int execution_log_indent_ = 0;
 	std::ostringstream *execution_log_ = nullptr;		// allocated lazily; for internal tokenization/parse/execution traces
 	
+	// property leaf values already evaluated by Evaluate_ScalarBytecode() or Evaluate_Fused() when it bails, which Evaluate_MemberRef()
+	// returns rather than evaluating those leaves a second time, while bailed_leaf_count_ is non-zero; see _EvaluateBailedNode()
+	const EidosASTNode **bailed_leaf_nodes_ = nullptr;
+	EidosValue_SP *bailed_leaf_values_ = nullptr;
+	int bailed_leaf_count_ = 0;
+	
 	// output streams for standard and error output from executed nodes and functions; these go into the user's console
 	std::ostream &execution_output_;
 	std::ostream &error_output_;
@@ -277,6 +283,11 @@ public:
 	EidosValue_SP Evaluate_GtEq(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_Not(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_NotEq(const EidosASTNode *p_node);
+	EidosValue_SP Evaluate_ScalarBytecode(const EidosASTNode *p_node);
+	EidosValue_SP _EvaluateBailedNode(const EidosASTNode *p_node, EidosEvaluationMethod p_fallback_evaluator, const EidosASTNode **p_leaf_nodes, EidosValue_SP *p_leaf_values, int p_leaf_count);
+	EidosValue_SP Evaluate_Fused(const EidosASTNode *p_node);
+	EidosValue_SP Evaluate_Folded(const EidosASTNode *p_node);
+	bool _FoldedNodeIsConstant(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_Number(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_String(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_Identifier(const EidosASTNode *p_node);
@@ -0,0 +1,210 @@
+//
+//  eidos_parallel.cpp
+//  Eidos
+//
+//  Created by agent on 10/19/2026.
+//  Copyright (c) 2026 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "eidos_parallel.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+
+int gEidosMaxThreads = 1;
+int64_t gEidosParallelThreshold = EIDOS_DEFAULT_PARALLEL_THRESHOLD;
+
+// set while a thread is running a chunk body, so that nested parallel calls run serially instead of deadlocking the pool
+static thread_local bool gEidosInParallelRegion = false;
+
+void Eidos_SetMaxThreads(int64_t p_max_threads)
+{
+	if (p_max_threads == 0)
+		p_max_threads = std::thread::hardware_concurrency();	// may itself be 0 if unknown, which is clamped to 1 below
+	
+	gEidosMaxThreads = (int)std::max<int64_t>(1, std::min<int64_t>(p_max_threads, EIDOS_MAX_THREADS));
+}
+
+void Eidos_SetParallelThreshold(int64_t p_threshold)
+{
+	gEidosParallelThreshold = std::max<int64_t>(p_threshold, 0);
+}
+
+
+namespace {
+
+// A fixed set of worker threads that sleep between jobs.  A job is a set of numbered tasks; the workers and the thread
+// that posted the job claim tasks from a shared counter until none remain.  Only one job runs at a time, and jobs are
+// only posted from the main thread.
+class EidosThreadPool
+{
+	std::vector<std::thread> workers_;
+	std::mutex mutex_;
+	std::condition_variable work_cv_;
+	std::condition_variable done_cv_;
+	
+	uint64_t job_generation_ = 0;			// incremented for each job posted; workers wait for it to change
+	bool stopping_ = false;
+	const std::function<void(int)> *job_task_ = nullptr;
+	int job_task_count_ = 0;
+	std::atomic<int> job_next_task_{0};
+	int job_busy_workers_ = 0;
+	std::exception_ptr job_exception_;
+	
+	void RunTasks(void)
+	{
+		gEidosInParallelRegion = true;
+		
+		int task_index;
+		
+		while ((task_index = job_next_task_.fetch_add(1, std::memory_order_relaxed)) < job_task_count_)
+		{
+			try {
+				(*job_task_)(task_index);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				
+				if (!job_exception_)
+					job_exception_ = std::current_exception();
+			}
+		}
+		
+		gEidosInParallelRegion = false;
+	}
+	
+	void WorkerLoop(uint64_t p_seen_generation)
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				
+				work_cv_.wait(lock, [this, p_seen_generation] { return stopping_ || (job_generation_ != p_seen_generation); });
+				
+				if (stopping_)
+					return;
+				
+				p_seen_generation = job_generation_;
+			}
+			
+			RunTasks();
+			
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				
+				if (--job_busy_workers_ == 0)
+					done_cv_.notify_one();
+			}
+		}
+	}
+
+public:
+	~EidosThreadPool(void)
+	{
+		Resize(0);
+	}
+	
+	size_t WorkerCount(void) const { return workers_.size(); }
+	
+	void Resize(size_t p_worker_count)
+	{
+		if (p_worker_count == workers_.size())
+			return;
+		
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		work_cv_.notify_all();
+		
+		for (std::thread &worker : workers_)
+			worker.join();
+		
+		workers_.clear();
+		stopping_ = false;
+		
+		for (size_t worker_index = 0; worker_index < p_worker_count; ++worker_index)
+			workers_.emplace_back(&EidosThreadPool::WorkerLoop, this, job_generation_);
+	}
+	
+	void Run(int p_task_count, const std::function<void(int)> &p_task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			
+			job_task_ = &p_task;
+			job_task_count_ = p_task_count;
+			job_next_task_.store(0, std::memory_order_relaxed);
+			job_busy_workers_ = (int)workers_.size();
+			job_exception_ = nullptr;
+			job_generation_++;
+		}
+		work_cv_.notify_all();
+		
+		RunTasks();
+		
+		std::exception_ptr exception;
+		
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			
+			done_cv_.wait(lock, [this] { return job_busy_workers_ == 0; });
+			
+			job_task_ = nullptr;
+			exception = job_exception_;
+			job_exception_ = nullptr;
+		}
+		
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+};
+
+EidosThreadPool &Eidos_ThreadPool(void)
+{
+	static EidosThreadPool pool;
+	
+	return pool;
+}
+
+}	// anonymous namespace
+
+void Eidos_ParallelFor(int64_t p_count, int p_chunk_count, const std::function<void(int, int64_t, int64_t)> &p_body)
+{
+	if (p_count <= 0)
+		return;
+	
+	p_chunk_count = (int)std::max<int64_t>(1, std::min<int64_t>(p_chunk_count, p_count));
+	
+	std::function<void(int)> chunk_task = [p_count, p_chunk_count, &p_body](int p_chunk_index) {
+		p_body(p_chunk_index, p_count * p_chunk_index / p_chunk_count, p_count * (p_chunk_index + 1) / p_chunk_count);
+	};
+	
+	if ((p_chunk_count == 1) || (gEidosMaxThreads <= 1) || gEidosInParallelRegion)
+	{
+		for (int chunk_index = 0; chunk_index < p_chunk_count; ++chunk_index)
+			chunk_task(chunk_index);
+		return;
+	}
+	
+	EidosThreadPool &pool = Eidos_ThreadPool();
+	
+	pool.Resize(gEidosMaxThreads - 1);
+	pool.Run(p_chunk_count, chunk_task);
+}
@@ -0,0 +1,115 @@
+//
+//  eidos_parallel.h
+//  Eidos
+//
+//  Created by agent on 10/19/2026.
+//  Copyright (c) 2026 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ This header provides the small thread pool used by Eidos builtins that work on large vectors: sort(), which(),
+ match(), tabulate(), weighted sample(), and a few element-wise math functions.  The pool is off by default, since
+ SLiM is very often run as many concurrent replicates; gEidosMaxThreads (-maxThreads on the command line, or the
+ maxThreads parameter of initializeSLiMOptions() in SLiM) turns it on, and gEidosParallelThreshold sets the number
+ of elements below which a builtin stays serial, because handing work to other threads costs several microseconds.
+
+ Parallel code must produce exactly the same results as the serial code it replaces, regardless of the number of
+ threads, so that models remain reproducible from their seed.  Parallel chunks therefore only ever work on raw
+ buffers: they never allocate EidosValues, never touch the random number generator (random draws are made on the
+ main thread, in the same order as in serial code, and only the work that consumes them is parallelized), and never
+ raise Eidos errors; anything that can fail is checked on the main thread before or after the parallel section.
+
+ */
+
+#ifndef __Eidos__eidos_parallel_h
+#define __Eidos__eidos_parallel_h
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+// The total number of threads used by parallel builtins, including the main thread; 1 (the default) disables the pool
+extern int gEidosMaxThreads;
+
+// The minimum amount of work, in elements, for a builtin to run in parallel
+extern int64_t gEidosParallelThreshold;
+
+#define EIDOS_MAX_THREADS						256
+#define EIDOS_DEFAULT_PARALLEL_THRESHOLD		100000
+
+// Set gEidosMaxThreads; 0 requests one thread per hardware thread.  The pool itself is resized lazily, on next use.
+void Eidos_SetMaxThreads(int64_t p_max_threads);
+void Eidos_SetParallelThreshold(int64_t p_threshold);
+
+// The number of chunks a builtin should split p_work elements of work into: 1 if it should run serially
+inline int Eidos_ParallelChunkCount(int64_t p_work)
+{
+	if ((gEidosMaxThreads <= 1) || (p_work < gEidosParallelThreshold) || (p_work < 2))
+		return 1;
+	
+	return (int)std::min<int64_t>(gEidosMaxThreads, p_work);
+}
+
+// Split [0, p_count) into p_chunk_count contiguous chunks, and call p_body(chunk_index, begin, end) for each of them on
+// the pool's threads, including the calling thread; returns when all chunks are done.  Chunk boundaries depend only on
+// p_count and p_chunk_count.  A call made from within a chunk body, or with p_chunk_count == 1, runs serially.
+void Eidos_ParallelFor(int64_t p_count, int p_chunk_count, const std::function<void(int, int64_t, int64_t)> &p_body);
+
+// Sort a buffer, in parallel for large buffers: chunks are sorted concurrently and then merged pairwise.  This gives a
+// different arrangement of elements that compare equal than std::sort() would, so it must be used only for types in
+// which such elements are indistinguishable (integers and strings, but not doubles, given -0.0 and 0.0).
+template <typename T, typename Compare>
+void Eidos_ParallelSort(T *p_values, int64_t p_count, Compare p_comp)
+{
+	int chunk_count = Eidos_ParallelChunkCount(p_count);
+	
+	if (chunk_count <= 1)
+	{
+		std::sort(p_values, p_values + p_count, p_comp);
+		return;
+	}
+	
+	std::vector<int64_t> bounds(chunk_count + 1);
+	
+	for (int chunk_index = 0; chunk_index <= chunk_count; ++chunk_index)
+		bounds[chunk_index] = p_count * chunk_index / chunk_count;
+	
+	Eidos_ParallelFor(chunk_count, chunk_count, [&](int, int64_t p_begin, int64_t p_end) {
+		for (int64_t chunk_index = p_begin; chunk_index < p_end; ++chunk_index)
+			std::sort(p_values + bounds[chunk_index], p_values + bounds[chunk_index + 1], p_comp);
+	});
+	
+	for (int width = 1; width < chunk_count; width *= 2)
+	{
+		int pair_count = (chunk_count + 2 * width - 1) / (2 * width);
+		
+		Eidos_ParallelFor(pair_count, pair_count, [&](int, int64_t p_begin, int64_t p_end) {
+			for (int64_t pair_index = p_begin; pair_index < p_end; ++pair_index)
+			{
+				int64_t first = pair_index * 2 * width;
+				int64_t middle = std::min<int64_t>(first + width, chunk_count);
+				int64_t last = std::min<int64_t>(first + 2 * width, chunk_count);
+				
+				if (middle < last)
+					std::inplace_merge(p_values + bounds[first], p_values + bounds[middle], p_values + bounds[last], p_comp);
+			}
+		});
+	}
+}
+
+
+#endif /* __Eidos__eidos_parallel_h */
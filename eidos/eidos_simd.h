@@ -0,0 +1,408 @@
+//
+//  eidos_simd.h
+//  Eidos
+//
+//  Created by agent on 10/19/2026.
+//  Copyright (c) 2026 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ This header provides the vectorized kernels used by Eidos's element-wise math builtins, its reductions, and its
+ comparison operators.  A thin abstraction layer (EidosSIMD_f64 / EidosSIMD_i64 and their inline operations) is
+ chosen at compile time: AVX2 when the compiler targets it (-mavx2 or -march=native), SSE2 on any other x86-64
+ build, and plain scalar loops elsewhere (which the compiler is free to auto-vectorize, as it does for NEON).
+ The kernels are written once against that layer, with a scalar loop for the tail of each buffer.
+
+ Every kernel here produces bit-identical results on every path.  sqrt(), fabs(), min/max and the comparisons are
+ exact IEEE operations; integer sums are exact, and the integer reduction below reproduces the overflow behavior
+ of the sequential loop it replaces.  Floating-point sums are deliberately NOT vectorized: reordering them would
+ change their rounding, and thus the results of models, depending on the instruction set a binary was built for.
+ Transcendental functions such as exp() and log() likewise stay with the C library for identical results.
+
+ */
+
+#ifndef __Eidos__eidos_simd_h
+#define __Eidos__eidos_simd_h
+
+#include "eidos_globals.h"
+#include "eidos_value.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define EIDOS_SIMD_LANES	4
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define EIDOS_SIMD_LANES	2
+#else
+#define EIDOS_SIMD_LANES	0
+#endif
+
+
+#pragma mark -
+#pragma mark SIMD abstraction layer
+#pragma mark -
+
+#if (EIDOS_SIMD_LANES == 4)
+
+typedef __m256d EidosSIMD_f64;
+typedef __m256i EidosSIMD_i64;
+
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_LoadF64(const double *p_ptr) { return _mm256_loadu_pd(p_ptr); }
+inline __attribute__((always_inline)) void EidosSIMD_StoreF64(double *p_ptr, EidosSIMD_f64 p_v) { _mm256_storeu_pd(p_ptr, p_v); }
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_SplatF64(double p_value) { return _mm256_set1_pd(p_value); }
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_SqrtF64(EidosSIMD_f64 p_v) { return _mm256_sqrt_pd(p_v); }
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_AndNotF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm256_andnot_pd(p_a, p_b); }		// ~p_a & p_b
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_MaxF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm256_max_pd(p_a, p_b); }		// p_a > p_b ? p_a : p_b
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_MinF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm256_min_pd(p_a, p_b); }		// p_a < p_b ? p_a : p_b
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_SelectF64(EidosSIMD_f64 p_mask, EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm256_blendv_pd(p_b, p_a, p_mask); }
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_UnorderedF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm256_cmp_pd(p_a, p_b, _CMP_UNORD_Q); }
+inline __attribute__((always_inline)) int EidosSIMD_MaskBitsF64(EidosSIMD_f64 p_mask) { return _mm256_movemask_pd(p_mask); }
+
+template <EidosComparisonOperator OP> inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_CompareF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b)
+{
+	switch (OP)
+	{
+		case EidosComparisonOperator::kLess:			return _mm256_cmp_pd(p_a, p_b, _CMP_LT_OQ);
+		case EidosComparisonOperator::kLessOrEqual:		return _mm256_cmp_pd(p_a, p_b, _CMP_LE_OQ);
+		case EidosComparisonOperator::kEqual:			return _mm256_cmp_pd(p_a, p_b, _CMP_EQ_OQ);
+		case EidosComparisonOperator::kGreaterOrEqual:	return _mm256_cmp_pd(p_a, p_b, _CMP_GE_OQ);
+		case EidosComparisonOperator::kGreater:			return _mm256_cmp_pd(p_a, p_b, _CMP_GT_OQ);
+		default:										return _mm256_cmp_pd(p_a, p_b, _CMP_NEQ_UQ);		// kNotEqual
+	}
+}
+
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_LoadI64(const int64_t *p_ptr) { return _mm256_loadu_si256((const __m256i *)p_ptr); }
+inline __attribute__((always_inline)) void EidosSIMD_StoreI64(int64_t *p_ptr, EidosSIMD_i64 p_v) { _mm256_storeu_si256((__m256i *)p_ptr, p_v); }
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_ZeroI64(void) { return _mm256_setzero_si256(); }
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_SplatI64(int64_t p_value) { return _mm256_set1_epi64x(p_value); }
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_AddI64(EidosSIMD_i64 p_a, EidosSIMD_i64 p_b) { return _mm256_add_epi64(p_a, p_b); }		// wraps
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_OrI64(EidosSIMD_i64 p_a, EidosSIMD_i64 p_b) { return _mm256_or_si256(p_a, p_b); }
+template <int SHIFT> inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_ShiftRightLogicalI64(EidosSIMD_i64 p_v) { return _mm256_srli_epi64(p_v, SHIFT); }
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_SumBytesI64(const uint8_t *p_ptr) { return _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)p_ptr), _mm256_setzero_si256()); }		// 32 bytes summed into 64-bit lanes
+#define EIDOS_SIMD_BYTES	32
+
+#elif (EIDOS_SIMD_LANES == 2)
+
+typedef __m128d EidosSIMD_f64;
+typedef __m128i EidosSIMD_i64;
+
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_LoadF64(const double *p_ptr) { return _mm_loadu_pd(p_ptr); }
+inline __attribute__((always_inline)) void EidosSIMD_StoreF64(double *p_ptr, EidosSIMD_f64 p_v) { _mm_storeu_pd(p_ptr, p_v); }
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_SplatF64(double p_value) { return _mm_set1_pd(p_value); }
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_SqrtF64(EidosSIMD_f64 p_v) { return _mm_sqrt_pd(p_v); }
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_AndNotF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm_andnot_pd(p_a, p_b); }		// ~p_a & p_b
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_MaxF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm_max_pd(p_a, p_b); }		// p_a > p_b ? p_a : p_b
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_MinF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm_min_pd(p_a, p_b); }		// p_a < p_b ? p_a : p_b
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_SelectF64(EidosSIMD_f64 p_mask, EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm_or_pd(_mm_and_pd(p_mask, p_a), _mm_andnot_pd(p_mask, p_b)); }
+inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_UnorderedF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b) { return _mm_cmpunord_pd(p_a, p_b); }
+inline __attribute__((always_inline)) int EidosSIMD_MaskBitsF64(EidosSIMD_f64 p_mask) { return _mm_movemask_pd(p_mask); }
+
+template <EidosComparisonOperator OP> inline __attribute__((always_inline)) EidosSIMD_f64 EidosSIMD_CompareF64(EidosSIMD_f64 p_a, EidosSIMD_f64 p_b)
+{
+	switch (OP)
+	{
+		case EidosComparisonOperator::kLess:			return _mm_cmplt_pd(p_a, p_b);
+		case EidosComparisonOperator::kLessOrEqual:		return _mm_cmple_pd(p_a, p_b);
+		case EidosComparisonOperator::kEqual:			return _mm_cmpeq_pd(p_a, p_b);
+		case EidosComparisonOperator::kGreaterOrEqual:	return _mm_cmpge_pd(p_a, p_b);
+		case EidosComparisonOperator::kGreater:			return _mm_cmpgt_pd(p_a, p_b);
+		default:										return _mm_cmpneq_pd(p_a, p_b);		// kNotEqual
+	}
+}
+
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_LoadI64(const int64_t *p_ptr) { return _mm_loadu_si128((const __m128i *)p_ptr); }
+inline __attribute__((always_inline)) void EidosSIMD_StoreI64(int64_t *p_ptr, EidosSIMD_i64 p_v) { _mm_storeu_si128((__m128i *)p_ptr, p_v); }
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_ZeroI64(void) { return _mm_setzero_si128(); }
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_SplatI64(int64_t p_value) { return _mm_set1_epi64x(p_value); }
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_AddI64(EidosSIMD_i64 p_a, EidosSIMD_i64 p_b) { return _mm_add_epi64(p_a, p_b); }		// wraps
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_OrI64(EidosSIMD_i64 p_a, EidosSIMD_i64 p_b) { return _mm_or_si128(p_a, p_b); }
+template <int SHIFT> inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_ShiftRightLogicalI64(EidosSIMD_i64 p_v) { return _mm_srli_epi64(p_v, SHIFT); }
+inline __attribute__((always_inline)) EidosSIMD_i64 EidosSIMD_SumBytesI64(const uint8_t *p_ptr) { return _mm_sad_epu8(_mm_loadu_si128((const __m128i *)p_ptr), _mm_setzero_si128()); }		// 16 bytes summed into 64-bit lanes
+#define EIDOS_SIMD_BYTES	16
+
+#endif
+
+
+#pragma mark -
+#pragma mark Scalar reference operations
+#pragma mark -
+
+// These define the semantics every vector path must reproduce, and handle buffer tails and the scalar build
+
+template <EidosComparisonOperator OP, typename T> inline __attribute__((always_inline)) bool EidosSIMD_CompareScalar(T p_a, T p_b)
+{
+	switch (OP)
+	{
+		case EidosComparisonOperator::kLess:			return (p_a < p_b);
+		case EidosComparisonOperator::kLessOrEqual:		return (p_a <= p_b);
+		case EidosComparisonOperator::kEqual:			return (p_a == p_b);
+		case EidosComparisonOperator::kGreaterOrEqual:	return (p_a >= p_b);
+		case EidosComparisonOperator::kGreater:			return (p_a > p_b);
+		default:										return (p_a != p_b);	// kNotEqual
+	}
+}
+
+// pmax() and pmin() return NAN if either operand is NAN, and otherwise std::max(a, b) / std::min(a, b); note that
+// std::max(a, b) is (a < b) ? b : a, which is EidosSIMD_MaxF64(b, a), and likewise for std::min(), so that the
+// choice between -0.0 and 0.0 matches as well
+inline __attribute__((always_inline)) double EidosSIMD_PMaxScalar(double p_a, double p_b)
+{
+	return (std::isnan(p_a) || std::isnan(p_b)) ? std::numeric_limits<double>::quiet_NaN() : std::max(p_a, p_b);
+}
+
+inline __attribute__((always_inline)) double EidosSIMD_PMinScalar(double p_a, double p_b)
+{
+	return (std::isnan(p_a) || std::isnan(p_b)) ? std::numeric_limits<double>::quiet_NaN() : std::min(p_a, p_b);
+}
+
+
+#pragma mark -
+#pragma mark Kernels
+#pragma mark -
+
+// sqrt() over a buffer; IEEE sqrt is correctly rounded, so this matches std::sqrt() exactly
+inline void Eidos_SIMD_Sqrt_F64(const double *p_in, double *p_out, int64_t p_count)
+{
+	int64_t index = 0;
+
+#if EIDOS_SIMD_LANES
+	for (; index + EIDOS_SIMD_LANES <= p_count; index += EIDOS_SIMD_LANES)
+		EidosSIMD_StoreF64(p_out + index, EidosSIMD_SqrtF64(EidosSIMD_LoadF64(p_in + index)));
+#endif
+	
+	for (; index < p_count; ++index)
+		p_out[index] = std::sqrt(p_in[index]);
+}
+
+// fabs() over a buffer, by clearing the sign bit as fabs() itself does
+inline void Eidos_SIMD_Abs_F64(const double *p_in, double *p_out, int64_t p_count)
+{
+	int64_t index = 0;
+
+#if EIDOS_SIMD_LANES
+	const EidosSIMD_f64 sign_bit = EidosSIMD_SplatF64(-0.0);
+	
+	for (; index + EIDOS_SIMD_LANES <= p_count; index += EIDOS_SIMD_LANES)
+		EidosSIMD_StoreF64(p_out + index, EidosSIMD_AndNotF64(sign_bit, EidosSIMD_LoadF64(p_in + index)));
+#endif
+	
+	for (; index < p_count; ++index)
+		p_out[index] = std::fabs(p_in[index]);
+}
+
+// pmax() / pmin() over two buffers, or a buffer and a singleton (p_b_singleton), with NAN propagation as above
+template <bool IS_MAX> inline void Eidos_SIMD_PMaxMin_F64(const double *p_a, const double *p_b, bool p_b_singleton, double *p_out, int64_t p_count)
+{
+	int64_t index = 0;
+
+#if EIDOS_SIMD_LANES
+	const EidosSIMD_f64 nan_value = EidosSIMD_SplatF64(std::numeric_limits<double>::quiet_NaN());
+	EidosSIMD_f64 b_value = EidosSIMD_SplatF64(p_b[0]);
+	
+	for (; index + EIDOS_SIMD_LANES <= p_count; index += EIDOS_SIMD_LANES)
+	{
+		EidosSIMD_f64 a_value = EidosSIMD_LoadF64(p_a + index);
+		
+		if (!p_b_singleton)
+			b_value = EidosSIMD_LoadF64(p_b + index);
+		
+		EidosSIMD_f64 extreme = (IS_MAX ? EidosSIMD_MaxF64(b_value, a_value) : EidosSIMD_MinF64(b_value, a_value));
+		
+		EidosSIMD_StoreF64(p_out + index, EidosSIMD_SelectF64(EidosSIMD_UnorderedF64(a_value, b_value), nan_value, extreme));
+	}
+#endif
+	
+	for (; index < p_count; ++index)
+	{
+		double b_value_scalar = (p_b_singleton ? p_b[0] : p_b[index]);
+		
+		p_out[index] = (IS_MAX ? EidosSIMD_PMaxScalar(p_a[index], b_value_scalar) : EidosSIMD_PMinScalar(p_a[index], b_value_scalar));
+	}
+}
+
+// A comparison operator over float operands, producing eidos_logical_t; either operand may be a singleton, but not both
+template <EidosComparisonOperator OP> inline void Eidos_SIMD_Compare_F64(const double *p_a, bool p_a_singleton, const double *p_b, bool p_b_singleton, eidos_logical_t *p_out, int64_t p_count)
+{
+	int64_t index = 0;
+
+#if EIDOS_SIMD_LANES
+	EidosSIMD_f64 a_value = EidosSIMD_SplatF64(p_a[0]);
+	EidosSIMD_f64 b_value = EidosSIMD_SplatF64(p_b[0]);
+	
+	for (; index + EIDOS_SIMD_LANES <= p_count; index += EIDOS_SIMD_LANES)
+	{
+		if (!p_a_singleton)
+			a_value = EidosSIMD_LoadF64(p_a + index);
+		if (!p_b_singleton)
+			b_value = EidosSIMD_LoadF64(p_b + index);
+		
+		int bits = EidosSIMD_MaskBitsF64(EidosSIMD_CompareF64<OP>(a_value, b_value));
+		
+		for (int lane = 0; lane < EIDOS_SIMD_LANES; ++lane)
+			p_out[index + lane] = (eidos_logical_t)((bits >> lane) & 1);
+	}
+#endif
+	
+	for (; index < p_count; ++index)
+		p_out[index] = EidosSIMD_CompareScalar<OP>(p_a_singleton ? p_a[0] : p_a[index], p_b_singleton ? p_b[0] : p_b[index]);
+}
+
+// The same for integer operands; without 64-bit vector compares in SSE2 this is a plain loop for the compiler to vectorize
+template <EidosComparisonOperator OP> inline void Eidos_SIMD_Compare_I64(const int64_t *p_a, bool p_a_singleton, const int64_t *p_b, bool p_b_singleton, eidos_logical_t *p_out, int64_t p_count)
+{
+	if (p_a_singleton)
+	{
+		int64_t a_value = p_a[0];
+		
+		for (int64_t index = 0; index < p_count; ++index)
+			p_out[index] = EidosSIMD_CompareScalar<OP>(a_value, p_b[index]);
+	}
+	else if (p_b_singleton)
+	{
+		int64_t b_value = p_b[0];
+		
+		for (int64_t index = 0; index < p_count; ++index)
+			p_out[index] = EidosSIMD_CompareScalar<OP>(p_a[index], b_value);
+	}
+	else
+	{
+		for (int64_t index = 0; index < p_count; ++index)
+			p_out[index] = EidosSIMD_CompareScalar<OP>(p_a[index], p_b[index]);
+	}
+}
+
+// Counts the T values in a logical buffer
+inline int64_t Eidos_SIMD_Sum_Logical(const eidos_logical_t *p_data, int64_t p_count)
+{
+	int64_t index = 0, sum = 0;
+
+#if EIDOS_SIMD_LANES
+	EidosSIMD_i64 lane_sums = EidosSIMD_ZeroI64();
+	int64_t lane_values[EIDOS_SIMD_LANES];
+	
+	for (; index + EIDOS_SIMD_BYTES <= p_count; index += EIDOS_SIMD_BYTES)
+		lane_sums = EidosSIMD_AddI64(lane_sums, EidosSIMD_SumBytesI64(p_data + index));
+	
+	EidosSIMD_StoreI64(lane_values, lane_sums);
+	
+	for (int lane = 0; lane < EIDOS_SIMD_LANES; ++lane)
+		sum += lane_values[lane];
+#endif
+	
+	for (; index < p_count; ++index)
+		sum += p_data[index];
+	
+	return sum;
+}
+
+// Integer values below this magnitude can be summed EIDOS_SIMD_INT_BLOCK at a time onto an accumulator below
+// EIDOS_SIMD_INT_SAFE_SUM without any possibility of overflow: 2^8 * 2^54 + 2^62 stays below 2^63
+#define EIDOS_SIMD_INT_BLOCK			256
+#define EIDOS_SIMD_INT_SMALL_SHIFT		54
+#define EIDOS_SIMD_INT_SAFE_SUM			(((int64_t)1) << 62)
+
+// Returns true if every value in the block lies in [-2^54, 2^54), testing ((uint64_t)value + 2^54) >> 55 == 0 so that
+// the test can be or-ed across the block without a branch per element.  The block's sum is accumulated in the same
+// pass, in wrapping unsigned arithmetic, and placed in *p_sum; it is exact whenever the block passes the test.
+inline bool _Eidos_SIMD_I64BlockIsSmall(const int64_t *p_data, int64_t p_count, int64_t *p_sum)
+{
+	const uint64_t offset = ((uint64_t)1) << EIDOS_SIMD_INT_SMALL_SHIFT;
+	uint64_t high_bits = 0, sum = 0;
+	int64_t index = 0;
+
+#if EIDOS_SIMD_LANES
+	const EidosSIMD_i64 offset_vector = EidosSIMD_SplatI64((int64_t)offset);
+	EidosSIMD_i64 high_vector = EidosSIMD_ZeroI64();
+	EidosSIMD_i64 sum_vector = EidosSIMD_ZeroI64();
+	int64_t high_lanes[EIDOS_SIMD_LANES], sum_lanes[EIDOS_SIMD_LANES];
+	
+	for (; index + EIDOS_SIMD_LANES <= p_count; index += EIDOS_SIMD_LANES)
+	{
+		EidosSIMD_i64 values = EidosSIMD_LoadI64(p_data + index);
+		
+		high_vector = EidosSIMD_OrI64(high_vector, EidosSIMD_ShiftRightLogicalI64<EIDOS_SIMD_INT_SMALL_SHIFT + 1>(EidosSIMD_AddI64(values, offset_vector)));
+		sum_vector = EidosSIMD_AddI64(sum_vector, values);
+	}
+	
+	EidosSIMD_StoreI64(high_lanes, high_vector);
+	EidosSIMD_StoreI64(sum_lanes, sum_vector);
+	
+	for (int lane = 0; lane < EIDOS_SIMD_LANES; ++lane)
+	{
+		high_bits |= (uint64_t)high_lanes[lane];
+		sum += (uint64_t)sum_lanes[lane];
+	}
+#endif
+	
+	for (; index < p_count; ++index)
+	{
+		high_bits |= (((uint64_t)p_data[index] + offset) >> (EIDOS_SIMD_INT_SMALL_SHIFT + 1));
+		sum += (uint64_t)p_data[index];
+	}
+	
+	*p_sum = (int64_t)sum;
+	return (high_bits == 0);
+}
+
+// Sums integers the way sum() and mean() always have: accumulate in *p_sum_i, and when the next addition would
+// overflow, spill the accumulator into *p_sum_d and restart it from that value.  Blocks that provably cannot overflow
+// are summed with vector adds; any other block takes the sequential path, so the spill points, and therefore the
+// result, are exactly those of the sequential loop.  Returns true if any overflow occurred.
+inline bool Eidos_SIMD_Sum_I64(const int64_t *p_data, int64_t p_count, int64_t *p_sum_i, double *p_sum_d)
+{
+	int64_t sum_i = *p_sum_i;
+	double sum_d = *p_sum_d;
+	bool overflowed = false;
+	
+	for (int64_t block_start = 0; block_start < p_count; block_start += EIDOS_SIMD_INT_BLOCK)
+	{
+		int64_t block_count = std::min((int64_t)EIDOS_SIMD_INT_BLOCK, p_count - block_start);
+		const int64_t *block_data = p_data + block_start;
+		
+		int64_t block_sum;
+		
+		if ((sum_i > -EIDOS_SIMD_INT_SAFE_SUM) && (sum_i < EIDOS_SIMD_INT_SAFE_SUM) && _Eidos_SIMD_I64BlockIsSmall(block_data, block_count, &block_sum))
+		{
+			sum_i += block_sum;
+			continue;
+		}
+		
+		for (int64_t index = 0; index < block_count; ++index)
+		{
+			int64_t old_sum = sum_i;
+			int64_t temp = block_data[index];
+			
+			if (Eidos_add_overflow(old_sum, temp, &sum_i))
+			{
+				overflowed = true;
+				sum_d += old_sum;
+				sum_i = temp;
+			}
+		}
+	}
+	
+	*p_sum_i = sum_i;
+	*p_sum_d = sum_d;
+	return overflowed;
+}
+
+
+#endif /* __Eidos__eidos_simd_h */
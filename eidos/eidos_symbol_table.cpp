@@ -125,6 +125,9 @@ EidosSymbolTable::EidosSymbolTable(EidosSymbolTableType p_table_type, EidosSymbo
 	// allocate the lookup table
 	slots_ = GetZeroedTableFromPool(&capacity_);
 	
+	if (table_type_ == EidosSymbolTableType::kEidosDefinedConstantsTable)
+		gEidosDefinedConstantsEpoch++;
+	
 	if (!p_parent_table)
 	{
 		// If no parent table is given, then we construct a base table for Eidos containing the standard constants.
@@ -192,18 +195,13 @@ EidosSymbolTable::~EidosSymbolTable(void)
 	if (table_type_ == EidosSymbolTableType::kINVALID_TABLE_TYPE)
 		EIDOS_TERMINATION << "ERROR (EidosSymbolTable::~EidosSymbolTable): (internal error) zombie symbol table being destructed." << EidosTerminate(nullptr);
 	
-	table_type_ = EidosSymbolTableType::kINVALID_TABLE_TYPE;
+	if (table_type_ == EidosSymbolTableType::kEidosDefinedConstantsTable)
+		gEidosDefinedConstantsEpoch++;
 	
-	// slots_ may have symbols defined in it, so we need to zero out the used slots for re-use.  Remember that
-	// the slot at index 0 never has a value defined, and its next_ value is the start of the linked list.
-	EidosSymbolTableSlot *slot = slots_;
+	table_type_ = EidosSymbolTableType::kINVALID_TABLE_TYPE;
 	
-	for (uint32_t index = slot->next_; index != 0; index = slot->next_)
-	{
-		slot->next_ = 0;
-		slot = slots_ + index;
-		slot->symbol_value_SP_.reset();
-	}
+	// slots_ may have symbols defined in it, so we need to zero out the used slots for re-use
+	RemoveAllSymbols();
 	
 	// then return the table to the pools for reuse
 	FreeZeroedTableToPool(slots_, capacity_);
@@ -289,6 +287,28 @@ bool EidosSymbolTable::ContainsSymbol_IsConstant(EidosGlobalStringID p_symbol_na
 	return false;
 }
 
+EidosValue *EidosSymbolTable::GetValueRawForDefinedConstant(EidosGlobalStringID p_symbol_name) const
+{
+	// This follows ContainsSymbol(), but only the first table in the chain that defines the symbol counts
+	const EidosSymbolTable *current_table = this;
+	
+	do
+	{
+		if ((p_symbol_name < current_table->capacity_) && (current_table->slots_[p_symbol_name].symbol_value_SP_))
+		{
+			if ((current_table->table_type_ == EidosSymbolTableType::kEidosIntrinsicConstantsTable) || (current_table->table_type_ == EidosSymbolTableType::kEidosDefinedConstantsTable))
+				return current_table->slots_[p_symbol_name].symbol_value_SP_.get();
+			
+			return nullptr;
+		}
+		
+		current_table = current_table->chain_symbol_table_;
+	}
+	while (current_table);
+	
+	return nullptr;
+}
+
 bool EidosSymbolTable::SymbolDefinedAnywhere(EidosGlobalStringID p_symbol_name) const
 {
 	// This follows ContainsSymbol() but follows parent_symbol_table_ instead of chain_symbol_table_.
@@ -384,6 +404,56 @@ EidosValue_SP EidosSymbolTable::_GetValue_IsConst(EidosGlobalStringID p_symbol_n
 	EIDOS_TERMINATION << "ERROR (EidosSymbolTable::_GetValue_IsConst): undefined identifier " << EidosStringRegistry::StringForGlobalStringID(p_symbol_name) << "." << EidosTerminate(p_symbol_token);
 }
 
+EidosValue_SP EidosSymbolTable::_GetValueForModification(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token)
+{
+	// This follows _GetValue(), but first gives the slot a private copy of its value if the value is shared with anybody
+	// else, so that the caller can modify it in place; this is the "copy" half of copy-on-write.  Singletons are never
+	// shared by SetValueForSymbol(), and the caller handles them specially anyway, so we leave them alone.  Note that the
+	// caller must not hold its own reference to the value when calling this, or the value will always look shared.
+	EidosSymbolTable *current_table = this;
+	
+	do
+	{
+		// try the current table, if the symbol is within its capacity
+		if (p_symbol_name < current_table->capacity_)
+		{
+			EidosValue_SP &slot_value = current_table->slots_[p_symbol_name].symbol_value_SP_;
+			
+			if (slot_value)
+			{
+				if (!slot_value->IsSingleton() && (slot_value->UseCount() > 1))
+					slot_value = slot_value->CopyValues();
+				
+				// a defined constant is being changed, so anything folded from it is now stale
+				if (current_table->table_type_ == EidosSymbolTableType::kEidosDefinedConstantsTable)
+					gEidosDefinedConstantsEpoch++;
+				
+				return slot_value;
+			}
+		}
+		
+		// We didn't get a hit, so try our chained table
+		current_table = current_table->chain_symbol_table_;
+	}
+	while (current_table);
+	
+	EIDOS_TERMINATION << "ERROR (EidosSymbolTable::_GetValueForModification): undefined identifier " << EidosStringRegistry::StringForGlobalStringID(p_symbol_name) << "." << EidosTerminate(p_symbol_token);
+}
+
+void EidosSymbolTable::RemoveAllSymbols(void)
+{
+	// Zero out the used slots by walking the linked list; this is O(n) in the number of defined symbols, not in capacity_.
+	// Remember that the slot at index 0 never has a value defined, and its next_ value is the start of the linked list.
+	EidosSymbolTableSlot *slot = slots_;
+	
+	for (uint32_t index = slot->next_; index != 0; index = slot->next_)
+	{
+		slot->next_ = 0;
+		slot = slots_ + index;
+		slot->symbol_value_SP_.reset();
+	}
+}
+
 void EidosSymbolTable::_ResizeToFitSymbol(EidosGlobalStringID p_symbol_name)
 {
 	uint32_t new_capacity = capacity_;
@@ -409,10 +479,12 @@ void EidosSymbolTable::_ResizeToFitSymbol(EidosGlobalStringID p_symbol_name)
 
 void EidosSymbolTable::SetValueForSymbol(EidosGlobalStringID p_symbol_name, EidosValue_SP p_value)
 {
-	// If we have the only reference to the value, we don't need to copy it; otherwise we copy, since we don't want to hold
-	// onto a reference that somebody else might modify under us (or that we might modify under them, with syntaxes like
-	// x[2]=...; and x=x+1;). If the value is invisible then we copy it, since the symbol table never stores invisible values.
-	if ((p_value->UseCount() != 1) || p_value->Invisible())
+	// If we have the only reference to the value, we don't need to copy it.  Otherwise, non-singleton values are shared
+	// copy-on-write: syntaxes that modify a variable in place, like x[2]=...; and x=x+1;, fetch it with
+	// GetValueForModificationOrRaiseForASTNode(), which makes a private copy first if the value is shared.  Singletons
+	// are cheap to copy, so we still copy them, as we do values that their owner munges in place (see Shareable()).
+	// If the value is invisible then we copy it, since the symbol table never stores invisible values.
+	if (_ValueMustBeCopied(p_value.get()))
 		p_value = p_value->CopyValues();
 	
 	// Make sure we have capacity
@@ -529,10 +601,8 @@ void EidosSymbolTable::DefineConstantForSymbol(EidosGlobalStringID p_symbol_name
 				patchTable->chain_symbol_table_ = definedConstantsTable;
 	}
 	
-	// If we have the only reference to the value, we don't need to copy it; otherwise we copy, since we don't want to hold
-	// onto a reference that somebody else might modify under us (or that we might modify under them, with syntaxes like
-	// x[2]=...; and x=x+1;). If the value is invisible then we copy it, since the symbol table never stores invisible values.
-	if ((p_value->UseCount() != 1) || p_value->Invisible())
+	// Share or copy the value as in SetValueForSymbol()
+	if (_ValueMustBeCopied(p_value.get()))
 		p_value = p_value->CopyValues();
 	
 	// Then ask the defined constants table to add the constant
@@ -550,10 +620,8 @@ void EidosSymbolTable::DefineGlobalForSymbol(EidosGlobalStringID p_symbol_name,
 	if (!global_variables_table)
 		EIDOS_TERMINATION << "ERROR (EidosSymbolTable::DefineGlobalForSymbol): (internal error) a global variables symbol table does not exist." << EidosTerminate(nullptr);
 	
-	// If we have the only reference to the value, we don't need to copy it; otherwise we copy, since we don't want to hold
-	// onto a reference that somebody else might modify under us (or that we might modify under them, with syntaxes like
-	// x[2]=...; and x=x+1;). If the value is invisible then we copy it, since the symbol table never stores invisible values.
-	if ((p_value->UseCount() != 1) || p_value->Invisible())
+	// Share or copy the value as in SetValueForSymbol()
+	if (_ValueMustBeCopied(p_value.get()))
 		p_value = p_value->CopyValues();
 	
 	// Make sure we have capacity; note this acts on global_variables_table, not this
@@ -602,6 +670,9 @@ void EidosSymbolTable::_RemoveSymbol(EidosGlobalStringID p_symbol_name, bool p_r
 			
 			slot->symbol_value_SP_.reset();
 			
+			if (table_type_ == EidosSymbolTableType::kEidosDefinedConstantsTable)
+				gEidosDefinedConstantsEpoch++;
+			
 			// Now we need to fix the linked list, which is O(n): we have to find the previous entry that points to this entry
 			EidosGlobalStringID index = 0;
 			
@@ -59,6 +59,11 @@ class EidosTypeTable;
 // This is a shared global symbol table containing the standard Eidos constants; it should be linked to as a parent symbol table
 extern EidosSymbolTable *gEidosConstantsSymbolTable;
 
+// Incremented whenever a constant defined with defineConstant() might change its value, which happens only when a defined
+// constants table is created or destroyed, or a defined constant is removed with rm(); values folded from defined constants
+// by EidosInterpreter::Evaluate_Folded() are valid only as long as this does not change
+extern uint32_t gEidosDefinedConstantsEpoch;
+
 
 // This is used by InitializeConstantSymbolEntry / ReinitializeConstantSymbolEntry for fast setup / teardown
 typedef std::pair<EidosGlobalStringID, EidosValue_SP> EidosSymbolTableEntry;
@@ -140,10 +145,14 @@ private:
 	EidosValue_SP _GetValue(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token) const;
 	EidosValue *_GetValue_RAW(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token) const;
 	EidosValue_SP _GetValue_IsConst(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token, bool *p_is_const) const;
+	EidosValue_SP _GetValueForModification(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token);
 	void _RemoveSymbol(EidosGlobalStringID p_symbol_name, bool p_remove_constant);
 	void _InitializeConstantSymbolEntry(EidosGlobalStringID p_symbol_name, EidosValue_SP p_value);
 	void _ResizeToFitSymbol(EidosGlobalStringID p_symbol_name);
 	
+	// Values put into the table are shared copy-on-write when possible; this decides when a copy must be made up front instead
+	static inline __attribute__((always_inline)) bool _ValueMustBeCopied(const EidosValue *p_value) { return p_value->Invisible() || ((p_value->UseCount() != 1) && (p_value->IsSingleton() || !p_value->Shareable())); }
+	
 public:
 	
 	EidosSymbolTable(const EidosSymbolTable&) = delete;													// no copying
@@ -162,6 +171,10 @@ public:
 	bool ContainsSymbol_IsConstant(EidosGlobalStringID p_symbol_name, bool *p_is_const) const;
 	bool SymbolDefinedAnywhere(EidosGlobalStringID p_symbol_name) const;
 	
+	// Get a value if the symbol is an intrinsic Eidos constant or a defined constant, as seen from this table; returns nullptr if the
+	// symbol is undefined, or is defined in any other kind of table, such as a Context constants table or a variables table
+	EidosValue *GetValueRawForDefinedConstant(EidosGlobalStringID p_symbol_name) const;
+	
 	// Set as a variable (raises if already defined as a constant); the NoCopy version is *not* what you want, almost certainly (see it for comments)
 	void SetValueForSymbol(EidosGlobalStringID p_symbol_name, EidosValue_SP p_value);
 	void SetValueForSymbolNoCopy(EidosGlobalStringID p_symbol_name, EidosValue_SP p_value);
@@ -176,6 +189,10 @@ public:
 	inline __attribute__((always_inline)) void RemoveValueForSymbol(EidosGlobalStringID p_symbol_name) { _RemoveSymbol(p_symbol_name, false); }
 	inline __attribute__((always_inline)) void RemoveConstantForSymbol(EidosGlobalStringID p_symbol_name) { _RemoveSymbol(p_symbol_name, true); }
 	
+	// Remove all symbols, constant or not, leaving the table empty but keeping its lookup table for reuse; this is for clients
+	// that keep a table alive across many short-lived uses, such as SLiM's callback frames, instead of constructing a new one
+	void RemoveAllSymbols(void);
+	
 	// Get a value, with an optional token used if the call raises due to an undefined symbol
 	inline __attribute__((always_inline)) EidosValue_SP GetValueOrRaiseForASTNode(const EidosASTNode *p_symbol_node) const { return _GetValue(p_symbol_node->cached_stringID_, p_symbol_node->token_); }
 	inline __attribute__((always_inline)) EidosValue_SP GetValueOrRaiseForSymbol(EidosGlobalStringID p_symbol_name) const { return _GetValue(p_symbol_name, nullptr); }
@@ -189,6 +206,10 @@ public:
 	inline __attribute__((always_inline)) EidosValue_SP GetValueOrRaiseForASTNode_IsConst(const EidosASTNode *p_symbol_node, bool *p_is_const) const { return _GetValue_IsConst(p_symbol_node->cached_stringID_, p_symbol_node->token_, p_is_const); }
 	inline __attribute__((always_inline)) EidosValue_SP GetValueOrRaiseForSymbol_IsConst(EidosGlobalStringID p_symbol_name, bool *p_is_const) const { return _GetValue_IsConst(p_symbol_name, nullptr, p_is_const); }
 	
+	// Get a value that the caller is about to modify in place, such as the base of a subscripted assignment; if the value is
+	// shared with anybody else (see SetValueForSymbol()), it is first replaced by a private copy in the table that defines it
+	inline __attribute__((always_inline)) EidosValue_SP GetValueForModificationOrRaiseForASTNode(const EidosASTNode *p_symbol_node) { return _GetValueForModification(p_symbol_node->cached_stringID_, p_symbol_node->token_); }
+	
 	// Special-purpose methods used for fast setup of new symbol tables with constants.
 	//
 	// These methods assume (1) that the name string is a global constant that does not need to be copied and
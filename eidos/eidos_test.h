@@ -33,6 +33,7 @@
 
 
 int RunEidosTests(void);
+int RunEidosBenchmarks(void);
 
 
 // Can turn on escape sequences to color test output; at present we turn these on for the command-line
@@ -69,6 +70,9 @@ extern void EidosAssertScriptSuccess_SV(const std::string &p_script_string, std:
 
 extern void EidosAssertScriptRaise(const std::string &p_script_string, const int p_bad_position, const char *p_reason_snip);
 
+// For checks of internal C++ machinery that cannot be reached from script; p_description is logged on failure
+extern void EidosAssertCondition(bool p_condition, const std::string &p_description);
+
 
 // Test subfunction prototypes
 extern void _RunLiteralsIdentifiersAndTokenizationTests(void);
@@ -97,6 +101,9 @@ extern void _RunOperatorLogicalAndTests(void);
 extern void _RunOperatorLogicalOrTests(void);
 extern void _RunOperatorLogicalNotTests(void);
 extern void _RunOperatorTernaryConditionalTests(void);
+extern void _RunOperatorScalarBytecodeTests(void);
+extern void _RunOperatorVectorFusionTests(void);
+extern void _RunOperatorConstantFoldingTests(void);
 extern void _RunKeywordIfTests(void);
 extern void _RunKeywordDoTests(void);
 extern void _RunKeywordWhileTests(void);
@@ -129,6 +136,7 @@ extern void _RunClassTests(std::string temp_path);
 extern void _RunCodeExampleTests(void);
 extern void _RunUserDefinedFunctionTests(void);
 extern void _RunVoidEidosValueTests(void);
+extern void _RunParallelBuiltinTests(void);
 
 
 #endif /* defined(__Eidos__eidos_test__) */
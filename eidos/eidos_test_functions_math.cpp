@@ -48,6 +48,10 @@ void _RunFunctionMathTests_a_through_f(void)
 	EidosAssertScriptRaise("abs(c(17, -9223372036854775807 - 1));", 0, "most negative integer");
 	EidosAssertScriptSuccess("abs(NAN);", gStaticEidosValue_FloatNAN);
 	EidosAssertScriptSuccess_FV("abs(c(-2.0, 7.0, -18.0, NAN, 12.0));", {2, 7, 18, std::numeric_limits<double>::quiet_NaN(), 12});
+	EidosAssertScriptRaise("abs(c(rep(-3, 37), -9223372036854775807 - 1, 5));", 0, "most negative integer");
+	EidosAssertScriptSuccess_L("identical(abs(-(1:37)), 1:37);", true);
+	EidosAssertScriptSuccess_L("identical(abs((-18:18) * 1.5), abs(-18:18) * 1.5);", true);
+	EidosAssertScriptSuccess_L("all(1 / abs(rep(-0.0, 7)) == INF);", true);
 	
 	EidosAssertScriptSuccess_L("identical(abs(matrix(5)), matrix(5));", true);
 	EidosAssertScriptSuccess_L("identical(abs(matrix(-5)), matrix(5));", true);
@@ -239,9 +243,13 @@ void _RunFunctionMathTests_a_through_f(void)
 	EidosAssertScriptRaise("-9223372036854775807 - 2;", 21, "subtraction overflow");
 	EidosAssertScriptRaise("cumSum(c(-9223372036854775807, -1, -1));", 0, "addition overflow");
 	EidosAssertScriptRaise("cumSum(c(9223372036854775807, 1, 1));", 0, "addition overflow");
+	EidosAssertScriptRaise("cumSum(c(rep(1, 300), 9223372036854775807));", 0, "addition overflow");
+	EidosAssertScriptRaise("cumSum(c(rep(4611686018427387904, 2), rep(0, 300)));", 0, "addition overflow");
 #endif
 	EidosAssertScriptSuccess_FV("cumSum(c(5, 5, 3.0, NAN, 2.0));", {5.0, 10.0, 13.0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()});
 	
+	EidosAssertScriptSuccess_L("identical(cumSum(rep(2, 600)), seq(2, 1200, by=2));", true);
+	EidosAssertScriptSuccess_L("identical(cumSum(c(4611686018427387904, rep(1, 300))), 4611686018427387904 + (0:300));", true);
 	EidosAssertScriptSuccess_L("identical(cumSum(matrix(0.5)), matrix(cumSum(0.5)));", true);
 	EidosAssertScriptSuccess_L("identical(cumSum(matrix(c(0.1, 0.2, 0.3))), matrix(cumSum(c(0.1, 0.2, 0.3))));", true);
 	
@@ -1089,6 +1097,8 @@ void _RunFunctionMathTests_s_through_z(void)
 	EidosAssertScriptRaise("sqrt(string(0));", 0, "cannot be type");
 	EidosAssertScriptSuccess("sqrt(NAN);", gStaticEidosValue_FloatNAN);
 	EidosAssertScriptSuccess_FV("sqrt(c(64, NAN, 9));", {8, std::numeric_limits<double>::quiet_NaN(), 3});
+	EidosAssertScriptSuccess_L("identical(sqrt((0:40)^2), asFloat(0:40));", true);
+	EidosAssertScriptSuccess_L("identical(sqrt(c(0:40) * c(0:40)), asFloat(0:40));", true);
 	
 	EidosAssertScriptSuccess_L("identical(sqrt(matrix(0.5)), matrix(sqrt(0.5)));", true);
 	EidosAssertScriptSuccess_L("identical(sqrt(matrix(c(0.1, 0.2, 0.3))), matrix(sqrt(c(0.1, 0.2, 0.3))));", true);
@@ -1100,12 +1110,19 @@ void _RunFunctionMathTests_s_through_z(void)
 	EidosAssertScriptSuccess_I("sum(c(200000000, 3000000000000));", 3000200000000);
 #if EIDOS_HAS_OVERFLOW_BUILTINS
 	EidosAssertScriptSuccess_F("sum(rep(3000000000000000000, 100));", 3e20);
+	EidosAssertScriptSuccess_L("isFloat(sum(c(rep(9223372036854775807, 3), rep(1, 300))));", true);
+	EidosAssertScriptSuccess_L("isFloat(sum(c(9223372036854775807, 1, -1)));", true);
+	EidosAssertScriptSuccess_I("sum(c(4611686018427387904, rep(1, 600)));", 4611686018427388504);
+	EidosAssertScriptSuccess_I("sum(c(rep(1, 600), 4611686018427387904, -4611686018427387904));", 600);
 #endif
 	EidosAssertScriptSuccess_F("sum(5.5);", 5.5);
 	EidosAssertScriptSuccess_F("sum(-5.5);", -5.5);
 	EidosAssertScriptSuccess_F("sum(c(-2.5, 7.5, -18.5, 12.5));", -1);
 	EidosAssertScriptSuccess("sum(T);", gStaticEidosValue_Integer1);
 	EidosAssertScriptSuccess_I("sum(c(T,F,T,F,T,T,T,F));", 5);
+	EidosAssertScriptSuccess_I("sum(1:1000);", 500500);
+	EidosAssertScriptSuccess_I("sum(-1000:999);", -1000);
+	EidosAssertScriptSuccess_I("sum(rep(c(T,F,T), 101));", 202);
 	EidosAssertScriptRaise("sum('foo');", 0, "cannot be type");
 	EidosAssertScriptRaise("sum(_Test(7));", 0, "cannot be type");
 	EidosAssertScriptRaise("sum(NULL);", 0, "cannot be type");
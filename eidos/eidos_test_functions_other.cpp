@@ -19,6 +19,7 @@
 
 
 #include "eidos_test.h"
+#include "eidos_parallel.h"
 
 #include <string>
 #include <vector>
@@ -288,8 +289,30 @@ void _RunFunctionFilesystemTests(std::string temp_path)
 	// writeFile() and writeTempFile() with compression – we don't decompress to verify, but we check for success and file existence
 	EidosAssertScriptSuccess_L("writeFile('" + temp_path + "/EidosTest.txt', c(paste(0:4), paste(5:9)), compress=T);", true);
 	EidosAssertScriptSuccess_L("fileExists('" + temp_path + "/EidosTest.txt.gz');", true);
+	EidosAssertScriptSuccess_L("p = '" + temp_path + "/EidosTestAppend.txt.gz'; writeFile(p, 'a', compress=T); writeFile(p, 'b', append=T, compress=T); writeFile(p, 'c', append=T, compress=T); deleteFile(p) & !fileExists(p);", true);		// deleteFile() finishes the buffered gzip stream first
 	EidosAssertScriptSuccess_L("file = writeTempFile('eidos_test_', '.txt', 'foo'); fileExists(file);", true);
 	
+	// compressed appends with a forced flush, as done by LogFile, must leave a complete gzip file on disk after each flush
+	{
+		std::string path = temp_path + "/EidosTestForceFlush.txt.gz";
+		std::string header("header"), row1("row1"), row2("row2"), row3("row3"), row4("row4");
+		std::string file_data, text;
+		
+		Eidos_WriteToFile(path, {&header}, false, true, EidosFileFlush::kDefaultFlush);
+		Eidos_WriteToFile(path, {&row1}, true, true, EidosFileFlush::kDefaultFlush);
+		Eidos_WriteToFile(path, {&row2}, true, true, EidosFileFlush::kForceFlush);
+		
+		EidosAssertCondition(Eidos_ReadFileContents(path, file_data) && Eidos_GunzipContents(file_data.data(), file_data.size(), text) && (text == "header\nrow1\nrow2\n"), "gzip file complete after first forced flush");
+		
+		Eidos_WriteToFile(path, {&row3}, true, true, EidosFileFlush::kDefaultFlush);
+		Eidos_WriteToFile(path, {&row4}, true, true, EidosFileFlush::kForceFlush);
+		text.clear();
+		
+		EidosAssertCondition(Eidos_ReadFileContents(path, file_data) && Eidos_GunzipContents(file_data.data(), file_data.size(), text) && (text == "header\nrow1\nrow2\nrow3\nrow4\n"), "gzip file complete after second forced flush");
+		
+		Eidos_FlushFile(path);
+	}
+	
 	// createDirectory() – we rely on writeTempFile() to give us a file path that isn't in use, from which we derive a directory path that also shouldn't be in use
 	EidosAssertScriptSuccess_L("file = writeTempFile('eidos_test_dir', '.txt', ''); dir = substr(file, 0, nchar(file) - 5); createDirectory(dir);", true);
 	
@@ -1294,6 +1317,7 @@ void _RunClassTests(std::string temp_path)
 			EidosAssertScriptSuccess_L("x = Dictionary('a', 3:6, 'b', c(121,131,141,141141)); file = writeTempFile('eidos_test_', '.csv', x.serialize('csv')); y = readCSV(file, quote='1'); Dictionary('\"a\"', 3:6, '\"b\"', c(2:4, 414)).identicalContents(y);", true);
 			EidosAssertScriptSuccess_L("x = Dictionary('b', c('10$25', '10$0', '10$')); file = writeTempFile('eidos_test_', '.csv', x.serialize('csv')); y = readCSV(file, dec='$'); Dictionary('b', c(10.25, 10, 10)).identicalContents(y);", true);
 			EidosAssertScriptSuccess_L("x = Dictionary('a', c('foo', 'bar'), 'b', c(10.5, 10.25)); file = writeTempFile('eidos_test_', '.csv', x.serialize('csv')); y = readCSV(file, dec='$', comment='.'); Dictionary('a', c('foo', 'bar'), 'b', c(10, 10)).identicalContents(y);", true);
+			EidosAssertScriptSuccess_L("file = writeTempFile('eidos_test_', '.csv', c('a,b', '\"x\"\"y\",-inf', '\"p', 'q\",1e3', ',NaN')); y = readCSV(file); identical(y.getValue('a'), c('x\"y', 'p\\nq', '')) & identical(y.getValue('b')[0:1], c(-INF, 1000.0)) & isNAN(y.getValue('b')[2]);", true);
 		}
 	}
 	
@@ -1690,6 +1714,36 @@ void _RunVoidEidosValueTests(void)
 	EidosAssertScriptRaise("for (x in citation()) T;", 0, "does not allow void");
 }
 
+#pragma mark parallel builtins
+void _RunParallelBuiltinTests(void)
+{
+	// builtins that split large vectors across threads must give exactly the serial result, including for random draws;
+	// we force every vector onto the parallel path, and compare against computations that do not use it
+	int saved_max_threads = gEidosMaxThreads;
+	int64_t saved_threshold = gEidosParallelThreshold;
+	
+	Eidos_SetMaxThreads(4);
+	Eidos_SetParallelThreshold(0);
+	
+	std::string setup = "setSeed(17); x = runif(1001, -5, 50); n = rdunif(1001, -3, 40); s = asString(rdunif(1001, 0, 300)); ";
+	
+	EidosAssertScriptSuccess_L(setup + "identical(exp(x), sapply(x, 'exp(applyValue);')) & identical(exp(n), sapply(n, 'exp(applyValue);'));", true);
+	EidosAssertScriptSuccess_L(setup + "identical(log(x), sapply(x, 'log(applyValue);')) & identical(log(n), sapply(n, 'log(applyValue);'));", true);
+	EidosAssertScriptSuccess_L(setup + "identical(sqrt(x), sapply(x, 'sqrt(applyValue);')) & identical(sqrt(n), sapply(n, 'sqrt(applyValue);'));", true);
+	EidosAssertScriptSuccess_L(setup + "l = x > 20; identical(which(l), (0:1000)[l]) & identical(which(x > 1e6), integer(0)) & identical(which(x < 1e6), 0:1000);", true);
+	EidosAssertScriptSuccess_L(setup + "t = rdunif(50, 0, 60); identical(match(n, t), sapply(n, 'match(applyValue, t);'));", true);
+	EidosAssertScriptSuccess_L(setup + "t = c(x[0:99], 7.5); y = c(x[500:1000], NAN, 7.5, 8.5); identical(match(y, t), sapply(y, 'match(applyValue, t);'));", true);
+	EidosAssertScriptSuccess_L(setup + "t = unique(s[0:200]); identical(match(s, t), sapply(s, 'match(applyValue, t);'));", true);
+	EidosAssertScriptSuccess_L(setup + "identical(tabulate(n), sapply(0:max(n), 'sum(n == applyValue);')) & identical(tabulate(n, 10), sapply(0:10, 'sum(n == applyValue);'));", true);
+	EidosAssertScriptSuccess_L(setup + "a = sort(n); all(a[1:1000] >= a[0:999]) & identical(a, n[order(n)]) & identical(sort(n, F), rev(a));", true);
+	EidosAssertScriptSuccess_L(setup + "a = sort(s); all(a[1:1000] >= a[0:999]) & identical(a, s[order(s)]) & identical(sort(s, F), rev(a));", true);
+	EidosAssertScriptSuccess_L(setup + "w = abs(x); setSeed(5); a = sample(0:1000, 2000, T, w); setSeed(5); b = sapply(1:2000, 'sample(0:1000, 1, T, w);'); identical(a, b);", true);
+	EidosAssertScriptSuccess_L(setup + "w = abs(n); setSeed(5); a = sample(s, 2000, T, w); setSeed(5); b = sapply(1:2000, 'sample(s, 1, T, w);'); identical(a, b);", true);
+	
+	gEidosMaxThreads = saved_max_threads;
+	gEidosParallelThreshold = saved_threshold;
+}
+
 
 
 
@@ -128,6 +128,8 @@ void _RunFunctionStatisticsTests_a_through_p(void)
 	EidosAssertScriptRaise("mean(string(0));", 0, "cannot be type");
 	EidosAssertScriptSuccess_F("mean(rep(1e18, 9));", 1e18);	// stays in integer internally
 	EidosAssertScriptSuccess_F("mean(rep(1e18, 10));", 1e18);	// overflows to float internally
+	EidosAssertScriptSuccess_F("mean(-1000:999);", -0.5);
+	EidosAssertScriptSuccess_F("mean(rep(c(T,F,T,T), 100));", 0.75);
 	EidosAssertScriptSuccess("mean(c(1.0, 5.0, NAN, 2.0));", gStaticEidosValue_FloatNAN);
 	
 	// min()
@@ -259,6 +261,11 @@ void _RunFunctionStatisticsTests_a_through_p(void)
 	EidosAssertScriptSuccess_S("pmin('xyzzy', 'xyzzy');", "xyzzy");
 	EidosAssertScriptSuccess("pmin('', 'bar');", gStaticEidosValue_StringEmpty);
 	EidosAssertScriptSuccess_SV("pmin(c('foo','bar','xyzzy',''), c('bar','baz','xyzzy','bar'));", {"bar", "bar", "xyzzy", ""});
+	EidosAssertScriptSuccess_LV("isNAN(pmin(c(1.0, 5, NAN, 7, 2), 3.0));", {false, false, true, false, false});
+	EidosAssertScriptSuccess_LV("isNAN(pmax(c(1.0, NAN, 3, 4, 5), c(2.0, 2, NAN, 1, NAN)));", {false, true, true, false, true});
+	EidosAssertScriptSuccess_FV("1 / pmax(c(-0.0, 0.0, -0.0, 0.0), c(0.0, -0.0, -0.0, 0.0));", {-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()});
+	EidosAssertScriptSuccess_FV("1 / pmin(c(-0.0, 0.0, -0.0, 0.0), c(0.0, -0.0, -0.0, 0.0));", {-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()});
+	EidosAssertScriptSuccess_L("identical(pmax((1:37) * 1.0, 19.0), c(rep(19.0, 19), 20.0:37));", true);
 	
 	EidosAssertScriptSuccess_LV("pmin(F, c(T,T,F,F));", {false, false, false, false});
 	EidosAssertScriptSuccess_LV("pmin(c(T,F,T,F), T);", {true, false, true, false});
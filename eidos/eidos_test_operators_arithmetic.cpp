@@ -387,6 +387,15 @@ void _RunOperatorPlusTests2(void)
 	EidosAssertScriptRaise("identical(array(1:6,c(1,3,2)) + array(1:6,c(3,2,1)), array(2:7, c(1,3,2)));", 30, "non-conformable");
 	EidosAssertScriptRaise("identical(array(1:6,c(2,1,3)) + array(1:6,c(3,2,1)), array(2:7, c(2,1,3)));", 30, "non-conformable");
 	EidosAssertScriptRaise("identical(array(1:6,c(1,2,3)) + array(1:6,c(3,2,1)), array(2:7, c(1,2,3)));", 30, "non-conformable");
+	
+	// operator +: singleton fast path, including reuse of temporary operands, which must never disturb a variable's value
+	EidosAssertScriptSuccess_IV("x = 5; y = abs(x) + 1; z = x + x; c(x, y, z);", {5, 6, 10});
+	EidosAssertScriptSuccess_FV("x = 2.5; y = 1 + abs(x); z = x + 1; c(x, y, z);", {2.5, 3.5, 3.5});
+	EidosAssertScriptSuccess_IV("x = 1:3; y = x[1] + x[2]; c(x, y);", {1, 2, 3, 5});
+	EidosAssertScriptSuccess_L("identical(matrix(5) + abs(2), matrix(7));", true);
+#if EIDOS_HAS_OVERFLOW_BUILTINS
+	EidosAssertScriptRaise("abs(9223372036854775807) + 1;", 25, "integer addition overflow");
+#endif
 }
 
 #pragma mark operator -
@@ -529,6 +538,13 @@ void _RunOperatorMultTests(void)
 	EidosAssertScriptRaise("identical(matrix(1:3) * matrix(2), matrix(c(2,4,6)));", 22, "non-conformable");
 	EidosAssertScriptRaise("identical(matrix(4:6,nrow=1) * matrix(1:3,ncol=1), matrix(c(4,10,18)));", 29, "non-conformable");
 	EidosAssertScriptSuccess_L("identical(matrix(6:8) * matrix(1:3), matrix(c(6,14,24)));", true);
+	
+	// operator *: singleton fast path, including reuse of temporary operands
+	EidosAssertScriptSuccess_FV("x = 3; y = 0.5; z = abs(x) * abs(y); c(x, y, z);", {3.0, 0.5, 1.5});
+	EidosAssertScriptSuccess_IV("x = 3; z = abs(x) * abs(x); c(x, z);", {3, 9});
+#if EIDOS_HAS_OVERFLOW_BUILTINS
+	EidosAssertScriptRaise("abs(5e18) * 2;", 10, "multiplication overflow");
+#endif
 }
 
 #pragma mark operator /
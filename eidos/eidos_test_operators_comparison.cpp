@@ -221,6 +221,20 @@ void _RunOperatorLtTests(void)
 	EidosAssertScriptRaise("identical(matrix(1:3) < matrix(2), matrix(c(T,F,F)));", 22, "non-conformable");
 	EidosAssertScriptRaise("identical(matrix(1:3,nrow=1) < matrix(3:1,ncol=1), matrix(c(T,F,F)));", 29, "non-conformable");
 	EidosAssertScriptSuccess_L("identical(matrix(1:3) < matrix(3:1), matrix(c(T,F,F)));", true);
+	
+	// operator <: singleton fast path with mixed int/float operands
+	EidosAssertScriptSuccess_L("x = 3; y = 3.5; x < y;", true);
+	EidosAssertScriptSuccess_L("x = 9007199254740993; y = 9007199254740992; y < x;", true);
+	EidosAssertScriptSuccess_L("x = 9007199254740993; y = 9007199254740992.0; y < x;", false);
+	EidosAssertScriptSuccess_L("x = NAN; abs(x) < 1 | abs(x) >= 1;", false);
+	
+	// operator <: vectorized int-to-int and float-to-float comparisons, including NAN and buffer tails
+	EidosAssertScriptSuccess_LV("c(1.0, NAN, 3, 4, 5) < 4.0;", {true, false, true, false, false});
+	EidosAssertScriptSuccess_LV("4.0 < c(1.0, NAN, 5, 4, 5);", {false, false, true, false, true});
+	EidosAssertScriptSuccess_LV("c(1.0, NAN, 3, 4, 5) < c(2.0, 1, NAN, 4, 6);", {true, false, false, false, true});
+	EidosAssertScriptSuccess_I("sum((1:37) < 19);", 18);
+	EidosAssertScriptSuccess_I("sum((1:37) * 1.0 < 19.5);", 19);
+	EidosAssertScriptSuccess_L("identical((1:37) < (37:1), c(rep(T, 18), rep(F, 19)));", true);
 }
 
 #pragma mark operator >=
@@ -623,6 +637,11 @@ void _RunOperatorNotEqTests(void)
 	EidosAssertScriptRaise("identical(matrix(1:3) != matrix(2), matrix(c(1.0,4,9)));", 22, "non-conformable");
 	EidosAssertScriptRaise("identical(matrix(2:4,nrow=1) != matrix(1:3,ncol=1), matrix(c(2.0,9,64)));", 29, "non-conformable");
 	EidosAssertScriptSuccess_L("identical(matrix(1:3) != matrix(3:1), matrix(c(T,F,T)));", true);
+	
+	// operator !=: vectorized comparisons with NAN, which is unequal to everything including itself
+	EidosAssertScriptSuccess_LV("c(1.0, NAN, 3, 4, 6) != c(1.0, NAN, 2, 4, 5);", {false, true, true, false, true});
+	EidosAssertScriptSuccess_LV("NAN != c(1.0, NAN, 3);", {true, true, true});
+	EidosAssertScriptSuccess_I("sum((1:37) != 19);", 36);
 }
 
 
@@ -19,6 +19,9 @@
 
 
 #include "eidos_test.h"
+#include "eidos_interpreter.h"
+#include "eidos_symbol_table.h"
+#include "eidos_class_TestElement.h"
 
 
 #pragma mark operator []
@@ -434,6 +437,22 @@ void _RunOperatorAssignTests(void)
 	EidosAssertScriptRaise("x = 5e18; x = x * 2;", 16, "multiplication overflow");
 	EidosAssertScriptRaise("x = c(5e18, 0); x = x * 2;", 22, "multiplication overflow");
 #endif
+	
+	// operator = (vectors are shared copy-on-write between variables, so modifying one must not affect the others)
+	EidosAssertScriptSuccess_IV("x = 1:5; y = x; y[0] = 9; x;", {1, 2, 3, 4, 5});
+	EidosAssertScriptSuccess_IV("x = 1:5; y = x; y[0] = 9; y;", {9, 2, 3, 4, 5});
+	EidosAssertScriptSuccess_IV("x = 1:5; y = x; x[4] = 9; y;", {1, 2, 3, 4, 5});
+	EidosAssertScriptSuccess_IV("x = 1:5; y = x; y = y + 1; x;", {1, 2, 3, 4, 5});
+	EidosAssertScriptSuccess_FV("x = c(1.5, 2.5); y = x; x = x * 2; c(x, y);", {3.0, 5.0, 1.5, 2.5});
+	EidosAssertScriptSuccess_L("x = c(T, F); y = x; y[1] = T; identical(x, c(T, F));", true);
+	EidosAssertScriptSuccess_IV("x = matrix(1:4, nrow=2); y = x; y[0, 0] = 9; x;", {1, 2, 3, 4});
+	EidosAssertScriptSuccess_IV("function (i)f(i x) { x[0] = 9; return x; } x = 1:3; y = f(x); c(x, y);", {1, 2, 3, 9, 2, 3});
+	EidosAssertScriptSuccess_IV("function (i)f(i x) { x = x + 1; return x; } x = 1:3; y = f(x); c(x, y);", {1, 2, 3, 2, 3, 4});
+	EidosAssertScriptSuccess_IV("x = 1:3; defineConstant('C', x); x[0] = 9; C;", {1, 2, 3});
+	EidosAssertScriptSuccess_IV("x = 1:3; defineGlobal('G', x); G[0] = 9; x;", {1, 2, 3});
+	EidosAssertScriptSuccess_IV("defineConstant('C', 1:3); x = 0; for (i in 1:2) { x = x + sum(C); C[0] = 10; } x;", {21});
+	EidosAssertScriptSuccess_LV("x = NULL; for (i in c(T, F)) x = c(x, i); x;", {true, false});
+	EidosAssertScriptSuccess_L("for (i in c(T, F)) { if (i) y = i; } y;", true);
 }
 
 #pragma mark operator &
@@ -739,6 +758,116 @@ void _RunOperatorTernaryConditionalTests(void)
 	// test right-associativity; this produces 2 if ? else is left-associative since the left half would then evaluate to 1, which is T
 	EidosAssertScriptSuccess_I("a = 0; a == 0 ? 1 else a == 1 ? 2 else 4;", 1);
 }
+
+#pragma mark scalar bytecode
+void _RunOperatorScalarBytecodeTests(void)
+{
+	// operator subtrees compiled to scalar bytecode; these must give exactly the same results and errors as the tree-walking evaluators
+	EidosAssertScriptSuccess_F("a = 3; b = 2.5; a + b * 2 - a % 2;", 7.0);
+	EidosAssertScriptSuccess_F("a = 3; a / 2 + a ^ 2;", 10.5);
+	EidosAssertScriptSuccess_F("a = 3; b = 2.5; -a + +b;", -0.5);
+	EidosAssertScriptSuccess_I("a = 3; c = 7; (a * c - 1) % 2 == 0 ? a * c + 1 else a - c;", 22);
+	EidosAssertScriptSuccess_L("a = 3; b = 2.5; l = T; a < b | l & !F;", true);
+	EidosAssertScriptSuccess_L("x = NAN; (x == x) | (x < 1.0) | (x >= 1.0);", false);
+	EidosAssertScriptSuccess_L("x = NAN; x != x;", true);
+	EidosAssertScriptSuccess_L("l = T; (l == 1) & (l < 2.5) & (F < T);", true);
+	EidosAssertScriptSuccess_I("x = _Test(7); x._yolk * 2 + 1;", 15);
+	EidosAssertScriptSuccess_IV("v = 1:3; a = 3; v + a * 2;", {7, 8, 9});
+	EidosAssertScriptSuccess_IV("m = matrix(5); dim(m + 1);", {1, 1});
+	EidosAssertScriptSuccess_IV("a = 3; v = 1:3; for (i in 1:40) y = v * i + a; y;", {43, 83, 123});
+	EidosAssertScriptSuccess_I("x = 0; for (i in 1:40) { v = (i % 2 == 0) ? i else 1:2; x = x + sum(v * 2 + 1); } x;", 1020);
+	EidosAssertScriptSuccess_I("x = -9223372036854775807 - 1; x + 0;", INT64_MIN);
+#if EIDOS_HAS_OVERFLOW_BUILTINS
+	EidosAssertScriptRaise("big = 9223372036854775807; big + 1;", 31, "integer addition overflow");
+	EidosAssertScriptRaise("x = -9223372036854775807 - 1; -x;", 30, "integer negation overflow");
+#endif
+	EidosAssertScriptRaise("l = T; l - undefinedThing;", 9, "operand type logical is not supported");
+	EidosAssertScriptRaise("a = 2; (a < 3) * undefinedThing;", 17, "undefined identifier");
+	EidosAssertScriptRaise("a = 2; (a < 3) * 5;", 15, "operand type logical is not supported");
+	
+	// property leaves evaluated before a bail are not evaluated again by the tree-walking evaluator
+	EidosTestElement::s_yolk_read_count_ = 0;
+	EidosAssertScriptSuccess_IV("x = _Test(7); y = c(_Test(1), _Test(2)); x._yolk + y._yolk * 2;", {9, 11});
+	EidosAssertCondition(EidosTestElement::s_yolk_read_count_ == 2, "property leaves read once when scalar bytecode bails");
+	EidosTestElement::s_yolk_read_count_ = 0;
+	EidosAssertScriptSuccess_IV("x = _Test(7); y = c(_Test(1), _Test(2)); y._yolk - x._increment._yolk;", {-7, -6});
+	EidosAssertCondition(EidosTestElement::s_yolk_read_count_ == 2, "property chain leaves read once when scalar bytecode bails");
+	EidosTestElement::s_yolk_read_count_ = 0;
+	EidosAssertScriptSuccess_FV("y = c(_Test(1), _Test(2)); m = matrix(c(1.0, 2.0)); c(y._yolk * 2.0 + m);", {3.0, 6.0});
+	EidosAssertCondition(EidosTestElement::s_yolk_read_count_ == 1, "property leaves read once when a fused expression bails");
+	EidosAssertScriptRaise("y = c(_Test(1), _Test(2)); y._yolk + undefinedThing;", 37, "undefined identifier");
+}
+
+#pragma mark constant folding
+void _RunOperatorConstantFoldingTests(void)
+{
+	// pure subtrees over constants are evaluated once and their value reused; this must be invisible except in speed
+	EidosAssertScriptSuccess_F("defineConstant('K', 3); x = 0; for (i in 1:10) x = x + K * 2 + exp(0.0); x;", 70.0);
+	EidosAssertScriptSuccess_I("function (i)f(void) { return K * 2 + sum(c(K, -1)); } defineConstant('K', 4); f() + f();", 22);
+	EidosAssertScriptSuccess_I("defineConstant('DEBUG', F); x = 0; for (i in 1:5) { if (!DEBUG) x = x + 2; else x = x + 1; } x;", 10);
+	EidosAssertScriptSuccess_IV("defineConstant('K', 1:3); x = integer(0); for (i in 1:3) { v = K * 2; x = c(x, v[0]); v[0] = 100; } x;", {2, 2, 2});
+	EidosAssertScriptSuccess_IV("defineConstant('K', 1:3); x = integer(0); for (i in 1:3) { v = rev(K); x = c(x, v[0]); v[0] = 100; } c(x, K);", {3, 3, 3, 1, 2, 3});
+	EidosAssertScriptSuccess_I("f = 0; for (i in 1:3) { defineConstant('K', i); f = f + K * 10; rm('K', removeConstants=T); } f;", 60);
+	EidosAssertScriptSuccess_I("f = 0; for (i in 1:3) { K = i; f = f + K * 10; rm('K'); } f;", 60);
+	EidosAssertScriptSuccess_S("defineConstant('S', 'a'); for (i in 1:3) x = paste(S, S + 'b', sep='-'); x;", "a-ab");
+	EidosAssertScriptRaise("for (i in 1:2) x = K * 2;", 19, "undefined identifier");
+	EidosAssertScriptRaise("defineConstant('K', 'a'); for (i in 1:2) x = K * 2;", 47, "is not supported by the '*' operator");
+	
+	// only small folded values are kept; a kept value is shared with the variable it is assigned to, which must then be copied on
+	// its first in-place modification, so a large vector must be left uniquely owned by the variable instead
+	{
+		EidosScript script("defineConstant('K', 3); small = rep(K, 4); large = rep(K, 1000); larger = seq(1, K * 1000);", -1);
+		EidosSymbolTable symbol_table(EidosSymbolTableType::kGlobalVariablesTable, gEidosConstantsSymbolTable);
+		EidosFunctionMap function_map(*EidosInterpreter::BuiltInFunctionMap());
+		
+		script.Tokenize();
+		script.ParseInterpreterBlockToAST(true);
+		
+		std::ostringstream black_hole;
+		EidosInterpreter interpreter(script, symbol_table, function_map, nullptr, black_hole, black_hole);
+		
+		interpreter.EvaluateInterpreterBlock(false, false);
+		
+		EidosValue *small = symbol_table.GetValueRawOrRaiseForSymbol(EidosStringRegistry::GlobalStringIDForString("small"));
+		EidosValue *large = symbol_table.GetValueRawOrRaiseForSymbol(EidosStringRegistry::GlobalStringIDForString("large"));
+		EidosValue *larger = symbol_table.GetValueRawOrRaiseForSymbol(EidosStringRegistry::GlobalStringIDForString("larger"));
+		
+		EidosAssertCondition(small->UseCount() == 2, "small folded vector shared with its folded constant");
+		EidosAssertCondition(large->UseCount() == 1, "large vector not kept by constant folding");
+		EidosAssertCondition(larger->UseCount() == 1, "large seq() result not kept by constant folding");
+		
+		symbol_table.RemoveAllSymbols();
+	}
+	EidosAssertScriptSuccess_I("defineConstant('K', 3); x = 0; for (i in 1:3) { v = rep(K, 1000); v[0] = i; x = x + sum(v); } x;", 8997);
+}
+
+#pragma mark vector fusion
+void _RunOperatorVectorFusionTests(void)
+{
+	// element-wise vector subtrees are evaluated in a single fused pass; this must be invisible except in speed, so we compare against the same computation done one operator at a time
+	std::string setup = "x = (1:1000) / 37.0; y = rev(x) - 3; n = 1:1000; mu = 0.3; sigma = 1.7; k = 5; ";
+	
+	EidosAssertScriptSuccess_L(setup + "a = x - mu; a = a^2; a = -a; b = 2 * sigma^2; a = a / b; a = exp(a); identical(exp(-(x - mu)^2 / (2 * sigma^2)), a);", true);
+	EidosAssertScriptSuccess_L(setup + "a = x * y; a = a + 1.5; identical(sum(x * y + 1.5), sum(a));", true);
+	EidosAssertScriptSuccess_L(setup + "a = x / y; a = a - n; identical(mean(x / y - n), mean(a));", true);
+	EidosAssertScriptSuccess_L(setup + "a = x * 2; b = y * y; identical(x * 2 > y * y, a > b);", true);
+	EidosAssertScriptSuccess_L(setup + "a = abs(y); a = sqrt(a); b = abs(x * y); b = log(b); identical(sqrt(abs(y)) + log(abs(x * y)), a + b);", true);
+	EidosAssertScriptSuccess_L(setup + "a = floor(y * 3); b = round(x); b = b * trunc(y); a = a - b; b = ceil(x / 3); identical(floor(y * 3) - round(x) * trunc(y) + ceil(x / 3), a + b);", true);
+	EidosAssertScriptSuccess_L(setup + "a = n * 2.5; a = a - k; identical(n * 2.5 - k, a);", true);
+	EidosAssertScriptSuccess_L(setup + "a = k + 1; a = x * a; identical(x * (k + 1) + 0.5, a + 0.5);", true);
+	EidosAssertScriptSuccess_L(setup + "a = x^2; a = -a; b = y^k; identical(-x^2 + y^k, a + b);", true);
+	EidosAssertScriptSuccess_L(setup + "z = n * 2 + k; isInteger(z) & identical(z, 2 * (1:1000) + 5);", true);
+	EidosAssertScriptSuccess_L(setup + "z = abs(-n) * 2; isInteger(z) & identical(z, n * 2);", true);
+	EidosAssertScriptSuccess_LV("x = c(1.0, NAN, 3.0); x * 2 == x * 2;", {true, false, true});
+	EidosAssertScriptSuccess_IV("x = matrix(1.0:4.0, nrow=2); dim(x * 2 + 1);", {2, 2});
+	EidosAssertScriptSuccess_F("x = 2.0; y = 3.0; x * y + x / 4;", 6.5);
+	EidosAssertScriptSuccess_FV("x = float(0); x * 2 + 1;", {});
+	EidosAssertScriptRaise("x = c(1.0, 2.0, 3.0); y = c(1.0, 2.0); x * 2 + y * 3;", 45, "requires that either");
+	EidosAssertScriptRaise("x = c(1.0, 2.0, 3.0); y = x * 2 + zz;", 34, "undefined identifier");
+	EidosAssertScriptRaise("x = c(1.0, 2.0, 3.0); y = exp(x) * 'a' + 1;", 33, "is not supported by the '*' operator");
+	EidosAssertScriptRaise("x = c(1.0, 2.0, 3.0); k = 5e18; y = x * (k * k) + 1;", 43, "multiplication overflow");
+	EidosAssertScriptRaise("n = 1:3; y = floor(n) * 2.0 + 1;", 13, "cannot be type integer");
+}
 	
 	// ************************************************************************************
 	//
@@ -21,6 +21,7 @@
 #include "eidos_functions.h"
 #include "eidos_call_signature.h"
 #include "eidos_property_signature.h"
+#include "eidos_parallel.h"
 #include "json.hpp"
 
 #include <algorithm>
@@ -319,7 +320,7 @@ int EidosValue::valueTrackingCount;
 std::vector<EidosValue *> EidosValue::valueTrackingVector;
 #endif
 
-EidosValue::EidosValue(EidosValueType p_value_type, bool p_singleton) : intrusive_ref_count_(0), cached_type_(p_value_type), invisible_(false), is_singleton_(p_singleton), dim_(nullptr)
+EidosValue::EidosValue(EidosValueType p_value_type, bool p_singleton) : intrusive_ref_count_(0), cached_type_(p_value_type), invisible_(false), is_singleton_(p_singleton), unshareable_(false), dim_(nullptr)
 {
 #ifdef EIDOS_TRACK_VALUE_ALLOCATION
 	valueTrackingCount++;
@@ -1396,10 +1397,11 @@ void EidosValue_String_vector::PushValueFromIndexOfEidosValue(int p_idx, const E
 
 void EidosValue_String_vector::Sort(bool p_ascending)
 {
+	// equal strings are indistinguishable, so a parallel sort gives the same result as std::sort()
 	if (p_ascending)
-		std::sort(values_.begin(), values_.end());
+		Eidos_ParallelSort(values_.data(), (int64_t)values_.size(), std::less<std::string>());
 	else
-		std::sort(values_.begin(), values_.end(), std::greater<std::string>());
+		Eidos_ParallelSort(values_.data(), (int64_t)values_.size(), std::greater<std::string>());
 }
 
 
@@ -1657,10 +1659,11 @@ void EidosValue_Int_vector::PushValueFromIndexOfEidosValue(int p_idx, const Eido
 
 void EidosValue_Int_vector::Sort(bool p_ascending)
 {
+	// equal integers are indistinguishable, so a parallel sort gives the same result as std::sort()
 	if (p_ascending)
-		std::sort(values_, values_ + count_);
+		Eidos_ParallelSort(values_, (int64_t)count_, std::less<int64_t>());
 	else
-		std::sort(values_, values_ + count_, std::greater<int64_t>());
+		Eidos_ParallelSort(values_, (int64_t)count_, std::greater<int64_t>());
 }
 
 EidosValue_Int_vector *EidosValue_Int_vector::reserve(size_t p_reserved_size)
@@ -159,6 +159,7 @@ protected:
 	uint8_t invisible_;										// as in R; if true, the value will not normally be printed to the console
 	uint8_t is_singleton_;									// allows Count() and IsSingleton() to be inline; cached at construction
 	uint8_t registered_for_patching_;						// used by EidosValue_Object, otherwise UNINITIALIZED; declared here for reasons of memory packing
+	uint8_t unshareable_;									// if true, the owner munges this value in place, so symbol tables must copy it rather than share it
 	
 	int64_t *dim_;											// nullptr for vectors; points to a malloced, OWNED array of dimensions for matrices and arrays
 															//    when allocated, the first value in the buffer is a count of the dimensions that follow
@@ -191,6 +192,12 @@ public:
 	inline __attribute__((always_inline)) bool Invisible(void) const							{ return invisible_; }
 	inline __attribute__((always_inline)) void SetInvisible(bool p_invisible)					{ invisible_ = p_invisible; }
 	
+	// copy-on-write sharing; symbol tables share non-singleton values rather than copying them, and copy only when a shared value is
+	// about to be modified in place (see EidosSymbolTable::GetValueForModificationOrRaiseForASTNode()).  Values that their owner
+	// munges in place from outside the symbol table, such as for loop index values and stack-allocated values, must not be shared.
+	inline __attribute__((always_inline)) bool Shareable(void) const							{ return !unshareable_; }
+	inline __attribute__((always_inline)) void MarkUnshareable(void)							{ unshareable_ = true; }
+	
 	// basic subscript access; abstract here since we want to force subclasses to define this
 	virtual EidosValue_SP GetValueAtIndex(const int p_idx, const EidosToken *p_blame_token) const = 0;
 	virtual void SetValueAtIndex(const int p_idx, const EidosValue &p_value, const EidosToken *p_blame_token) = 0;
@@ -280,7 +287,7 @@ public:
 	
 	// Eidos_intrusive_ptr support; we use Eidos_intrusive_ptr as a fast smart pointer to EidosValue.
 	inline __attribute__((always_inline)) uint32_t UseCount() const { return intrusive_ref_count_; }
-	inline __attribute__((always_inline)) void StackAllocated() { intrusive_ref_count_++; }			// used with stack-allocated EidosValues that have to be put under Eidos_intrusive_ptr
+	inline __attribute__((always_inline)) void StackAllocated() { intrusive_ref_count_++; unshareable_ = true; }			// used with stack-allocated EidosValues that have to be put under Eidos_intrusive_ptr
 	
 	friend void Eidos_intrusive_ptr_add_ref(const EidosValue *p_value);
 	friend void Eidos_intrusive_ptr_release(const EidosValue *p_value);
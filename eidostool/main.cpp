@@ -20,13 +20,14 @@
 #include "eidos_globals.h"
 #include "eidos_interpreter.h"
 #include "eidos_test.h"
+#include "eidos_parallel.h"
 
 
 void PrintUsageAndDie();
 
 void PrintUsageAndDie()
 {
-	std::cout << "usage: eidos -version | -usage | -testEidos | [-time] [-mem] <script file>" << std::endl;
+	std::cout << "usage: eidos -version | -usage | -testEidos | -benchmarkEidos | [-time] [-mem] [-noBytecode] [-noFusion] [-noFolding] [-maxThreads <n>] [-parallelThreshold <n>] <script file>" << std::endl;
 	exit(0);
 }
 
@@ -63,6 +64,52 @@ int main(int argc, const char * argv[])
 			continue;
 		}
 		
+		// -noBytecode: run everything through the tree-walking interpreter; must precede -testEidos to affect it
+		if (strcmp(arg, "-noBytecode") == 0)
+		{
+			gEidosScalarBytecode = false;
+			
+			continue;
+		}
+		
+		// -noFusion: evaluate vector expressions one operator at a time; must precede -testEidos to affect it
+		if (strcmp(arg, "-noFusion") == 0)
+		{
+			gEidosVectorFusion = false;
+			
+			continue;
+		}
+		
+		// -noFolding: re-evaluate constant expressions every time; must precede -testEidos to affect it
+		if (strcmp(arg, "-noFolding") == 0)
+		{
+			gEidosConstantFolding = false;
+			
+			continue;
+		}
+		
+		// -maxThreads <n>: let large vector builtins use up to n threads (0 for one per core); results do not depend on it
+		if (strcmp(arg, "-maxThreads") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie();
+			
+			Eidos_SetMaxThreads(strtol(argv[arg_index], NULL, 10));
+			
+			continue;
+		}
+		
+		// -parallelThreshold <n>: the number of elements below which builtins stay single-threaded
+		if (strcmp(arg, "-parallelThreshold") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie();
+			
+			Eidos_SetParallelThreshold(strtol(argv[arg_index], NULL, 10));
+			
+			continue;
+		}
+		
 		// -version or -v: print version information
 		if (strcmp(arg, "-version") == 0 || strcmp(arg, "-v") == 0)
 		{
@@ -82,6 +129,18 @@ int main(int argc, const char * argv[])
 			exit(test_result);
 		}
 		
+		// -benchmarkEidos: measure the element throughput of vectorized builtins and operators, and quit
+		if (strcmp(arg, "-benchmarkEidos") == 0)
+		{
+			gEidosTerminateThrows = true;
+			Eidos_WarmUp();
+			
+			int benchmark_result = RunEidosBenchmarks();
+			
+			Eidos_FlushFiles();
+			exit(benchmark_result);
+		}
+		
 		// -usage or -u: print usage information
 		if (strcmp(arg, "-usage") == 0 || strcmp(arg, "-u") == 0 || strcmp(arg, "-?") == 0)
 		{